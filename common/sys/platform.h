@@ -109,6 +109,7 @@
 //#define __USE_RAY_MASK__
 //#define __USE_STAT_COUNTERS__
 //#define __BACKFACE_CULLING__
+//#define __INTERSECTION_FILTER__
 //#define __FIX_RAYS__
 //#define __SPINLOCKS__
 #endif
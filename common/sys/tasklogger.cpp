@@ -26,6 +26,9 @@ namespace embree
 {
   bool TaskLogger::active = false;
   int64 TaskLogger::startCycle = 0;
+  int64 TaskLogger::stopCycle = 0;
+  double TaskLogger::startTime = 0.0;
+  double TaskLogger::stopTime = 0.0;
   std::vector<TaskLogger*> TaskLogger::threads;
 
   bool TaskLogger::init (size_t numThreads)
@@ -46,6 +49,7 @@ namespace embree
     for (size_t i=0; i<threads.size(); i++)
       threads[i]->reset();
     
+    startTime = getSeconds();
     startCycle = rdtsc();
     active = true;
 #endif
@@ -54,6 +58,8 @@ namespace embree
   void TaskLogger::stop() {
 #if defined(__LOG_TASKS__)
     active = false;
+    stopCycle = rdtsc();
+    stopTime = getSeconds();
 #endif
   }
 
@@ -319,6 +325,56 @@ namespace embree
     
     sheet.drawPolyLine(points,numUsage,lineSize,DRAW::Blue);
     sheet.drawText(Vec2f(0.5f+box.lower.x,0.5f+box.upper.y),"Usage [Percent]",textSize,DRAW::Black);
+#endif
+  }
+
+  /** store all logged data into trace event JSON file */
+  void TaskLogger::storeJSON(const char* fname)
+  {
+#if defined(__LOG_TASKS__)
+
+    /** calibrate cycle counter against wall clock time */
+    double cyclesPerMicroSecond = 1.0;
+    if (stopCycle > startCycle && stopTime > startTime)
+      cyclesPerMicroSecond = double(stopCycle-startCycle)/(1E6*(stopTime-startTime));
+
+    /** the run starts with the first logged task, counters are
+     *  relative to the start of the logger, which might precede the
+     *  first task by the time spent between rtcInit and the first build */
+    int64 minCycle = 0;
+    bool first = true;
+    for (size_t i=0; i<threads.size(); i++) {
+      for (size_t j=0; j<threads[i]->curTask; j++) {
+        if (first || threads[i]->counters[j].start < minCycle) minCycle = threads[i]->counters[j].start;
+        first = false;
+      }
+    }
+
+    std::ofstream fout(fname);
+    if (!fout) throw std::runtime_error("cannot open file "+std::string(fname));
+    fout.setf(std::ios::fixed, std::ios::floatfield);
+    fout.precision(3);
+
+    fout << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" << "\n";
+    for (size_t tid=0; tid<threads.size(); tid++) 
+    {
+      if (tid) fout << ",\n";
+      fout << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << tid 
+           << ",\"args\":{\"name\":\"thread" << tid << "\"}}";
+      
+      TaskLogger* counters = threads[tid];
+      for (size_t j=0; j<counters->curTask; j++) 
+      {
+        const char* name = counters->counters[j].name;
+        if (name == NULL) name = "NULL";
+        const double t0 = double(counters->counters[j].start-minCycle)/cyclesPerMicroSecond;
+        const double t1 = double(counters->counters[j].stop -minCycle)/cyclesPerMicroSecond;
+        fout << ",\n{\"name\":\"" << name << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << tid 
+             << ",\"ts\":" << t0 << ",\"dur\":" << t1-t0 
+             << ",\"args\":{\"elt\":" << (int64)counters->counters[j].elt << "}}";
+      }
+    }
+    fout << "\n]}" << std::endl;
 #endif
   }
 }
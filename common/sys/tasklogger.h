@@ -18,7 +18,8 @@
 #define __EMBREE_TASKLOGGER_H__
 
 /*! \file Implements a task logger. One can log start and end cycle of a task and store the
-   resulting scheduling diagram into a FIG file. */
+   resulting scheduling diagram into a FIG file or into a trace event JSON file that can be
+   loaded into chrome://tracing or Perfetto. */
 
 #include "sys/platform.h"
 #include "sys/intrinsics.h"
@@ -35,6 +36,9 @@ namespace embree
   public:
     static bool active;
     static int64 startCycle;
+    static int64 stopCycle;
+    static double startTime;
+    static double stopTime;
     static std::vector<TaskLogger*> threads;
 
   public:
@@ -71,6 +75,9 @@ namespace embree
     /* store scheduling diagram to FIG file */
     static void store(const char* fname);
 
+    /* store all logged tasks to trace event JSON file */
+    static void storeJSON(const char* fname);
+
   public:
     
     TaskLogger (int threadID) : threadID(threadID) {
@@ -41,6 +41,15 @@ namespace embree
   
   TaskScheduler* TaskScheduler::instance = NULL;
 
+  /*! set for threads that execute the tasks they add themselves */
+  static __thread bool g_executeInline = false;
+
+  /*! set for the worker threads of the scheduler */
+  static __thread bool g_workerThread = false;
+
+  /*! index of the worker thread */
+  static __thread size_t g_threadIndex = 0;
+
   void TaskScheduler::create(size_t numThreads)
   {
     if (instance)
@@ -73,14 +82,46 @@ namespace embree
   void TaskScheduler::addTask(ssize_t threadIndex, QUEUE queue, Task* task)
   {
     if (!instance) throw std::runtime_error("Embree tasks not running.");
+    if (g_executeInline) { runInline(task); return; }
     instance->add(threadIndex,queue,task);
   }
 
+  bool TaskScheduler::executeInline(bool enable) 
+  {
+    const bool previous = g_executeInline;
+    g_executeInline = enable;
+    return previous;
+  }
+
+  bool TaskScheduler::isWorkerThread() {
+    return g_workerThread;
+  }
+
+  bool TaskScheduler::runPendingTask() 
+  {
+    if (!g_workerThread) return false;
+    return instance->tryRun(g_threadIndex,instance->numThreads);
+  }
+
+  void TaskScheduler::runInline(Task* task)
+  {
+    Event* event = task->event;
+    const size_t elts = task->elts;
+    if (event) event->inc();
+    if (task->run) {
+      for (size_t i=0; i<elts; i++) 
+        task->run(task->runData,0,1,i,elts,event);
+    }
+    if (task->complete) task->complete(task->completeData,0,1,event);
+    if (event) event->dec();
+  }
+
   void TaskScheduler::executeTask(size_t threadIndex, size_t threadCount, 
                                   runFunction run, void* runData, size_t elts, completeFunction complete, void* completeData, const char* name)
   {
     TaskScheduler::Event event;
     TaskScheduler::Task task(&event,run,runData,elts,complete,completeData,name);
+    if (g_executeInline) { runInline(&task); return; }
     instance->add(threadIndex,TaskScheduler::GLOBAL_FRONT,&task);
     instance->wait(threadIndex,threadCount,&event);
   }
@@ -90,6 +131,7 @@ namespace embree
   {
     TaskScheduler::Event event;
     TaskScheduler::Task task(&event,run,runData,elts,NULL,NULL,name);
+    if (g_executeInline) { runInline(&task); return; }
     instance->add(threadIndex,TaskScheduler::GLOBAL_FRONT,&task);
     instance->wait(threadIndex,threadCount,&event);
   }
@@ -99,6 +141,7 @@ namespace embree
   {
     TaskScheduler::Event event;
     TaskScheduler::Task task(&event,NULL,NULL,1,complete,completeData,name);
+    if (g_executeInline) { runInline(&task); return; }
     instance->add(threadIndex,TaskScheduler::GLOBAL_FRONT,&task);
     instance->wait(threadIndex,threadCount,&event);
   }
@@ -158,7 +201,8 @@ namespace embree
     Thread thread = *(Thread*) ptr;
     delete (Thread*) ptr;
 
-    
+    g_workerThread = true;
+    g_threadIndex = thread.threadIndex;
     thread.scheduler->run(thread.threadIndex,thread.threadCount);
   }
   catch (const Terminate&) {
@@ -156,6 +156,22 @@ namespace embree
 
     static void executeTask(size_t threadIndex, size_t threadCount, completeFunction complete, void* completeData, const char* name);
 
+    /*! Executes all tasks the calling thread adds from now on
+     *  immediately on the calling thread instead of passing them to
+     *  the worker threads, returns the previous setting. Lets a thread
+     *  that may itself run inside a task execute work without waiting
+     *  for the other threads. */
+    static bool executeInline(bool enable);
+
+    /*! returns true if the calling thread is one of the worker threads */
+    static bool isWorkerThread();
+
+    /*! Executes a pending task on the calling worker thread. Returns
+     *  false if no task is pending or the caller is no worker thread.
+     *  Lets a worker thread that waits for another thread help with
+     *  the tasks that thread may wait for. */
+    static bool runPendingTask();
+
     /*! destroys the task scheduler */
     static void destroy();
 
@@ -167,6 +183,9 @@ namespace embree
     
   protected:
 
+    /*! executes all elements of the task on the calling thread */
+    static void runInline(Task* task);
+
     /*! creates all threads */
     void createThreads(size_t numThreads);
 
@@ -182,6 +201,9 @@ namespace embree
     /*! waits for an event out of a task */
     virtual void wait(size_t threadIndex, size_t threadCount, Event* event) = 0;
 
+    /*! executes a pending task without waiting for one, returns false if no task is pending */
+    virtual bool tryRun(size_t threadIndex, size_t threadCount) { return false; }
+
     /*! sets the terminate thread variable */
     virtual void terminate() = 0;
 
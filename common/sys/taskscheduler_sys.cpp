@@ -141,13 +141,17 @@ namespace embree
     }
   }
 
-  void TaskSchedulerSys::work(size_t threadIndex, size_t threadCount, bool wait)
+  bool TaskSchedulerSys::tryRun(size_t threadIndex, size_t threadCount) {
+    return work(threadIndex,threadCount,false);
+  }
+
+  bool TaskSchedulerSys::work(size_t threadIndex, size_t threadCount, bool wait)
   {
     /* wait for available task */
     mutex.lock();
     while ((end-begin) == 0 && !terminateThreads) {
       if (wait) condition.wait(mutex);
-      else { mutex.unlock(); return; }
+      else { mutex.unlock(); return false; }
     }
     
     /* terminate this thread */
@@ -181,6 +185,7 @@ namespace embree
       }
       if (event) event->dec();
     }
+    return true;
   }
 
   void TaskSchedulerSys::run(size_t threadIndex, size_t threadCount)
@@ -39,8 +39,11 @@ namespace embree
     /*! waits for an event out of a task */
     void wait(size_t threadIndex, size_t threadCount, Event* event);
 
-    /*! processes next task */
-    void work(size_t threadIndex, size_t threadCount, bool wait);
+    /*! executes a pending task without waiting for one */
+    bool tryRun(size_t threadIndex, size_t threadCount);
+
+    /*! processes next task, returns false if no task is pending and wait is not set */
+    bool work(size_t threadIndex, size_t threadCount, bool wait);
 
     /*! thread function */
     void run(size_t threadIndex, size_t threadCount);
@@ -33,6 +33,19 @@
 #  define RTCORE_ALIGN(...) __attribute__((aligned(__VA_ARGS__)))
 #endif
 
+/*! Version of the Embree API. Version 2.2 added the instStack member
+ *  to all ray structures, applications compiled against an older
+ *  version have to be recompiled. */
+#define RTCORE_VERSION_MAJOR 2
+#define RTCORE_VERSION_MINOR 2
+#define RTCORE_VERSION_PATCH 0
+#define RTCORE_VERSION 20200
+
+/*! Maximal number of nested instances recorded in the instStack
+ *  member of rays. Instances can be nested deeper, but only the
+ *  outermost RTC_MAX_INSTANCE_DEPTH levels are recorded. */
+#define RTC_MAX_INSTANCE_DEPTH 4
+
 #include "rtcore_scene.h"
 #include "rtcore_geometry.h"
 #include "rtcore_geometry_user.h"
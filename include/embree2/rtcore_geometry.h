@@ -23,6 +23,9 @@
 /*! invalid geometry ID */
 #define RTC_INVALID_GEOMETRY_ID ((unsigned)-1)
 
+/*! maximal number of motion blur time steps of an instance */
+#define RTC_MAX_INSTANCE_TIME_STEPS 256
+
 /*! \brief Specifies the type of buffers when mapping buffers */
 enum RTCBufferType {
   RTC_INDEX_BUFFER    = 0x01000000,
@@ -53,18 +56,60 @@ enum RTCGeometryFlags
   will typically transform the ray with the inverse of the provided
   transformation and continue traversing the ray through the provided
   scene. If any geometry is hit, the instance ID (instID) member of
-  the ray will get set to the geometry ID of the instance. */
+  the ray will get set to the geometry ID of the instance. 
+
+  The instanced scene may itself contain instances. For such nested
+  instances instID holds the ID of the outermost instance and the
+  instStack member of the ray the IDs of all instances along the path
+  to the hit geometry, outermost first, with unused levels set to
+  RTC_INVALID_GEOMETRY_ID. A hit outside of any instance sets instID
+  and instStack to RTC_INVALID_GEOMETRY_ID, thus instID does not have
+  to be initialized. Committing a scene
+  commits again all non-static scenes it instances, directly or
+  nested, whose instanced scenes got committed after them, thus
+  changes of deeply nested scenes propagate up to the committed
+  scene. Instancing a scene that contains the target scene fails
+  with RTC_INVALID_ARGUMENT. 
+
+  For motion blur an instance can have multiple time steps
+  (numTimeSteps), each with its own transformation. The
+  transformations get linearly interpolated by the time of the ray,
+  with the first time step at time 0 and the last at time 1. A number
+  of time steps outside the range 1 to RTC_MAX_INSTANCE_TIME_STEPS
+  fails with RTC_INVALID_ARGUMENT. */
 RTCORE_API unsigned rtcNewInstance (RTCScene target,                  //!< the scene the instance belongs to
-                                    RTCScene source                   //!< the scene to instantiate
+                                    RTCScene source,                  //!< the scene to instantiate
+                                    size_t numTimeSteps = 1           //!< number of motion blur time steps
   );
 
-/*! \brief Sets transformation of the instance */
+/*! \brief Sets transformation of the instance for some time step */
 RTCORE_API void rtcSetTransform (RTCScene scene,                          //!< scene handle
                                  unsigned geomID,                         //!< ID of geometry
                                  RTCMatrixType layout,                    //!< layout of transformation matrix
-                                 const float* xfm                         //!< transformation matrix
+                                 const float* xfm,                        //!< transformation matrix
+                                 size_t timeStep = 0                      //!< time step to set the transformation for
                                  );
 
+/*! \brief Sets the transformations of many instances at once.
+
+  The transformation of instance geomIDs[i] is read from xfms at
+  offset i*12 floats (i*16 floats for
+  RTC_MATRIX_COLUMN_MAJOR_ALIGNED16). The scene is locked only once
+  for all instances. If only transformations of instances changed
+  since the last commit, the next commit refits the top level BVH
+  instead of rebuilding it. As refitting lets the quality of the BVH
+  degrade, the top level BVH still gets rebuilt if its SAH cost grew
+  by more than 50% since the last rebuild, and after 64 commits at the
+  latest. The rtcInit options toprebuildsah and toprebuild change
+  these limits, 0 disables them. */
+RTCORE_API void rtcSetTransforms (RTCScene scene,                          //!< scene handle
+                                  RTCMatrixType layout,                    //!< layout of transformation matrices
+                                  size_t numTransforms,                    //!< number of transformations
+                                  const unsigned* geomIDs,                 //!< IDs of the instances
+                                  const float* xfms,                       //!< transformation matrices
+                                  size_t timeStep = 0                      //!< time step to set the transformations for
+                                  );
+
 /*! \brief Creates a new triangle mesh. 
 
   The number of triangles (numTriangles), number of vertices
@@ -82,7 +127,51 @@ RTCORE_API unsigned rtcNewTriangleMesh (RTCScene scene,                    //!<
                                         size_t numTimeSteps = 1            //!< number of motion blur time steps
   );
 
-/*! \brief Sets 30 bit ray mask. */
+/*! \brief Creates a new quad mesh.
+
+  The number of quads (numQuads) and number of vertices (numVertices)
+  have to get specified. The quad indices can be set by mapping and
+  writing to the index buffer (RTC_INDEX_BUFFER), which stores 4
+  integers per quad. The vertices can be set by mapping and writing
+  into the vertex buffer (RTC_VERTEX_BUFFER). Each quad (v0,v1,v2,v3)
+  is intersected as the two triangles (v0,v1,v3) and (v2,v3,v1), and
+  the hit reports u/v coordinates of the quad, with v0 at (0,0), v1 at
+  (1,0), v2 at (1,1), and v3 at (0,1). */
+RTCORE_API unsigned rtcNewQuadMesh (RTCScene scene,                    //!< the scene the mesh belongs to
+                                    RTCGeometryFlags flags,            //!< geometry flags
+                                    size_t numQuads,                   //!< number of quads
+                                    size_t numVertices                 //!< number of vertices
+  );
+
+/*! \brief Supported shapes of point primitives. */
+enum RTCPointType
+{
+  RTC_POINT_SPHERE = 0,    //!< each point is a sphere around its center
+  RTC_POINT_DISC   = 1,    //!< each point is a disc around its center that faces the ray
+};
+
+/*! \brief Creates a new set of points.
+
+  Each point is specified by a center and a radius. The points are
+  set by mapping and writing into the vertex buffer
+  (RTC_VERTEX_BUFFER), which stores 4 floats per point: the x, y,
+  and z coordinate of the center followed by the radius. Depending
+  on the point type, the points are intersected as spheres or as
+  discs oriented towards the ray origin. */
+RTCORE_API unsigned rtcNewPoints (RTCScene scene,                    //!< the scene the points belong to
+                                  RTCGeometryFlags flags,            //!< geometry flags
+                                  RTCPointType type,                 //!< shape of the points
+                                  size_t numPoints                   //!< number of points
+  );
+
+/*! \brief Sets 30 bit ray mask.
+
+  A ray can only hit a geometry if the bitwise AND of the ray mask
+  and the geometry mask is not 0. The mask of an instance applies to
+  all geometries of the instanced scene. Rays whose mask matches none
+  of the geometries of an instanced scene skip the instance without
+  traversing the instanced scene. Changed masks take effect at the
+  next commit. */
 RTCORE_API void rtcSetMask (RTCScene scene, unsigned geomID, int mask);
 
 /*! \brief Maps specified buffer. This function can be used to set index and
@@ -115,6 +204,56 @@ RTCORE_API void rtcDisable (RTCScene scene, unsigned geomID);
 /*! \brief Deletes the geometry. */
 RTCORE_API void rtcDeleteGeometry (RTCScene scene, unsigned geomID);
 
+/*! Type of filter function pointer for single rays. */
+typedef void (*RTCFilterFunc)(void* ptr,           /*!< pointer to user data */
+                              RTCRay& ray          /*!< intersection to filter */);
+
+/*! Type of filter function pointer for ray packets of size 4. */
+typedef void (*RTCFilterFunc4)(const void* valid,  /*!< pointer to valid mask */
+                               void* ptr,          /*!< pointer to user data */
+                               RTCRay4& ray        /*!< intersection to filter */);
+
+/*! Type of filter function pointer for ray packets of size 8. */
+typedef void (*RTCFilterFunc8)(const void* valid,  /*!< pointer to valid mask */
+                               void* ptr,          /*!< pointer to user data */
+                               RTCRay8& ray        /*!< intersection to filter */);
+
+/*! \brief Sets the intersection filter function for single rays. 
+
+  The filter is called by the traversal kernels for each hit of a
+  triangle of this mesh that is closer than the current hit. The ray
+  passed to the filter contains the hit information of the potential
+  hit. Setting the geomID member of the ray to RTC_INVALID_GEOMETRY_ID
+  rejects the hit and traversal continues with the previous hit
+  restored. The pointer set with rtcSetUserData is passed to the
+  filter. Filter functions are only invoked if Embree got compiled
+  with RTCORE_INTERSECTION_FILTER enabled and only by the BVH4
+  triangle kernels, otherwise setting a filter function fails with
+  RTC_INVALID_OPERATION. Setting the first filter
+  function or ray mask of a scene takes effect with the next
+  rtcCommit, as the scene only selects kernels that support filter
+  functions and masks at commit time. */
+RTCORE_API void rtcSetIntersectionFilterFunction (RTCScene scene, unsigned geomID, RTCFilterFunc func);
+
+/*! \brief Sets the intersection filter function for ray packets of size 4. */
+RTCORE_API void rtcSetIntersectionFilterFunction4 (RTCScene scene, unsigned geomID, RTCFilterFunc4 func);
+
+/*! \brief Sets the intersection filter function for ray packets of size 8. */
+RTCORE_API void rtcSetIntersectionFilterFunction8 (RTCScene scene, unsigned geomID, RTCFilterFunc8 func);
+
+/*! \brief Sets the occlusion filter function for single rays. 
+
+  The filter is called for each potential occluder found for the ray
+  and works analogous to the intersection filter. Setting the geomID
+  member of the ray to RTC_INVALID_GEOMETRY_ID rejects the occluder. */
+RTCORE_API void rtcSetOcclusionFilterFunction (RTCScene scene, unsigned geomID, RTCFilterFunc func);
+
+/*! \brief Sets the occlusion filter function for ray packets of size 4. */
+RTCORE_API void rtcSetOcclusionFilterFunction4 (RTCScene scene, unsigned geomID, RTCFilterFunc4 func);
+
+/*! \brief Sets the occlusion filter function for ray packets of size 8. */
+RTCORE_API void rtcSetOcclusionFilterFunction8 (RTCScene scene, unsigned geomID, RTCFilterFunc8 func);
+
 /*! @} */
 
 #endif
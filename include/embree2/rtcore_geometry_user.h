@@ -78,6 +78,66 @@ typedef void (*RTCOccludedFunc16) (const void* valid, /*! pointer to valid mask
                                    RTCRay16& ray,     /*!< Ray packet to test occlusion. */
                                    size_t item        /*!< item to test for occlusion */);
 
+/*! Type of bounding function for a range of items. */
+typedef void (*RTCBoundsRangeFunc)(void* ptr,         /*!< pointer to user data */
+                                   size_t begin,      /*!< first item to calculate bounds for */
+                                   size_t end,        /*!< one past the last item */
+                                   RTCBounds* bounds_o /*!< returns end-begin calculated bounds */);
+
+/*! Type of intersect function pointer for a range of items and single rays. */
+typedef void (*RTCIntersectRangeFunc)(void* ptr,      /*!< pointer to user data */
+                                      RTCRay& ray,    /*!< ray to intersect */
+                                      size_t begin,   /*!< first item to intersect */
+                                      size_t end      /*!< one past the last item */);
+
+/*! Type of intersect function pointer for a range of items and ray packets of size 4. */
+typedef void (*RTCIntersectRangeFunc4)(const void* valid, /*!< pointer to valid mask */
+                                       void* ptr,         /*!< pointer to user data */
+                                       RTCRay4& ray,      /*!< ray packet to intersect */
+                                       size_t begin,      /*!< first item to intersect */
+                                       size_t end         /*!< one past the last item */);
+
+/*! Type of intersect function pointer for a range of items and ray packets of size 8. */
+typedef void (*RTCIntersectRangeFunc8)(const void* valid, /*!< pointer to valid mask */
+                                       void* ptr,         /*!< pointer to user data */
+                                       RTCRay8& ray,      /*!< ray packet to intersect */
+                                       size_t begin,      /*!< first item to intersect */
+                                       size_t end         /*!< one past the last item */);
+
+/*! Type of intersect function pointer for a range of items and ray packets of size 16. */
+typedef void (*RTCIntersectRangeFunc16)(const void* valid, /*!< pointer to valid mask */
+                                        void* ptr,         /*!< pointer to user data */
+                                        RTCRay16& ray,     /*!< ray packet to intersect */
+                                        size_t begin,      /*!< first item to intersect */
+                                        size_t end         /*!< one past the last item */);
+
+/*! Type of occlusion function pointer for a range of items and single rays. */
+typedef void (*RTCOccludedRangeFunc) (void* ptr,      /*!< pointer to user data */ 
+                                      RTCRay& ray,    /*!< ray to test occlusion */
+                                      size_t begin,   /*!< first item to test for occlusion */
+                                      size_t end      /*!< one past the last item */);
+
+/*! Type of occlusion function pointer for a range of items and ray packets of size 4. */
+typedef void (*RTCOccludedRangeFunc4) (const void* valid, /*! pointer to valid mask */
+                                       void* ptr,         /*!< pointer to user data */
+                                       RTCRay4& ray,      /*!< Ray packet to test occlusion. */
+                                       size_t begin,      /*!< first item to test for occlusion */
+                                       size_t end         /*!< one past the last item */);
+
+/*! Type of occlusion function pointer for a range of items and ray packets of size 8. */
+typedef void (*RTCOccludedRangeFunc8) (const void* valid, /*! pointer to valid mask */
+                                       void* ptr,         /*!< pointer to user data */
+                                       RTCRay8& ray,      /*!< Ray packet to test occlusion. */
+                                       size_t begin,      /*!< first item to test for occlusion */
+                                       size_t end         /*!< one past the last item */);
+
+/*! Type of occlusion function pointer for a range of items and ray packets of size 16. */
+typedef void (*RTCOccludedRangeFunc16) (const void* valid, /*! pointer to valid mask */
+                                        void* ptr,         /*!< pointer to user data */
+                                        RTCRay16& ray,     /*!< Ray packet to test occlusion. */
+                                        size_t begin,      /*!< first item to test for occlusion */
+                                        size_t end         /*!< one past the last item */);
+
 /*! Creates a new user geometry object. This feature makes it possible
  *  to add arbitrary types of geometry to the scene by providing
  *  appropiate bounding, intersect and occluded functions. A user
@@ -145,6 +205,48 @@ RTCORE_API void rtcSetOccludedFunction8 (RTCScene scene, unsigned geomID, RTCOcc
  *  intersecting the user geometry. */
 RTCORE_API void rtcSetOccludedFunction16 (RTCScene scene, unsigned geomID, RTCOccludedFunc16 occluded16);
 
+/*! Sets a bounding function that calculates the bounds of all items
+ *  of the range [begin,end) in a single call. Setting any of the
+ *  range functions makes Embree group consecutive items into blocks
+ *  of up to 8 items that are built and intersected together, thus
+ *  items should be ordered spatially coherent. The range functions
+ *  cannot be changed anymore once a static scene got committed. */
+RTCORE_API void rtcSetBoundsRangeFunction (RTCScene scene, unsigned geomID, RTCBoundsRangeFunc bounds);
+
+/*! Set intersect function for a range of items and single rays. The
+ *  rtcIntersect function will call the passed function once per
+ *  block of items instead of once per item. */
+RTCORE_API void rtcSetIntersectRangeFunction (RTCScene scene, unsigned geomID, RTCIntersectRangeFunc intersect);
+
+/*! Set intersect function for a range of items and ray packets of
+ *  size 4. */
+RTCORE_API void rtcSetIntersectRangeFunction4 (RTCScene scene, unsigned geomID, RTCIntersectRangeFunc4 intersect4);
+
+/*! Set intersect function for a range of items and ray packets of
+ *  size 8. */
+RTCORE_API void rtcSetIntersectRangeFunction8 (RTCScene scene, unsigned geomID, RTCIntersectRangeFunc8 intersect8);
+
+/*! Set intersect function for a range of items and ray packets of
+ *  size 16. */
+RTCORE_API void rtcSetIntersectRangeFunction16 (RTCScene scene, unsigned geomID, RTCIntersectRangeFunc16 intersect16);
+
+/*! Set occlusion function for a range of items and single rays. The
+ *  rtcOccluded function will call the passed function once per block
+ *  of items instead of once per item. */
+RTCORE_API void rtcSetOccludedRangeFunction (RTCScene scene, unsigned geomID, RTCOccludedRangeFunc occluded);
+
+/*! Set occlusion function for a range of items and ray packets of
+ *  size 4. */
+RTCORE_API void rtcSetOccludedRangeFunction4 (RTCScene scene, unsigned geomID, RTCOccludedRangeFunc4 occluded4);
+
+/*! Set occlusion function for a range of items and ray packets of
+ *  size 8. */
+RTCORE_API void rtcSetOccludedRangeFunction8 (RTCScene scene, unsigned geomID, RTCOccludedRangeFunc8 occluded8);
+
+/*! Set occlusion function for a range of items and ray packets of
+ *  size 16. */
+RTCORE_API void rtcSetOccludedRangeFunction16 (RTCScene scene, unsigned geomID, RTCOccludedRangeFunc16 occluded16);
+
 /*! @} */
 
 #endif
@@ -47,7 +47,8 @@ public:
 
   int32 geomID;        //!< geometry ID
   int32 primID;        //!< primitive ID
-  int32 instID;        //!< instance ID
+  int32 instID;        //!< instance ID of the outermost instance
+  int32 instStack[RTC_MAX_INSTANCE_DEPTH]; //!< instance IDs of all nested instances, outermost first
 };
 
 /*! Ray structure for packets of 4 rays. */
@@ -80,7 +81,8 @@ public:
   
   int32 geomID[4];  //!< geometry ID
   int32 primID[4];  //!< primitive ID
-  int32 instID[4];  //!< instance ID
+  int32 instID[4];  //!< instance ID of the outermost instance
+  int32 instStack[RTC_MAX_INSTANCE_DEPTH][4]; //!< instance IDs of all nested instances, outermost first
 };
 
 /*! Ray structure for packets of 8 rays. */
@@ -113,7 +115,8 @@ public:
   
   int32 geomID[8];  //!< geometry ID
   int32 primID[8];  //!< primitive ID
-  int32 instID[8];  //!< instance ID
+  int32 instID[8];  //!< instance ID of the outermost instance
+  int32 instStack[RTC_MAX_INSTANCE_DEPTH][8]; //!< instance IDs of all nested instances, outermost first
 };
 
 /*! \brief Ray structure for packets of 16 rays. */
@@ -146,7 +149,8 @@ public:
   
   int32 geomID[16];  //!< geometry ID
   int32 primID[16];  //!< primitive ID
-  int32 instID[16];  //!< instance ID
+  int32 instID[16];  //!< instance ID of the outermost instance
+  int32 instStack[RTC_MAX_INSTANCE_DEPTH][16]; //!< instance IDs of all nested instances, outermost first
 };
 
 /*! @} */
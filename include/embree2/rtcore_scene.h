@@ -38,6 +38,8 @@ enum RTCSceneFlags
   RTC_SCENE_COHERENT   = (1 << 9),    //!< optimize data structures for coherent rays
   RTC_SCENE_INCOHERENT = (1 << 10),    //!< optimize data structures for in-coherent rays (enabled by default)
   RTC_SCENE_HIGH_QUALITY = (1 << 11),  //!< create higher quality data structures
+  RTC_SCENE_AUTOTUNE   = (1 << 12),    //!< select data structure by measuring candidates at commit time
+  RTC_SCENE_DEFERRED   = (1 << 13),    //!< build data structure when the first ray reaches the scene
 
   /* traversal algorithm flags */
   RTC_SCENE_ROBUST     = (1 << 16)     //!< use more robust traversal algorithms
@@ -60,7 +62,11 @@ RTCORE_API RTCScene rtcNewScene (RTCSceneFlags flags, RTCAlgorithmFlags aflags);
 
 /*! Commits the geometry of the scene. After initializing or modifying
  *  geometries, this function has to get called before tracing
- *  rays. */
+ *  rays. Scenes created with the RTC_SCENE_DEFERRED flag only
+ *  compute their bounds at commit, their acceleration structure gets
+ *  built by the first ray that reaches the scene, directly or through
+ *  an instance. Rays that reach the scene while it gets built wait
+ *  for the build to finish. */
 RTCORE_API void rtcCommit (RTCScene scene);
 
 /*! Intersects a single ray with the scene. The ray has to be aligned
@@ -113,6 +119,269 @@ RTCORE_API void rtcOccluded8 (const void* valid, RTCScene scene, RTCRay8& ray);
  *  instructions. */
 RTCORE_API void rtcOccluded16 (const void* valid, RTCScene scene, RTCRay16& ray);
 
+/*! Primitive that blocked a previous shadow ray, see rtcOccludedHint. */
+struct RTCOccluderHint
+{
+  unsigned geomID;  //!< geometry ID of the occluder, RTC_INVALID_GEOMETRY_ID for no hint
+  unsigned primID;  //!< primitive ID of the occluder
+  size_t leaf;      //!< opaque reference to the leaf of the acceleration structure containing the occluder
+  RTCScene scene;   //!< scene that filled the hint
+  size_t commit;    //!< commit of the scene that filled the hint
+};
+
+/*! \brief Tests if a single ray is occluded by the scene, starting with a hinted occluder.
+
+  The primitives of the acceleration structure leaf that contained
+  the hinted occluder are tested first and the traversal is skipped
+  entirely if one of them blocks the ray. Otherwise the scene gets
+  traversed like by rtcOccluded and the hint is left unchanged. A
+  hint has to be initialized by setting geomID to
+  RTC_INVALID_GEOMETRY_ID. A ray without a hint traverses the scene
+  until it finds the first occluder and writes the primitive and its
+  leaf to the hint, thus the hint can be passed to the next coherent
+  ray, e.g. the next shadow ray of the same pixel towards the same
+  light. The hint records the scene and commit that filled it, a
+  hint of another scene or of an earlier commit is reset. A hint
+  must not be used after its scene got deleted. As
+  for rtcOccluded, geomID of the ray is set to 0 if the ray is
+  occluded. Occlusion filter functions and geometry masks are
+  honoured. Scenes that do not consist of triangle meshes using the
+  BVH4 based acceleration structures ignore the hint and behave like
+  rtcOccluded. This function can only be called for scenes with the
+  RTC_INTERSECT1 flag set. */
+RTCORE_API void rtcOccludedHint (RTCScene scene, RTCRay& ray, RTCOccluderHint& hint);
+
+/*! \brief Tests visibility between many points and many targets.
+
+  For each pair of point i and target j the segment between them is
+  tested for occlusion, excluding a distance of eps at both ends to
+  avoid self intersections. The result is written as a bitmask in row
+  major order, each row consists of (numTargets+31)/32 unsigned
+  integers and bit j%32 of integer j/32 of row i is set if the
+  segment from point i to target j is occluded. Points and targets
+  are given as 3 floats per entry with a stride in bytes between
+  entries. All rays of a point share their origin and get traced
+  using the widest packet size enabled for the scene, each segment
+  terminates at the first occluder found. The scene has to be
+  committed and created with the RTC_INTERSECT1 flag. The function is
+  thread safe, thus large matrices can be split into blocks of points
+  that get processed in parallel. */
+RTCORE_API void rtcOccludedMatrix (RTCScene scene, 
+                                   const float* points, size_t numPoints, size_t pointStride,
+                                   const float* targets, size_t numTargets, size_t targetStride,
+                                   float eps, unsigned int* occluded);
+
+/*! Result of a closest point query. */
+struct RTCORE_ALIGN(16) RTCClosestPoint
+{
+  float p[3];      //!< closest point on the surface
+  float dist;      //!< distance of the closest point to the query point
+  float u;         //!< barycentric u coordinate of the closest point
+  float v;         //!< barycentric v coordinate of the closest point
+  int geomID;      //!< geometry ID of the closest triangle, RTC_INVALID_GEOMETRY_ID if none was found
+  int primID;      //!< primitive ID of the closest triangle
+};
+
+/*! \brief Finds the closest point on the triangles of the scene.
+
+  Searches the triangle closest to the point p (3 floats) within the
+  distance radius, considering only meshes whose mask has a bit in
+  common with the given mask. The BVH gets traversed in order of the
+  distance of its nodes to the query point, thus small radii make the
+  query fast. If no triangle is found within the radius, the geomID of
+  the result is set to RTC_INVALID_GEOMETRY_ID. The scene has to be
+  committed and may only contain static or deformable triangle
+  meshes, scenes with motion blurred meshes, user geometries,
+  instances, points, or quads are rejected. The query is supported
+  by the BVH4 based triangle acceleration structures, which are the
+  default ones. In all other cases an RTC_INVALID_OPERATION error is
+  recorded. */
+RTCORE_API void rtcClosestPoint (RTCScene scene, const float* p, float radius, int mask, RTCClosestPoint& result);
+
+/*! Pair of overlapping triangles found by rtcCollide. */
+struct RTCCollision
+{
+  unsigned int geomID0;   //!< geometry ID of the triangle of the first scene
+  unsigned int primID0;   //!< primitive ID of the triangle of the first scene
+  unsigned int geomID1;   //!< geometry ID of the triangle of the second scene
+  unsigned int primID1;   //!< primitive ID of the triangle of the second scene
+};
+
+/*! Type of the callback function that receives the overlapping triangle pairs found by rtcCollide. */
+typedef void (*RTCCollideFunc)(void* userPtr,                   /*!< user pointer passed to rtcCollide */
+                               const RTCCollision* collisions,  /*!< array of overlapping triangle pairs */
+                               size_t num                       /*!< number of pairs in the array */);
+
+/*! \brief Finds all pairs of overlapping triangles of two scenes.
+
+  Both BVHs are traversed simultaneously, testing the 4 children of
+  a node of the first scene against the 4 children of a node of the
+  second scene at once. The second scene is placed into the space of
+  the first scene by the optional transformation xfm1, given as a 3x4
+  column major matrix (12 floats), pass NULL for the identity. This
+  way the same scene can get tested at many poses without rebuilding
+  it. Overlapping triangle pairs, including touching ones, are passed
+  in batches to the callback. The traversal gets split into tasks
+  that run in parallel on the Embree threads, thus the callback gets
+  invoked concurrently from different threads and has to be thread
+  safe. Both scenes have to be committed and may only contain static
+  or deformable triangle meshes, scenes with motion blurred meshes,
+  user geometries, instances, points, or quads are rejected. Both
+  scenes have to use the BVH4 based triangle acceleration structures,
+  which are the default ones. In all other cases an
+  RTC_INVALID_OPERATION error is recorded. */
+RTCORE_API void rtcCollide (RTCScene scene0, RTCScene scene1, const float* xfm1, RTCCollideFunc callback, void* userPtr);
+
+/*! Hit found by a multi-hit query. */
+struct RTCHit
+{
+  float t;         //!< distance of the hit along the ray
+  float u;         //!< barycentric u coordinate of the hit
+  float v;         //!< barycentric v coordinate of the hit
+  int geomID;      //!< geometry ID of the hit triangle
+  int primID;      //!< primitive ID of the hit triangle
+};
+
+/*! \brief Finds the first k hits along a ray. 
+
+  Collects the up to k closest hits of the ray in the range
+  [tnear,tfar] in a single traversal of the BVH. Once k hits are
+  found, the search range is shrunk to the distance of the k-th hit,
+  thus subtrees behind it get culled. The hits are written sorted by
+  distance to the hits array that has to provide space for k
+  entries, and their number is returned. Each triangle is reported at
+  most once. The ray itself is not modified. Intersection filter
+  functions are not invoked, geometry masks are tested if ray masks
+  are enabled. The scene has to be committed and contain only
+  triangle meshes using the BVH4 based acceleration structures, which
+  are the default ones, otherwise an RTC_INVALID_OPERATION error is
+  recorded. */
+RTCORE_API size_t rtcIntersectMultiHit (RTCScene scene, const RTCRay& ray, RTCHit* hits, size_t k);
+
+/*! \brief Finds the first k hits along each ray of a ray packet of size 8. 
+
+  The hits of ray i are written to hits[i*k] to hits[i*k+k-1] and
+  their number to numHits[i]. Inactive rays get 0 hits. Only
+  supported on CPUs with AVX. See rtcIntersectMultiHit. */
+RTCORE_API void rtcIntersectMultiHit8 (const void* valid, RTCScene scene, const RTCRay8& ray, RTCHit* hits, size_t k, size_t* numHits);
+
+/*! Type of the resolved intersect function for single rays. */
+typedef void (*RTCSceneIntersectFunc)(void* ptr,          /*!< opaque pointer of the intersector */
+                                      RTCRay& ray         /*!< ray to intersect */);
+
+/*! Type of the resolved intersect function for ray packets of size 4. */
+typedef void (*RTCSceneIntersectFunc4)(const void* valid, /*!< pointer to valid mask */
+                                       void* ptr,         /*!< opaque pointer of the intersector */
+                                       RTCRay4& ray       /*!< ray packet to intersect */);
+
+/*! Type of the resolved intersect function for ray packets of size 8. */
+typedef void (*RTCSceneIntersectFunc8)(const void* valid, /*!< pointer to valid mask */
+                                       void* ptr,         /*!< opaque pointer of the intersector */
+                                       RTCRay8& ray       /*!< ray packet to intersect */);
+
+/*! Type of the resolved intersect function for ray packets of size 16. */
+typedef void (*RTCSceneIntersectFunc16)(const void* valid, /*!< pointer to valid mask */
+                                        void* ptr,         /*!< opaque pointer of the intersector */
+                                        RTCRay16& ray      /*!< ray packet to intersect */);
+
+/*! Type of the resolved occlusion function for single rays. */
+typedef void (*RTCSceneOccludedFunc)(void* ptr,           /*!< opaque pointer of the intersector */
+                                     RTCRay& ray          /*!< ray to test occlusion */);
+
+/*! Type of the resolved occlusion function for ray packets of size 4. */
+typedef void (*RTCSceneOccludedFunc4)(const void* valid,  /*!< pointer to valid mask */
+                                      void* ptr,          /*!< opaque pointer of the intersector */
+                                      RTCRay4& ray        /*!< ray packet to test occlusion */);
+
+/*! Type of the resolved occlusion function for ray packets of size 8. */
+typedef void (*RTCSceneOccludedFunc8)(const void* valid,  /*!< pointer to valid mask */
+                                      void* ptr,          /*!< opaque pointer of the intersector */
+                                      RTCRay8& ray        /*!< ray packet to test occlusion */);
+
+/*! Type of the resolved occlusion function for ray packets of size 16. */
+typedef void (*RTCSceneOccludedFunc16)(const void* valid, /*!< pointer to valid mask */
+                                       void* ptr,         /*!< opaque pointer of the intersector */
+                                       RTCRay16& ray      /*!< ray packet to test occlusion */);
+
+/*! Resolved traversal functions of a committed scene for single
+ *  rays. Calling intersect(ptr,ray) is equivalent to
+ *  rtcIntersect(scene,ray), calling occluded(ptr,ray) is equivalent
+ *  to rtcOccluded(scene,ray). */
+struct RTCSceneIntersector 
+{
+  void* ptr;                          //!< opaque pointer to pass to the functions
+  RTCSceneIntersectFunc intersect;    //!< intersect function
+  RTCSceneOccludedFunc occluded;      //!< occlusion function
+};
+
+/*! Resolved traversal functions of a committed scene for ray packets of size 4. */
+struct RTCSceneIntersector4 
+{
+  void* ptr;                          //!< opaque pointer to pass to the functions
+  RTCSceneIntersectFunc4 intersect;   //!< intersect function
+  RTCSceneOccludedFunc4 occluded;     //!< occlusion function
+};
+
+/*! Resolved traversal functions of a committed scene for ray packets of size 8. */
+struct RTCSceneIntersector8 
+{
+  void* ptr;                          //!< opaque pointer to pass to the functions
+  RTCSceneIntersectFunc8 intersect;   //!< intersect function
+  RTCSceneOccludedFunc8 occluded;     //!< occlusion function
+};
+
+/*! Resolved traversal functions of a committed scene for ray packets of size 16. */
+struct RTCSceneIntersector16 
+{
+  void* ptr;                          //!< opaque pointer to pass to the functions
+  RTCSceneIntersectFunc16 intersect;  //!< intersect function
+  RTCSceneOccludedFunc16 occluded;    //!< occlusion function
+};
+
+/*! \brief Returns the resolved single ray traversal functions of the scene. 
+
+  The functions call directly into the traversal kernels selected at
+  commit time and skip the dispatch of rtcIntersect and
+  rtcOccluded. This helps tight loops that trace many short rays. The
+  scene has to be committed and created with the RTC_INTERSECT1
+  flag. The returned functions stay valid until the scene gets
+  committed again or deleted. On error all members are set to
+  NULL.
+
+  Embree builds a separate acceleration structure per geometry type,
+  i.e. for triangle meshes, motion blurred triangle meshes, user
+  geometries and instances, points, and quads. If only one of them
+  contains geometry, the functions are the traversal kernels of that
+  acceleration structure. Otherwise they are a dispatcher that
+  traverses the acceleration structures one after the other, thus
+  tracing a ray costs one traversal per geometry type in the
+  scene. */
+RTCORE_API void rtcGetSceneIntersector (RTCScene scene, RTCSceneIntersector& intersector);
+
+/*! \brief Returns the resolved traversal functions for ray packets of
+ *  size 4. The scene has to be created with the RTC_INTERSECT4
+ *  flag. See rtcGetSceneIntersector. */
+RTCORE_API void rtcGetSceneIntersector4 (RTCScene scene, RTCSceneIntersector4& intersector);
+
+/*! \brief Returns the resolved traversal functions for ray packets of
+ *  size 8. The scene has to be created with the RTC_INTERSECT8
+ *  flag. See rtcGetSceneIntersector. */
+RTCORE_API void rtcGetSceneIntersector8 (RTCScene scene, RTCSceneIntersector8& intersector);
+
+/*! \brief Returns the resolved traversal functions for ray packets of
+ *  size 16. The scene has to be created with the RTC_INTERSECT16
+ *  flag. See rtcGetSceneIntersector. */
+RTCORE_API void rtcGetSceneIntersector16 (RTCScene scene, RTCSceneIntersector16& intersector);
+
+/*! Returns the name of the triangle acceleration structure used by
+ *  the scene, e.g. "bvh4.triangle4". For scenes created with the
+ *  RTC_SCENE_AUTOTUNE flag this is the candidate that won the
+ *  measurement performed at commit time, otherwise the configured
+ *  tri_accel ("default" for the built-in selection). The scene has to
+ *  be committed before calling this function. The returned string
+ *  stays valid until the scene is deleted. */
+RTCORE_API const char* rtcGetSceneAccel (RTCScene scene);
+
 /*! Deletes the scene. All contained geometry get also destroyed. */
 RTCORE_API void rtcDeleteScene (RTCScene scene);
 
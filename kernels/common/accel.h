@@ -18,6 +18,8 @@
 #define __EMBREE_ACCEL_H__
 
 #include "common/default.h"
+#include "common/point_query.h"
+#include "embree2/rtcore_ray.h"
 
 namespace embree
 {
@@ -29,6 +31,62 @@ namespace embree
     BBox3f bounds;
   };
 
+  /*! Hides the current hit of a ray while an acceleration structure
+   *  gets traversed. The traversal sees a ray without hit and
+   *  invalid instance IDs, instance hits write instID and instStack,
+   *  all other hits leave them invalid. restore puts back the
+   *  previous hit and its instance IDs if no closer hit was found. */
+  struct SavedHit1
+  {
+    __forceinline SavedHit1 (RTCRay& ray) 
+      : geomID(ray.geomID), instID(ray.instID)
+    {
+      for (size_t i=0; i<RTC_MAX_INSTANCE_DEPTH; i++) instStack[i] = ray.instStack[i];
+      ray.geomID = ray.instID = RTC_INVALID_GEOMETRY_ID;
+      for (size_t i=0; i<RTC_MAX_INSTANCE_DEPTH; i++) ray.instStack[i] = RTC_INVALID_GEOMETRY_ID;
+    }
+
+    __forceinline void restore (RTCRay& ray) const
+    {
+      if (ray.geomID != RTC_INVALID_GEOMETRY_ID) return;
+      ray.geomID = geomID; ray.instID = instID;
+      for (size_t i=0; i<RTC_MAX_INSTANCE_DEPTH; i++) ray.instStack[i] = instStack[i];
+    }
+
+    int geomID, instID, instStack[RTC_MAX_INSTANCE_DEPTH];
+  };
+
+  /*! Hides the current hits of the active rays of a ray packet, see SavedHit1. */
+  template<int N, typename RTCRayN>
+  struct SavedHitN
+  {
+    __forceinline SavedHitN (const void* valid_i, RTCRayN& ray) 
+      : valid((const int*)valid_i)
+    {
+      for (size_t k=0; k<N; k++) 
+      {
+        if (!valid[k]) continue;
+        geomID[k] = ray.geomID[k]; instID[k] = ray.instID[k];
+        for (size_t i=0; i<RTC_MAX_INSTANCE_DEPTH; i++) instStack[i][k] = ray.instStack[i][k];
+        ray.geomID[k] = ray.instID[k] = RTC_INVALID_GEOMETRY_ID;
+        for (size_t i=0; i<RTC_MAX_INSTANCE_DEPTH; i++) ray.instStack[i][k] = RTC_INVALID_GEOMETRY_ID;
+      }
+    }
+
+    __forceinline void restore (RTCRayN& ray) const
+    {
+      for (size_t k=0; k<N; k++) 
+      {
+        if (!valid[k] || ray.geomID[k] != RTC_INVALID_GEOMETRY_ID) continue;
+        ray.geomID[k] = geomID[k]; ray.instID[k] = instID[k];
+        for (size_t i=0; i<RTC_MAX_INSTANCE_DEPTH; i++) ray.instStack[i][k] = instStack[i][k];
+      }
+    }
+
+    const int* valid;
+    int geomID[N], instID[N], instStack[RTC_MAX_INSTANCE_DEPTH][N];
+  };
+
   /*! Base class for all intersectable and buildable acceleration structures. */
   class Accel : public Bounded
   {
@@ -73,6 +131,37 @@ namespace embree
                                     void* ptr,         /*!< pointer to user data */
                                     RTCRay16& ray      /*!< Ray packet to test occlusion. */);
   
+    /*! Type of closest point query function. */
+    typedef void (*PointQueryFunc) (void* ptr,          /*!< pointer to user data */
+                                    PointQuery& query   /*!< closest point query */);
+
+    /*! Type of collision query function between two acceleration structures. */
+    typedef void (*CollideFunc) (void* ptr0,                  /*!< pointer to first acceleration structure */
+                                 void* ptr1,                  /*!< pointer to second acceleration structure */
+                                 const AffineSpace3f* xfm1,   /*!< transformation of the second structure, NULL for identity */
+                                 RTCCollideFunc callback,     /*!< receives the overlapping primitive pairs */
+                                 void* userPtr                /*!< user pointer passed to the callback */);
+
+    /*! Type of multi-hit query function for single rays. */
+    typedef size_t (*MultiHitFunc) (void* ptr,          /*!< pointer to user data */
+                                    const RTCRay& ray,  /*!< ray to find the hits of */
+                                    RTCHit* hits,       /*!< sorted hits, space for k hits */
+                                    size_t k            /*!< maximal number of hits */);
+
+    /*! Type of occlusion query function for single rays that tests a
+     *  hinted occluder first and reports the occluder found. */
+    typedef void (*OccludedHintFunc) (void* ptr,              /*!< pointer to user data */
+                                      RTCRay& ray,            /*!< ray to test occlusion for */
+                                      RTCOccluderHint& hint   /*!< occluder to test first, receives the occluder found */);
+
+    /*! Type of multi-hit query function for ray packets of size 8. */
+    typedef void (*MultiHit8Func) (const void* valid,   /*!< pointer to valid mask */
+                                   void* ptr,           /*!< pointer to user data */
+                                   const RTCRay8& ray,  /*!< ray packet to find the hits of */
+                                   RTCHit* hits,        /*!< sorted hits, space for k hits per ray */
+                                   size_t k,            /*!< maximal number of hits per ray */
+                                   size_t* numHits      /*!< number of hits found per ray */);
+  
     struct Intersector1
     {
       Intersector1 (ErrorFunc error = NULL) 
@@ -154,6 +243,12 @@ namespace embree
     
     /*! build accel */
     virtual void build (size_t threadIndex, size_t threadCount) = 0;
+
+    /*! selects the intersectors for the kernel features used by the scene, see KernelFeatures */
+    virtual void selectFeatures (int features) {}
+
+    /*! returns the kernel features some intersectors of the acceleration structure support */
+    virtual int supportedFeatures () const { return intersectors.features; }
     
     /*! Intersects a single ray with the scene. */
     __forceinline void intersect (RTCRay& ray) {
@@ -207,7 +302,7 @@ namespace embree
     struct Intersectors 
     {
       Intersectors() 
-        : ptr(NULL) {}
+        : ptr(NULL), pointQuery(NULL), collide(NULL), multiHit(NULL), multiHit8(NULL), occludedHint(NULL), features(KERNEL_FEATURES_NONE) {}
 
       void print(size_t ident) 
       {
@@ -235,28 +330,50 @@ namespace embree
       Intersector4 intersector4;
       Intersector8 intersector8;
       Intersector16 intersector16;
+      PointQueryFunc pointQuery;   //!< closest point query, NULL if not supported
+      CollideFunc collide;         //!< collision query, NULL if not supported
+      MultiHitFunc multiHit;       //!< multi-hit query, NULL if not supported
+      MultiHit8Func multiHit8;     //!< multi-hit query for ray packets of size 8, NULL if not supported
+      OccludedHintFunc occludedHint; //!< occlusion query with occluder hint, NULL if not supported
+      int features;                //!< kernel features supported by the intersectors, see KernelFeatures
     } intersectors;
   };
 
-#define DEFINE_INTERSECTOR1(symbol,intersector)                        \
-  Accel::Intersector1 symbol((Accel::IntersectFunc)intersector::intersect, \
-                             (Accel::OccludedFunc )intersector::occluded,  \
+#define DEFINE_INTERSECTOR1(symbol,...)                        \
+  Accel::Intersector1 symbol((Accel::IntersectFunc)__VA_ARGS__::intersect, \
+                             (Accel::OccludedFunc )__VA_ARGS__::occluded,  \
                              TOSTRING(isa) "::" TOSTRING(symbol));
 
-#define DEFINE_INTERSECTOR4(symbol,intersector)                         \
-  Accel::Intersector4 symbol((Accel::IntersectFunc4)intersector::intersect, \
-                             (Accel::OccludedFunc4)intersector::occluded,   \
+#define DEFINE_INTERSECTOR4(symbol,...)                         \
+  Accel::Intersector4 symbol((Accel::IntersectFunc4)__VA_ARGS__::intersect, \
+                             (Accel::OccludedFunc4)__VA_ARGS__::occluded,   \
                              TOSTRING(isa) "::" TOSTRING(symbol));
 
-#define DEFINE_INTERSECTOR8(symbol,intersector)                         \
-  Accel::Intersector8 symbol((Accel::IntersectFunc8)intersector::intersect, \
-                             (Accel::OccludedFunc8)intersector::occluded,   \
+#define DEFINE_INTERSECTOR8(symbol,...)                         \
+  Accel::Intersector8 symbol((Accel::IntersectFunc8)__VA_ARGS__::intersect, \
+                             (Accel::OccludedFunc8)__VA_ARGS__::occluded,   \
                              TOSTRING(isa) "::" TOSTRING(symbol));
 
-#define DEFINE_INTERSECTOR16(symbol,intersector)                         \
-  Accel::Intersector16 symbol((Accel::IntersectFunc16)intersector::intersect, \
-                              (Accel::OccludedFunc16)intersector::occluded,\
+#define DEFINE_INTERSECTOR16(symbol,...)                         \
+  Accel::Intersector16 symbol((Accel::IntersectFunc16)__VA_ARGS__::intersect, \
+                              (Accel::OccludedFunc16)__VA_ARGS__::occluded,\
                               TOSTRING(isa) "::" TOSTRING(symbol));
+
+#define DEFINE_POINT_QUERY(symbol,...)                                  \
+  Accel::PointQueryFunc symbol = (Accel::PointQueryFunc)__VA_ARGS__::query;
+
+#define DEFINE_COLLIDER(symbol,...)                                     \
+  Accel::CollideFunc symbol = (Accel::CollideFunc)__VA_ARGS__::collide;
+
+#define DEFINE_MULTI_HIT(symbol,...)                                    \
+  Accel::MultiHitFunc symbol = (Accel::MultiHitFunc)__VA_ARGS__::intersect;
+
+#define DEFINE_MULTI_HIT8(symbol,...)                                   \
+  Accel::MultiHit8Func symbol = (Accel::MultiHit8Func)__VA_ARGS__::intersect;
+
+#define DEFINE_OCCLUDED_HINT(symbol,...)                                \
+  Accel::OccludedHintFunc symbol = (Accel::OccludedHintFunc)__VA_ARGS__::occluded;
+
 }
 
 #endif
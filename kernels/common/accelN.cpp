@@ -0,0 +1,241 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "accelN.h"
+#include "embree2/rtcore_ray.h"
+
+namespace embree
+{
+  AccelN::AccelN (Accel* accel0, Accel* accel1, Accel* accel2, Accel* accel3, Accel* accel4) 
+  : accel0(accel0), accel1(accel1), accel2(accel2), accel3(accel3), accel4(accel4) {}
+
+  AccelN::~AccelN() {
+    delete accel0;
+    delete accel1;
+    delete accel2;
+    delete accel3;
+    delete accel4;
+  }
+
+  /*! Each acceleration structure sees a ray without hit, thus the
+   *  instance IDs are those of the closest hit afterwards. */
+  static __forceinline void intersect1(Accel* accel, RTCRay& ray)
+  {
+    const SavedHit1 hit(ray);
+    accel->intersect(ray);
+    hit.restore(ray);
+  }
+
+  template<int N, typename RTCRayN>
+  static __forceinline void intersectN(Accel* accel, void (Accel::*intersect)(const void*, RTCRayN&), const void* valid, RTCRayN& ray)
+  {
+    const SavedHitN<N,RTCRayN> hit(valid,ray);
+    (accel->*intersect)(valid,ray);
+    hit.restore(ray);
+  }
+
+  void AccelN::intersect (void* ptr, RTCRay& ray) 
+  {
+    AccelN* This = (AccelN*)ptr;
+    if (This->accel0) intersect1(This->accel0,ray);
+    if (This->accel1) intersect1(This->accel1,ray);
+    if (This->accel2) intersect1(This->accel2,ray);
+    if (This->accel3) intersect1(This->accel3,ray);
+    if (This->accel4) intersect1(This->accel4,ray);
+  }
+
+  void AccelN::intersect4 (const void* valid, void* ptr, RTCRay4& ray) 
+  {
+    AccelN* This = (AccelN*)ptr;
+    if (This->accel0) intersectN<4>(This->accel0,&Accel::intersect4,valid,ray);
+    if (This->accel1) intersectN<4>(This->accel1,&Accel::intersect4,valid,ray);
+    if (This->accel2) intersectN<4>(This->accel2,&Accel::intersect4,valid,ray);
+    if (This->accel3) intersectN<4>(This->accel3,&Accel::intersect4,valid,ray);
+    if (This->accel4) intersectN<4>(This->accel4,&Accel::intersect4,valid,ray);
+  }
+
+  void AccelN::intersect8 (const void* valid, void* ptr, RTCRay8& ray) 
+  {
+    AccelN* This = (AccelN*)ptr;
+    if (This->accel0) intersectN<8>(This->accel0,&Accel::intersect8,valid,ray);
+    if (This->accel1) intersectN<8>(This->accel1,&Accel::intersect8,valid,ray);
+    if (This->accel2) intersectN<8>(This->accel2,&Accel::intersect8,valid,ray);
+    if (This->accel3) intersectN<8>(This->accel3,&Accel::intersect8,valid,ray);
+    if (This->accel4) intersectN<8>(This->accel4,&Accel::intersect8,valid,ray);
+  }
+
+  void AccelN::intersect16 (const void* valid, void* ptr, RTCRay16& ray) 
+  {
+    AccelN* This = (AccelN*)ptr;
+    if (This->accel0) intersectN<16>(This->accel0,&Accel::intersect16,valid,ray);
+    if (This->accel1) intersectN<16>(This->accel1,&Accel::intersect16,valid,ray);
+    if (This->accel2) intersectN<16>(This->accel2,&Accel::intersect16,valid,ray);
+    if (This->accel3) intersectN<16>(This->accel3,&Accel::intersect16,valid,ray);
+    if (This->accel4) intersectN<16>(This->accel4,&Accel::intersect16,valid,ray);
+  }
+
+  void AccelN::occluded (void* ptr, RTCRay& ray) 
+  {
+    AccelN* This = (AccelN*)ptr;
+    if (This->accel0) This->accel0->occluded(ray);
+    if (This->accel1) This->accel1->occluded(ray);
+    if (This->accel2) This->accel2->occluded(ray);
+    if (This->accel3) This->accel3->occluded(ray);
+    if (This->accel4) This->accel4->occluded(ray);
+  }
+
+  void AccelN::occluded4 (const void* valid, void* ptr, RTCRay4& ray) 
+  {
+    AccelN* This = (AccelN*)ptr;
+    if (This->accel0) This->accel0->occluded4(valid,ray);
+    if (This->accel1) This->accel1->occluded4(valid,ray);
+    if (This->accel2) This->accel2->occluded4(valid,ray);
+    if (This->accel3) This->accel3->occluded4(valid,ray);
+    if (This->accel4) This->accel4->occluded4(valid,ray);
+  }
+
+  void AccelN::occluded8 (const void* valid, void* ptr, RTCRay8& ray) 
+  {
+    AccelN* This = (AccelN*)ptr;
+    if (This->accel0) This->accel0->occluded8(valid,ray);
+    if (This->accel1) This->accel1->occluded8(valid,ray);
+    if (This->accel2) This->accel2->occluded8(valid,ray);
+    if (This->accel3) This->accel3->occluded8(valid,ray);
+    if (This->accel4) This->accel4->occluded8(valid,ray);
+  }
+
+  void AccelN::occluded16 (const void* valid, void* ptr, RTCRay16& ray) 
+  {
+    AccelN* This = (AccelN*)ptr;
+    if (This->accel0) This->accel0->occluded16(valid,ray);
+    if (This->accel1) This->accel1->occluded16(valid,ray);
+    if (This->accel2) This->accel2->occluded16(valid,ray);
+    if (This->accel3) This->accel3->occluded16(valid,ray);
+    if (This->accel4) This->accel4->occluded16(valid,ray);
+  }
+
+  void AccelN::print(size_t ident)
+  {
+    if (accel0) {
+      for (size_t i=0; i<ident; i++) std::cout << " "; 
+      std::cout << "accel0" << std::endl;
+      accel0->intersectors.print(ident+2);
+    }
+    if (accel1) {
+      for (size_t i=0; i<ident; i++) std::cout << " "; 
+      std::cout << "accel1" << std::endl;
+      accel1->intersectors.print(ident+2);
+    }
+    if (accel2) {
+      for (size_t i=0; i<ident; i++) std::cout << " "; 
+      std::cout << "accel2" << std::endl;
+      accel2->intersectors.print(ident+2);
+    }
+    if (accel3) {
+      for (size_t i=0; i<ident; i++) std::cout << " "; 
+      std::cout << "accel3" << std::endl;
+      accel3->intersectors.print(ident+2);
+    }
+    if (accel4) {
+      for (size_t i=0; i<ident; i++) std::cout << " "; 
+      std::cout << "accel4" << std::endl;
+      accel4->intersectors.print(ident+2);
+    }
+  }
+
+  void AccelN::immutable()
+  {
+    if (accel0) accel0->immutable();
+    if (accel1) accel1->immutable();
+    if (accel2) accel2->immutable();
+    if (accel3) accel3->immutable();
+    if (accel4) accel4->immutable();
+  }
+
+  void AccelN::selectFeatures (int features)
+  {
+    if (accel0) accel0->selectFeatures(features);
+    if (accel1) accel1->selectFeatures(features);
+    if (accel2) accel2->selectFeatures(features);
+    if (accel3) accel3->selectFeatures(features);
+    if (accel4) accel4->selectFeatures(features);
+  }
+
+  void AccelN::build (size_t threadIndex, size_t threadCount) 
+  {
+    if (accel0) accel0->build(threadIndex,threadCount);
+    if (accel1) accel1->build(threadIndex,threadCount);
+    if (accel2) accel2->build(threadIndex,threadCount);
+    if (accel3) accel3->build(threadIndex,threadCount);
+    if (accel4) accel4->build(threadIndex,threadCount);
+
+    select();
+  }
+
+  bool AccelN::onlyFirstNonEmpty () const
+  {
+    if (accel1 && !accel1->bounds.empty()) return false;
+    if (accel2 && !accel2->bounds.empty()) return false;
+    if (accel3 && !accel3->bounds.empty()) return false;
+    if (accel4 && !accel4->bounds.empty()) return false;
+    return true;
+  }
+
+  void AccelN::select () 
+  {
+    const bool has_accel0 = accel0 && !accel0->bounds.empty();
+    const bool has_accel1 = accel1 && !accel1->bounds.empty();
+    const bool has_accel2 = accel2 && !accel2->bounds.empty();
+    const bool has_accel3 = accel3 && !accel3->bounds.empty();
+    const bool has_accel4 = accel4 && !accel4->bounds.empty();
+    size_t num = has_accel0 + has_accel1 + has_accel2 + has_accel3 + has_accel4;
+        
+    if (num == 1)
+    {
+      if (has_accel0)
+        intersectors = accel0->intersectors;
+      else if (has_accel1)
+        intersectors = accel1->intersectors;
+      else if (has_accel2)
+        intersectors = accel2->intersectors;
+      else if (has_accel3)
+        intersectors = accel3->intersectors;
+      else if (has_accel4)
+        intersectors = accel4->intersectors;
+    }
+    else 
+    {
+      intersectors.ptr = this;
+      intersectors.intersector1 = Intersector1(&intersect,&occluded,"AccelN::intersector1");
+      intersectors.intersector4 = Intersector4(&intersect4,&occluded4,"AccelN::intersector4");
+      intersectors.intersector8 = Intersector8(&intersect8,&occluded8,"AccelN::intersector8");
+      intersectors.intersector16= Intersector16(&intersect16,&occluded16,"AccelN::intersector16");
+      intersectors.pointQuery = NULL;
+      intersectors.collide = NULL;
+      intersectors.multiHit = NULL;
+      intersectors.multiHit8 = NULL;
+      intersectors.occludedHint = NULL;
+    }
+    
+    /*! calculate bounds */
+    bounds = empty;
+    if (accel0) bounds.extend(accel0->bounds);
+    if (accel1) bounds.extend(accel1->bounds);
+    if (accel2) bounds.extend(accel2->bounds);
+    if (accel3) bounds.extend(accel3->bounds);
+    if (accel4) bounds.extend(accel4->bounds);
+  }
+}
@@ -14,18 +14,21 @@
 // limitations under the License.                                           //
 // ======================================================================== //
 
-#ifndef __EMBREE_ACCEL3_H__
-#define __EMBREE_ACCEL3_H__
+#ifndef __EMBREE_ACCELN_H__
+#define __EMBREE_ACCELN_H__
 
 #include "accel.h"
 
 namespace embree
 {
-  class Accel3 : public Accel
+  /*! Combines the acceleration structures of the different geometry
+   *  types of a scene, slots of geometry types the scene does not
+   *  contain stay NULL. */
+  class AccelN : public Accel
   {
   public:
-    Accel3 (Accel* accel0 = NULL, Accel* accel1 = NULL, Accel* accel2 = NULL);
-    ~Accel3();
+    AccelN (Accel* accel0 = NULL, Accel* accel1 = NULL, Accel* accel2 = NULL, Accel* accel3 = NULL, Accel* accel4 = NULL);
+    ~AccelN();
 
   public:
     static void intersect (void* ptr, RTCRay& ray);
@@ -43,11 +46,20 @@ namespace embree
     void print(size_t ident);
     void immutable();
     void build (size_t threadIndex, size_t threadCount);
+    void selectFeatures (int features);
+
+    /*! selects the intersectors and calculates the bounds of the already build acceleration structures */
+    void select ();
+
+    /*! tests if only the first acceleration structure contains geometry */
+    bool onlyFirstNonEmpty () const;
 
   public:
     Accel* accel0;
     Accel* accel1;
     Accel* accel2;
+    Accel* accel3;
+    Accel* accel4;
   };
 }
 
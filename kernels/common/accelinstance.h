@@ -26,9 +26,49 @@ namespace embree
   {
   public:
     AccelInstance (Bounded* accel, Builder* builder, Intersectors& intersectors)
-      : accel(accel), builder(builder) 
+      : accel(accel), builder(builder), numVariants(0)
     {
       this->intersectors = intersectors;
+      this->generalIntersectors = intersectors;
+    }
+
+    /*! Construction with additional sets of intersectors that support
+     *  only some of the optional kernel features. The general set has
+     *  to support all features of the variants, which are preferred
+     *  over the general set in the order given. */
+    AccelInstance (Bounded* accel, Builder* builder, Intersectors& intersectors, const Intersectors& variant0)
+      : accel(accel), builder(builder), numVariants(1)
+    {
+      this->intersectors = intersectors;
+      this->generalIntersectors = intersectors;
+      this->variants[0] = variant0;
+    }
+
+    AccelInstance (Bounded* accel, Builder* builder, Intersectors& intersectors, const Intersectors& variant0, const Intersectors& variant1)
+      : accel(accel), builder(builder), numVariants(2)
+    {
+      this->intersectors = intersectors;
+      this->generalIntersectors = intersectors;
+      this->variants[0] = variant0;
+      this->variants[1] = variant1;
+    }
+
+    int supportedFeatures () const {
+      return generalIntersectors.features;
+    }
+
+    /*! selects the first variant that supports all requested
+     *  features, features no set supports are ignored */
+    void selectFeatures (int features) 
+    {
+      features &= generalIntersectors.features;
+      for (size_t i=0; i<numVariants; i++) {
+        if ((features & ~variants[i].features) == 0) {
+          intersectors = variants[i];
+          return;
+        }
+      }
+      intersectors = generalIntersectors;
     }
 
     void immutable () {
@@ -49,6 +89,9 @@ namespace embree
   private:
     Bounded* accel;
     Builder* builder;
+    Intersectors generalIntersectors;
+    Intersectors variants[2];
+    size_t numVariants;
   };
 }
 
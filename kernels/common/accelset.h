@@ -38,13 +38,26 @@ namespace embree
     typedef RTCOccludedFunc8 OccludedFunc8;
     typedef RTCOccludedFunc16 OccludedFunc16;
 
+    typedef RTCIntersectRangeFunc IntersectRangeFunc;
+    typedef RTCIntersectRangeFunc4 IntersectRangeFunc4;
+    typedef RTCIntersectRangeFunc8 IntersectRangeFunc8;
+    typedef RTCIntersectRangeFunc16 IntersectRangeFunc16;
+    
+    typedef RTCOccludedRangeFunc OccludedRangeFunc;
+    typedef RTCOccludedRangeFunc4 OccludedRangeFunc4;
+    typedef RTCOccludedRangeFunc8 OccludedRangeFunc8;
+    typedef RTCOccludedRangeFunc16 OccludedRangeFunc16;
+
+    /*! maximal number of consecutive items grouped into one block */
+    static const size_t maxBlockSize = 8;
+
     struct Intersector1
     {
       Intersector1 (ErrorFunc error = NULL) 
-      : intersect((IntersectFunc)error), occluded((OccludedFunc)error), name(NULL) {}
+      : intersect((IntersectFunc)error), occluded((OccludedFunc)error), intersectRange(NULL), occludedRange(NULL), name(NULL) {}
 
       Intersector1 (IntersectFunc intersect, OccludedFunc occluded, const char* name)
-      : intersect(intersect), occluded(occluded), name(name) {}
+      : intersect(intersect), occluded(occluded), intersectRange(NULL), occludedRange(NULL), name(name) {}
       
         operator bool() const { return name; }
         
@@ -53,15 +66,17 @@ namespace embree
         const char* name;
         IntersectFunc intersect;
         OccludedFunc occluded;  
+        IntersectRangeFunc intersectRange;
+        OccludedRangeFunc occludedRange;
       };
       
       struct Intersector4 
       {
         Intersector4 (ErrorFunc error = NULL) 
-        : intersect((IntersectFunc4)error), occluded((OccludedFunc4)error), name(NULL) {}
+        : intersect((IntersectFunc4)error), occluded((OccludedFunc4)error), intersectRange(NULL), occludedRange(NULL), name(NULL) {}
 
         Intersector4 (IntersectFunc4 intersect, OccludedFunc4 occluded, const char* name)
-        : intersect(intersect), occluded(occluded), name(name) {}
+        : intersect(intersect), occluded(occluded), intersectRange(NULL), occludedRange(NULL), name(name) {}
         
         operator bool() const { return name; }
         
@@ -70,15 +85,17 @@ namespace embree
         const char* name;
         IntersectFunc4 intersect;
         OccludedFunc4 occluded;
+        IntersectRangeFunc4 intersectRange;
+        OccludedRangeFunc4 occludedRange;
       };
       
       struct Intersector8 
       {
         Intersector8 (ErrorFunc error = NULL) 
-        : intersect((IntersectFunc8)error), occluded((OccludedFunc8)error), name(NULL) {}
+        : intersect((IntersectFunc8)error), occluded((OccludedFunc8)error), intersectRange(NULL), occludedRange(NULL), name(NULL) {}
 
         Intersector8 (IntersectFunc8 intersect, OccludedFunc8 occluded, const char* name)
-        : intersect(intersect), occluded(occluded), name(name) {}
+        : intersect(intersect), occluded(occluded), intersectRange(NULL), occludedRange(NULL), name(name) {}
         
         operator bool() const { return name; }
         
@@ -87,15 +104,17 @@ namespace embree
         const char* name;
         IntersectFunc8 intersect;
         OccludedFunc8 occluded;
+        IntersectRangeFunc8 intersectRange;
+        OccludedRangeFunc8 occludedRange;
       };
       
       struct Intersector16 
       {
         Intersector16 (ErrorFunc error = NULL) 
-        : intersect((IntersectFunc16)error), occluded((OccludedFunc16)error), name(NULL) {}
+        : intersect((IntersectFunc16)error), occluded((OccludedFunc16)error), intersectRange(NULL), occludedRange(NULL), name(NULL) {}
 
         Intersector16 (IntersectFunc16 intersect, OccludedFunc16 occluded, const char* name)
-        : intersect(intersect), occluded(occluded), name(name) {}
+        : intersect(intersect), occluded(occluded), intersectRange(NULL), occludedRange(NULL), name(name) {}
         
         operator bool() const { return name; }
         
@@ -104,12 +123,14 @@ namespace embree
         const char* name;
         IntersectFunc16 intersect;
         OccludedFunc16 occluded;
+        IntersectRangeFunc16 intersectRange;
+        OccludedRangeFunc16 occludedRange;
       };
       
     public:
       
       /*! Construction */
-      AccelSet (size_t numItems) : numItems(numItems) {
+      AccelSet (size_t numItems) : numItems(numItems), boundsRangeFunc(NULL), blockSize(1) {
         intersectors.ptr = NULL; 
         intersectors.boundsPtr = NULL;
       }
@@ -128,6 +149,11 @@ namespace embree
         return numItems;
       }
 
+      /*! return number of blocks of consecutive items in set */
+      __forceinline size_t blocks() const {
+        return (numItems+blockSize-1)/blockSize;
+      }
+
       /*! Calculates the bounds of an item */
       __forceinline BBox3f bounds (size_t item) 
       {
@@ -184,9 +210,108 @@ namespace embree
         intersectors.intersector16.occluded(valid,intersectors.ptr,ray,item);
       }
       
+      /*! Calculates the bounds of a block of consecutive items */
+      __forceinline BBox3f blockBounds (size_t block) 
+      {
+        const size_t begin = block*blockSize;
+        const size_t end = min(begin+blockSize,numItems);
+        BBox3f box = empty;
+        if (boundsRangeFunc) {
+          RTCBounds boxes[maxBlockSize];
+          boundsRangeFunc(intersectors.boundsPtr,begin,end,boxes);
+          for (size_t i=0; i<end-begin; i++) box.extend((BBox3f&)boxes[i]);
+        }
+        else {
+          for (size_t i=begin; i<end; i++) box.extend(bounds(i));
+        }
+        return box;
+      }
+
+      /*! Intersects a single ray with the block of items starting at item. */
+      __forceinline void intersectBlock (RTCRay& ray, size_t item) 
+      {
+        const size_t end = min(item+blockSize,numItems);
+        if (intersectors.intersector1.intersectRange)
+          intersectors.intersector1.intersectRange(intersectors.ptr,ray,item,end);
+        else for (size_t i=item; i<end; i++) 
+          intersect(ray,i);
+      }
+
+      /*! Intersects a packet of 4 rays with the block of items starting at item. */
+      __forceinline void intersect4Block (const void* valid, RTCRay4& ray, size_t item) 
+      {
+        const size_t end = min(item+blockSize,numItems);
+        if (intersectors.intersector4.intersectRange)
+          intersectors.intersector4.intersectRange(valid,intersectors.ptr,ray,item,end);
+        else for (size_t i=item; i<end; i++) 
+          intersect4(valid,ray,i);
+      }
+
+      /*! Intersects a packet of 8 rays with the block of items starting at item. */
+      __forceinline void intersect8Block (const void* valid, RTCRay8& ray, size_t item) 
+      {
+        const size_t end = min(item+blockSize,numItems);
+        if (intersectors.intersector8.intersectRange)
+          intersectors.intersector8.intersectRange(valid,intersectors.ptr,ray,item,end);
+        else for (size_t i=item; i<end; i++) 
+          intersect8(valid,ray,i);
+      }
+
+      /*! Intersects a packet of 16 rays with the block of items starting at item. */
+      __forceinline void intersect16Block (const void* valid, RTCRay16& ray, size_t item) 
+      {
+        const size_t end = min(item+blockSize,numItems);
+        if (intersectors.intersector16.intersectRange)
+          intersectors.intersector16.intersectRange(valid,intersectors.ptr,ray,item,end);
+        else for (size_t i=item; i<end; i++) 
+          intersect16(valid,ray,i);
+      }
+
+      /*! Tests if single ray is occluded by the block of items starting at item. */
+      __forceinline void occludedBlock (RTCRay& ray, size_t item) 
+      {
+        const size_t end = min(item+blockSize,numItems);
+        if (intersectors.intersector1.occludedRange)
+          intersectors.intersector1.occludedRange(intersectors.ptr,ray,item,end);
+        else for (size_t i=item; i<end; i++) 
+          occluded(ray,i);
+      }
+
+      /*! Tests if a packet of 4 rays is occluded by the block of items starting at item. */
+      __forceinline void occluded4Block (const void* valid, RTCRay4& ray, size_t item) 
+      {
+        const size_t end = min(item+blockSize,numItems);
+        if (intersectors.intersector4.occludedRange)
+          intersectors.intersector4.occludedRange(valid,intersectors.ptr,ray,item,end);
+        else for (size_t i=item; i<end; i++) 
+          occluded4(valid,ray,i);
+      }
+
+      /*! Tests if a packet of 8 rays is occluded by the block of items starting at item. */
+      __forceinline void occluded8Block (const void* valid, RTCRay8& ray, size_t item) 
+      {
+        const size_t end = min(item+blockSize,numItems);
+        if (intersectors.intersector8.occludedRange)
+          intersectors.intersector8.occludedRange(valid,intersectors.ptr,ray,item,end);
+        else for (size_t i=item; i<end; i++) 
+          occluded8(valid,ray,i);
+      }
+
+      /*! Tests if a packet of 16 rays is occluded by the block of items starting at item. */
+      __forceinline void occluded16Block (const void* valid, RTCRay16& ray, size_t item) 
+      {
+        const size_t end = min(item+blockSize,numItems);
+        if (intersectors.intersector16.occludedRange)
+          intersectors.intersector16.occludedRange(valid,intersectors.ptr,ray,item,end);
+        else for (size_t i=item; i<end; i++) 
+          occluded16(valid,ray,i);
+      }
+      
     public:
       size_t numItems;
       RTCBoundsFunc boundsFunc;
+      RTCBoundsRangeFunc boundsRangeFunc;
+      size_t blockSize;       //!< number of consecutive items per block, larger than one when range functions are set
 
       struct Intersectors 
       {
@@ -42,7 +42,7 @@
 #include <vector>
 #include <algorithm>
 
-#define __EMBREE_VERSION__ "2.1"
+#define __EMBREE_VERSION__ "2.2"
 
 #define ERROR(x) \
   throw std::runtime_error(x)
@@ -62,6 +62,8 @@ namespace embree
   extern std::string g_tri_accel;
   extern std::string g_builder;
   extern std::string g_traverser;
+  extern size_t g_top_rebuild;
+  extern size_t g_top_rebuild_sah;
   extern int g_scene_flags;
   extern size_t g_benchmark;
 
@@ -77,6 +79,29 @@ namespace embree
   __forceinline bool isCoherent  (RTCSceneFlags flags) { return flags & RTC_SCENE_COHERENT; }
   __forceinline bool isIncoherent(RTCSceneFlags flags) { return flags & RTC_SCENE_INCOHERENT; }
   __forceinline bool isHighQuality(RTCSceneFlags flags) { return flags & RTC_SCENE_HIGH_QUALITY; }
+  __forceinline bool isAutotune  (RTCSceneFlags flags) { return flags & RTC_SCENE_AUTOTUNE; }
+  __forceinline bool isDeferred  (RTCSceneFlags flags) { return flags & RTC_SCENE_DEFERRED; }
+
+  /*! Optional features of the primitive intersectors. Support for
+   *  masks and filters gets compiled in with __USE_RAY_MASK__ and
+   *  __INTERSECTION_FILTER__, which also decide whether leaves store
+   *  masks and whether setting filter functions is supported at
+   *  all. The Moeller, watertight, and motion blur intersectors are
+   *  templated over these two features, and the acceleration
+   *  structures using them additionally get intersectors without
+   *  them, which the scene selects at commit time if none of its
+   *  geometries uses a mask or filter. Robust scenes select the
+   *  watertight intersectors of the BVH4 over Triangle4v and
+   *  Triangle4i leaves. Motion blur has no feature bit, as motion
+   *  blurred meshes always get their own acceleration structure. */
+  enum KernelFeatures
+  {
+    KERNEL_FEATURES_NONE    = 0,
+    KERNEL_FEATURE_RAY_MASK = 1,  //!< geometry masks are tested against the ray mask
+    KERNEL_FEATURE_FILTER   = 2,  //!< intersection and occlusion filters are invoked
+    KERNEL_FEATURES_ALL     = KERNEL_FEATURE_RAY_MASK | KERNEL_FEATURE_FILTER,
+    KERNEL_FEATURE_ROBUST   = 4   //!< watertight intersection tests and robust traversal
+  };
 
   /*! CPU features */
   static const int SSE   = CPU_FEATURE_SSE; 
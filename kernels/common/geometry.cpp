@@ -20,7 +20,9 @@
 namespace embree
 {
   Geometry::Geometry (Scene* parent, GeometryTy type, size_t numPrimitives, RTCGeometryFlags flags) 
-    : parent(parent), type(type), numPrimitives(numPrimitives), id(0), flags(flags), state(ENABLING) 
+    : parent(parent), type(type), numPrimitives(numPrimitives), id(0), flags(flags), state(ENABLING), userPtr(NULL),
+      intersectionFilter1(NULL), intersectionFilter4(NULL), intersectionFilter8(NULL),
+      occlusionFilter1(NULL), occlusionFilter4(NULL), occlusionFilter8(NULL)
   {
     id = parent->add(this);
   }
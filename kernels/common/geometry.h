@@ -25,7 +25,7 @@ namespace embree
   class Scene;
 
   /*! type of geometry */
-  enum GeometryTy { TRIANGLE_MESH, USER_GEOMETRY, QUADRATIC_BEZIER_CURVES, INSTANCES };
+  enum GeometryTy { TRIANGLE_MESH, USER_GEOMETRY, QUADRATIC_BEZIER_CURVES, INSTANCES, POINTS, QUAD_MESH };
   
   /*! Base class all geometries are derived from */
   class Geometry
@@ -61,6 +61,14 @@ namespace embree
     /* test if this is a dynamic geometry */
     __forceinline bool isDynamic() const { return flags == RTC_GEOMETRY_DYNAMIC; }
 
+    /* test if filter functions are set */
+    __forceinline bool hasIntersectionFilter1() const { return intersectionFilter1 != NULL; }
+    __forceinline bool hasIntersectionFilter4() const { return intersectionFilter4 != NULL; }
+    __forceinline bool hasIntersectionFilter8() const { return intersectionFilter8 != NULL; }
+    __forceinline bool hasOcclusionFilter1() const { return occlusionFilter1 != NULL; }
+    __forceinline bool hasOcclusionFilter4() const { return occlusionFilter4 != NULL; }
+    __forceinline bool hasOcclusionFilter8() const { return occlusionFilter8 != NULL; }
+
     /*! for all geometries */
   public:
 
@@ -96,6 +104,41 @@ namespace embree
       recordError(RTC_INVALID_OPERATION); 
     }
 
+    /*! Returns the ray mask, geometries without mask can get hit by all rays. */
+    virtual unsigned getMask () const { 
+      return -1; 
+    }
+
+    /*! Sets intersection filter function for single rays. */
+    virtual void setIntersectionFilterFunction (RTCFilterFunc filter) { 
+      recordError(RTC_INVALID_OPERATION); 
+    }
+
+    /*! Sets intersection filter function for ray packets of size 4. */
+    virtual void setIntersectionFilterFunction4 (RTCFilterFunc4 filter4) { 
+      recordError(RTC_INVALID_OPERATION); 
+    }
+
+    /*! Sets intersection filter function for ray packets of size 8. */
+    virtual void setIntersectionFilterFunction8 (RTCFilterFunc8 filter8) { 
+      recordError(RTC_INVALID_OPERATION); 
+    }
+
+    /*! Sets occlusion filter function for single rays. */
+    virtual void setOcclusionFilterFunction (RTCFilterFunc filter) { 
+      recordError(RTC_INVALID_OPERATION); 
+    }
+
+    /*! Sets occlusion filter function for ray packets of size 4. */
+    virtual void setOcclusionFilterFunction4 (RTCFilterFunc4 filter4) { 
+      recordError(RTC_INVALID_OPERATION); 
+    }
+
+    /*! Sets occlusion filter function for ray packets of size 8. */
+    virtual void setOcclusionFilterFunction8 (RTCFilterFunc8 filter8) { 
+      recordError(RTC_INVALID_OPERATION); 
+    }
+
     /*! Maps specified buffer. */
     virtual void* map(RTCBufferType type) { 
       recordError(RTC_INVALID_OPERATION); 
@@ -110,8 +153,8 @@ namespace embree
     /*! instances only */
   public:
     
-    /*! Sets transformation of the instance */
-    virtual void setTransform(AffineSpace3f& transform) {
+    /*! Sets transformation of the instance at some time step */
+    virtual void setTransform(AffineSpace3f& transform, size_t timeStep) {
       recordError(RTC_INVALID_OPERATION); 
     };
 
@@ -168,6 +211,51 @@ namespace embree
       recordError(RTC_INVALID_OPERATION); 
     }
 
+    /*! Set bounds function for a range of items. */
+    virtual void setBoundsRangeFunction (RTCBoundsRangeFunc bounds) { 
+      recordError(RTC_INVALID_OPERATION); 
+    }
+
+    /*! Set intersect function for a range of items and single rays. */
+    virtual void setIntersectRangeFunction (RTCIntersectRangeFunc intersect) { 
+      recordError(RTC_INVALID_OPERATION); 
+    }
+
+    /*! Set intersect function for a range of items and ray packets of size 4. */
+    virtual void setIntersectRangeFunction4 (RTCIntersectRangeFunc4 intersect4) { 
+      recordError(RTC_INVALID_OPERATION); 
+    }
+
+    /*! Set intersect function for a range of items and ray packets of size 8. */
+    virtual void setIntersectRangeFunction8 (RTCIntersectRangeFunc8 intersect8) { 
+      recordError(RTC_INVALID_OPERATION); 
+    }
+
+    /*! Set intersect function for a range of items and ray packets of size 16. */
+    virtual void setIntersectRangeFunction16 (RTCIntersectRangeFunc16 intersect16) { 
+      recordError(RTC_INVALID_OPERATION); 
+    }
+
+    /*! Set occlusion function for a range of items and single rays. */
+    virtual void setOccludedRangeFunction (RTCOccludedRangeFunc occluded) { 
+      recordError(RTC_INVALID_OPERATION); 
+    }
+
+    /*! Set occlusion function for a range of items and ray packets of size 4. */
+    virtual void setOccludedRangeFunction4 (RTCOccludedRangeFunc4 occluded4) { 
+      recordError(RTC_INVALID_OPERATION); 
+    }
+
+    /*! Set occlusion function for a range of items and ray packets of size 8. */
+    virtual void setOccludedRangeFunction8 (RTCOccludedRangeFunc8 occluded8) { 
+      recordError(RTC_INVALID_OPERATION); 
+    }
+
+    /*! Set occlusion function for a range of items and ray packets of size 16. */
+    virtual void setOccludedRangeFunction16 (RTCOccludedRangeFunc16 occluded16) { 
+      recordError(RTC_INVALID_OPERATION); 
+    }
+
   public:
     Scene* parent;   //!< pointer to scene this mesh belongs to
     GeometryTy type;
@@ -175,6 +263,15 @@ namespace embree
     unsigned id;       //!< internal geometry ID
     RTCGeometryFlags flags;    //!< flags of geometry
     State state;       //!< state of the geometry 
+
+  public:
+    void* userPtr;     //!< user pointer passed to filter functions
+    RTCFilterFunc intersectionFilter1;
+    RTCFilterFunc4 intersectionFilter4;
+    RTCFilterFunc8 intersectionFilter8;
+    RTCFilterFunc occlusionFilter1;
+    RTCFilterFunc4 occlusionFilter4;
+    RTCFilterFunc8 occlusionFilter8;
   };
 
 }
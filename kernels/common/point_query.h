@@ -0,0 +1,101 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#ifndef __EMBREE_POINT_QUERY_H__
+#define __EMBREE_POINT_QUERY_H__
+
+#include "default.h"
+
+namespace embree
+{
+  /*! Closest point query. The query searches the triangle closest to
+   *  p within the search radius, each found triangle shrinks the
+   *  radius to its distance. */
+  struct PointQuery
+  {
+    __forceinline PointQuery (const Vec3fa& p, float radius, int mask)
+      : p(p), radius(radius), mask(mask), closest(zero), u(0.0f), v(0.0f), geomID(-1), primID(-1) {}
+
+  public:
+    Vec3fa p;          //!< query position
+    float radius;      //!< search radius, set to the distance of the closest triangle found
+    int mask;          //!< only triangles of meshes with a matching mask are considered
+
+  public:
+    Vec3fa closest;    //!< closest point on the surface
+    float u;           //!< barycentric u coordinate of closest point
+    float v;           //!< barycentric v coordinate of closest point
+    int geomID;        //!< geometry ID of closest triangle
+    int primID;        //!< primitive ID of closest triangle
+  };
+
+  /*! Calculates the point of the triangle (v0,v1,v2) closest to p and
+   *  returns its barycentric coordinates such that the point is
+   *  (1-u-v)*v0 + u*v1 + v*v2. Follows the Voronoi region tests of
+   *  "Real-Time Collision Detection" by Ericson. */
+  __forceinline Vec3fa closestPointTriangle(const Vec3fa& p, const Vec3fa& v0, const Vec3fa& v1, const Vec3fa& v2, float& u, float& v)
+  {
+    const Vec3fa e1 = v1-v0, e2 = v2-v0, ap = p-v0;
+    const float d1 = dot(e1,ap), d2 = dot(e2,ap);
+    if (d1 <= 0.0f && d2 <= 0.0f) { u = 0.0f; v = 0.0f; return v0; }
+
+    const Vec3fa bp = p-v1;
+    const float d3 = dot(e1,bp), d4 = dot(e2,bp);
+    if (d3 >= 0.0f && d4 <= d3) { u = 1.0f; v = 0.0f; return v1; }
+
+    const Vec3fa cp = p-v2;
+    const float d5 = dot(e1,cp), d6 = dot(e2,cp);
+    if (d6 >= 0.0f && d5 <= d6) { u = 0.0f; v = 1.0f; return v2; }
+
+    const float vc = d1*d4 - d3*d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+      u = d1/(d1-d3); v = 0.0f;
+      return v0 + u*e1;
+    }
+
+    const float vb = d5*d2 - d1*d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+      u = 0.0f; v = d2/(d2-d6);
+      return v0 + v*e2;
+    }
+
+    const float va = d3*d6 - d5*d4;
+    if (va <= 0.0f && (d4-d3) >= 0.0f && (d5-d6) >= 0.0f) {
+      v = (d4-d3)/((d4-d3)+(d5-d6)); u = 1.0f-v;
+      return v1 + v*(v2-v1);
+    }
+
+    const float denom = 1.0f/(va+vb+vc);
+    u = vb*denom; v = vc*denom;
+    return v0 + u*e1 + v*e2;
+  }
+
+  /*! Updates the query with the triangle (v0,v1,v2) if it is closer than the current search radius. */
+  __forceinline void pointQueryTriangle(PointQuery& query, const Vec3fa& v0, const Vec3fa& v1, const Vec3fa& v2, int geomID, int primID)
+  {
+    float u,v;
+    const Vec3fa c = closestPointTriangle(query.p,v0,v1,v2,u,v);
+    const float d = length(c-query.p);
+    if (d > query.radius) return;
+    query.radius = d;
+    query.closest = c;
+    query.u = u; query.v = v;
+    query.geomID = geomID;
+    query.primID = primID;
+  }
+}
+
+#endif
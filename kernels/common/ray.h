@@ -31,7 +31,10 @@ namespace embree
     /*! Constructs a ray from origin, direction, and ray segment. Near
      *  has to be smaller than far. */
     __forceinline Ray(const Vec3fa& org, const Vec3fa& dir, float tnear = zero, float tfar = inf, float time = zero, int mask = -1)
-      : org(org), dir(dir), tnear(tnear), tfar(tfar), geomID(-1), primID(-1), instID(-1), mask(mask), time(time) {}
+      : org(org), dir(dir), tnear(tnear), tfar(tfar), geomID(-1), primID(-1), instID(-1), mask(mask), time(time)
+    {
+      for (size_t i=0; i<RTC_MAX_INSTANCE_DEPTH; i++) instStack[i] = -1;
+    }
 
     /*! Tests if we hit something. */
     __forceinline operator bool() const { return geomID != -1; }
@@ -50,7 +53,8 @@ namespace embree
     float v;           //!< Barycentric v coordinate of hit
     int geomID;        //!< geometry ID
     int primID;        //!< primitive ID
-    int instID;        //!< instance ID
+    int instID;        //!< instance ID of the outermost instance
+    int instStack[RTC_MAX_INSTANCE_DEPTH]; //!< instance IDs of all nested instances, outermost first
   };
 
   /*! Outputs ray to stream. */
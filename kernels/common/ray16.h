@@ -31,7 +31,10 @@ namespace embree
     /*! Constructs a ray from origin, direction, and ray segment. Near
      *  has to be smaller than far. */
     __forceinline Ray16(const mic3f& org, const mic3f& dir, const mic_f& tnear = zero, const mic_f& tfar = inf, const mic_f& time = zero, const mic_i& mask = -1)
-      : org(org), dir(dir), tnear(tnear), tfar(tfar), geomID(-1), primID(-1), mask(mask), time(time) {}
+      : org(org), dir(dir), tnear(tnear), tfar(tfar), geomID(-1), primID(-1), instID(-1), mask(mask), time(time)
+    {
+      for (size_t i=0; i<RTC_MAX_INSTANCE_DEPTH; i++) instStack[i] = -1;
+    }
 
     /*! Tests if we hit something. */
     __forceinline operator mic_m() const { return geomID != mic_i(-1); }
@@ -50,7 +53,8 @@ namespace embree
     mic_f v;        //!< Barycentric v coordinate of hit
     mic_i geomID;   //!< geometry ID
     mic_i primID;   //!< primitive ID
-    mic_i instID;   //!< instance ID
+    mic_i instID;   //!< instance ID of the outermost instance
+    mic_i instStack[RTC_MAX_INSTANCE_DEPTH]; //!< instance IDs of all nested instances, outermost first
   };
 
   /*! Outputs ray to stream. */
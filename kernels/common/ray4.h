@@ -30,7 +30,10 @@ namespace embree
     /*! Constructs a ray from origin, direction, and ray segment. Near
      *  has to be smaller than far. */
     __forceinline Ray4(const sse3f& org, const sse3f& dir, const ssef& tnear = zero, const ssef& tfar = inf, const ssef& time = zero, const ssei& mask = -1)
-      : org(org), dir(dir), tnear(tnear), tfar(tfar), geomID(-1), primID(-1), instID(-1), mask(mask), time(time) {}
+      : org(org), dir(dir), tnear(tnear), tfar(tfar), geomID(-1), primID(-1), instID(-1), mask(mask), time(time)
+    {
+      for (size_t i=0; i<RTC_MAX_INSTANCE_DEPTH; i++) instStack[i] = -1;
+    }
 
     /*! Tests if we hit something. */
     __forceinline operator sseb() const { return geomID != ssei(-1); }
@@ -49,7 +52,8 @@ namespace embree
     ssef v;         //!< Barycentric v coordinate of hit
     ssei geomID;    //!< geometry ID
     ssei primID;    //!< primitive ID
-    ssei instID;    //!< instance ID
+    ssei instID;    //!< instance ID of the outermost instance
+    ssei instStack[RTC_MAX_INSTANCE_DEPTH]; //!< instance IDs of all nested instances, outermost first
   };
 
   /*! Outputs ray to stream. */
@@ -31,7 +31,10 @@ namespace embree
     /*! Constructs a ray from origin, direction, and ray segment. Near
      *  has to be smaller than far. */
     __forceinline Ray8(const avx3f& org, const avx3f& dir, const avxf& tnear = zero, const avxf& tfar = inf, const avxf& time = zero, const avxi& mask = -1)
-      : org(org), dir(dir), tnear(tnear), tfar(tfar), geomID(-1), primID(-1), instID(-1), mask(mask), time(time)  {}
+      : org(org), dir(dir), tnear(tnear), tfar(tfar), geomID(-1), primID(-1), instID(-1), mask(mask), time(time)
+    {
+      for (size_t i=0; i<RTC_MAX_INSTANCE_DEPTH; i++) instStack[i] = -1;
+    }
 
     /*! Tests if we hit something. */
     __forceinline operator avxb() const { return geomID != avxi(-1); }
@@ -50,7 +53,8 @@ namespace embree
     avxf v;         //!< Barycentric v coordinate of hit
     avxi geomID;    //!< geometry ID
     avxi primID;    //!< primitive ID
-    avxi instID;    //!< instance ID
+    avxi instID;    //!< instance ID of the outermost instance
+    avxi instStack[RTC_MAX_INSTANCE_DEPTH]; //!< instance IDs of all nested instances, outermost first
   };
 
   /*! Outputs ray to stream. */
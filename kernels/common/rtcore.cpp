@@ -26,6 +26,7 @@
 #include "common/scene.h"
 #include "sys/taskscheduler.h"
 #include "sys/thread.h"
+#include "sys/tasklogger.h"
 
 #define TRACE(x) //std::cout << #x << std::endl;
 
@@ -75,10 +76,13 @@ namespace embree
   std::string g_tri_accel = "default";    //!< triangle acceleration structure to use
   std::string g_builder = "default";      //!< builder to use
   std::string g_traverser = "default";    //!< traverser to use
+  size_t g_top_rebuild = 64;              //!< rebuild refitted toplevel BVHs every that many commits, 0 for never
+  size_t g_top_rebuild_sah = 50;          //!< rebuild refitted toplevel BVHs once their SAH cost grew by that many percent, 0 for never
   int g_scene_flags = -1;       //!< scene flags to use
   size_t g_verbose = 0;                   //!< verbosity of output
   size_t g_numThreads = 0;                //!< number of threads to use in builders
   size_t g_benchmark = 0;
+  std::string g_tasklog = "";             //!< file to store task log into
 
   /* error flag */
   static tls_t g_error = NULL;
@@ -110,6 +114,14 @@ namespace embree
     return std::string(str+begin,str+pos);
   }
 
+  std::string parseFilename(const char* str, size_t& pos) 
+  {
+    skipSpace(str,pos);
+    size_t begin = pos;
+    while (str[pos] && str[pos] != ',' && str[pos] != ' ') pos++;
+    return std::string(str+begin,str+pos);
+  }
+
   bool parseSymbol(const char* str, char c, size_t& pos) 
   {
     skipSpace(str,pos);
@@ -156,10 +168,13 @@ namespace embree
     g_tri_accel = "default";
     g_builder = "default";
     g_traverser = "default";
+    g_top_rebuild = 64;
+    g_top_rebuild_sah = 50;
     g_scene_flags = -1;
     g_verbose = 0;
     g_numThreads = 0;
     g_benchmark = 0;
+    g_tasklog = "";
 
     if (cfg != NULL) 
     {
@@ -209,6 +224,14 @@ namespace embree
           if (parseSymbol (cfg,'=',pos))
             g_traverser = parseIdentifier (cfg,pos);
         }
+        else if (tok == "toprebuild") {
+          if (parseSymbol (cfg,'=',pos))
+            g_top_rebuild = parseInt (cfg,pos);
+        }
+        else if (tok == "toprebuildsah") {
+          if (parseSymbol (cfg,'=',pos))
+            g_top_rebuild_sah = parseInt (cfg,pos);
+        }
         else if (tok == "verbose") {
           if (parseSymbol (cfg,'=',pos))
             g_verbose = parseInt (cfg,pos);
@@ -217,6 +240,10 @@ namespace embree
           if (parseSymbol (cfg,'=',pos))
             g_benchmark = parseInt (cfg,pos);
         }
+        else if (tok == "tasklog") {
+          if (parseSymbol (cfg,'=',pos))
+            g_tasklog = parseFilename (cfg,pos);
+        }
         else if (tok == "flags") {
           g_scene_flags = 0;
           if (parseSymbol (cfg,'=',pos)) {
@@ -228,6 +255,8 @@ namespace embree
               else if (flag == "coherent") g_scene_flags |= RTC_SCENE_COHERENT;
               else if (flag == "incoherent") g_scene_flags |= RTC_SCENE_INCOHERENT;
               else if (flag == "high_quality") g_scene_flags |= RTC_SCENE_HIGH_QUALITY;
+              else if (flag == "autotune") g_scene_flags |= RTC_SCENE_AUTOTUNE;
+              else if (flag == "deferred") g_scene_flags |= RTC_SCENE_DEFERRED;
               else if (flag == "robust") g_scene_flags |= RTC_SCENE_ROBUST;
             } while (parseSymbol (cfg,',',pos));
           }
@@ -268,10 +297,21 @@ namespace embree
       PRINT(g_tri_accel);
       PRINT(g_builder);
       PRINT(g_traverser);
+      PRINT(g_top_rebuild);
+      PRINT(g_top_rebuild_sah);
+      PRINT(g_tasklog);
     }
 
     TaskScheduler::create(g_numThreads);
 
+    /* start logging of tasks */
+    if (g_tasklog != "") {
+#if !defined(__LOG_TASKS__)
+      std::cerr << "Embree: task logging requires RTCORE_ENABLE_TASKLOGGER" << std::endl;
+#endif
+      TaskLogger::start();
+    }
+
     CATCH_END;
   }
   
@@ -283,9 +323,21 @@ namespace embree
     if (!g_initialized) {
       return;
     }
+
+    /* store task log as FIG diagram or trace event JSON file */
+    if (g_tasklog != "") {
+      TaskLogger::stop();
+      size_t ext = g_tasklog.find_last_of('.');
+      if (ext != std::string::npos && g_tasklog.substr(ext) == ".fig") 
+        TaskLogger::store(g_tasklog.c_str());
+      else 
+        TaskLogger::storeJSON(g_tasklog.c_str());
+    }
+
     TaskScheduler::destroy();
     for (size_t i=0; i<g_errors.size(); i++)
       delete g_errors[i];
+    g_errors.clear();
     destroyTls(g_error);
     Alloc::global.clear();
     g_initialized = false;
@@ -369,7 +421,9 @@ namespace embree
   {
     TRACE(rtcIntersect);
     STAT3(normal.travs,1,1,1);
+    const SavedHit1 hit(ray);
     ((Scene*)scene)->intersect(ray);
+    hit.restore(ray);
   }
   
   RTCORE_API void rtcIntersect4 (const void* valid, RTCScene scene, RTCRay4& ray) 
@@ -381,7 +435,9 @@ namespace embree
     TRACE(rtcIntersect4);
     STAT(size_t cnt=0; for (size_t i=0; i<4; i++) cnt += ((int*)valid)[i] == -1;);
     STAT3(normal.travs,1,cnt,4);
+    const SavedHitN<4,RTCRay4> hit(valid,ray);
     ((Scene*)scene)->intersect4(valid,ray);
+    hit.restore(ray);
 #endif
   }
   
@@ -394,7 +450,9 @@ namespace embree
 #else
     STAT(size_t cnt=0; for (size_t i=0; i<8; i++) cnt += ((int*)valid)[i] == -1;);
     STAT3(normal.travs,1,cnt,8);
+    const SavedHitN<8,RTCRay8> hit(valid,ray);
     ((Scene*)scene)->intersect8(valid,ray);
+    hit.restore(ray);
 #endif
   }
   
@@ -407,7 +465,9 @@ namespace embree
 #else
     STAT(size_t cnt=0; for (size_t i=0; i<16; i++) cnt += ((int*)valid)[i] == -1;);
     STAT3(normal.travs,1,cnt,16);
+    const SavedHitN<16,RTCRay16> hit(valid,ray);
     ((Scene*)scene)->intersect16(valid,ray);
+    hit.restore(ray);
 #endif
   }
   
@@ -418,6 +478,31 @@ namespace embree
     ((Scene*)scene)->occluded(ray);
   }
   
+  RTCORE_API void rtcOccludedHint (RTCScene scene, RTCRay& ray, RTCOccluderHint& hint) 
+  {
+    CATCH_BEGIN;
+    TRACE(rtcOccludedHint);
+    VERIFY_HANDLE(scene);
+    Scene* s = (Scene*) scene;
+    if (!s->isBuild()) {
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+    STAT3(shadow.travs,1,1,1);
+
+    /* the leaf of a hint from another scene or an earlier commit may no longer exist */
+    if (hint.scene != scene || hint.commit != s->commitCounter)
+      hint.geomID = RTC_INVALID_GEOMETRY_ID;
+
+    if (s->intersectors.occludedHint) s->intersectors.occludedHint(s->intersectors.ptr,ray,hint);
+    else s->occluded(ray);
+    if (hint.geomID != RTC_INVALID_GEOMETRY_ID) {
+      hint.scene = scene;
+      hint.commit = s->commitCounter;
+    }
+    CATCH_END;
+  }
+  
   RTCORE_API void rtcOccluded4 (const void* valid, RTCScene scene, RTCRay4& ray) 
   {
     TRACE(rtcOccluded4);
@@ -457,6 +542,216 @@ namespace embree
 #endif
   }
   
+  RTCORE_API void rtcClosestPoint (RTCScene scene, const float* p, float radius, int mask, RTCClosestPoint& result)
+  {
+    CATCH_BEGIN;
+    TRACE(rtcClosestPoint);
+    VERIFY_HANDLE(scene);
+    result.geomID = result.primID = RTC_INVALID_GEOMETRY_ID;
+    if (p == NULL || !(radius >= 0.0f)) {
+      recordError(RTC_INVALID_ARGUMENT);
+      return;
+    }
+    if (!((Scene*)scene)->isBuild()) {
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+    PointQuery query(Vec3fa(p[0],p[1],p[2]),radius,mask);
+    if (!((Scene*)scene)->pointQuery(query)) {
+      if (VERBOSE) std::cerr << "Embree: point queries not supported by acceleration structure or geometry types of the scene" << std::endl;
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+    result.p[0] = query.closest.x; result.p[1] = query.closest.y; result.p[2] = query.closest.z;
+    result.dist = query.radius;
+    result.u = query.u; result.v = query.v;
+    result.geomID = query.geomID;
+    result.primID = query.primID;
+    CATCH_END;
+  }
+
+  RTCORE_API void rtcCollide (RTCScene scene0, RTCScene scene1, const float* xfm1, RTCCollideFunc callback, void* userPtr)
+  {
+    CATCH_BEGIN;
+    TRACE(rtcCollide);
+    VERIFY_HANDLE(scene0);
+    VERIFY_HANDLE(scene1);
+    if (callback == NULL) {
+      recordError(RTC_INVALID_ARGUMENT);
+      return;
+    }
+    if (!((Scene*)scene0)->isBuild() || !((Scene*)scene1)->isBuild()) {
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+    AffineSpace3f transform = one;
+    if (xfm1) transform = copyFromArray(xfm1);
+    if (!((Scene*)scene0)->collide((Scene*)scene1,xfm1 ? &transform : NULL,callback,userPtr)) {
+      if (VERBOSE) std::cerr << "Embree: collision queries not supported by acceleration structure or geometry types of the scenes" << std::endl;
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+    CATCH_END;
+  }
+
+  RTCORE_API size_t rtcIntersectMultiHit (RTCScene scene, const RTCRay& ray, RTCHit* hits, size_t k) 
+  {
+    CATCH_BEGIN;
+    TRACE(rtcIntersectMultiHit);
+    VERIFY_HANDLE(scene);
+    if (k && hits == NULL) {
+      recordError(RTC_INVALID_ARGUMENT);
+      return 0;
+    }
+    Scene* s = (Scene*) scene;
+    if (!s->isBuild()) {
+      recordError(RTC_INVALID_OPERATION);
+      return 0;
+    }
+    if (s->bounds.empty()) return 0;
+    if (s->intersectors.multiHit == NULL) {
+      if (VERBOSE) std::cerr << "Embree: multi-hit queries not supported by acceleration structure" << std::endl;
+      recordError(RTC_INVALID_OPERATION);
+      return 0;
+    }
+    STAT3(normal.travs,1,1,1);
+    return s->intersectors.multiHit(s->intersectors.ptr,ray,hits,k);
+    CATCH_END;
+    return 0;
+  }
+
+  RTCORE_API void rtcIntersectMultiHit8 (const void* valid, RTCScene scene, const RTCRay8& ray, RTCHit* hits, size_t k, size_t* numHits) 
+  {
+    CATCH_BEGIN;
+    TRACE(rtcIntersectMultiHit8);
+    VERIFY_HANDLE(scene);
+    if (valid == NULL || numHits == NULL || (k && hits == NULL)) {
+      recordError(RTC_INVALID_ARGUMENT);
+      return;
+    }
+    for (size_t i=0; i<8; i++) numHits[i] = 0;
+#if !defined(__TARGET_AVX__) && !defined(__TARGET_AVX2__)
+    if (VERBOSE) std::cerr << "Embree: rtcIntersectMultiHit8 not supported" << std::endl;    
+    recordError(RTC_INVALID_OPERATION);                                    
+#else
+    Scene* s = (Scene*) scene;
+    if (!s->isBuild()) {
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+    if (s->bounds.empty()) return;
+    if (s->intersectors.multiHit8 == NULL || !has_feature(AVX)) {
+      if (VERBOSE) std::cerr << "Embree: multi-hit queries for ray packets not supported" << std::endl;
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+    STAT(size_t cnt=0; for (size_t i=0; i<8; i++) cnt += ((int*)valid)[i] == -1;);
+    STAT3(normal.travs,1,cnt,8);
+    s->intersectors.multiHit8(valid,s->intersectors.ptr,ray,hits,k,numHits);
+#endif
+    CATCH_END;
+  }
+
+  RTCORE_API void rtcOccludedMatrix (RTCScene scene, 
+                                     const float* points, size_t numPoints, size_t pointStride,
+                                     const float* targets, size_t numTargets, size_t targetStride,
+                                     float eps, unsigned int* occluded)
+  {
+    CATCH_BEGIN;
+    TRACE(rtcOccludedMatrix);
+    VERIFY_HANDLE(scene);
+    if ((numPoints && points == NULL) || (numTargets && targets == NULL) || (numPoints && numTargets && occluded == NULL) ||
+        pointStride < 3*sizeof(float) || targetStride < 3*sizeof(float) || !(eps >= 0.0f)) {
+      recordError(RTC_INVALID_ARGUMENT);
+      return;
+    }
+    if (!((Scene*)scene)->isBuild() || !(((Scene*)scene)->aflags & RTC_INTERSECT1)) {
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+    ((Scene*)scene)->occludedMatrix((const char*)points,numPoints,pointStride,(const char*)targets,numTargets,targetStride,eps,occluded);
+    CATCH_END;
+  }
+
+  /*! resolves the traversal functions of a scene for one ray packet size */
+  template<typename Intersector, typename SceneIntersector>
+  static void getSceneIntersector (RTCScene hscene, RTCAlgorithmFlags flag, const Intersector& (*get)(Scene*), SceneIntersector& intersector)
+  {
+    intersector.ptr = NULL;
+    intersector.intersect = NULL;
+    intersector.occluded = NULL;
+
+    Scene* scene = (Scene*) hscene;
+    if (!scene->isBuild() || !(scene->aflags & flag)) {
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+    const Intersector& in = get(scene);
+    if (!in) {
+      if (VERBOSE) std::cerr << "Embree: packet size not supported by this scene" << std::endl;
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+    intersector.ptr = scene->intersectors.ptr;
+    intersector.intersect = in.intersect;
+    intersector.occluded = in.occluded;
+  }
+
+  static const Accel::Intersector1&  getIntersector1 (Scene* scene) { return scene->intersectors.intersector1; }
+  static const Accel::Intersector4&  getIntersector4 (Scene* scene) { return scene->intersectors.intersector4; }
+  static const Accel::Intersector8&  getIntersector8 (Scene* scene) { return scene->intersectors.intersector8; }
+  static const Accel::Intersector16& getIntersector16(Scene* scene) { return scene->intersectors.intersector16; }
+
+  RTCORE_API void rtcGetSceneIntersector (RTCScene scene, RTCSceneIntersector& intersector) 
+  {
+    CATCH_BEGIN;
+    TRACE(rtcGetSceneIntersector);
+    VERIFY_HANDLE(scene);
+    getSceneIntersector(scene,RTC_INTERSECT1,getIntersector1,intersector);
+    CATCH_END;
+  }
+
+  RTCORE_API void rtcGetSceneIntersector4 (RTCScene scene, RTCSceneIntersector4& intersector) 
+  {
+    CATCH_BEGIN;
+    TRACE(rtcGetSceneIntersector4);
+    VERIFY_HANDLE(scene);
+    getSceneIntersector(scene,RTC_INTERSECT4,getIntersector4,intersector);
+    CATCH_END;
+  }
+
+  RTCORE_API void rtcGetSceneIntersector8 (RTCScene scene, RTCSceneIntersector8& intersector) 
+  {
+    CATCH_BEGIN;
+    TRACE(rtcGetSceneIntersector8);
+    VERIFY_HANDLE(scene);
+    getSceneIntersector(scene,RTC_INTERSECT8,getIntersector8,intersector);
+    CATCH_END;
+  }
+
+  RTCORE_API void rtcGetSceneIntersector16 (RTCScene scene, RTCSceneIntersector16& intersector) 
+  {
+    CATCH_BEGIN;
+    TRACE(rtcGetSceneIntersector16);
+    VERIFY_HANDLE(scene);
+    getSceneIntersector(scene,RTC_INTERSECT16,getIntersector16,intersector);
+    CATCH_END;
+  }
+
+  RTCORE_API const char* rtcGetSceneAccel (RTCScene scene) 
+  {
+    CATCH_BEGIN;
+    TRACE(rtcGetSceneAccel);
+    VERIFY_HANDLE(scene);
+    if (!((Scene*)scene)->isBuild()) {
+      recordError(RTC_INVALID_OPERATION);
+      return NULL;
+    }
+    return ((Scene*)scene)->accelName.c_str();
+    CATCH_END;
+    return NULL;
+  }
+
   RTCORE_API void rtcDeleteScene (RTCScene scene) 
   {
     CATCH_BEGIN;
@@ -466,25 +761,20 @@ namespace embree
     CATCH_END;
   }
 
-  RTCORE_API unsigned rtcNewInstance (RTCScene target, RTCScene source) 
+  RTCORE_API unsigned rtcNewInstance (RTCScene target, RTCScene source, size_t numTimeSteps) 
   {
     CATCH_BEGIN;
     TRACE(rtcNewInstance);
     VERIFY_HANDLE(target);
     VERIFY_HANDLE(source);
-    return ((Scene*) target)->newInstance((Scene*) source);
+    return ((Scene*) target)->newInstance((Scene*) source,numTimeSteps);
     CATCH_END;
     return -1;
   }
 
-  RTCORE_API void rtcSetTransform (RTCScene scene, unsigned geomID, RTCMatrixType layout, const float* xfm) 
+  /*! converts a transformation matrix of the API into an affine space */
+  static AffineSpace3f loadTransform(RTCMatrixType layout, const float* xfm)
   {
-    CATCH_BEGIN;
-    TRACE(rtcSetTransform);
-    VERIFY_HANDLE(scene);
-    VERIFY_GEOMID(geomID);
-    VERIFY_HANDLE(xfm);
-
     AffineSpace3f transform = one;
     switch (layout) 
     {
@@ -513,8 +803,41 @@ namespace embree
       ERROR("Unknown matrix type");
       break;
     }
-    ((Scene*) scene)->get_locked(geomID)->setTransform(transform);
+    return transform;
+  }
+
+  RTCORE_API void rtcSetTransform (RTCScene scene, unsigned geomID, RTCMatrixType layout, const float* xfm, size_t timeStep) 
+  {
+    CATCH_BEGIN;
+    TRACE(rtcSetTransform);
+    VERIFY_HANDLE(scene);
+    VERIFY_GEOMID(geomID);
+    VERIFY_HANDLE(xfm);
+    AffineSpace3f transform = loadTransform(layout,xfm);
+    ((Scene*) scene)->get_locked(geomID)->setTransform(transform,timeStep);
+    CATCH_END;
+  }
 
+  RTCORE_API void rtcSetTransforms (RTCScene hscene, RTCMatrixType layout, size_t numTransforms, const unsigned* geomIDs, const float* xfms, size_t timeStep) 
+  {
+    CATCH_BEGIN;
+    TRACE(rtcSetTransforms);
+    VERIFY_HANDLE(hscene);
+    VERIFY_HANDLE(geomIDs);
+    VERIFY_HANDLE(xfms);
+    Scene* scene = (Scene*) hscene;
+    const size_t stride = layout == RTC_MATRIX_COLUMN_MAJOR_ALIGNED16 ? 16 : 12;
+    Lock<AtomicMutex> lock(scene->geometriesMutex);
+    for (size_t i=0; i<numTransforms; i++) 
+    {
+      const unsigned geomID = geomIDs[i];
+      if (geomID >= scene->size() || scene->get(geomID) == NULL) {
+        recordError(RTC_INVALID_ARGUMENT);
+        continue;
+      }
+      AffineSpace3f transform = loadTransform(layout,xfms+i*stride);
+      scene->get(geomID)->setTransform(transform,timeStep);
+    }
     CATCH_END;
   }
 
@@ -538,6 +861,26 @@ namespace embree
     return -1;
   }
 
+  RTCORE_API unsigned rtcNewQuadMesh (RTCScene scene, RTCGeometryFlags flags, size_t numQuads, size_t numVertices)
+  {
+    CATCH_BEGIN;
+    TRACE(rtcNewQuadMesh);
+    VERIFY_HANDLE(scene);
+    return ((Scene*)scene)->newQuadMesh(flags,numQuads,numVertices);
+    CATCH_END;
+    return -1;
+  }
+
+  RTCORE_API unsigned rtcNewPoints (RTCScene scene, RTCGeometryFlags flags, RTCPointType type, size_t numPoints)
+  {
+    CATCH_BEGIN;
+    TRACE(rtcNewPoints);
+    VERIFY_HANDLE(scene);
+    return ((Scene*)scene)->newPoints(flags,type,numPoints);
+    CATCH_END;
+    return -1;
+  }
+
 /*  RTCORE_API unsigned rtcNewQuadraticBezierCurves (RTCScene scene, RTCGeometryFlags flags, size_t numCurves, size_t numVertices, size_t numTimeSteps) 
   {
     CATCH_BEGIN;
@@ -558,6 +901,66 @@ namespace embree
     CATCH_END;
   }
 
+  RTCORE_API void rtcSetIntersectionFilterFunction (RTCScene scene, unsigned geomID, RTCFilterFunc filter) 
+  {
+    CATCH_BEGIN;
+    TRACE(rtcSetIntersectionFilterFunction);
+    VERIFY_HANDLE(scene);
+    VERIFY_GEOMID(geomID);
+    ((Scene*)scene)->get_locked(geomID)->setIntersectionFilterFunction(filter);
+    CATCH_END;
+  }
+
+  RTCORE_API void rtcSetIntersectionFilterFunction4 (RTCScene scene, unsigned geomID, RTCFilterFunc4 filter) 
+  {
+    CATCH_BEGIN;
+    TRACE(rtcSetIntersectionFilterFunction4);
+    VERIFY_HANDLE(scene);
+    VERIFY_GEOMID(geomID);
+    ((Scene*)scene)->get_locked(geomID)->setIntersectionFilterFunction4(filter);
+    CATCH_END;
+  }
+
+  RTCORE_API void rtcSetIntersectionFilterFunction8 (RTCScene scene, unsigned geomID, RTCFilterFunc8 filter) 
+  {
+    CATCH_BEGIN;
+    TRACE(rtcSetIntersectionFilterFunction8);
+    VERIFY_HANDLE(scene);
+    VERIFY_GEOMID(geomID);
+    ((Scene*)scene)->get_locked(geomID)->setIntersectionFilterFunction8(filter);
+    CATCH_END;
+  }
+
+  RTCORE_API void rtcSetOcclusionFilterFunction (RTCScene scene, unsigned geomID, RTCFilterFunc filter) 
+  {
+    CATCH_BEGIN;
+    TRACE(rtcSetOcclusionFilterFunction);
+    VERIFY_HANDLE(scene);
+    VERIFY_GEOMID(geomID);
+    ((Scene*)scene)->get_locked(geomID)->setOcclusionFilterFunction(filter);
+    CATCH_END;
+  }
+
+  RTCORE_API void rtcSetOcclusionFilterFunction4 (RTCScene scene, unsigned geomID, RTCFilterFunc4 filter) 
+  {
+    CATCH_BEGIN;
+    TRACE(rtcSetOcclusionFilterFunction4);
+    VERIFY_HANDLE(scene);
+    VERIFY_GEOMID(geomID);
+    ((Scene*)scene)->get_locked(geomID)->setOcclusionFilterFunction4(filter);
+    CATCH_END;
+  }
+
+  RTCORE_API void rtcSetOcclusionFilterFunction8 (RTCScene scene, unsigned geomID, RTCFilterFunc8 filter) 
+  {
+    CATCH_BEGIN;
+    TRACE(rtcSetOcclusionFilterFunction8);
+    VERIFY_HANDLE(scene);
+    VERIFY_GEOMID(geomID);
+    ((Scene*)scene)->get_locked(geomID)->setOcclusionFilterFunction8(filter);
+    CATCH_END;
+  }
+
   RTCORE_API void* rtcMapBuffer(RTCScene scene, unsigned geomID, RTCBufferType type) 
   {
     CATCH_BEGIN;
@@ -718,4 +1121,94 @@ namespace embree
     ((Scene*)scene)->get_locked(geomID)->setOccludedFunction16(occluded16);
     CATCH_END;
   }
+
+  RTCORE_API void rtcSetBoundsRangeFunction (RTCScene scene, unsigned geomID, RTCBoundsRangeFunc bounds) 
+  {
+    CATCH_BEGIN;
+    TRACE(rtcSetBoundsRangeFunction);
+    VERIFY_HANDLE(scene);
+    VERIFY_GEOMID(geomID);
+    ((Scene*)scene)->get_locked(geomID)->setBoundsRangeFunction(bounds);
+    CATCH_END;
+  }
+
+  RTCORE_API void rtcSetIntersectRangeFunction (RTCScene scene, unsigned geomID, RTCIntersectRangeFunc intersect) 
+  {
+    CATCH_BEGIN;
+    TRACE(rtcSetIntersectRangeFunction);
+    VERIFY_HANDLE(scene);
+    VERIFY_GEOMID(geomID);
+    ((Scene*)scene)->get_locked(geomID)->setIntersectRangeFunction(intersect);
+    CATCH_END;
+  }
+
+  RTCORE_API void rtcSetIntersectRangeFunction4 (RTCScene scene, unsigned geomID, RTCIntersectRangeFunc4 intersect4) 
+  {
+    CATCH_BEGIN;
+    TRACE(rtcSetIntersectRangeFunction4);
+    VERIFY_HANDLE(scene);
+    VERIFY_GEOMID(geomID);
+    ((Scene*)scene)->get_locked(geomID)->setIntersectRangeFunction4(intersect4);
+    CATCH_END;
+  }
+
+  RTCORE_API void rtcSetIntersectRangeFunction8 (RTCScene scene, unsigned geomID, RTCIntersectRangeFunc8 intersect8) 
+  {
+    CATCH_BEGIN;
+    TRACE(rtcSetIntersectRangeFunction8);
+    VERIFY_HANDLE(scene);
+    VERIFY_GEOMID(geomID);
+    ((Scene*)scene)->get_locked(geomID)->setIntersectRangeFunction8(intersect8);
+    CATCH_END;
+  }
+
+  RTCORE_API void rtcSetIntersectRangeFunction16 (RTCScene scene, unsigned geomID, RTCIntersectRangeFunc16 intersect16) 
+  {
+    CATCH_BEGIN;
+    TRACE(rtcSetIntersectRangeFunction16);
+    VERIFY_HANDLE(scene);
+    VERIFY_GEOMID(geomID);
+    ((Scene*)scene)->get_locked(geomID)->setIntersectRangeFunction16(intersect16);
+    CATCH_END;
+  }
+
+  RTCORE_API void rtcSetOccludedRangeFunction (RTCScene scene, unsigned geomID, RTCOccludedRangeFunc occluded) 
+  {
+    CATCH_BEGIN;
+    TRACE(rtcSetOccludedRangeFunction);
+    VERIFY_HANDLE(scene);
+    VERIFY_GEOMID(geomID);
+    ((Scene*)scene)->get_locked(geomID)->setOccludedRangeFunction(occluded);
+    CATCH_END;
+  }
+
+  RTCORE_API void rtcSetOccludedRangeFunction4 (RTCScene scene, unsigned geomID, RTCOccludedRangeFunc4 occluded4) 
+  {
+    CATCH_BEGIN;
+    TRACE(rtcSetOccludedRangeFunction4);
+    VERIFY_HANDLE(scene);
+    VERIFY_GEOMID(geomID);
+    ((Scene*)scene)->get_locked(geomID)->setOccludedRangeFunction4(occluded4);
+    CATCH_END;
+  }
+
+  RTCORE_API void rtcSetOccludedRangeFunction8 (RTCScene scene, unsigned geomID, RTCOccludedRangeFunc8 occluded8) 
+  {
+    CATCH_BEGIN;
+    TRACE(rtcSetOccludedRangeFunction8);
+    VERIFY_HANDLE(scene);
+    VERIFY_GEOMID(geomID);
+    ((Scene*)scene)->get_locked(geomID)->setOccludedRangeFunction8(occluded8);
+    CATCH_END;
+  }
+
+  RTCORE_API void rtcSetOccludedRangeFunction16 (RTCScene scene, unsigned geomID, RTCOccludedRangeFunc16 occluded16) 
+  {
+    CATCH_BEGIN;
+    TRACE(rtcSetOccludedRangeFunction16);
+    VERIFY_HANDLE(scene);
+    VERIFY_GEOMID(geomID);
+    ((Scene*)scene)->get_locked(geomID)->setOccludedRangeFunction16(occluded16);
+    CATCH_END;
+  }
 }
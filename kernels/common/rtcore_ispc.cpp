@@ -110,12 +110,16 @@ namespace embree
     rtcDeleteScene(scene);
   }
   
-  extern "C" unsigned ispcNewInstance (RTCScene target, RTCScene source) {
-    return rtcNewInstance(target,source);
+  extern "C" unsigned ispcNewInstance (RTCScene target, RTCScene source, size_t numTimeSteps) {
+    return rtcNewInstance(target,source,numTimeSteps);
   }
   
-  extern "C" void ispcSetTransform (RTCScene scene, unsigned geomID, RTCMatrixType layout, const float* xfm) {
-    return rtcSetTransform(scene,geomID,layout,xfm);
+  extern "C" void ispcSetTransform (RTCScene scene, unsigned geomID, RTCMatrixType layout, const float* xfm, size_t timeStep) {
+    return rtcSetTransform(scene,geomID,layout,xfm,timeStep);
+  }
+  
+  extern "C" void ispcSetTransforms (RTCScene scene, RTCMatrixType layout, size_t numTransforms, const unsigned* geomIDs, const float* xfms, size_t timeStep) {
+    return rtcSetTransforms(scene,layout,numTransforms,geomIDs,xfms,timeStep);
   }
   
   extern "C" unsigned ispcNewUserGeometry (RTCScene scene, size_t numItems) {
@@ -15,6 +15,7 @@
 // ======================================================================== //
 
 #include "scene.h"
+#include "embree2/rtcore_ray.h"
 
 #if !defined(__MIC__)
 #include "bvh4/twolevel_accel.h"
@@ -31,15 +32,17 @@
 
 namespace embree
 {
+
   Scene::Scene (RTCSceneFlags sflags, RTCAlgorithmFlags aflags)
-    : flags(sflags), aflags(aflags), numMappedBuffers(0), is_build(false), needTriangles(false), needVertices(false),
-      numTriangleMeshes(0), numTriangleMeshes2(0), numUserGeometries(0),
-      flat_triangle_source_1(this,1), flat_triangle_source_2(this,2)
+    : flags(sflags), aflags(aflags), numMappedBuffers(0), is_build(false), commitCounter(0), mask(-1), deferredPending(false), deferredBuilding(false), needTriangles(false), needVertices(false),
+      numTriangleMeshes(0), numTriangleMeshes2(0), numUserGeometries(0), numPointSets(0), numQuadMeshes(0),
+      flat_triangle_source_1(this,1), flat_triangle_source_2(this,2), flat_point_source(this), flat_quad_source(this)
   {
     if (g_scene_flags != -1)
       flags = (RTCSceneFlags) g_scene_flags;
 
     geometries.reserve(128);
+    accelName = g_tri_accel;
 
 #if defined(__MIC__)
 
@@ -94,7 +97,12 @@ namespace embree
     /* create default acceleration structure */
     if (g_top_accel == "default" && g_tri_accel == "default") 
     {
-      if (isStatic()) {
+      /* triangle acceleration structure gets selected at commit time */
+      if (isAutotune()) {
+        accels.accel1 = BVH4MB::BVH4MBTriangle1v(this); 
+        accels.accel2 = new TwoLevelAccel("bvh4",this); 
+      } 
+      else if (isStatic()) {
         int mode =  4*(int)isCoherent() + 2*(int)isCompact() + 1*(int)isRobust();
         switch (mode) {
         case /*0b000*/ 0: 
@@ -119,7 +127,7 @@ namespace embree
           if (isHighQuality()) accels.accel0 = BVH4::BVH4Triangle1SpatialSplit(this);
           else                 accels.accel0 = BVH4::BVH4Triangle1ObjectSplit(this); 
           break;
-        case /*0b101*/ 5: accels.accel0 = BVH4::BVH4Triangle1vObjectSplit(this); break;
+        case /*0b101*/ 5: accels.accel0 = BVH4::BVH4Triangle4vObjectSplit(this); break;
         case /*0b110*/ 6: accels.accel0 = BVH4::BVH4Triangle4iObjectSplit(this); break;
         case /*0b111*/ 7: accels.accel0 = BVH4::BVH4Triangle4iObjectSplit(this); break;
         }
@@ -133,9 +141,9 @@ namespace embree
         case /*0b010*/ 2: accels.accel0 = BVH4::BVH4BVH4Triangle4vObjectSplit(this); break;
         case /*0b011*/ 3: accels.accel0 = BVH4::BVH4BVH4Triangle4vObjectSplit(this); break;
         case /*0b100*/ 4: accels.accel0 = BVH4::BVH4BVH4Triangle1ObjectSplit(this); break;
-        case /*0b101*/ 5: accels.accel0 = BVH4::BVH4BVH4Triangle1vObjectSplit(this); break;
+        case /*0b101*/ 5: accels.accel0 = BVH4::BVH4BVH4Triangle4vObjectSplit(this); break;
         case /*0b110*/ 6: accels.accel0 = BVH4::BVH4BVH4Triangle1vObjectSplit(this); break;
-        case /*0b111*/ 7: accels.accel0 = BVH4::BVH4BVH4Triangle1vObjectSplit(this); break;
+        case /*0b111*/ 7: accels.accel0 = BVH4::BVH4BVH4Triangle4vObjectSplit(this); break;
         }
         accels.accel1 = BVH4MB::BVH4MBTriangle1v(this);
         accels.accel2 = new TwoLevelAccel("bvh4",this);
@@ -158,6 +166,8 @@ namespace embree
       else if (g_tri_accel == "bvh4.triangle1v")        accels.accel0 = BVH4::BVH4Triangle1v(this);
       else if (g_tri_accel == "bvh4.triangle4v")        accels.accel0 = BVH4::BVH4Triangle4v(this);
       else if (g_tri_accel == "bvh4.triangle4i")        accels.accel0 = BVH4::BVH4Triangle4i(this);
+      else if (g_tri_accel == "bvh4.triangle4q")        accels.accel0 = BVH4::BVH4Triangle4q(this);
+      else if (g_tri_accel == "bvh4.trianglemeshlet")   accels.accel0 = BVH4::BVH4TriangleMeshlet(this);
       else if (g_tri_accel == "bvh4i.triangle1")        accels.accel0 = BVH4i::BVH4iTriangle1(this);
       else if (g_tri_accel == "bvh4i.triangle4")        accels.accel0 = BVH4i::BVH4iTriangle4(this);
       else if (g_tri_accel == "bvh4i.triangle1.v1")     accels.accel0 = BVH4i::BVH4iTriangle1_v1(this);
@@ -175,6 +185,17 @@ namespace embree
       accels.accel0 = new TwoLevelAccel(g_top_accel,this);
       accels.accel1 = NULL;
     }
+
+    /* point and quad acceleration structures get created at the first
+     * commit that contains such geometry, see createPointAndQuadAccels */
+#endif
+
+    /* filter functions can be set if the triangle kernels invoke them,
+     * autotuning only considers candidates with filter support */
+#if defined(__INTERSECTION_FILTER__)
+    filterFunctions = accels.accel0 == NULL || (accels.accel0->supportedFeatures() & KERNEL_FEATURE_FILTER);
+#else
+    filterFunctions = false;
 #endif
   }
   
@@ -190,11 +211,61 @@ namespace embree
     return geom->id;
   }
   
-  unsigned Scene::newInstance (Scene* scene) {
-    Geometry* geom = new UserGeometryScene::Instance(this,scene);
+  unsigned Scene::newInstance (Scene* scene, size_t numTimeSteps) 
+  {
+    if (numTimeSteps == 0 || numTimeSteps > RTC_MAX_INSTANCE_TIME_STEPS) {
+      recordError(RTC_INVALID_ARGUMENT);
+      return -1;
+    }
+
+    /* instancing a scene that contains this scene would create a cycle */
+    std::set<const Scene*> visited;
+    if (scene == this || scene->instances(this,visited)) {
+      recordError(RTC_INVALID_ARGUMENT);
+      return -1;
+    }
+    Geometry* geom = new UserGeometryScene::Instance(this,scene,numTimeSteps);
     return geom->id;
   }
 
+  bool Scene::instances (const Scene* scene, std::set<const Scene*>& visited) const
+  {
+    for (size_t i=0; i<geometries.size(); i++) 
+    {
+      const Geometry* geom = geometries[i];
+      if (geom == NULL || geom->type != INSTANCES) continue;
+      const Scene* object = (const Scene*) ((const UserGeometryScene::Instance*) geom)->object;
+      if (object == scene) return true;
+      if (!visited.insert(object).second) continue;
+      if (object->instances(scene,visited)) return true;
+    }
+    return false;
+  }
+
+  void Scene::commitInstancedScenes (std::set<const Scene*>& visited)
+  {
+    for (size_t i=0; i<geometries.size(); i++) 
+    {
+      Geometry* geom = geometries[i];
+      if (geom == NULL || geom->type != INSTANCES || !geom->isEnabled()) continue;
+      Scene* object = (Scene*) ((UserGeometryScene::Instance*) geom)->object;
+      if (!visited.insert(object).second) continue;
+
+      /* update the scenes instanced by the object first */
+      object->commitInstancedScenes(visited);
+      if (object->isStatic() || !object->isBuild()) continue;
+
+      /* commit the object if one of its instanced scenes changed since its last commit */
+      bool outdated = false;
+      for (size_t j=0; j<object->geometries.size(); j++) {
+        UserGeometryScene::Instance* instance = (UserGeometryScene::Instance*) object->geometries[j];
+        if (instance == NULL || instance->type != INSTANCES || !instance->isEnabled()) continue;
+        outdated |= instance->objectCommitCounter != ((Scene*) instance->object)->commitCounter;
+      }
+      if (outdated) object->build();
+    }
+  }
+
   unsigned Scene::newTriangleMesh (RTCGeometryFlags gflags, size_t numTriangles, size_t numVertices, size_t numTimeSteps) 
   {
     if (isStatic() && (gflags != RTC_GEOMETRY_STATIC)) {
@@ -222,6 +293,43 @@ namespace embree
     return geom->id;
   }
 
+  unsigned Scene::newQuadMesh (RTCGeometryFlags gflags, size_t numQuads, size_t numVertices) 
+  {
+    if (isStatic() && (gflags != RTC_GEOMETRY_STATIC)) {
+      recordError(RTC_INVALID_OPERATION);
+      return -1;
+    }
+
+#if defined(__MIC__)
+    recordError(RTC_INVALID_OPERATION);
+    return -1;
+#else
+    Geometry* geom = new QuadMeshScene::QuadMesh(this,gflags,numQuads,numVertices);
+    return geom->id;
+#endif
+  }
+
+  unsigned Scene::newPoints (RTCGeometryFlags gflags, RTCPointType type, size_t numPoints) 
+  {
+    if (isStatic() && (gflags != RTC_GEOMETRY_STATIC)) {
+      recordError(RTC_INVALID_OPERATION);
+      return -1;
+    }
+
+    if (type != RTC_POINT_SPHERE && type != RTC_POINT_DISC) {
+      recordError(RTC_INVALID_ARGUMENT);
+      return -1;
+    }
+
+#if defined(__MIC__)
+    recordError(RTC_INVALID_OPERATION);
+    return -1;
+#else
+    Geometry* geom = new PointsScene::Points(this,gflags,type,numPoints);
+    return geom->id;
+#endif
+  }
+
   unsigned Scene::add(Geometry* geometry) 
   {
     Lock<AtomicMutex> lock(geometriesMutex);
@@ -246,14 +354,615 @@ namespace embree
     delete geometry;
   }
 
-  void Scene::build (size_t threadIndex, size_t threadCount) {
+  int Scene::kernelFeatures ()
+  {
+    int features = isRobust() ? KERNEL_FEATURE_ROBUST : KERNEL_FEATURES_NONE;
+    for (size_t i=0; i<geometries.size(); i++) 
+    {
+      Geometry* geom = geometries[i];
+      if (geom == NULL || !geom->isEnabled()) continue;
+#if defined(__USE_RAY_MASK__)
+      TriangleMesh* mesh = getTriangleMeshSafe(i);
+      if (mesh && mesh->mask != unsigned(-1)) 
+        features |= KERNEL_FEATURE_RAY_MASK;
+#endif
+#if defined(__INTERSECTION_FILTER__)
+      if (geom->hasIntersectionFilter1() || geom->hasIntersectionFilter4() || geom->hasIntersectionFilter8() ||
+          geom->hasOcclusionFilter1()    || geom->hasOcclusionFilter4()    || geom->hasOcclusionFilter8())
+        features |= KERNEL_FEATURE_FILTER;
+#endif
+    }
+    return features;
+  }
+
+  bool Scene::pointQuery (PointQuery& query)
+  {
+    buildDeferred();
+    Accel* accel = accels.accel0;
+    if (!accels.onlyFirstNonEmpty()) return false;
+    if (accel == NULL || accel->bounds.empty()) return true;
+    if (accel->intersectors.pointQuery == NULL) return false;
+    accel->intersectors.pointQuery(accel->intersectors.ptr,query);
+    return true;
+  }
+
+  bool Scene::collide (Scene* other, const AffineSpace3f* xfm1, RTCCollideFunc callback, void* userPtr)
+  {
+    buildDeferred();
+    other->buildDeferred();
+    Accel* accel0 = accels.accel0;
+    Accel* accel1 = other->accels.accel0;
+    if (!accels.onlyFirstNonEmpty() || !other->accels.onlyFirstNonEmpty()) return false;
+    if (accel0 == NULL || accel0->bounds.empty()) return true;
+    if (accel1 == NULL || accel1->bounds.empty()) return true;
+
+    /* both structures have to share the same node layout */
+    if (accel0->intersectors.collide == NULL || accel0->intersectors.collide != accel1->intersectors.collide) return false;
+    accel0->intersectors.collide(accel0->intersectors.ptr,accel1->intersectors.ptr,xfm1,callback,userPtr);
+    return true;
+  }
+
+  /*! Traces the visibility rays from one point to N targets at a time
+   *  using the packet occlusion function of the scene. */
+  template<typename RTCRayN, int N, typename Intersector>
+  static void occludedMatrixN (const Intersector& intersector, void* ptr, const Vec3fa& org, 
+                               const char* targets, size_t numTargets, size_t targetStride, 
+                               float eps, unsigned int* occluded)
+  {
+    RTCRayN ray;
+    __align(64) int valid[N];
+
+    for (size_t j0=0; j0<numTargets; j0+=N)
+    {
+      /* all rays of the packet share the origin */
+      size_t numActive = 0;
+      for (size_t k=0; k<N; k++)
+      {
+        const size_t j = j0+k;
+        valid[k] = 0;
+        if (j >= numTargets) continue;
+        const float* t = (const float*)(targets+j*targetStride);
+        const Vec3fa d = Vec3fa(t[0],t[1],t[2])-org;
+        const float dist = length(d);
+        if (dist <= 2.0f*eps) continue;
+        const Vec3fa dir = d*rcp(dist);
+        ray.orgx[k] = org.x; ray.orgy[k] = org.y; ray.orgz[k] = org.z;
+        ray.dirx[k] = dir.x; ray.diry[k] = dir.y; ray.dirz[k] = dir.z;
+        ray.tnear[k] = eps; ray.tfar[k] = dist-eps;
+        ray.time[k] = 0.0f; ray.mask[k] = -1;
+        ray.geomID[k] = RTC_INVALID_GEOMETRY_ID; 
+        ray.primID[k] = RTC_INVALID_GEOMETRY_ID; 
+        ray.instID[k] = RTC_INVALID_GEOMETRY_ID;
+        valid[k] = -1;
+        numActive++;
+      }
+      if (numActive == 0) continue;
+
+      intersector.occluded(valid,ptr,ray);
+      for (size_t k=0; k<N; k++) {
+        const size_t j = j0+k;
+        if (valid[k] && ray.geomID[k] == 0) occluded[j/32] |= 1u << (j%32);
+      }
+    }
+  }
+
+  void Scene::occludedMatrix (const char* points, size_t numPoints, size_t pointStride, 
+                              const char* targets, size_t numTargets, size_t targetStride, 
+                              float eps, unsigned int* occluded)
+  {
+    const size_t rowWords = (numTargets+31)/32;
+    for (size_t i=0; i<numPoints; i++)
+    {
+      const float* p = (const float*)(points+i*pointStride);
+      const Vec3fa org(p[0],p[1],p[2]);
+      unsigned int* row = occluded+i*rowWords;
+      for (size_t j=0; j<rowWords; j++) row[j] = 0;
+
+      /* use the widest packets the scene supports */
+#if defined(__MIC__)
+      if ((aflags & RTC_INTERSECT16) && intersectors.intersector16) {
+        occludedMatrixN<RTCRay16,16>(intersectors.intersector16,intersectors.ptr,org,targets,numTargets,targetStride,eps,row);
+        continue;
+      }
+#else
+      if ((aflags & RTC_INTERSECT8) && intersectors.intersector8 && has_feature(AVX)) {
+        occludedMatrixN<RTCRay8,8>(intersectors.intersector8,intersectors.ptr,org,targets,numTargets,targetStride,eps,row);
+        continue;
+      }
+      if ((aflags & RTC_INTERSECT4) && intersectors.intersector4) {
+        occludedMatrixN<RTCRay4,4>(intersectors.intersector4,intersectors.ptr,org,targets,numTargets,targetStride,eps,row);
+        continue;
+      }
+#endif
+      for (size_t j=0; j<numTargets; j++)
+      {
+        const float* t = (const float*)(targets+j*targetStride);
+        const Vec3fa d = Vec3fa(t[0],t[1],t[2])-org;
+        const float dist = length(d);
+        if (dist <= 2.0f*eps) continue;
+        RTCRay ray;
+        for (size_t k=0; k<3; k++) ray.org[k] = org[k];
+        for (size_t k=0; k<3; k++) ray.dir[k] = d[k]/dist;
+        ray.tnear = eps; ray.tfar = dist-eps;
+        ray.time = 0.0f; ray.mask = -1;
+        ray.geomID = ray.primID = ray.instID = RTC_INVALID_GEOMETRY_ID;
+        intersectors.intersector1.occluded(intersectors.ptr,ray);
+        if (ray.geomID == 0) row[j/32] |= 1u << (j%32);
+      }
+    }
+  }
+
+  void Scene::build (size_t threadIndex, size_t threadCount) 
+  {
+#if !defined(__MIC__)
+    if (isAutotune() && accels.accel0 == NULL) {
+      autotune(threadIndex,threadCount);
+      return;
+    }
+#endif
+    accels.selectFeatures(kernelFeatures());
     accels.build(threadIndex,threadCount);
   }
 
+#if !defined(__MIC__)
+
+  /*! number of rays traced per candidate during autotuning */
+  static const size_t numAutotuneRays = 4096;
+
+  /*! sampled ray for autotuning */
+  struct AutotuneRay 
+  {
+    Vec3fa org;     //!< ray origin
+    Vec3fa dir;     //!< ray direction, the sampled surface point is at distance 1
+    float tnear;    //!< start of ray segment
+  };
+
+  /*! deterministic random number generator for ray sampling */
+  __forceinline float autotuneRandom(unsigned int& state) {
+    state = 1103515245U*state + 12345U;
+    return float(state >> 8) * (1.0f/16777216.0f);
+  }
+
+  static void traceAutotuneRays(const Accel::Intersector1& intersector, void* ptr, const std::vector<AutotuneRay>& rays)
+  {
+    for (size_t i=0; i<rays.size(); i++)
+    {
+      RTCRay ray;
+      ray.org[0] = rays[i].org.x; ray.org[1] = rays[i].org.y; ray.org[2] = rays[i].org.z;
+      ray.dir[0] = rays[i].dir.x; ray.dir[1] = rays[i].dir.y; ray.dir[2] = rays[i].dir.z;
+      ray.tnear = rays[i].tnear; ray.tfar = inf; ray.time = 0.0f; ray.mask = -1;
+      ray.geomID = ray.primID = ray.instID = -1;
+      intersector.intersect(ptr,ray);
+
+      /* shadow ray towards the sampled surface point */
+      ray.tfar = 0.999f; ray.geomID = -1;
+      intersector.occluded(ptr,ray);
+    }
+  }
+
+  template<typename RTCRayN, typename IntersectorN, size_t N>
+  static void traceAutotuneRays(const IntersectorN& intersector, void* ptr, const std::vector<AutotuneRay>& rays)
+  {
+    __align(64) int valid[N];
+    for (size_t j=0; j<N; j++) valid[j] = -1;
+
+    for (size_t i=0; i+N<=rays.size(); i+=N)
+    {
+      __align(64) RTCRayN ray;
+      for (size_t j=0; j<N; j++) {
+        const AutotuneRay& r = rays[i+j];
+        ray.orgx[j] = r.org.x; ray.orgy[j] = r.org.y; ray.orgz[j] = r.org.z;
+        ray.dirx[j] = r.dir.x; ray.diry[j] = r.dir.y; ray.dirz[j] = r.dir.z;
+        ray.tnear[j] = r.tnear; ray.tfar[j] = inf; ray.time[j] = 0.0f; ray.mask[j] = -1;
+        ray.geomID[j] = ray.primID[j] = ray.instID[j] = -1;
+      }
+      intersector.intersect(valid,ptr,ray);
+
+      for (size_t j=0; j<N; j++) {
+        ray.tfar[j] = 0.999f; ray.geomID[j] = -1;
+      }
+      intersector.occluded(valid,ptr,ray);
+    }
+  }
+
+  /*! traces the sampled rays with all ray widths enabled for the scene */
+  static double traceAutotuneRays(const Accel::Intersectors& intersectors, RTCAlgorithmFlags aflags, const std::vector<AutotuneRay>& rays)
+  {
+    double t0 = getSeconds();
+    if ((aflags & RTC_INTERSECT1) && intersectors.intersector1) traceAutotuneRays(intersectors.intersector1,intersectors.ptr,rays);
+    if ((aflags & RTC_INTERSECT4) && intersectors.intersector4) traceAutotuneRays<RTCRay4,Accel::Intersector4,4>(intersectors.intersector4,intersectors.ptr,rays);
+    if ((aflags & RTC_INTERSECT8) && intersectors.intersector8) traceAutotuneRays<RTCRay8,Accel::Intersector8,8>(intersectors.intersector8,intersectors.ptr,rays);
+    return getSeconds()-t0;
+  }
+
+  /*! tests if the accel provides all intersectors the application requested */
+  static bool hasIntersectors(const Accel::Intersectors& intersectors, RTCAlgorithmFlags aflags)
+  {
+    if ((aflags & RTC_INTERSECT1) && !intersectors.intersector1) return false;
+    if ((aflags & RTC_INTERSECT4) && !intersectors.intersector4) return false;
+    if ((aflags & RTC_INTERSECT8) && !intersectors.intersector8) return false;
+    return true;
+  }
+
+  void Scene::autotune (size_t threadIndex, size_t threadCount)
+  {
+    /* collect all triangles the candidates get build over */
+    std::vector<TriangleMesh*> meshes;
+    std::vector<size_t> prefix;
+    size_t numTriangles = 0;
+    for (size_t i=0; i<geometries.size(); i++) {
+      TriangleMesh* mesh = getTriangleMeshSafe(i);
+      if (mesh == NULL || !mesh->isEnabled() || mesh->numTimeSteps != 1 || mesh->numTriangles == 0) continue;
+      meshes.push_back(mesh);
+      prefix.push_back(numTriangles);
+      numTriangles += mesh->numTriangles;
+    }
+
+    /* nothing to tune for yet, select at a later commit */
+    if (numTriangles == 0) {
+      accels.selectFeatures(kernelFeatures());
+      accels.build(threadIndex,threadCount);
+      return;
+    }
+
+    /* create list of candidates */
+    typedef Accel* (*CreateAccelFunc)(Scene* scene);
+    typedef std::pair<const char*,CreateAccelFunc> Candidate;
+    std::vector<Candidate> candidates;
+    if (isStatic()) 
+    {
+      if (isRobust()) {
+        candidates.push_back(Candidate("bvh4.triangle4v",&BVH4::BVH4Triangle4vObjectSplit));
+      }
+      else if (isCompact()) {
+        candidates.push_back(Candidate("bvh4.triangle4i",&BVH4::BVH4Triangle4iObjectSplit));
+      }
+      else if (isHighQuality()) {
+        candidates.push_back(Candidate("bvh4.triangle4",&BVH4::BVH4Triangle4SpatialSplit));
+        candidates.push_back(Candidate("bvh4.triangle1",&BVH4::BVH4Triangle1SpatialSplit));
+#if defined (__TARGET_AVX__)
+        if (has_feature(AVX)) candidates.push_back(Candidate("bvh4.triangle8",&BVH4::BVH4Triangle8SpatialSplit));
+#endif
+      }
+      else {
+        candidates.push_back(Candidate("bvh4.triangle4",&BVH4::BVH4Triangle4ObjectSplit));
+        candidates.push_back(Candidate("bvh4.triangle1",&BVH4::BVH4Triangle1ObjectSplit));
+#if defined (__TARGET_AVX__)
+        if (has_feature(AVX)) candidates.push_back(Candidate("bvh4.triangle8",&BVH4::BVH4Triangle8ObjectSplit));
+#endif
+
+        /* the BVH4i and BVH8i kernels do not invoke filter functions */
+        if (!(kernelFeatures() & KERNEL_FEATURE_FILTER)) {
+          candidates.push_back(Candidate("bvh4i.triangle1",&BVH4i::BVH4iTriangle1));
+#if !defined(__WIN32__) && defined (__TARGET_AVX__)
+          if (has_feature(AVX)) candidates.push_back(Candidate("bvh8i.triangle1",&BVH8i::BVH8iTriangle1));
+#endif
+        }
+      }
+    }
+    else 
+    {
+      if (isRobust()) {
+        candidates.push_back(Candidate("bvh4.bvh4.triangle4v",&BVH4::BVH4BVH4Triangle4vObjectSplit));
+      }
+      else {
+        candidates.push_back(Candidate("bvh4.bvh4.triangle4",&BVH4::BVH4BVH4Triangle4ObjectSplit));
+        candidates.push_back(Candidate("bvh4.bvh4.triangle1",&BVH4::BVH4BVH4Triangle1ObjectSplit));
+        candidates.push_back(Candidate("bvh4.bvh4.triangle1.morton",&BVH4::BVH4BVH4Triangle1Morton));
+      }
+    }
+
+    /* the builders reset the modified state, thus each candidate has to start from the same state */
+    std::vector<Geometry::State> states(geometries.size());
+    for (size_t i=0; i<geometries.size(); i++)
+      if (geometries[i]) states[i] = geometries[i]->state;
+
+    /* sample rays from outside the scene and between surface points */
+    std::vector<AutotuneRay> rays;
+    
+    Accel* best = NULL;
+    const char* bestName = NULL;
+    double bestCost = inf;
+    for (size_t c=0; c<candidates.size(); c++)
+    {
+      Accel* accel = candidates[c].second(this);
+
+      /* candidates are timed without masks and filters, thus the
+       * filters of the application never see the sampled rays */
+      accel->selectFeatures(kernelFeatures() & ~KERNEL_FEATURES_ALL);
+      
+      /* the first candidate is always usable */
+      if (c > 0 && !hasIntersectors(accel->intersectors,aflags)) {
+        delete accel;
+        continue;
+      }
+      
+      for (size_t i=0; i<geometries.size(); i++)
+        if (geometries[i]) geometries[i]->state = states[i];
+
+      double t0 = getSeconds();
+      accel->build(threadIndex,threadCount);
+      double dtBuild = getSeconds()-t0;
+
+      /* a single candidate needs no measurement */
+      if (candidates.size() == 1) {
+        best = accel; bestName = candidates[c].first;
+        break;
+      }
+
+      if (rays.size() == 0) 
+      {
+        const Vec3fa center = 0.5f*(accel->bounds.lower+accel->bounds.upper);
+        const float radius = 0.5f*length(accel->bounds.upper-accel->bounds.lower);
+        unsigned int state = 0x12345678;
+        rays.resize(numAutotuneRays);
+        for (size_t i=0; i<numAutotuneRays; i++) 
+        {
+          Vec3fa p[2];
+          for (size_t k=0; k<2; k++) {
+            const size_t index = min(size_t(autotuneRandom(state)*numTriangles),numTriangles-1);
+            const size_t m = std::upper_bound(prefix.begin(),prefix.end(),index)-prefix.begin()-1;
+            const TriangleMesh::Triangle& tri = meshes[m]->triangle(index-prefix[m]);
+            float u = autotuneRandom(state), v = autotuneRandom(state);
+            if (u+v > 1.0f) { u = 1.0f-u; v = 1.0f-v; }
+            p[k] = (1.0f-u-v)*meshes[m]->vertex(tri.v[0]) + u*meshes[m]->vertex(tri.v[1]) + v*meshes[m]->vertex(tri.v[2]);
+          }
+          if (i%2 == 0) {
+            const Vec3fa d = Vec3fa(autotuneRandom(state)-0.5f,autotuneRandom(state)-0.5f,autotuneRandom(state)-0.5f);
+            rays[i].org = center + 2.0f*radius*normalize(d + Vec3fa(1E-6f));
+            rays[i].tnear = 0.0f;
+          } else {
+            rays[i].org = p[1];
+            rays[i].tnear = 1E-4f;
+          }
+          rays[i].dir = p[0]-rays[i].org;
+        }
+      }
+
+      /* first pass warms up the caches */
+      traceAutotuneRays(accel->intersectors,aflags,rays);
+      double dtTrace = traceAutotuneRays(accel->intersectors,aflags,rays);
+
+      /* dynamic scenes pay for the build at each commit */
+      double cost = dtTrace;
+      if (isDynamic()) cost += dtBuild;
+      
+      if (g_verbose >= 1) 
+        std::cout << "autotune: " << candidates[c].first << " build = " << 1000.0*dtBuild << " ms, " 
+                  << "trace = " << 1000.0*dtTrace << " ms" << std::endl;
+
+      if (cost < bestCost) {
+        delete best;
+        best = accel; bestName = candidates[c].first; bestCost = cost;
+      } else {
+        delete accel;
+      }
+    }
+
+    if (g_verbose >= 1) 
+      std::cout << "autotune: selected " << bestName << std::endl;
+    
+    accels.accel0 = best;
+    accelName = bestName;
+    if (accels.accel1) accels.accel1->build(threadIndex,threadCount);
+    if (accels.accel2) accels.accel2->build(threadIndex,threadCount);
+    if (accels.accel3) accels.accel3->build(threadIndex,threadCount);
+    if (accels.accel4) accels.accel4->build(threadIndex,threadCount);
+    accels.selectFeatures(kernelFeatures());
+    accels.select();
+  }
+
+#endif
+
+  void Scene::createPointAndQuadAccels ()
+  {
+#if !defined(__MIC__)
+    /* spheres and discs are always stored in a flat BVH over packed points */
+    if (accels.accel3 == NULL && numPointSets) 
+    {
+#if defined (__TARGET_AVX__)
+      if (has_feature(AVX)) accels.accel3 = BVH4::BVH4Point8(this);
+      else
+#endif
+      accels.accel3 = BVH4::BVH4Point4(this);
+    }
+
+    /* quads are stored in a flat BVH over packed quad pairs */
+    if (accels.accel4 == NULL && numQuadMeshes) 
+    {
+#if defined (__TARGET_AVX__)
+      if (has_feature(AVX)) accels.accel4 = BVH4::BVH4Quad8(this);
+      else
+#endif
+      accels.accel4 = BVH4::BVH4Quad4(this);
+    }
+#endif
+  }
+
   void Scene::task_build(size_t threadIndex, size_t threadCount, TaskScheduler::Event* event) {
     build(threadIndex,threadCount);
   }
 
+  BBox3f Scene::geometryBounds () 
+  {
+    BBox3f bounds = empty;
+    for (size_t i=0; i<geometries.size(); i++) 
+    {
+      Geometry* geom = geometries[i];
+      if (geom == NULL || !geom->isEnabled()) continue;
+
+      switch (geom->type) 
+      {
+      case TRIANGLE_MESH: {
+        TriangleMesh* mesh = (TriangleMesh*) geom;
+        for (size_t t=0; t<mesh->numTimeSteps; t++)
+          for (size_t j=0; j<mesh->numTriangles; j++) {
+            const TriangleMesh::Triangle& tri = mesh->triangle(j);
+            bounds.extend(mesh->vertex(tri.v[0],t));
+            bounds.extend(mesh->vertex(tri.v[1],t));
+            bounds.extend(mesh->vertex(tri.v[2],t));
+          }
+        break;
+      }
+      case QUADRATIC_BEZIER_CURVES: {
+        QuadraticBezierCurvesScene::QuadraticBezierCurves* curves = (QuadraticBezierCurvesScene::QuadraticBezierCurves*) geom;
+        for (size_t j=0; j<curves->numCurves; j++) bounds.extend(curves->bounds(j));
+        break;
+      }
+      case POINTS: {
+        Points* points = (Points*) geom;
+        for (size_t j=0; j<points->numPoints; j++) bounds.extend(points->bounds(j));
+        break;
+      }
+      case QUAD_MESH: {
+        QuadMesh* mesh = (QuadMesh*) geom;
+        for (size_t j=0; j<mesh->numQuads; j++) bounds.extend(mesh->bounds(j));
+        break;
+      }
+      case USER_GEOMETRY: 
+      case INSTANCES: {
+        UserGeometryScene::Base* set = (UserGeometryScene::Base*) geom;
+        for (size_t j=0; j<set->blocks(); j++) bounds.extend(set->blockBounds(j));
+        break;
+      }
+      }
+    }
+    return bounds;
+  }
+
+  /*! Intersectors of deferred scenes. They build the scene when the
+   *  first ray reaches it and then forward to the intersectors of
+   *  the built acceleration structure. */
+  static void deferredIntersect1 (Scene* scene, RTCRay& ray) {
+    scene->buildDeferred();
+    scene->deferredIntersectors.intersector1.intersect(scene->deferredIntersectors.ptr,ray);
+  }
+
+  static void deferredOccluded1 (Scene* scene, RTCRay& ray) {
+    scene->buildDeferred();
+    scene->deferredIntersectors.intersector1.occluded(scene->deferredIntersectors.ptr,ray);
+  }
+
+  static void deferredIntersect4 (const void* valid, Scene* scene, RTCRay4& ray) {
+    scene->buildDeferred();
+    scene->deferredIntersectors.intersector4.intersect(valid,scene->deferredIntersectors.ptr,ray);
+  }
+
+  static void deferredOccluded4 (const void* valid, Scene* scene, RTCRay4& ray) {
+    scene->buildDeferred();
+    scene->deferredIntersectors.intersector4.occluded(valid,scene->deferredIntersectors.ptr,ray);
+  }
+
+  static void deferredIntersect8 (const void* valid, Scene* scene, RTCRay8& ray) {
+    scene->buildDeferred();
+    scene->deferredIntersectors.intersector8.intersect(valid,scene->deferredIntersectors.ptr,ray);
+  }
+
+  static void deferredOccluded8 (const void* valid, Scene* scene, RTCRay8& ray) {
+    scene->buildDeferred();
+    scene->deferredIntersectors.intersector8.occluded(valid,scene->deferredIntersectors.ptr,ray);
+  }
+
+  static void deferredIntersect16 (const void* valid, Scene* scene, RTCRay16& ray) {
+    scene->buildDeferred();
+    scene->deferredIntersectors.intersector16.intersect(valid,scene->deferredIntersectors.ptr,ray);
+  }
+
+  static void deferredOccluded16 (const void* valid, Scene* scene, RTCRay16& ray) {
+    scene->buildDeferred();
+    scene->deferredIntersectors.intersector16.occluded(valid,scene->deferredIntersectors.ptr,ray);
+  }
+
+  static size_t deferredMultiHit (Scene* scene, const RTCRay& ray, RTCHit* hits, size_t k) 
+  {
+    scene->buildDeferred();
+    if (scene->deferredIntersectors.multiHit == NULL) {
+      recordError(RTC_INVALID_OPERATION);
+      return 0;
+    }
+    return scene->deferredIntersectors.multiHit(scene->deferredIntersectors.ptr,ray,hits,k);
+  }
+
+  static void deferredMultiHit8 (const void* valid, Scene* scene, const RTCRay8& ray, RTCHit* hits, size_t k, size_t* numHits) 
+  {
+    scene->buildDeferred();
+    if (scene->deferredIntersectors.multiHit8 == NULL) {
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+    scene->deferredIntersectors.multiHit8(valid,scene->deferredIntersectors.ptr,ray,hits,k,numHits);
+  }
+
+  static void deferredOccludedHint (Scene* scene, RTCRay& ray, RTCOccluderHint& hint) 
+  {
+    scene->buildDeferred();
+    if (scene->deferredIntersectors.occludedHint) scene->deferredIntersectors.occludedHint(scene->deferredIntersectors.ptr,ray,hint);
+    else scene->deferredIntersectors.intersector1.occluded(scene->deferredIntersectors.ptr,ray);
+  }
+
+  void Scene::executeDeferredBuild ()
+  {
+    /* only the first thread that reaches the scene builds it */
+    deferredMutex.lock();
+    if (!deferredPending) {
+      deferredMutex.unlock();
+      return;
+    }
+
+    /* the build may run on the worker threads, thus waiting worker
+     * threads help with the pending tasks while any other thread
+     * sleeps until the build finished */
+    if (deferredBuilding) 
+    {
+      if (TaskScheduler::isWorkerThread()) {
+        deferredMutex.unlock();
+        while (deferredPending) 
+          if (!TaskScheduler::runPendingTask()) yield();
+      } 
+      else {
+        while (deferredPending) deferredCondition.wait(deferredMutex);
+        deferredMutex.unlock();
+      }
+      return;
+    }
+    deferredBuilding = true;
+    deferredMutex.unlock();
+
+    /* a ray traced inside a task of the worker threads builds the
+     * scene itself as the other workers may wait for that task */
+    if (TaskScheduler::isWorkerThread()) 
+    {
+      const bool executeInline = TaskScheduler::executeInline(true);
+      build(0,1);
+      TaskScheduler::executeInline(executeInline);
+    }
+
+    /* any other thread lets the worker threads build the scene like rtcCommit */
+    else 
+    {
+      TaskScheduler::EventSync event;
+      TaskScheduler::Task task(&event,NULL,NULL,1,_task_build,this,"scene_build_deferred");
+      TaskScheduler::addTask(-1,TaskScheduler::GLOBAL_FRONT,&task);
+      event.sync();
+    }
+
+    /* make static geometry immutable */
+    if (isStatic()) 
+    {
+      accels.immutable();
+      for (size_t i=0; i<geometries.size(); i++)
+        geometries[i]->immutable();
+    }
+
+    /* wake up the threads waiting for the build */
+    Lock<MutexSys> lock(deferredMutex);
+    deferredIntersectors = accels.intersectors;
+    __memory_barrier();
+    deferredPending = false;
+    deferredBuilding = false;
+    deferredCondition.broadcast();
+  }
+
   void Scene::build () 
   {
     Lock<MutexSys> lock(mutex);
@@ -275,18 +984,32 @@ namespace embree
     }
 #endif
 
-    /* spawn build task */
-    TaskScheduler::EventSync event;
-    new (&task) TaskScheduler::Task(&event,NULL,NULL,1,_task_build,this,"scene_build");
-    TaskScheduler::addTask(-1,TaskScheduler::GLOBAL_FRONT,&task);
-    event.sync();
+    /* propagate changes of nested instanced scenes */
+    std::set<const Scene*> visited;
+    commitInstancedScenes(visited);
 
-    /* make static geometry immutable */
-    if (isStatic()) 
+    createPointAndQuadAccels();
+
+    /* deferred scenes get built by the first ray that reaches them */
+    if (isDeferred()) {
+      deferredPending = true;
+    }
+
+    /* spawn build task */
+    else 
     {
-      accels.immutable();
-      for (size_t i=0; i<geometries.size(); i++)
-        geometries[i]->immutable();
+      TaskScheduler::EventSync event;
+      new (&task) TaskScheduler::Task(&event,NULL,NULL,1,_task_build,this,"scene_build");
+      TaskScheduler::addTask(-1,TaskScheduler::GLOBAL_FRONT,&task);
+      event.sync();
+      
+      /* make static geometry immutable */
+      if (isStatic()) 
+      {
+        accels.immutable();
+        for (size_t i=0; i<geometries.size(); i++)
+          geometries[i]->immutable();
+      }
     }
 
     /* delete geometry that is scheduled for delete */
@@ -297,10 +1020,46 @@ namespace embree
       remove(geom);
     }
 
+    /* remember which commits of the instanced scenes got built */
+    for (size_t i=0; i<geometries.size(); i++) 
+    {
+      Geometry* geom = geometries[i];
+      if (geom == NULL || geom->type != INSTANCES) continue;
+      UserGeometryScene::Instance* instance = (UserGeometryScene::Instance*) geom;
+      instance->objectCommitCounter = ((Scene*) instance->object)->commitCounter;
+      instance->objectMask = ((Scene*) instance->object)->mask;
+    }
+
+    /* rays can only hit geometries of this scene if their mask matches one of the geometry masks */
+    mask = 0;
+    for (size_t i=0; i<geometries.size(); i++) 
+    {
+      Geometry* geom = geometries[i];
+      if (geom == NULL || !geom->isEnabled()) continue;
+      mask |= geom->getMask();
+    }
+
     /* update bounds */
-    bounds = accels.bounds;
-    intersectors = accels.intersectors;
+    if (isDeferred()) 
+    {
+      bounds = geometryBounds();
+      intersectors = Intersectors();
+      intersectors.ptr = this;
+      intersectors.intersector1  = Intersector1 ((IntersectFunc  )deferredIntersect1, (OccludedFunc  )deferredOccluded1, "deferred::intersector1");
+      intersectors.intersector4  = Intersector4 ((IntersectFunc4 )deferredIntersect4, (OccludedFunc4 )deferredOccluded4, "deferred::intersector4");
+      intersectors.intersector8  = Intersector8 ((IntersectFunc8 )deferredIntersect8, (OccludedFunc8 )deferredOccluded8, "deferred::intersector8");
+      intersectors.intersector16 = Intersector16((IntersectFunc16)deferredIntersect16,(OccludedFunc16)deferredOccluded16,"deferred::intersector16");
+      intersectors.multiHit = (MultiHitFunc) deferredMultiHit;
+      intersectors.multiHit8 = (MultiHit8Func) deferredMultiHit8;
+      intersectors.occludedHint = (OccludedHintFunc) deferredOccludedHint;
+    }
+    else 
+    {
+      bounds = accels.bounds;
+      intersectors = accels.intersectors;
+    }
     is_build = true;
+    commitCounter++;
 
     /* enable only algorithms choosen by application */
     if ((aflags & RTC_INTERSECT1) == 0) {
@@ -18,12 +18,15 @@
 #define __EMBREE_SCENE_H__
 
 #include "common/default.h"
+#include "sys/sync/condition.h"
 
 #include "scene_triangle_mesh.h"
 #include "scene_user_geometry.h"
 #include "scene_quadratic_bezier_curves.h"
+#include "scene_points.h"
+#include "scene_quad_mesh.h"
 
-#include "common/accel3.h"
+#include "common/accelN.h"
 #include "geometry.h"
 #include "common/buildsource.h"
 
@@ -36,6 +39,8 @@ namespace embree
   public:
 
     typedef TriangleMeshScene::TriangleMesh TriangleMesh;
+    typedef PointsScene::Points Points;
+    typedef QuadMeshScene::QuadMesh QuadMesh;
     
     /*! Scene construction */
     Scene (RTCSceneFlags flags, RTCAlgorithmFlags aflags);
@@ -46,8 +51,11 @@ namespace embree
     /*! Creates new user geometry. */
     unsigned int newUserGeometry (size_t items);
 
-    /*! Creates a new scene instance. */
-    unsigned int newInstance (Scene* scene);
+    /*! Creates a new scene instance. Scenes that contain instances
+     *  can get instanced again, but instancing a scene that contains
+     *  this scene fails. Instances with multiple time steps
+     *  interpolate their transformations by the ray time. */
+    unsigned int newInstance (Scene* scene, size_t numTimeSteps);
 
     /*! Creates a new triangle mesh. */
     unsigned int newTriangleMesh (RTCGeometryFlags flags, size_t maxTriangles, size_t maxVertices, size_t numTimeSteps);
@@ -55,11 +63,72 @@ namespace embree
     /*! Creates a new collection of quadratic bezier curves. */
     unsigned int newQuadraticBezierCurves (RTCGeometryFlags flags, size_t maxCurves, size_t maxVertices, size_t numTimeSteps);
 
+    /*! Creates a new quad mesh. */
+    unsigned int newQuadMesh (RTCGeometryFlags flags, size_t maxQuads, size_t maxVertices);
+
+    /*! Creates a new set of spheres or discs. */
+    unsigned int newPoints (RTCGeometryFlags flags, RTCPointType type, size_t numPoints);
+
     /*! Builds acceleration structure for the scene. */
     void build ();
 
     void build (size_t threadIndex, size_t threadCount);
 
+    /*! Builds the acceleration structure of a deferred scene if it did
+     *  not get built since the last commit. */
+    __forceinline void buildDeferred () {
+      if (unlikely(deferredPending)) executeDeferredBuild();
+    }
+
+    /*! Builds the acceleration structure of a deferred scene, other
+     *  threads tracing rays into the scene wait for the build to finish. */
+    void executeDeferredBuild ();
+
+    /*! Returns the bounds of all enabled geometries, calculated without
+     *  building an acceleration structure. */
+    BBox3f geometryBounds ();
+
+    /*! Returns the optional kernel features the geometries of the
+     *  scene require, see KernelFeatures. */
+    int kernelFeatures ();
+
+    /*! Finds the triangle closest to the query point, returns false
+     *  if the triangle acceleration structure does not support point
+     *  queries or the scene contains other geometry types. */
+    bool pointQuery (PointQuery& query);
+
+    /*! Reports all pairs of overlapping triangles of this scene and
+     *  the other scene transformed by xfm1, returns false if the
+     *  triangle acceleration structures do not support collision
+     *  queries or one of the scenes contains other geometry types. */
+    bool collide (Scene* other, const AffineSpace3f* xfm1, RTCCollideFunc callback, void* userPtr);
+
+    /*! Tests visibility between each pair of a set of points and a
+     *  set of targets, see rtcOccludedMatrix. */
+    void occludedMatrix (const char* points, size_t numPoints, size_t pointStride, 
+                         const char* targets, size_t numTargets, size_t targetStride, 
+                         float eps, unsigned int* occluded);
+
+    /*! Tests if this scene contains an instance of the scene, directly
+     *  or through nested instances. */
+    bool instances (const Scene* scene, std::set<const Scene*>& visited) const;
+
+    /*! Commits again all instanced scenes, directly or through nested
+     *  instances, that instance a scene that got committed after
+     *  them, such that their bounds get propagated up to this
+     *  scene. Static scenes cannot get committed again and are
+     *  skipped. */
+    void commitInstancedScenes (std::set<const Scene*>& visited);
+
+    /*! Creates the point and quad acceleration structures once the
+     *  scene contains geometry of that type, such that scenes without
+     *  points or quads do not pay for them at commit and traversal. */
+    void createPointAndQuadAccels ();
+
+    /*! Builds all candidate triangle acceleration structures, measures
+     *  a sampled ray workload on each, and keeps the fastest one. */
+    void autotune (size_t threadIndex, size_t threadCount);
+
     /*! build task */
     TASK_COMPLETE_FUNCTION(Scene,task_build);
     TaskScheduler::Task task;
@@ -105,6 +174,18 @@ namespace embree
       if (geometries[i]->type != TRIANGLE_MESH) return NULL;
       else return (TriangleMesh*) geometries[i]; 
     }
+    __forceinline Points* getPoints(size_t i) { 
+      assert(i < geometries.size()); 
+      assert(geometries[i]);
+      assert(geometries[i]->type == POINTS);
+      return (Points*) geometries[i]; 
+    }
+    __forceinline QuadMesh* getQuadMesh(size_t i) { 
+      assert(i < geometries.size()); 
+      assert(geometries[i]);
+      assert(geometries[i]->type == QUAD_MESH);
+      return (QuadMesh*) geometries[i]; 
+    }
     __forceinline UserGeometryScene::Base* getUserGeometrySafe(size_t i) { 
       assert(i < geometries.size()); 
       if (geometries[i] == NULL) return NULL;
@@ -123,10 +204,15 @@ namespace embree
     __forceinline bool isCoherent() const { return embree::isCoherent(flags); }
     __forceinline bool isRobust() const { return embree::isRobust(flags); }
     __forceinline bool isHighQuality() const { return embree::isHighQuality(flags); }
+    __forceinline bool isAutotune() const { return embree::isAutotune(flags); }
+    __forceinline bool isDeferred() const { return embree::isDeferred(flags); }
 
     /* test if scene got already build */
     __forceinline bool isBuild() const { return is_build; }
 
+    /* test if the triangle kernels of the scene invoke filter functions */
+    __forceinline bool supportsFilterFunctions() const { return filterFunctions; }
+
     struct FlatTriangleAccelBuildSource : public BuildSource
     {
       FlatTriangleAccelBuildSource (Scene* scene, size_t numTimeSteps = 1)
@@ -203,19 +289,114 @@ namespace embree
       size_t numTimeSteps;
     };
 
+
+    struct FlatPointAccelBuildSource : public BuildSource
+    {
+      FlatPointAccelBuildSource (Scene* scene)
+        : scene(scene) {}
+
+      bool isEmpty () const { 
+        return scene->numPointSets == 0;
+      }
+      
+      size_t groups () const { 
+        return scene->geometries.size();
+      }
+      
+      size_t prims (size_t group, size_t* numVertices) const 
+      {
+        if (scene->get(group) == NULL || scene->get(group)->type != POINTS) return 0;
+        Points* points = scene->getPoints(group);
+        if (!points->isEnabled()) return 0;
+        if (numVertices) *numVertices = points->numPoints;
+        return points->numPoints;
+      }
+
+      const BBox3f bounds(size_t group, size_t prim) const 
+      {
+        assert(scene->get(group) != NULL);
+        assert(scene->get(group)->type == POINTS);
+        return scene->getPoints(group)->bounds(prim);
+      }
+
+      void bounds(size_t group, size_t begin, size_t end, BBox3f* bounds_o) const 
+      {
+        assert(scene->get(group) != NULL);
+        assert(scene->get(group)->type == POINTS);
+
+        Points* points = scene->getPoints(group);
+        for (size_t i=begin; i<end; i++)
+          bounds_o[i-begin] = points->bounds(i);
+      }
+
+    public:
+      Scene* scene;
+    };
+
+    struct FlatQuadAccelBuildSource : public BuildSource
+    {
+      FlatQuadAccelBuildSource (Scene* scene)
+        : scene(scene) {}
+
+      bool isEmpty () const { 
+        return scene->numQuadMeshes == 0;
+      }
+      
+      size_t groups () const { 
+        return scene->geometries.size();
+      }
+      
+      size_t prims (size_t group, size_t* numVertices) const 
+      {
+        if (scene->get(group) == NULL || scene->get(group)->type != QUAD_MESH) return 0;
+        QuadMesh* mesh = scene->getQuadMesh(group);
+        if (!mesh->isEnabled()) return 0;
+        if (numVertices) *numVertices = mesh->numVertices;
+        return mesh->numQuads;
+      }
+
+      const BBox3f bounds(size_t group, size_t prim) const 
+      {
+        assert(scene->get(group) != NULL);
+        assert(scene->get(group)->type == QUAD_MESH);
+        return scene->getQuadMesh(group)->bounds(prim);
+      }
+
+      void bounds(size_t group, size_t begin, size_t end, BBox3f* bounds_o) const 
+      {
+        assert(scene->get(group) != NULL);
+        assert(scene->get(group)->type == QUAD_MESH);
+
+        QuadMesh* mesh = scene->getQuadMesh(group);
+        for (size_t i=begin; i<end; i++)
+          bounds_o[i-begin] = mesh->bounds(i);
+      }
+
+    public:
+      Scene* scene;
+    };
     
   public:
     std::vector<int> usedIDs;
     std::vector<Geometry*> geometries; //!< list of all user geometries
     
   public:
-    Accel3 accels;
+    AccelN accels;
+    std::string accelName;             //!< name of the selected triangle acceleration structure
     atomic_t numMappedBuffers;         //!< number of mapped buffers
     RTCSceneFlags flags;
     RTCAlgorithmFlags aflags;
     bool needTriangles;
     bool needVertices;
     bool is_build;
+    bool filterFunctions;              //!< true if the triangle kernels of the scene invoke filter functions
+    size_t commitCounter;              //!< number of commits of this scene
+    unsigned mask;                     //!< union of the ray masks of all enabled geometries
+    volatile bool deferredPending;     //!< true if a deferred scene did not get built since the last commit
+    Intersectors deferredIntersectors; //!< intersectors of a deferred scene once it got built
+    volatile bool deferredBuilding;    //!< true while the first ray that reached a deferred scene builds it
+    MutexSys deferredMutex;            //!< lets only the first ray that reaches a deferred scene build it
+    ConditionSys deferredCondition;    //!< signals the end of the build of a deferred scene
     MutexSys mutex;
     AtomicMutex geometriesMutex;
 
@@ -223,10 +404,14 @@ namespace embree
     atomic_t numTriangleMeshes;        //!< number of enabled triangle meshes
     atomic_t numTriangleMeshes2;       //!< number of enabled motion blur triangle meshes
     atomic_t numUserGeometries;        //!< number of enabled user geometries
+    atomic_t numPointSets;             //!< number of enabled point sets
+    atomic_t numQuadMeshes;            //!< number of enabled quad meshes
     
   public:
     FlatTriangleAccelBuildSource flat_triangle_source_1;
     FlatTriangleAccelBuildSource flat_triangle_source_2;
+    FlatPointAccelBuildSource flat_point_source;
+    FlatQuadAccelBuildSource flat_quad_source;
   };
 
   typedef Builder* (*TriangleMeshBuilderFunc)(void* accel, TriangleMeshScene::TriangleMesh* mesh, const size_t minLeafSize, const size_t maxLeafSize);
@@ -0,0 +1,152 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "scene_points.h"
+#include "scene.h"
+
+namespace embree
+{
+  PointsScene::Points::Points (Scene* parent, RTCGeometryFlags flags, RTCPointType pointType, size_t numPoints)
+    : Geometry(parent,POINTS,numPoints,flags), mask(-1), built(false), pointType(pointType),
+      vertices(NULL), numPoints(numPoints), mappedVertices(false)
+  {
+    vertices = (Vertex*) alignedMalloc(numPoints*sizeof(Vertex));
+    enabling();
+  }
+
+  void PointsScene::Points::enabling() {
+    atomic_add(&parent->numPointSets,1);
+  }
+
+  void PointsScene::Points::disabling() {
+    atomic_add(&parent->numPointSets,-1);
+  }
+
+  PointsScene::Points::~Points () {
+    alignedFree(vertices);
+  }
+
+  void PointsScene::Points::setMask (unsigned mask)
+  {
+    if (parent->isStatic() && parent->isBuild()) {
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+    this->mask = mask;
+  }
+
+  void PointsScene::Points::enable ()
+  {
+    if (parent->isStatic() || anyMappedBuffers()) {
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+    Geometry::enable();
+  }
+
+  void PointsScene::Points::update ()
+  {
+    if (parent->isStatic() || anyMappedBuffers()) {
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+    Geometry::update();
+  }
+
+  void PointsScene::Points::disable ()
+  {
+    if (parent->isStatic() || anyMappedBuffers()) {
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+    Geometry::disable();
+  }
+
+  void PointsScene::Points::erase ()
+  {
+    if (parent->isStatic() || anyMappedBuffers()) {
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+    Geometry::erase();
+  }
+
+  void* PointsScene::Points::map(RTCBufferType type)
+  {
+    if (parent->isStatic() && parent->isBuild()) {
+      recordError(RTC_INVALID_OPERATION);
+      return NULL;
+    }
+
+    switch (type) {
+    case RTC_VERTEX_BUFFER:
+    {
+      if (mappedVertices) {
+        recordError(RTC_INVALID_OPERATION);
+        return NULL;
+      }
+      mappedVertices = true;
+      atomic_add(&parent->numMappedBuffers,1);
+      return vertices;
+    }
+    default:
+      recordError(RTC_INVALID_ARGUMENT);
+      return NULL;
+    }
+  }
+
+  void PointsScene::Points::unmap(RTCBufferType type)
+  {
+    if (parent->isStatic() && parent->isBuild()) {
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+
+    switch (type) {
+    case RTC_VERTEX_BUFFER:
+    {
+      if (mappedVertices) {
+        mappedVertices = false;
+        atomic_add(&parent->numMappedBuffers,-1);
+      } else {
+        recordError(RTC_INVALID_OPERATION);
+      }
+      break;
+    }
+    default:
+      recordError(RTC_INVALID_ARGUMENT);
+    }
+  }
+
+  void PointsScene::Points::immutable ()
+  {
+    /* the point leaves store a copy of all centers and radii */
+    built = true;
+    alignedFree(vertices); vertices = NULL;
+  }
+
+  bool PointsScene::Points::verify ()
+  {
+    float range = sqrtf(0.5f*FLT_MAX);
+    for (size_t i=0; i<numPoints; i++) {
+      if (vertices[i].x < -range || vertices[i].x > range) return false;
+      if (vertices[i].y < -range || vertices[i].y > range) return false;
+      if (vertices[i].z < -range || vertices[i].z > range) return false;
+      if (!(vertices[i].r >= 0.0f) || vertices[i].r > range) return false;
+    }
+    return true;
+  }
+}
@@ -0,0 +1,89 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#ifndef __EMBREE_POINTS_SCENE_H__
+#define __EMBREE_POINTS_SCENE_H__
+
+#include "common/default.h"
+#include "common/geometry.h"
+
+namespace embree
+{
+  namespace PointsScene
+  {
+    /*! Set of points, each point is a sphere or ray facing disc
+     *  specified by a center and a radius. */
+    struct Points : public Geometry
+    {
+      struct Vertex {
+        float x,y,z,r;
+      };
+
+    public:
+      Points (Scene* parent, RTCGeometryFlags flags, RTCPointType pointType, size_t numPoints);
+      ~Points ();
+
+    public:
+      void setMask (unsigned mask);
+      unsigned getMask () const { return mask; }
+      void enable ();
+      void update ();
+      void disable ();
+      void erase ();
+      void immutable ();
+      bool verify ();
+      void* map(RTCBufferType type);
+      void unmap(RTCBufferType type);
+      void enabling();
+      void disabling();
+
+    public:
+
+      __forceinline const Vec3fa& vertex(size_t i) const {
+        assert(i < numPoints);
+        return (Vec3fa&)vertices[i];
+      }
+
+      __forceinline float radius(size_t i) const {
+        assert(i < numPoints);
+        return vertices[i].r;
+      }
+
+      __forceinline BBox3f bounds(size_t i) const {
+        return enlarge(BBox3f(vertex(i)),Vec3fa(radius(i)));
+      }
+
+      __forceinline bool isDisc() const {
+        return pointType == RTC_POINT_DISC;
+      }
+
+      __forceinline bool anyMappedBuffers() const {
+        return mappedVertices;
+      }
+
+    public:
+      unsigned mask;              //!< for masking out geometry
+      bool built;                 //!< geometry got built
+      RTCPointType pointType;     //!< spheres or discs
+
+      Vertex* vertices;           //!< array of centers and radii
+      size_t numPoints;           //!< number of points in array
+      bool mappedVertices;        //!< is vertices buffer mapped?
+    };
+  }
+}
+
+#endif
@@ -0,0 +1,182 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "scene_quad_mesh.h"
+#include "scene.h"
+
+namespace embree
+{
+  QuadMeshScene::QuadMesh::QuadMesh (Scene* parent, RTCGeometryFlags flags, size_t numQuads, size_t numVertices)
+    : Geometry(parent,QUAD_MESH,numQuads,flags), mask(-1), built(false),
+      quads(NULL), numQuads(numQuads), mappedQuads(false),
+      vertices(NULL), numVertices(numVertices), mappedVertices(false)
+  {
+    quads = (Quad*) alignedMalloc(numQuads*sizeof(Quad));
+    vertices = (Vec3fa*) alignedMalloc(numVertices*sizeof(Vec3fa));
+    enabling();
+  }
+
+  void QuadMeshScene::QuadMesh::enabling() {
+    atomic_add(&parent->numQuadMeshes,1);
+  }
+
+  void QuadMeshScene::QuadMesh::disabling() {
+    atomic_add(&parent->numQuadMeshes,-1);
+  }
+
+  QuadMeshScene::QuadMesh::~QuadMesh () 
+  {
+    alignedFree(quads);
+    alignedFree(vertices);
+  }
+
+  void QuadMeshScene::QuadMesh::setMask (unsigned mask)
+  {
+    if (parent->isStatic() && parent->isBuild()) {
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+    this->mask = mask;
+  }
+
+  void QuadMeshScene::QuadMesh::enable ()
+  {
+    if (parent->isStatic() || anyMappedBuffers()) {
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+    Geometry::enable();
+  }
+
+  void QuadMeshScene::QuadMesh::update ()
+  {
+    if (parent->isStatic() || anyMappedBuffers()) {
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+    Geometry::update();
+  }
+
+  void QuadMeshScene::QuadMesh::disable ()
+  {
+    if (parent->isStatic() || anyMappedBuffers()) {
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+    Geometry::disable();
+  }
+
+  void QuadMeshScene::QuadMesh::erase ()
+  {
+    if (parent->isStatic() || anyMappedBuffers()) {
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+    Geometry::erase();
+  }
+
+  void* QuadMeshScene::QuadMesh::map(RTCBufferType type)
+  {
+    if (parent->isStatic() && parent->isBuild()) {
+      recordError(RTC_INVALID_OPERATION);
+      return NULL;
+    }
+
+    switch (type) {
+    case RTC_INDEX_BUFFER:
+    {
+      if (mappedQuads) {
+        recordError(RTC_INVALID_OPERATION);
+        return NULL;
+      }
+      mappedQuads = true;
+      atomic_add(&parent->numMappedBuffers,1);
+      return quads;
+    }
+    case RTC_VERTEX_BUFFER:
+    {
+      if (mappedVertices) {
+        recordError(RTC_INVALID_OPERATION);
+        return NULL;
+      }
+      mappedVertices = true;
+      atomic_add(&parent->numMappedBuffers,1);
+      return vertices;
+    }
+    default:
+      recordError(RTC_INVALID_ARGUMENT);
+      return NULL;
+    }
+  }
+
+  void QuadMeshScene::QuadMesh::unmap(RTCBufferType type)
+  {
+    if (parent->isStatic() && parent->isBuild()) {
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+
+    switch (type) {
+    case RTC_INDEX_BUFFER:
+    {
+      if (mappedQuads) {
+        mappedQuads = false;
+        atomic_add(&parent->numMappedBuffers,-1);
+      } else {
+        recordError(RTC_INVALID_OPERATION);
+      }
+      break;
+    }
+    case RTC_VERTEX_BUFFER:
+    {
+      if (mappedVertices) {
+        mappedVertices = false;
+        atomic_add(&parent->numMappedBuffers,-1);
+      } else {
+        recordError(RTC_INVALID_OPERATION);
+      }
+      break;
+    }
+    default:
+      recordError(RTC_INVALID_ARGUMENT);
+    }
+  }
+
+  void QuadMeshScene::QuadMesh::immutable ()
+  {
+    /* the quad leaves store a copy of all vertices */
+    built = true;
+    alignedFree(quads); quads = NULL;
+    alignedFree(vertices); vertices = NULL;
+  }
+
+  bool QuadMeshScene::QuadMesh::verify ()
+  {
+    float range = sqrtf(0.5f*FLT_MAX);
+    for (size_t i=0; i<numQuads; i++) {
+      if (quads[i].v[0] >= numVertices) return false;
+      if (quads[i].v[1] >= numVertices) return false;
+      if (quads[i].v[2] >= numVertices) return false;
+      if (quads[i].v[3] >= numVertices) return false;
+    }
+    for (size_t i=0; i<numVertices; i++) {
+      if (vertices[i].x < -range || vertices[i].x > range) return false;
+      if (vertices[i].y < -range || vertices[i].y > range) return false;
+      if (vertices[i].z < -range || vertices[i].z > range) return false;
+    }
+    return true;
+  }
+}
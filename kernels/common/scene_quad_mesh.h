@@ -0,0 +1,95 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#ifndef __EMBREE_QUAD_MESH_SCENE_H__
+#define __EMBREE_QUAD_MESH_SCENE_H__
+
+#include "common/default.h"
+#include "common/geometry.h"
+
+namespace embree
+{
+  namespace QuadMeshScene
+  {
+    /*! Quad Mesh. Each quad (v0,v1,v2,v3) is intersected as the two
+     *  triangles (v0,v1,v3) and (v2,v3,v1) that share the diagonal
+     *  v1-v3. Degenerated quads with v2 == v3 are triangles. */
+    struct QuadMesh : public Geometry
+    {
+      struct Quad {
+        unsigned int v[4];
+      };
+
+    public:
+      QuadMesh (Scene* parent, RTCGeometryFlags flags, size_t numQuads, size_t numVertices);
+      ~QuadMesh ();
+
+    public:
+      void setMask (unsigned mask);
+      unsigned getMask () const { return mask; }
+      void enable ();
+      void update ();
+      void disable ();
+      void erase ();
+      void immutable ();
+      bool verify ();
+      void* map(RTCBufferType type);
+      void unmap(RTCBufferType type);
+      void enabling();
+      void disabling();
+
+    public:
+
+      __forceinline const Quad& quad(size_t i) const {
+        assert(i < numQuads);
+        return quads[i];
+      }
+
+      __forceinline const Vec3fa& vertex(size_t i) const {
+        assert(i < numVertices);
+        return vertices[i];
+      }
+
+      __forceinline BBox3f bounds(size_t index) const 
+      {
+        const Quad& q = quad(index);
+        const Vec3fa& v0 = vertex(q.v[0]);
+        const Vec3fa& v1 = vertex(q.v[1]);
+        const Vec3fa& v2 = vertex(q.v[2]);
+        const Vec3fa& v3 = vertex(q.v[3]);
+        return BBox3f( min(min(v0,v1),min(v2,v3)), max(max(v0,v1),max(v2,v3)) );
+      }
+
+      __forceinline bool anyMappedBuffers() const {
+        return mappedQuads || mappedVertices;
+      }
+
+    public:
+      unsigned mask;              //!< for masking out geometry
+      bool built;                 //!< geometry got built
+
+      Quad* quads;                //!< array of quads
+      size_t numQuads;            //!< number of quads in array
+      bool mappedQuads;           //!< is index buffer mapped?
+
+      Vec3fa* vertices;           //!< array of vertices, has to be aligned to 16 bytes
+      size_t numVertices;         //!< number of vertices in array
+      bool mappedVertices;        //!< is vertex buffer mapped?
+    };
+  }
+}
+
+#endif
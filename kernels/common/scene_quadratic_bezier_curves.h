@@ -41,6 +41,7 @@ namespace embree
       
     public:
       void setMask (unsigned mask);
+      unsigned getMask () const { return mask; }
       void enable ();
       void update ();
       void disable ();
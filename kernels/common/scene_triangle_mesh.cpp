@@ -69,6 +69,52 @@ namespace embree
     this->mask = mask; 
   }
 
+  void TriangleMeshScene::TriangleMesh::setUserData (void* ptr, bool ispc) 
+  {
+    if (ispc) {
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+    userPtr = ptr;
+  }
+
+  /*! filter functions of static scenes cannot change after the
+   *  commit, and the triangle kernels of the scene have to support
+   *  filter functions at all */
+  template<typename Filter>
+  static void setFilterFunction (Scene* parent, Filter& dst, Filter src)
+  {
+    if ((parent->isStatic() && parent->isBuild()) || !parent->supportsFilterFunctions()) {
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+    dst = src;
+  }
+
+  void TriangleMeshScene::TriangleMesh::setIntersectionFilterFunction (RTCFilterFunc filter) {
+    setFilterFunction(parent,intersectionFilter1,filter);
+  }
+
+  void TriangleMeshScene::TriangleMesh::setIntersectionFilterFunction4 (RTCFilterFunc4 filter4) {
+    setFilterFunction(parent,intersectionFilter4,filter4);
+  }
+
+  void TriangleMeshScene::TriangleMesh::setIntersectionFilterFunction8 (RTCFilterFunc8 filter8) {
+    setFilterFunction(parent,intersectionFilter8,filter8);
+  }
+
+  void TriangleMeshScene::TriangleMesh::setOcclusionFilterFunction (RTCFilterFunc filter) {
+    setFilterFunction(parent,occlusionFilter1,filter);
+  }
+
+  void TriangleMeshScene::TriangleMesh::setOcclusionFilterFunction4 (RTCFilterFunc4 filter4) {
+    setFilterFunction(parent,occlusionFilter4,filter4);
+  }
+
+  void TriangleMeshScene::TriangleMesh::setOcclusionFilterFunction8 (RTCFilterFunc8 filter8) {
+    setFilterFunction(parent,occlusionFilter8,filter8);
+  }
+
   void TriangleMeshScene::TriangleMesh::enable () 
   {
     if (parent->isStatic() || anyMappedBuffers()) {
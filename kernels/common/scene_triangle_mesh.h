@@ -39,6 +39,14 @@ namespace embree
       
     public:
       void setMask (unsigned mask);
+      unsigned getMask () const { return mask; }
+      void setUserData (void* ptr, bool ispc);
+      void setIntersectionFilterFunction (RTCFilterFunc filter);
+      void setIntersectionFilterFunction4 (RTCFilterFunc4 filter4);
+      void setIntersectionFilterFunction8 (RTCFilterFunc8 filter8);
+      void setOcclusionFilterFunction (RTCFilterFunc filter);
+      void setOcclusionFilterFunction4 (RTCFilterFunc4 filter4);
+      void setOcclusionFilterFunction8 (RTCFilterFunc8 filter8);
       void enable ();
       void update ();
       void disable ();
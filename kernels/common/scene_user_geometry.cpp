@@ -151,14 +151,115 @@ namespace embree
     }
   }
 
+  void UserGeometryScene::UserGeometry::setBoundsRangeFunction (RTCBoundsRangeFunc bounds)
+  {
+    if (parent->isStatic() && parent->isBuild()) {
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+    this->boundsRangeFunc = bounds;
+    updateBlockSize();
+  }
+
+  void UserGeometryScene::UserGeometry::setIntersectRangeFunction (RTCIntersectRangeFunc intersect)
+  {
+    if (parent->isStatic() && parent->isBuild()) {
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+    intersectors.intersector1.intersectRange = intersect;
+    updateBlockSize();
+  }
+
+  void UserGeometryScene::UserGeometry::setIntersectRangeFunction4 (RTCIntersectRangeFunc4 intersect4)
+  {
+    if (parent->isStatic() && parent->isBuild()) {
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+    intersectors.intersector4.intersectRange = intersect4;
+    updateBlockSize();
+  }
+
+  void UserGeometryScene::UserGeometry::setIntersectRangeFunction8 (RTCIntersectRangeFunc8 intersect8)
+  {
+    if (parent->isStatic() && parent->isBuild()) {
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+    intersectors.intersector8.intersectRange = intersect8;
+    updateBlockSize();
+  }
+
+  void UserGeometryScene::UserGeometry::setIntersectRangeFunction16 (RTCIntersectRangeFunc16 intersect16)
+  {
+    if (parent->isStatic() && parent->isBuild()) {
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+    intersectors.intersector16.intersectRange = intersect16;
+    updateBlockSize();
+  }
+
+  void UserGeometryScene::UserGeometry::setOccludedRangeFunction (RTCOccludedRangeFunc occluded)
+  {
+    if (parent->isStatic() && parent->isBuild()) {
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+    intersectors.intersector1.occludedRange = occluded;
+    updateBlockSize();
+  }
+
+  void UserGeometryScene::UserGeometry::setOccludedRangeFunction4 (RTCOccludedRangeFunc4 occluded4)
+  {
+    if (parent->isStatic() && parent->isBuild()) {
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+    intersectors.intersector4.occludedRange = occluded4;
+    updateBlockSize();
+  }
+
+  void UserGeometryScene::UserGeometry::setOccludedRangeFunction8 (RTCOccludedRangeFunc8 occluded8)
+  {
+    if (parent->isStatic() && parent->isBuild()) {
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+    intersectors.intersector8.occludedRange = occluded8;
+    updateBlockSize();
+  }
+
+  void UserGeometryScene::UserGeometry::setOccludedRangeFunction16 (RTCOccludedRangeFunc16 occluded16)
+  {
+    if (parent->isStatic() && parent->isBuild()) {
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+    intersectors.intersector16.occludedRange = occluded16;
+    updateBlockSize();
+  }
+
+  void UserGeometryScene::UserGeometry::updateBlockSize ()
+  {
+    const bool ranged = boundsRangeFunc ||
+      intersectors.intersector1.intersectRange  || intersectors.intersector1.occludedRange  ||
+      intersectors.intersector4.intersectRange  || intersectors.intersector4.occludedRange  ||
+      intersectors.intersector8.intersectRange  || intersectors.intersector8.occludedRange  ||
+      intersectors.intersector16.intersectRange || intersectors.intersector16.occludedRange;
+    blockSize = ranged ? maxBlockSize : 1;
+  }
+
   extern RTCBoundsFunc InstanceBoundsFunc;
   extern AccelSet::Intersector1 InstanceIntersector1;
   extern AccelSet::Intersector4 InstanceIntersector4;
   extern AccelSet::Intersector8 InstanceIntersector8;
   extern AccelSet::Intersector16 InstanceIntersector16;
 
-  UserGeometryScene::Instance::Instance (Scene* parent, Accel* object) 
-    : Base(parent,INSTANCES,1), local2world(one), world2local(one), object(object)
+  UserGeometryScene::Instance::Instance (Scene* parent, Accel* object, size_t numTimeSteps) 
+    : Base(parent,INSTANCES,1), numTimeSteps(numTimeSteps), local2world(numTimeSteps,one), world2local(numTimeSteps,one), 
+      object(object), objectCommitCounter(0), mask(-1), objectMask(-1)
   {
     intersectors.ptr = this;
     intersectors.boundsPtr = this;
@@ -169,9 +270,22 @@ namespace embree
     intersectors.intersector16 = InstanceIntersector16;
   }
   
-  void UserGeometryScene::Instance::setTransform(AffineSpace3f& xfm)
+  void UserGeometryScene::Instance::setTransform(AffineSpace3f& xfm, size_t timeStep)
   {
-    local2world = xfm;
-    world2local = rcp(xfm);
+    if (timeStep >= numTimeSteps) {
+      recordError(RTC_INVALID_OPERATION); 
+      return;
+    }
+    local2world[timeStep] = xfm;
+    world2local[timeStep] = rcp(xfm);
+  }
+
+  void UserGeometryScene::Instance::setMask (unsigned mask) 
+  {
+    if (parent->isStatic() && parent->isBuild()) {
+      recordError(RTC_INVALID_OPERATION);
+      return;
+    }
+    this->mask = mask; 
   }
 }
@@ -50,8 +50,21 @@ namespace embree
       virtual void setOccludedFunction4 (RTCOccludedFunc4 occluded4, bool ispc);
       virtual void setOccludedFunction8 (RTCOccludedFunc8 occluded8, bool ispc);
       virtual void setOccludedFunction16 (RTCOccludedFunc16 occluded16, bool ispc);
+      virtual void setBoundsRangeFunction (RTCBoundsRangeFunc bounds);
+      virtual void setIntersectRangeFunction (RTCIntersectRangeFunc intersect);
+      virtual void setIntersectRangeFunction4 (RTCIntersectRangeFunc4 intersect4);
+      virtual void setIntersectRangeFunction8 (RTCIntersectRangeFunc8 intersect8);
+      virtual void setIntersectRangeFunction16 (RTCIntersectRangeFunc16 intersect16);
+      virtual void setOccludedRangeFunction (RTCOccludedRangeFunc occluded);
+      virtual void setOccludedRangeFunction4 (RTCOccludedRangeFunc4 occluded4);
+      virtual void setOccludedRangeFunction8 (RTCOccludedRangeFunc8 occluded8);
+      virtual void setOccludedRangeFunction16 (RTCOccludedRangeFunc16 occluded16);
       virtual void build(size_t threadIndex, size_t threadCount) {}
 
+    private:
+      /*! groups items into blocks as soon as some range function is set */
+      void updateBlockSize ();
+
     public:
       void* ispcPtr;
       void* ispcIntersect1;
@@ -67,14 +80,62 @@ namespace embree
     struct Instance : public Base
     {
     public:
-      Instance (Scene* parent, Accel* object); 
-      virtual void setTransform(AffineSpace3f& local2world);
+      Instance (Scene* parent, Accel* object, size_t numTimeSteps); 
+      virtual void setTransform(AffineSpace3f& local2world, size_t timeStep);
+      virtual void setMask (unsigned mask);
+      virtual unsigned getMask () const { return objectMask; }
       virtual void build(size_t threadIndex, size_t threadCount) {}
+
+      /*! returns the world to local transformation at the given time, keys are linearly interpolated */
+      __forceinline AffineSpace3f getWorld2Local(float time) const
+      {
+        if (numTimeSteps == 1) return world2local[0];
+        const float t = clamp(time,0.0f,1.0f)*float(numTimeSteps-1);
+        const size_t i = min(size_t(t),numTimeSteps-2);
+        const float f = t-float(i);
+        return rcp((1.0f-f)*local2world[i]+f*local2world[i+1]);
+      }
+
+      /*! returns the world to local transformations of a ray packet */
+      template<typename AffineSpaceN, typename floatN>
+        __forceinline AffineSpaceN getWorld2Local(const floatN& time) const
+      {
+        if (numTimeSteps == 1) return AffineSpaceN(world2local[0]);
+        if (numTimeSteps == 2) {
+          const floatN f = max(min(time,floatN(1.0f)),floatN(zero));
+          return rcp((floatN(one)-f)*AffineSpaceN(local2world[0])+f*AffineSpaceN(local2world[1]));
+        }
+
+        /* gather the keys around the time of each ray */
+        floatN f; AffineSpaceN xfm0, xfm1;
+        for (size_t k=0; k<sizeof(floatN)/sizeof(float); k++) {
+          const float t = clamp(time[k],0.0f,1.0f)*float(numTimeSteps-1);
+          const size_t i = min(size_t(t),numTimeSteps-2);
+          f[k] = t-float(i);
+          setLane(xfm0,k,local2world[i]);
+          setLane(xfm1,k,local2world[i+1]);
+        }
+        return rcp((floatN(one)-f)*xfm0+f*xfm1);
+      }
+
+    private:
+      template<typename AffineSpaceN>
+        static __forceinline void setLane(AffineSpaceN& xfm, size_t k, const AffineSpace3f& x)
+      {
+        xfm.l.vx.x[k] = x.l.vx.x; xfm.l.vx.y[k] = x.l.vx.y; xfm.l.vx.z[k] = x.l.vx.z;
+        xfm.l.vy.x[k] = x.l.vy.x; xfm.l.vy.y[k] = x.l.vy.y; xfm.l.vy.z[k] = x.l.vy.z;
+        xfm.l.vz.x[k] = x.l.vz.x; xfm.l.vz.y[k] = x.l.vz.y; xfm.l.vz.z[k] = x.l.vz.z;
+        xfm.p.x[k] = x.p.x; xfm.p.y[k] = x.p.y; xfm.p.z[k] = x.p.z;
+      }
     
     public:
-      AffineSpace3f local2world;
-      AffineSpace3f world2local;
+      size_t numTimeSteps;                    //!< number of transformation keys, 1 for static instances
+      std::vector<AffineSpace3f> local2world; //!< transformation of each key
+      std::vector<AffineSpace3f> world2local; //!< inverse transformation of each key
       Accel* object;
+      size_t objectCommitCounter;   //!< commit counter of the instanced scene at the last commit of the parent scene
+      unsigned mask;                //!< ray mask of the instance
+      unsigned objectMask;          //!< union of the masks of all geometries of the instanced scene
     };
   }
 }
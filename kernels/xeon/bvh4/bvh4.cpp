@@ -22,40 +22,100 @@
 #include "geometry/triangle1v.h"
 #include "geometry/triangle4v.h"
 #include "geometry/triangle4i.h"
+#include "geometry/triangle4q.h"
+#include "geometry/trianglemeshlet.h"
+#include "geometry/point4.h"
+#include "geometry/point8.h"
+#include "geometry/quad4.h"
+#include "geometry/quad8.h"
 
 #include "common/accelinstance.h"
 
 namespace embree
 {
   DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle1Intersector1Moeller);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle1Intersector1MoellerBasic);
   DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle4Intersector1Moeller);
   DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle8Intersector1Moeller);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle4Intersector1MoellerBasic);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle8Intersector1MoellerBasic);
   DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle1vIntersector1Pluecker);
   DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle4vIntersector1Pluecker);
   DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle4iIntersector1Pluecker);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle4vIntersector1Watertight);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle4iIntersector1Watertight);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle4vIntersector1WatertightBasic);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle4iIntersector1WatertightBasic);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle4qIntersector1);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH4TriangleMeshletIntersector1);
   DECLARE_SYMBOL(Accel::Intersector1,BVH4VirtualIntersector1);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH4Point4Intersector1);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH4Point8Intersector1);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH4Quad4Intersector1);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH4Quad8Intersector1);
 
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle1Intersector4ChunkMoeller);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle1Intersector4ChunkMoellerBasic);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4Intersector4ChunkMoeller);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle8Intersector4ChunkMoeller);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4Intersector4HybridMoeller);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle8Intersector4HybridMoeller);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4Intersector4HybridMoellerBasic);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle8Intersector4HybridMoellerBasic);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle1vIntersector4ChunkPluecker);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4vIntersector4ChunkPluecker);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4vIntersector4HybridPluecker);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4iIntersector4ChunkPluecker);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4vIntersector4ChunkWatertight);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4iIntersector4ChunkWatertight);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4vIntersector4ChunkWatertightBasic);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4iIntersector4ChunkWatertightBasic);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4qIntersector4Chunk);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4TriangleMeshletIntersector4Chunk);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4VirtualIntersector4Chunk);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Point4Intersector4Chunk);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Point8Intersector4Chunk);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Quad4Intersector4Chunk);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Quad8Intersector4Chunk);
 
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle1Intersector8ChunkMoeller);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle1Intersector8ChunkMoellerBasic);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle4Intersector8ChunkMoeller);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle8Intersector8ChunkMoeller);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle4Intersector8HybridMoeller);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle8Intersector8HybridMoeller);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle4Intersector8HybridMoellerBasic);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle8Intersector8HybridMoellerBasic);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle1vIntersector8ChunkPluecker);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle4vIntersector8ChunkPluecker);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle4vIntersector8HybridPluecker);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle4iIntersector8ChunkPluecker);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle4vIntersector8ChunkWatertight);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle4iIntersector8ChunkWatertight);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle4vIntersector8ChunkWatertightBasic);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle4iIntersector8ChunkWatertightBasic);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle4qIntersector8Chunk);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4TriangleMeshletIntersector8Chunk);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4VirtualIntersector8Chunk);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4Point4Intersector8Chunk);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4Point8Intersector8Chunk);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4Quad4Intersector8Chunk);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4Quad8Intersector8Chunk);
+
+  DECLARE_SYMBOL(Accel::PointQueryFunc,BVH4Triangle1PointQuery);
+  DECLARE_SYMBOL(Accel::PointQueryFunc,BVH4Triangle4PointQuery);
+  DECLARE_SYMBOL(Accel::PointQueryFunc,BVH4Triangle8PointQuery);
+  DECLARE_SYMBOL(Accel::PointQueryFunc,BVH4Triangle1vPointQuery);
+  DECLARE_SYMBOL(Accel::PointQueryFunc,BVH4Triangle4vPointQuery);
+  DECLARE_SYMBOL(Accel::PointQueryFunc,BVH4Triangle4iPointQuery);
+  DECLARE_SYMBOL(Accel::PointQueryFunc,BVH4Triangle4qPointQuery);
+  DECLARE_SYMBOL(Accel::PointQueryFunc,BVH4TriangleMeshletPointQuery);
+
+  DECLARE_SYMBOL(Accel::CollideFunc,BVH4Collide);
+
+  DECLARE_SYMBOL(Accel::MultiHitFunc,BVH4MultiHitIntersector);
+  DECLARE_SYMBOL(Accel::MultiHit8Func,BVH4MultiHitIntersector8);
+  DECLARE_SYMBOL(Accel::OccludedHintFunc,BVH4OccludedHintIntersector);
 
   DECLARE_TOPLEVEL_BUILDER(BVH4BuilderTopLevelFast);
 
@@ -90,36 +150,91 @@ namespace embree
 
     /* select intersectors1 */
     SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Triangle1Intersector1Moeller);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Triangle1Intersector1MoellerBasic);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Triangle4Intersector1Moeller);
     SELECT_SYMBOL_AVX_AVX2              (features,BVH4Triangle8Intersector1Moeller);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Triangle4Intersector1MoellerBasic);
+    SELECT_SYMBOL_AVX_AVX2              (features,BVH4Triangle8Intersector1MoellerBasic);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle1vIntersector1Pluecker);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle4vIntersector1Pluecker);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle4iIntersector1Pluecker);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle4vIntersector1Watertight);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle4iIntersector1Watertight);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle4vIntersector1WatertightBasic);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle4iIntersector1WatertightBasic);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle4qIntersector1);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4TriangleMeshletIntersector1);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4VirtualIntersector1);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Point4Intersector1);
+    SELECT_SYMBOL_AVX_AVX2              (features,BVH4Point8Intersector1);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Quad4Intersector1);
+    SELECT_SYMBOL_AVX_AVX2              (features,BVH4Quad8Intersector1);
 
     /* select intersectors4 */
     SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Triangle1Intersector4ChunkMoeller);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Triangle1Intersector4ChunkMoellerBasic);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Triangle4Intersector4ChunkMoeller);
     SELECT_SYMBOL_AVX_AVX2              (features,BVH4Triangle8Intersector4ChunkMoeller);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Triangle4Intersector4HybridMoeller);
     SELECT_SYMBOL_AVX_AVX2              (features,BVH4Triangle8Intersector4HybridMoeller);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Triangle4Intersector4HybridMoellerBasic);
+    SELECT_SYMBOL_AVX_AVX2              (features,BVH4Triangle8Intersector4HybridMoellerBasic);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle1vIntersector4ChunkPluecker);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle4vIntersector4ChunkPluecker);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle4vIntersector4HybridPluecker);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle4iIntersector4ChunkPluecker);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle4vIntersector4ChunkWatertight);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle4iIntersector4ChunkWatertight);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle4vIntersector4ChunkWatertightBasic);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle4iIntersector4ChunkWatertightBasic);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle4qIntersector4Chunk);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4TriangleMeshletIntersector4Chunk);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4VirtualIntersector4Chunk);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Point4Intersector4Chunk);
+    SELECT_SYMBOL_AVX_AVX2              (features,BVH4Point8Intersector4Chunk);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Quad4Intersector4Chunk);
+    SELECT_SYMBOL_AVX_AVX2              (features,BVH4Quad8Intersector4Chunk);
 
     /* select intersectors8 */
     SELECT_SYMBOL_AVX_AVX2(features,BVH4Triangle1Intersector8ChunkMoeller);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH4Triangle1Intersector8ChunkMoellerBasic);
     SELECT_SYMBOL_AVX_AVX2(features,BVH4Triangle4Intersector8ChunkMoeller);
     SELECT_SYMBOL_AVX_AVX2(features,BVH4Triangle8Intersector8ChunkMoeller);
     SELECT_SYMBOL_AVX_AVX2(features,BVH4Triangle4Intersector8HybridMoeller);
     SELECT_SYMBOL_AVX_AVX2(features,BVH4Triangle8Intersector8HybridMoeller);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH4Triangle4Intersector8HybridMoellerBasic);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH4Triangle8Intersector8HybridMoellerBasic);
     SELECT_SYMBOL_AVX     (features,BVH4Triangle1vIntersector8ChunkPluecker);
     SELECT_SYMBOL_AVX     (features,BVH4Triangle4vIntersector8ChunkPluecker);
     SELECT_SYMBOL_AVX     (features,BVH4Triangle4vIntersector8HybridPluecker);
     SELECT_SYMBOL_AVX     (features,BVH4Triangle4iIntersector8ChunkPluecker);
+    SELECT_SYMBOL_AVX     (features,BVH4Triangle4vIntersector8ChunkWatertight);
+    SELECT_SYMBOL_AVX     (features,BVH4Triangle4iIntersector8ChunkWatertight);
+    SELECT_SYMBOL_AVX     (features,BVH4Triangle4vIntersector8ChunkWatertightBasic);
+    SELECT_SYMBOL_AVX     (features,BVH4Triangle4iIntersector8ChunkWatertightBasic);
+    SELECT_SYMBOL_AVX     (features,BVH4Triangle4qIntersector8Chunk);
+    SELECT_SYMBOL_AVX     (features,BVH4TriangleMeshletIntersector8Chunk);
     SELECT_SYMBOL_AVX_AVX2(features,BVH4VirtualIntersector8Chunk);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH4Point4Intersector8Chunk);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH4Point8Intersector8Chunk);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH4Quad4Intersector8Chunk);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH4Quad8Intersector8Chunk);
+
+    /* select point queries */
+    SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Triangle1PointQuery);
+    SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Triangle4PointQuery);
+    SELECT_SYMBOL_AVX        (features,BVH4Triangle8PointQuery);
+    SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Triangle1vPointQuery);
+    SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Triangle4vPointQuery);
+    SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Triangle4iPointQuery);
+    SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Triangle4qPointQuery);
+    SELECT_SYMBOL_DEFAULT_AVX(features,BVH4TriangleMeshletPointQuery);
+
+    SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Collide);
+
+    SELECT_SYMBOL_DEFAULT_AVX(features,BVH4MultiHitIntersector);
+    SELECT_SYMBOL_AVX        (features,BVH4MultiHitIntersector8);
+    SELECT_SYMBOL_DEFAULT_AVX(features,BVH4OccludedHintIntersector);
   }
 
   BVH4::BVH4 (const PrimitiveType& primTy, void* geometry)
@@ -133,109 +248,278 @@ namespace embree
     for (size_t i=0; i<objects.size(); i++) delete objects[i];
   }
   
-  Accel::Intersectors BVH4Triangle1Intersectors(BVH4* bvh)
+  /*! Initializes the intersectors of a BVH4 over triangles with the
+   *  queries that work on the triangles extracted from the leaves. */
+  static Accel::Intersectors BVH4TriangleIntersectors(BVH4* bvh)
   {
     Accel::Intersectors intersectors;
     intersectors.ptr = bvh;
+    intersectors.collide = BVH4Collide;
+    intersectors.multiHit = BVH4MultiHitIntersector;
+    intersectors.multiHit8 = BVH4MultiHitIntersector8;
+    intersectors.occludedHint = BVH4OccludedHintIntersector;
+    intersectors.features = KERNEL_FEATURES_ALL;
+    return intersectors;
+  }
+
+  Accel::Intersectors BVH4Triangle1Intersectors(BVH4* bvh)
+  {
+    Accel::Intersectors intersectors = BVH4TriangleIntersectors(bvh);
     intersectors.intersector1 = BVH4Triangle1Intersector1Moeller;
     intersectors.intersector4 = BVH4Triangle1Intersector4ChunkMoeller;
     intersectors.intersector8 = BVH4Triangle1Intersector8ChunkMoeller;
     intersectors.intersector16 = NULL;
+    intersectors.pointQuery = BVH4Triangle1PointQuery;
+    return intersectors;
+  }
+
+  Accel::Intersectors BVH4Triangle1IntersectorsBasic(BVH4* bvh)
+  {
+    Accel::Intersectors intersectors = BVH4TriangleIntersectors(bvh);
+    intersectors.intersector1 = BVH4Triangle1Intersector1MoellerBasic;
+    intersectors.intersector4 = BVH4Triangle1Intersector4ChunkMoellerBasic;
+    intersectors.intersector8 = BVH4Triangle1Intersector8ChunkMoellerBasic;
+    intersectors.intersector16 = NULL;
+    intersectors.pointQuery = BVH4Triangle1PointQuery;
+    intersectors.features = KERNEL_FEATURES_NONE;
     return intersectors;
   }
 
   Accel::Intersectors BVH4Triangle4IntersectorsChunk(BVH4* bvh)
   {
-    Accel::Intersectors intersectors;
-    intersectors.ptr = bvh;
+    Accel::Intersectors intersectors = BVH4TriangleIntersectors(bvh);
     intersectors.intersector1 = BVH4Triangle4Intersector1Moeller;
     intersectors.intersector4 = BVH4Triangle4Intersector4ChunkMoeller;
     intersectors.intersector8 = BVH4Triangle4Intersector8ChunkMoeller;
     intersectors.intersector16 = NULL;
+    intersectors.pointQuery = BVH4Triangle4PointQuery;
     return intersectors;
   }
 
   Accel::Intersectors BVH4Triangle4IntersectorsHybrid(BVH4* bvh)
   {
-    Accel::Intersectors intersectors;
-    intersectors.ptr = bvh;
+    Accel::Intersectors intersectors = BVH4TriangleIntersectors(bvh);
     intersectors.intersector1 = BVH4Triangle4Intersector1Moeller;
     intersectors.intersector4 = BVH4Triangle4Intersector4HybridMoeller;
     intersectors.intersector8 = BVH4Triangle4Intersector8HybridMoeller;
     intersectors.intersector16 = NULL;
+    intersectors.pointQuery = BVH4Triangle4PointQuery;
+    return intersectors;
+  }
+
+  Accel::Intersectors BVH4Triangle4IntersectorsHybridBasic(BVH4* bvh)
+  {
+    Accel::Intersectors intersectors = BVH4TriangleIntersectors(bvh);
+    intersectors.intersector1 = BVH4Triangle4Intersector1MoellerBasic;
+    intersectors.intersector4 = BVH4Triangle4Intersector4HybridMoellerBasic;
+    intersectors.intersector8 = BVH4Triangle4Intersector8HybridMoellerBasic;
+    intersectors.intersector16 = NULL;
+    intersectors.pointQuery = BVH4Triangle4PointQuery;
+    intersectors.features = KERNEL_FEATURES_NONE;
     return intersectors;
   }
 
   Accel::Intersectors BVH4Triangle8IntersectorsChunk(BVH4* bvh)
   {
-    Accel::Intersectors intersectors;
-    intersectors.ptr = bvh;
+    Accel::Intersectors intersectors = BVH4TriangleIntersectors(bvh);
     intersectors.intersector1 = BVH4Triangle8Intersector1Moeller;
     intersectors.intersector4 = BVH4Triangle8Intersector4ChunkMoeller;
     intersectors.intersector8 = BVH4Triangle8Intersector8ChunkMoeller;
     intersectors.intersector16 = NULL;
+    intersectors.pointQuery = BVH4Triangle8PointQuery;
     return intersectors;
   }
 
   Accel::Intersectors BVH4Triangle8IntersectorsHybrid(BVH4* bvh)
   {
-    Accel::Intersectors intersectors;
-    intersectors.ptr = bvh;
+    Accel::Intersectors intersectors = BVH4TriangleIntersectors(bvh);
     intersectors.intersector1 = BVH4Triangle8Intersector1Moeller;
     intersectors.intersector4 = BVH4Triangle8Intersector4HybridMoeller;
     intersectors.intersector8 = BVH4Triangle8Intersector8HybridMoeller;
     intersectors.intersector16 = NULL;
+    intersectors.pointQuery = BVH4Triangle8PointQuery;
+    return intersectors;
+  }
+
+  Accel::Intersectors BVH4Triangle8IntersectorsHybridBasic(BVH4* bvh)
+  {
+    Accel::Intersectors intersectors = BVH4TriangleIntersectors(bvh);
+    intersectors.intersector1 = BVH4Triangle8Intersector1MoellerBasic;
+    intersectors.intersector4 = BVH4Triangle8Intersector4HybridMoellerBasic;
+    intersectors.intersector8 = BVH4Triangle8Intersector8HybridMoellerBasic;
+    intersectors.intersector16 = NULL;
+    intersectors.pointQuery = BVH4Triangle8PointQuery;
+    intersectors.features = KERNEL_FEATURES_NONE;
     return intersectors;
   }
 
   Accel::Intersectors BVH4Triangle1vIntersectors(BVH4* bvh)
   {
-    Accel::Intersectors intersectors;
-    intersectors.ptr = bvh;
+    Accel::Intersectors intersectors = BVH4TriangleIntersectors(bvh);
     intersectors.intersector1 = BVH4Triangle1vIntersector1Pluecker;
     intersectors.intersector4 = BVH4Triangle1vIntersector4ChunkPluecker;
     intersectors.intersector8 = BVH4Triangle1vIntersector8ChunkPluecker;
     intersectors.intersector16 = NULL;
+    intersectors.pointQuery = BVH4Triangle1vPointQuery;
     return intersectors;
   }
 
   Accel::Intersectors BVH4Triangle4vIntersectorsChunk(BVH4* bvh)
   {
-    Accel::Intersectors intersectors;
-    intersectors.ptr = bvh;
+    Accel::Intersectors intersectors = BVH4TriangleIntersectors(bvh);
     intersectors.intersector1 = BVH4Triangle4vIntersector1Pluecker;
     intersectors.intersector4 = BVH4Triangle4vIntersector4ChunkPluecker;
     intersectors.intersector8 = BVH4Triangle4vIntersector8ChunkPluecker;
     intersectors.intersector16 = NULL;
+    intersectors.pointQuery = BVH4Triangle4vPointQuery;
     return intersectors;
   }
 
   Accel::Intersectors BVH4Triangle4vIntersectorsHybrid(BVH4* bvh)
   {
-    Accel::Intersectors intersectors;
-    intersectors.ptr = bvh;
+    Accel::Intersectors intersectors = BVH4TriangleIntersectors(bvh);
     intersectors.intersector1 = BVH4Triangle4vIntersector1Pluecker;
     intersectors.intersector4 = BVH4Triangle4vIntersector4HybridPluecker;
     intersectors.intersector8 = BVH4Triangle4vIntersector8HybridPluecker;
     intersectors.intersector16 = NULL;
+    intersectors.pointQuery = BVH4Triangle4vPointQuery;
     return intersectors;
   }
 
   Accel::Intersectors BVH4Triangle4iIntersectors(BVH4* bvh)
   {
-    Accel::Intersectors intersectors;
-    intersectors.ptr = bvh;
+    Accel::Intersectors intersectors = BVH4TriangleIntersectors(bvh);
     intersectors.intersector1 = BVH4Triangle4iIntersector1Pluecker;
     intersectors.intersector4 = BVH4Triangle4iIntersector4ChunkPluecker;
     intersectors.intersector8 = BVH4Triangle4iIntersector8ChunkPluecker;
     intersectors.intersector16 = NULL;
+    intersectors.pointQuery = BVH4Triangle4iPointQuery;
+    return intersectors;
+  }
+
+  Accel::Intersectors BVH4Triangle4vIntersectorsWatertight(BVH4* bvh)
+  {
+    Accel::Intersectors intersectors = BVH4TriangleIntersectors(bvh);
+    intersectors.intersector1 = BVH4Triangle4vIntersector1Watertight;
+    intersectors.intersector4 = BVH4Triangle4vIntersector4ChunkWatertight;
+    intersectors.intersector8 = BVH4Triangle4vIntersector8ChunkWatertight;
+    intersectors.intersector16 = NULL;
+    intersectors.pointQuery = BVH4Triangle4vPointQuery;
+    intersectors.features = KERNEL_FEATURES_ALL | KERNEL_FEATURE_ROBUST;
+    return intersectors;
+  }
+
+  Accel::Intersectors BVH4Triangle4vIntersectorsWatertightBasic(BVH4* bvh)
+  {
+    Accel::Intersectors intersectors = BVH4TriangleIntersectors(bvh);
+    intersectors.intersector1 = BVH4Triangle4vIntersector1WatertightBasic;
+    intersectors.intersector4 = BVH4Triangle4vIntersector4ChunkWatertightBasic;
+    intersectors.intersector8 = BVH4Triangle4vIntersector8ChunkWatertightBasic;
+    intersectors.intersector16 = NULL;
+    intersectors.pointQuery = BVH4Triangle4vPointQuery;
+    intersectors.features = KERNEL_FEATURE_ROBUST;
+    return intersectors;
+  }
+
+  Accel::Intersectors BVH4Triangle4iIntersectorsWatertight(BVH4* bvh)
+  {
+    Accel::Intersectors intersectors = BVH4TriangleIntersectors(bvh);
+    intersectors.intersector1 = BVH4Triangle4iIntersector1Watertight;
+    intersectors.intersector4 = BVH4Triangle4iIntersector4ChunkWatertight;
+    intersectors.intersector8 = BVH4Triangle4iIntersector8ChunkWatertight;
+    intersectors.intersector16 = NULL;
+    intersectors.pointQuery = BVH4Triangle4iPointQuery;
+    intersectors.features = KERNEL_FEATURES_ALL | KERNEL_FEATURE_ROBUST;
+    return intersectors;
+  }
+
+  Accel::Intersectors BVH4Triangle4iIntersectorsWatertightBasic(BVH4* bvh)
+  {
+    Accel::Intersectors intersectors = BVH4TriangleIntersectors(bvh);
+    intersectors.intersector1 = BVH4Triangle4iIntersector1WatertightBasic;
+    intersectors.intersector4 = BVH4Triangle4iIntersector4ChunkWatertightBasic;
+    intersectors.intersector8 = BVH4Triangle4iIntersector8ChunkWatertightBasic;
+    intersectors.intersector16 = NULL;
+    intersectors.pointQuery = BVH4Triangle4iPointQuery;
+    intersectors.features = KERNEL_FEATURE_ROBUST;
+    return intersectors;
+  }
+
+  Accel::Intersectors BVH4Triangle4qIntersectors(BVH4* bvh)
+  {
+    Accel::Intersectors intersectors = BVH4TriangleIntersectors(bvh);
+    intersectors.intersector1 = BVH4Triangle4qIntersector1;
+    intersectors.intersector4 = BVH4Triangle4qIntersector4Chunk;
+    intersectors.intersector8 = BVH4Triangle4qIntersector8Chunk;
+    intersectors.intersector16 = NULL;
+    intersectors.pointQuery = BVH4Triangle4qPointQuery;
+    return intersectors;
+  }
+
+  Accel::Intersectors BVH4TriangleMeshletIntersectors(BVH4* bvh)
+  {
+    Accel::Intersectors intersectors = BVH4TriangleIntersectors(bvh);
+    intersectors.intersector1 = BVH4TriangleMeshletIntersector1;
+    intersectors.intersector4 = BVH4TriangleMeshletIntersector4Chunk;
+    intersectors.intersector8 = BVH4TriangleMeshletIntersector8Chunk;
+    intersectors.intersector16 = NULL;
+    intersectors.pointQuery = BVH4TriangleMeshletPointQuery;
+    return intersectors;
+  }
+
+  Accel::Intersectors BVH4Point4Intersectors(BVH4* bvh)
+  {
+    Accel::Intersectors intersectors;
+    intersectors.ptr = bvh;
+    intersectors.intersector1 = BVH4Point4Intersector1;
+    intersectors.intersector4 = BVH4Point4Intersector4Chunk;
+    intersectors.intersector8 = BVH4Point4Intersector8Chunk;
+    intersectors.intersector16 = NULL;
+    intersectors.features = KERNEL_FEATURE_RAY_MASK;
+    return intersectors;
+  }
+
+  Accel::Intersectors BVH4Point8Intersectors(BVH4* bvh)
+  {
+    Accel::Intersectors intersectors;
+    intersectors.ptr = bvh;
+    intersectors.intersector1 = BVH4Point8Intersector1;
+    intersectors.intersector4 = BVH4Point8Intersector4Chunk;
+    intersectors.intersector8 = BVH4Point8Intersector8Chunk;
+    intersectors.intersector16 = NULL;
+    intersectors.features = KERNEL_FEATURE_RAY_MASK;
+    return intersectors;
+  }
+
+  Accel::Intersectors BVH4Quad4Intersectors(BVH4* bvh)
+  {
+    Accel::Intersectors intersectors;
+    intersectors.ptr = bvh;
+    intersectors.intersector1 = BVH4Quad4Intersector1;
+    intersectors.intersector4 = BVH4Quad4Intersector4Chunk;
+    intersectors.intersector8 = BVH4Quad4Intersector8Chunk;
+    intersectors.intersector16 = NULL;
+    intersectors.features = KERNEL_FEATURE_RAY_MASK;
+    return intersectors;
+  }
+
+  Accel::Intersectors BVH4Quad8Intersectors(BVH4* bvh)
+  {
+    Accel::Intersectors intersectors;
+    intersectors.ptr = bvh;
+    intersectors.intersector1 = BVH4Quad8Intersector1;
+    intersectors.intersector4 = BVH4Quad8Intersector4Chunk;
+    intersectors.intersector8 = BVH4Quad8Intersector8Chunk;
+    intersectors.intersector16 = NULL;
+    intersectors.features = KERNEL_FEATURE_RAY_MASK;
     return intersectors;
   }
 
   Accel* BVH4::BVH4Triangle1(Scene* scene)
   { 
-    BVH4* accel = new BVH4(SceneTriangle1::type);
+    BVH4* accel = new BVH4(SceneTriangle1::type,scene);
     Accel::Intersectors intersectors = BVH4Triangle1Intersectors(accel);
+    Accel::Intersectors basicIntersectors = BVH4Triangle1IntersectorsBasic(accel);
     
     Builder* builder = NULL;
     if      (g_builder == "default"     ) builder = BVH4BuilderObjectSplit1(accel,&scene->flat_triangle_source_1,scene,1,inf);
@@ -245,12 +529,12 @@ namespace embree
     else if (g_builder == "fast"        ) builder = BVH4BuilderObjectSplit4Fast(accel,&scene->flat_triangle_source_1,scene,4,inf);
     else throw std::runtime_error("unknown builder "+g_builder+" for BVH4<Triangle1>");
 
-    return new AccelInstance(accel,builder,intersectors);
+    return new AccelInstance(accel,builder,intersectors,basicIntersectors);
   }
 
   Accel* BVH4::BVH4Triangle4(Scene* scene)
   { 
-    BVH4* accel = new BVH4(SceneTriangle4::type);
+    BVH4* accel = new BVH4(SceneTriangle4::type,scene);
 
     Accel::Intersectors intersectors;
     if      (g_traverser == "default") intersectors = BVH4Triangle4IntersectorsChunk(accel);
@@ -275,7 +559,7 @@ namespace embree
 
   Accel* BVH4::BVH4Triangle8(Scene* scene)
   { 
-    BVH4* accel = new BVH4(SceneTriangle8::type);
+    BVH4* accel = new BVH4(SceneTriangle8::type,scene);
 
     Accel::Intersectors intersectors;
     if      (g_traverser == "default") intersectors = BVH4Triangle8IntersectorsChunk(accel);
@@ -295,7 +579,7 @@ namespace embree
 
   Accel* BVH4::BVH4Triangle1v(Scene* scene)
   {
-    BVH4* accel = new BVH4(SceneTriangle1v::type);
+    BVH4* accel = new BVH4(SceneTriangle1v::type,scene);
     Accel::Intersectors intersectors = BVH4Triangle1vIntersectors(accel);
 
     Builder* builder = NULL;
@@ -311,7 +595,7 @@ namespace embree
 
   Accel* BVH4::BVH4Triangle4v(Scene* scene)
   {
-    BVH4* accel = new BVH4(SceneTriangle4v::type);
+    BVH4* accel = new BVH4(SceneTriangle4v::type,scene);
 
     Accel::Intersectors intersectors;
     if      (g_traverser == "default") intersectors = BVH4Triangle4vIntersectorsChunk(accel);
@@ -327,13 +611,15 @@ namespace embree
     else if (g_builder == "fast"        ) builder = BVH4BuilderObjectSplit4Fast(accel,&scene->flat_triangle_source_1,scene,4,inf);
     else throw std::runtime_error("unknown builder "+g_builder+" for BVH4<Triangle4v>");
 
-    return new AccelInstance(accel,builder,intersectors);
+    /* robust scenes select the watertight intersectors */
+    Accel::Intersectors robustIntersectors = BVH4Triangle4vIntersectorsWatertight(accel);
+    return new AccelInstance(accel,builder,robustIntersectors,intersectors,BVH4Triangle4vIntersectorsWatertightBasic(accel));
   }
 
   Accel* BVH4::BVH4Triangle4i(Scene* scene)
   {
     BVH4* accel = new BVH4(Triangle4iType::type,scene);
-    Accel::Intersectors intersectors = BVH4Triangle4iIntersectors(accel);
+    Accel::Intersectors intersectors = BVH4Triangle4iIntersectorsWatertight(accel);
 
     Builder* builder = NULL;
     if      (g_builder == "default"     ) builder = BVH4BuilderObjectSplit4(accel,&scene->flat_triangle_source_1,scene,1,inf);
@@ -342,20 +628,49 @@ namespace embree
     else throw std::runtime_error("unknown builder "+g_builder+" for BVH4<Triangle4i>");
 
     scene->needVertices = true;
+    return new AccelInstance(accel,builder,intersectors,BVH4Triangle4iIntersectors(accel),BVH4Triangle4iIntersectorsWatertightBasic(accel));
+  }
+
+  Accel* BVH4::BVH4Triangle4q(Scene* scene)
+  {
+    BVH4* accel = new BVH4(SceneTriangle4q::type,scene);
+    Accel::Intersectors intersectors = BVH4Triangle4qIntersectors(accel);
+
+    Builder* builder = NULL;
+    if      (g_builder == "default"     ) builder = BVH4BuilderObjectSplit4(accel,&scene->flat_triangle_source_1,scene,1,inf);
+    else if (g_builder == "spatialsplit") builder = BVH4BuilderSpatialSplit4(accel,&scene->flat_triangle_source_1,scene,1,inf);
+    else if (g_builder == "objectsplit" ) builder = BVH4BuilderObjectSplit4(accel,&scene->flat_triangle_source_1,scene,1,inf);
+    else throw std::runtime_error("unknown builder "+g_builder+" for BVH4<Triangle4q>");
+
+    return new AccelInstance(accel,builder,intersectors);
+  }
+  Accel* BVH4::BVH4TriangleMeshlet(Scene* scene)
+  {
+    BVH4* accel = new BVH4(SceneTriangleMeshlet::type,scene);
+    Accel::Intersectors intersectors = BVH4TriangleMeshletIntersectors(accel);
+
+    /* leaves of up to 16 triangles are always created to fill the clusters */
+    Builder* builder = NULL;
+    if      (g_builder == "default"     ) builder = BVH4BuilderObjectSplit4(accel,&scene->flat_triangle_source_1,scene,16,inf);
+    else if (g_builder == "spatialsplit") builder = BVH4BuilderSpatialSplit4(accel,&scene->flat_triangle_source_1,scene,16,inf);
+    else if (g_builder == "objectsplit" ) builder = BVH4BuilderObjectSplit4(accel,&scene->flat_triangle_source_1,scene,16,inf);
+    else throw std::runtime_error("unknown builder "+g_builder+" for BVH4<TriangleMeshlet>");
+
     return new AccelInstance(accel,builder,intersectors);
   }
 
+
   void createTriangleMeshTriangle1Morton(TriangleMeshScene::TriangleMesh* mesh, BVH4*& accel, Builder*& builder)
   {
     if (mesh->numTimeSteps != 1) throw std::runtime_error("internal error");
-    accel = new BVH4(TriangleMeshTriangle1::type);
+    accel = new BVH4(TriangleMeshTriangle1::type,mesh->parent);
     builder = BVH4BuilderMortonTriangleMeshFast(accel,mesh,4,inf);
   } 
 
   void createTriangleMeshTriangle1(TriangleMeshScene::TriangleMesh* mesh, BVH4*& accel, Builder*& builder)
   {
     if (mesh->numTimeSteps != 1) throw std::runtime_error("internal error");
-    accel = new BVH4(TriangleMeshTriangle1::type);
+    accel = new BVH4(TriangleMeshTriangle1::type,mesh->parent);
     switch (mesh->flags) {
     case RTC_GEOMETRY_STATIC:     builder = BVH4BuilderObjectSplit4TriangleMeshFast(accel,mesh,4,inf); break;
     case RTC_GEOMETRY_DEFORMABLE: builder = BVH4BuilderRefitObjectSplit4TriangleMeshFast(accel,mesh,4,inf); break;
@@ -367,7 +682,7 @@ namespace embree
   void createTriangleMeshTriangle4(TriangleMeshScene::TriangleMesh* mesh, BVH4*& accel, Builder*& builder)
   {
     if (mesh->numTimeSteps != 1) throw std::runtime_error("internal error");
-    accel = new BVH4(TriangleMeshTriangle4::type);
+    accel = new BVH4(TriangleMeshTriangle4::type,mesh->parent);
     switch (mesh->flags) {
     case RTC_GEOMETRY_STATIC:     builder = BVH4BuilderObjectSplit4TriangleMeshFast(accel,mesh,4,inf); break;
     case RTC_GEOMETRY_DEFORMABLE: builder = BVH4BuilderRefitObjectSplit4TriangleMeshFast(accel,mesh,4,inf); break;
@@ -379,7 +694,7 @@ namespace embree
   void createTriangleMeshTriangle1v(TriangleMeshScene::TriangleMesh* mesh, BVH4*& accel, Builder*& builder)
   {
     if (mesh->numTimeSteps != 1) throw std::runtime_error("internal error");
-    accel = new BVH4(TriangleMeshTriangle1v::type);
+    accel = new BVH4(TriangleMeshTriangle1v::type,mesh->parent);
     switch (mesh->flags) {
     case RTC_GEOMETRY_STATIC:     builder = BVH4BuilderObjectSplit4TriangleMeshFast(accel,mesh,4,inf); break;
     case RTC_GEOMETRY_DEFORMABLE: builder = BVH4BuilderRefitObjectSplit4TriangleMeshFast(accel,mesh,4,inf); break;
@@ -391,7 +706,7 @@ namespace embree
   void createTriangleMeshTriangle4v(TriangleMeshScene::TriangleMesh* mesh, BVH4*& accel, Builder*& builder)
   {
     if (mesh->numTimeSteps != 1) throw std::runtime_error("internal error");
-    accel = new BVH4(TriangleMeshTriangle4v::type);
+    accel = new BVH4(TriangleMeshTriangle4v::type,mesh->parent);
     switch (mesh->flags) {
     case RTC_GEOMETRY_STATIC:     builder = BVH4BuilderObjectSplit4TriangleMeshFast(accel,mesh,4,inf); break;
     case RTC_GEOMETRY_DEFORMABLE: builder = BVH4BuilderRefitObjectSplit4TriangleMeshFast(accel,mesh,4,inf); break;
@@ -402,31 +717,31 @@ namespace embree
 
   Accel* BVH4::BVH4BVH4Triangle1Morton(Scene* scene)
   {
-    BVH4* accel = new BVH4(TriangleMeshTriangle1::type);
+    BVH4* accel = new BVH4(TriangleMeshTriangle1::type,scene);
     Accel::Intersectors intersectors = BVH4Triangle1Intersectors(accel);
     Builder* builder = BVH4BuilderTopLevelFast(accel,scene,&createTriangleMeshTriangle1Morton);
-    return new AccelInstance(accel,builder,intersectors);
+    return new AccelInstance(accel,builder,intersectors,BVH4Triangle1IntersectorsBasic(accel));
   }
 
   Accel* BVH4::BVH4BVH4Triangle1ObjectSplit(Scene* scene)
   {
-    BVH4* accel = new BVH4(TriangleMeshTriangle1::type);
+    BVH4* accel = new BVH4(TriangleMeshTriangle1::type,scene);
     Accel::Intersectors intersectors = BVH4Triangle1Intersectors(accel);
     Builder* builder = BVH4BuilderTopLevelFast(accel,scene,&createTriangleMeshTriangle1);
-    return new AccelInstance(accel,builder,intersectors);
+    return new AccelInstance(accel,builder,intersectors,BVH4Triangle1IntersectorsBasic(accel));
   }
 
   Accel* BVH4::BVH4BVH4Triangle4ObjectSplit(Scene* scene)
   {
-    BVH4* accel = new BVH4(TriangleMeshTriangle4::type);
+    BVH4* accel = new BVH4(TriangleMeshTriangle4::type,scene);
     Accel::Intersectors intersectors = BVH4Triangle4IntersectorsHybrid(accel);
     Builder* builder = BVH4BuilderTopLevelFast(accel,scene,&createTriangleMeshTriangle4);
-    return new AccelInstance(accel,builder,intersectors);
+    return new AccelInstance(accel,builder,intersectors,BVH4Triangle4IntersectorsHybridBasic(accel));
   }
 
   Accel* BVH4::BVH4BVH4Triangle1vObjectSplit(Scene* scene)
   {
-    BVH4* accel = new BVH4(TriangleMeshTriangle1v::type);
+    BVH4* accel = new BVH4(TriangleMeshTriangle1v::type,scene);
     Accel::Intersectors intersectors = BVH4Triangle1vIntersectors(accel);
     Builder* builder = BVH4BuilderTopLevelFast(accel,scene,&createTriangleMeshTriangle1v);
     return new AccelInstance(accel,builder,intersectors);
@@ -434,71 +749,71 @@ namespace embree
 
   Accel* BVH4::BVH4BVH4Triangle4vObjectSplit(Scene* scene)
   {
-    BVH4* accel = new BVH4(TriangleMeshTriangle4v::type);
-    Accel::Intersectors intersectors = BVH4Triangle4vIntersectorsHybrid(accel);
+    BVH4* accel = new BVH4(TriangleMeshTriangle4v::type,scene);
+    Accel::Intersectors intersectors = BVH4Triangle4vIntersectorsWatertight(accel);
     Builder* builder = BVH4BuilderTopLevelFast(accel,scene,&createTriangleMeshTriangle4v);
-    return new AccelInstance(accel,builder,intersectors);
+    return new AccelInstance(accel,builder,intersectors,BVH4Triangle4vIntersectorsHybrid(accel),BVH4Triangle4vIntersectorsWatertightBasic(accel));
   }
 
   Accel* BVH4::BVH4Triangle1SpatialSplit(Scene* scene)
   {
-    BVH4* accel = new BVH4(SceneTriangle1::type);
+    BVH4* accel = new BVH4(SceneTriangle1::type,scene);
     Builder* builder = BVH4BuilderSpatialSplit1(accel,&scene->flat_triangle_source_1,scene,1,inf);
     Accel::Intersectors intersectors = BVH4Triangle1Intersectors(accel);
-    return new AccelInstance(accel,builder,intersectors);
+    return new AccelInstance(accel,builder,intersectors,BVH4Triangle1IntersectorsBasic(accel));
   }
   
   Accel* BVH4::BVH4Triangle4SpatialSplit(Scene* scene)
   {
-    BVH4* accel = new BVH4(SceneTriangle4::type);
+    BVH4* accel = new BVH4(SceneTriangle4::type,scene);
     Builder* builder = BVH4BuilderSpatialSplit4(accel,&scene->flat_triangle_source_1,scene,1,inf);
     Accel::Intersectors intersectors = BVH4Triangle4IntersectorsHybrid(accel);
-    return new AccelInstance(accel,builder,intersectors);
+    return new AccelInstance(accel,builder,intersectors,BVH4Triangle4IntersectorsHybridBasic(accel));
   }
 
 #if defined (__TARGET_AVX__)
 
   Accel* BVH4::BVH4Triangle8SpatialSplit(Scene* scene)
   {
-    BVH4* accel = new BVH4(SceneTriangle8::type);
+    BVH4* accel = new BVH4(SceneTriangle8::type,scene);
     Builder* builder = BVH4BuilderSpatialSplit8(accel,&scene->flat_triangle_source_1,scene,1,inf);
     Accel::Intersectors intersectors = BVH4Triangle8IntersectorsHybrid(accel);
-    return new AccelInstance(accel,builder,intersectors);
+    return new AccelInstance(accel,builder,intersectors,BVH4Triangle8IntersectorsHybridBasic(accel));
   }
 
 #endif
 
   Accel* BVH4::BVH4Triangle1ObjectSplit(Scene* scene)
   {
-    BVH4* accel = new BVH4(SceneTriangle1::type);
+    BVH4* accel = new BVH4(SceneTriangle1::type,scene);
     Builder* builder = BVH4BuilderObjectSplit1(accel,&scene->flat_triangle_source_1,scene,1,inf);
     Accel::Intersectors intersectors = BVH4Triangle1Intersectors(accel);
-    return new AccelInstance(accel,builder,intersectors);
+    return new AccelInstance(accel,builder,intersectors,BVH4Triangle1IntersectorsBasic(accel));
   }
   
   Accel* BVH4::BVH4Triangle4ObjectSplit(Scene* scene)
   {
-    BVH4* accel = new BVH4(SceneTriangle4::type);
+    BVH4* accel = new BVH4(SceneTriangle4::type,scene);
     Builder* builder = BVH4BuilderObjectSplit4(accel,&scene->flat_triangle_source_1,scene,1,inf);
     Accel::Intersectors intersectors = BVH4Triangle4IntersectorsHybrid(accel);
-    return new AccelInstance(accel,builder,intersectors);
+    return new AccelInstance(accel,builder,intersectors,BVH4Triangle4IntersectorsHybridBasic(accel));
   }
 
 #if defined (__TARGET_AVX__)
 
   Accel* BVH4::BVH4Triangle8ObjectSplit(Scene* scene)
   {
-    BVH4* accel = new BVH4(SceneTriangle8::type);
+    BVH4* accel = new BVH4(SceneTriangle8::type,scene);
     Builder* builder = BVH4BuilderObjectSplit8(accel,&scene->flat_triangle_source_1,scene,1,inf);
     Accel::Intersectors intersectors = BVH4Triangle8IntersectorsHybrid(accel);
-    return new AccelInstance(accel,builder,intersectors);
+    return new AccelInstance(accel,builder,intersectors,BVH4Triangle8IntersectorsHybridBasic(accel));
   }
 
 #endif
 
   Accel* BVH4::BVH4Triangle1vObjectSplit(Scene* scene)
   {
-    BVH4* accel = new BVH4(SceneTriangle1v::type);
+    BVH4* accel = new BVH4(SceneTriangle1v::type,scene);
     Builder* builder = BVH4BuilderObjectSplit1(accel,&scene->flat_triangle_source_1,scene,1,inf);
     Accel::Intersectors intersectors = BVH4Triangle1vIntersectors(accel);
     return new AccelInstance(accel,builder,intersectors);
@@ -506,24 +821,24 @@ namespace embree
 
   Accel* BVH4::BVH4Triangle4vObjectSplit(Scene* scene)
   {
-    BVH4* accel = new BVH4(SceneTriangle4v::type);
+    BVH4* accel = new BVH4(SceneTriangle4v::type,scene);
     Builder* builder = BVH4BuilderObjectSplit4(accel,&scene->flat_triangle_source_1,scene,1,inf);
-    Accel::Intersectors intersectors = BVH4Triangle4vIntersectorsHybrid(accel);
-    return new AccelInstance(accel,builder,intersectors);
+    Accel::Intersectors intersectors = BVH4Triangle4vIntersectorsWatertight(accel);
+    return new AccelInstance(accel,builder,intersectors,BVH4Triangle4vIntersectorsHybrid(accel),BVH4Triangle4vIntersectorsWatertightBasic(accel));
   }
 
   Accel* BVH4::BVH4Triangle4iObjectSplit(Scene* scene)
   {
     BVH4* accel = new BVH4(Triangle4iType::type,scene);
     Builder* builder = BVH4BuilderObjectSplit4(accel,&scene->flat_triangle_source_1,scene,1,inf);
-    Accel::Intersectors intersectors = BVH4Triangle4iIntersectors(accel);
+    Accel::Intersectors intersectors = BVH4Triangle4iIntersectorsWatertight(accel);
     scene->needVertices = true;
-    return new AccelInstance(accel,builder,intersectors);
+    return new AccelInstance(accel,builder,intersectors,BVH4Triangle4iIntersectors(accel),BVH4Triangle4iIntersectorsWatertightBasic(accel));
   }
 
   Accel* BVH4::BVH4Triangle1ObjectSplit(TriangleMeshScene::TriangleMesh* mesh)
   {
-    BVH4* accel = new BVH4(TriangleMeshTriangle1::type);
+    BVH4* accel = new BVH4(TriangleMeshTriangle1::type,mesh->parent);
     Builder* builder = BVH4BuilderObjectSplit4TriangleMeshFast(accel,mesh,4,inf);
     Accel::Intersectors intersectors = BVH4Triangle1Intersectors(accel);
     return new AccelInstance(accel,builder,intersectors);
@@ -531,7 +846,7 @@ namespace embree
 
   Accel* BVH4::BVH4Triangle4ObjectSplit(TriangleMeshScene::TriangleMesh* mesh)
   {
-    BVH4* accel = new BVH4(TriangleMeshTriangle4::type);
+    BVH4* accel = new BVH4(TriangleMeshTriangle4::type,mesh->parent);
     Builder* builder = BVH4BuilderObjectSplit4TriangleMeshFast(accel,mesh,4,inf);
     Accel::Intersectors intersectors = BVH4Triangle4IntersectorsHybrid(accel);
     return new AccelInstance(accel,builder,intersectors);
@@ -539,7 +854,7 @@ namespace embree
 
   Accel* BVH4::BVH4Triangle1vObjectSplit(TriangleMeshScene::TriangleMesh* mesh)
   {
-    BVH4* accel = new BVH4(TriangleMeshTriangle1v::type);
+    BVH4* accel = new BVH4(TriangleMeshTriangle1v::type,mesh->parent);
     Builder* builder = BVH4BuilderObjectSplit4TriangleMeshFast(accel,mesh,4,inf);
     Accel::Intersectors intersectors = BVH4Triangle1vIntersectors(accel);
     return new AccelInstance(accel,builder,intersectors);
@@ -547,20 +862,62 @@ namespace embree
 
   Accel* BVH4::BVH4Triangle4vObjectSplit(TriangleMeshScene::TriangleMesh* mesh)
   {
-    BVH4* accel = new BVH4(TriangleMeshTriangle4v::type);
+    BVH4* accel = new BVH4(TriangleMeshTriangle4v::type,mesh->parent);
     Builder* builder = BVH4BuilderObjectSplit4TriangleMeshFast(accel,mesh,4,inf);
-    Accel::Intersectors intersectors = BVH4Triangle4vIntersectorsHybrid(accel);
+    Accel::Intersectors intersectors;
+    if (mesh->parent->isRobust()) intersectors = BVH4Triangle4vIntersectorsWatertight(accel);
+    else                          intersectors = BVH4Triangle4vIntersectorsHybrid(accel);
     return new AccelInstance(accel,builder,intersectors);
   }
 
   Accel* BVH4::BVH4Triangle4Refit(TriangleMeshScene::TriangleMesh* mesh)
   {
-    BVH4* accel = new BVH4(TriangleMeshTriangle4::type);
+    BVH4* accel = new BVH4(TriangleMeshTriangle4::type,mesh->parent);
     Builder* builder = BVH4BuilderRefitObjectSplit4TriangleMeshFast(accel,mesh,4,inf);
     Accel::Intersectors intersectors = BVH4Triangle4IntersectorsHybrid(accel);
     return new AccelInstance(accel,builder,intersectors);
   }
 
+  Accel* BVH4::BVH4Point4(Scene* scene)
+  {
+    BVH4* accel = new BVH4(ScenePoint4::type,scene);
+    Builder* builder = BVH4BuilderObjectSplit4(accel,&scene->flat_point_source,scene,1,inf);
+    Accel::Intersectors intersectors = BVH4Point4Intersectors(accel);
+    return new AccelInstance(accel,builder,intersectors);
+  }
+
+#if defined (__TARGET_AVX__)
+
+  Accel* BVH4::BVH4Point8(Scene* scene)
+  {
+    BVH4* accel = new BVH4(ScenePoint8::type,scene);
+    Builder* builder = BVH4BuilderObjectSplit8(accel,&scene->flat_point_source,scene,1,inf);
+    Accel::Intersectors intersectors = BVH4Point8Intersectors(accel);
+    return new AccelInstance(accel,builder,intersectors);
+  }
+
+#endif
+
+  Accel* BVH4::BVH4Quad4(Scene* scene)
+  {
+    BVH4* accel = new BVH4(SceneQuad4::type,scene);
+    Builder* builder = BVH4BuilderObjectSplit4(accel,&scene->flat_quad_source,scene,1,inf);
+    Accel::Intersectors intersectors = BVH4Quad4Intersectors(accel);
+    return new AccelInstance(accel,builder,intersectors);
+  }
+
+#if defined (__TARGET_AVX__)
+
+  Accel* BVH4::BVH4Quad8(Scene* scene)
+  {
+    BVH4* accel = new BVH4(SceneQuad8::type,scene);
+    Builder* builder = BVH4BuilderObjectSplit8(accel,&scene->flat_quad_source,scene,1,inf);
+    Accel::Intersectors intersectors = BVH4Quad8Intersectors(accel);
+    return new AccelInstance(accel,builder,intersectors);
+  }
+
+#endif
+
   void BVH4::clear () 
   {
     root = emptyNode;
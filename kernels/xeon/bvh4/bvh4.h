@@ -213,6 +213,8 @@ namespace embree
     static Accel* BVH4Triangle1v(Scene* scene);
     static Accel* BVH4Triangle4v(Scene* scene);
     static Accel* BVH4Triangle4i(Scene* scene);
+    static Accel* BVH4Triangle4q(Scene* scene);
+    static Accel* BVH4TriangleMeshlet(Scene* scene);
     
     static Accel* BVH4BVH4Triangle1Morton(Scene* scene);
     static Accel* BVH4BVH4Triangle1ObjectSplit(Scene* scene);
@@ -236,6 +238,12 @@ namespace embree
     static Accel* BVH4Triangle4vObjectSplit(TriangleMeshScene::TriangleMesh* mesh);
     static Accel* BVH4Triangle4Refit(TriangleMeshScene::TriangleMesh* mesh);
 
+    static Accel* BVH4Point4(Scene* scene);
+    static Accel* BVH4Point8(Scene* scene);
+
+    static Accel* BVH4Quad4(Scene* scene);
+    static Accel* BVH4Quad8(Scene* scene);
+
     /*! clears the acceleration structure */
     void clear ();
 
@@ -22,6 +22,7 @@
 
 #include "builders/heuristics.h"
 #include "builders/splitter_fallback.h"
+#include "sys/tasklogger.h"
 
 #define ROTATE_TREE 1
 
@@ -44,7 +45,9 @@ namespace embree
       t0 = getSeconds();
     
     /* first generate primrefs */
+    size_t taskID = TaskLogger::beginTask(threadIndex,"BVH4Builder::primrefgen",0);
     new (&initStage) PrimRefGenNormal(threadIndex,threadCount,source,&alloc);
+    TaskLogger::endTask(threadIndex,taskID);
     bvh->numPrimitives = initStage.numPrimitives;
     if (primTy.needVertices) bvh->numVertices = initStage.numVertices;
     else                     bvh->numVertices = 0;
@@ -54,8 +57,10 @@ namespace embree
 
     /* finish build */
 #if ROTATE_TREE
+    taskID = TaskLogger::beginTask(threadIndex,"BVH4Builder::rotate",0);
     for (int i=0; i<5; i++) 
       BVH4Rotate::rotate(bvh,bvh->root);
+    TaskLogger::endTask(threadIndex,taskID);
 #endif
     bvh->clearBarrier(bvh->root);
     bvh->bounds = initStage.pinfo.geomBounds;
@@ -95,8 +100,9 @@ namespace embree
   typename BVH4Builder<Heuristic>::NodeRef BVH4Builder<Heuristic>::createLeaf(size_t threadIndex, atomic_set<PrimRefBlock>& prims, const PrimInfo& pinfo)
   {
     /* allocate leaf node */
-    size_t blocks = primTy.blocks(pinfo.size());
+    size_t blocks = primTy.leafBlocks(prims,pinfo.size(),geometry);
     char* leaf = bvh->allocPrimitiveBlocks(threadIndex,blocks);
+    assert(blocks <= pinfo.size());
     assert(blocks <= (size_t)BVH4::maxLeafBlocks);
 
     /* insert all triangles */
@@ -121,8 +127,8 @@ namespace embree
       throw std::runtime_error("ERROR: Loosing primitives during build.");
 #endif
     
-    /* create leaf for few primitives */
-    if (pinfo.size() <= maxLeafSize)
+    /* create leaf for few primitives, unless they do not pack densely enough to fit into a leaf */
+    if (pinfo.size() <= maxLeafSize && primTy.leafBlocks(prims,pinfo.size(),geometry) <= (size_t)BVH4::maxLeafBlocks)
       return createLeaf(threadIndex,prims,pinfo);
 
     /* first level */
@@ -90,7 +90,7 @@ namespace embree
         else 
         {
           if (!g_state.get()) 
-            g_state.reset(new GlobalState(threadCount));
+            g_state.reset(new GlobalState(TaskScheduler::getNumThreads()));
 
           g_state->scheduler.init(threadCount);
           TaskScheduler::executeTask(threadIndex,threadCount,_build_parallel,this,threadCount,"build_parallel");
@@ -123,7 +123,7 @@ namespace embree
         else 
         {
           if (!g_state.get()) 
-            g_state.reset(new GlobalState(threadCount));
+            g_state.reset(new GlobalState(TaskScheduler::getNumThreads()));
 
           g_state->scheduler.init(threadCount);
           TaskScheduler::executeTask(threadIndex,threadCount,_build_parallel,this,threadCount,"build_parallel");
@@ -311,6 +311,7 @@ namespace embree
     
     void BVH4BuilderMorton::computeBounds(const size_t threadID, const size_t numThreads)
     {
+      size_t taskID = TaskLogger::beginTask(threadID,"BVH4BuilderMorton::computeBounds",0);
       const size_t startID = (threadID+0)*numPrimitives/numThreads;
       const size_t endID   = (threadID+1)*numPrimitives/numThreads;
       
@@ -335,6 +336,7 @@ namespace embree
       }
       
       global_bounds.extend_atomic(bounds);    
+      TaskLogger::endTask(threadID,taskID);
     }
 
     void BVH4BuilderMorton::computeMortonCodes(const size_t startID, const size_t endID, 
@@ -400,12 +402,14 @@ namespace embree
     
     void BVH4BuilderMorton::computeMortonCodes(const size_t threadID, const size_t numThreads)
     {      
+      size_t taskID = TaskLogger::beginTask(threadID,"BVH4BuilderMorton::computeMortonCodes",0);
       const size_t startID = (threadID+0)*numPrimitives/numThreads;
       const size_t endID   = (threadID+1)*numPrimitives/numThreads;
       
       /* store the morton codes temporarily in 'node' memory */
       MortonID32Bit* __restrict__ const dest = (MortonID32Bit*)nodeAllocator.data; 
       computeMortonCodes(startID,endID,g_state->startGroup[threadID],g_state->startGroupOffset[threadID],dest);
+      TaskLogger::endTask(threadID,taskID);
     }
     
     void BVH4BuilderMorton::recreateMortonCodes(SmallBuildRecord& current) const
@@ -453,7 +457,7 @@ namespace embree
     
     void BVH4BuilderMorton::radixsort(const size_t threadID, const size_t numThreads)
     {
-      //size_t taskID = TaskLogger::beginTask(threadID,"BVH4BuilderMorton::radixsort",0);
+      size_t taskID = TaskLogger::beginTask(threadID,"BVH4BuilderMorton::radixsort",0);
 
       const size_t startID = (threadID+0)*numPrimitives/numThreads;
       const size_t endID   = (threadID+1)*numPrimitives/numThreads;
@@ -512,7 +516,7 @@ namespace embree
         if (b < 2) scheduler.syncThreads(threadID,numThreads);
       }
 
-      //TaskLogger::endTask(threadID,taskID);
+      TaskLogger::endTask(threadID,taskID);
     }
     
     void BVH4BuilderMorton::recurseSubMortonTrees(const size_t threadID, const size_t numThreads)
@@ -524,11 +528,11 @@ namespace embree
         const unsigned int taskID = scheduler.taskCounter.inc();
         if (taskID >= g_state->numBuildRecords) break;
         
-        //size_t id = TaskLogger::beginTask(threadID,"BVH4BuilderMorton::subtree",0);
+        size_t id = TaskLogger::beginTask(threadID,"BVH4BuilderMorton::subtree",taskID);
         recurse(g_state->buildRecords[taskID],nodeAlloc,leafAlloc,RECURSE,threadID);
         g_state->buildRecords[taskID].parent->setBarrier();
         g_state->workStack.push(g_state->buildRecords[taskID]);
-        //TaskLogger::endTask(threadID,id);
+        TaskLogger::endTask(threadID,id);
       }
     }
     
@@ -1049,11 +1053,13 @@ namespace embree
       br.depth = 1;
       
       /* perform first splits in single threaded mode */
+      size_t taskID = TaskLogger::beginTask(threadIndex,"BVH4BuilderMorton::toplevel",0);
       nodeAllocator.reset();
       primAllocator.reset();
       __align(64) Allocator nodeAlloc(nodeAllocator);
       __align(64) Allocator leafAlloc(primAllocator);
       recurse(br,nodeAlloc,leafAlloc,CREATE_TOP_LEVEL,threadIndex);	    
+      TaskLogger::endTask(threadIndex,taskID);
       
       /* sort all subtasks by size */
       insertionsort_decending<SmallBuildRecord>(g_state->buildRecords,g_state->numBuildRecords);
@@ -1063,7 +1069,9 @@ namespace embree
       scheduler.dispatchTask( task_recurseSubMortonTrees, this, threadIndex, threadCount );
       
       /* refit toplevel part of tree */
+      taskID = TaskLogger::beginTask(threadIndex,"BVH4BuilderMorton::refit_toplevel",0);
       refit_toplevel(bvh->root);
+      TaskLogger::endTask(threadIndex,taskID);
       
       /* end task */
       scheduler.releaseThreads(threadCount);
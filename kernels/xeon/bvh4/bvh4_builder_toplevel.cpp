@@ -62,7 +62,7 @@ namespace embree
 
       /* create global state */
       if (!g_state.get()) 
-        g_state.reset(new GlobalState(threadCount));
+        g_state.reset(new GlobalState(TaskScheduler::getNumThreads()));
 
       /* delete some objects */
       size_t N = scene->size();
@@ -0,0 +1,240 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "bvh4_collider.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! tests if the projections of two triangles onto an axis are
+     *  disjoint, a degenerated axis never separates */
+    __forceinline bool separated(const Vec3fa& axis,
+                                 const Vec3fa& a0, const Vec3fa& a1, const Vec3fa& a2,
+                                 const Vec3fa& b0, const Vec3fa& b1, const Vec3fa& b2)
+    {
+      const float pa0 = dot(axis,a0), pa1 = dot(axis,a1), pa2 = dot(axis,a2);
+      const float pb0 = dot(axis,b0), pb1 = dot(axis,b1), pb2 = dot(axis,b2);
+      return max(pa0,pa1,pa2) < min(pb0,pb1,pb2) || max(pb0,pb1,pb2) < min(pa0,pa1,pa2);
+    }
+
+    /*! Tests two triangles for overlap using the separating axis
+     *  theorem. Besides the two normals and the 9 edge cross products
+     *  the in-plane edge normals are tested to handle coplanar
+     *  triangles. Touching triangles overlap. */
+    __forceinline bool overlap(const Vec3fa& a0, const Vec3fa& a1, const Vec3fa& a2,
+                               const Vec3fa& b0, const Vec3fa& b1, const Vec3fa& b2)
+    {
+      const Vec3fa ea[3] = { a1-a0, a2-a1, a0-a2 };
+      const Vec3fa eb[3] = { b1-b0, b2-b1, b0-b2 };
+      const Vec3fa na = cross(ea[0],ea[1]);
+      const Vec3fa nb = cross(eb[0],eb[1]);
+      if (separated(na,a0,a1,a2,b0,b1,b2)) return false;
+      if (separated(nb,a0,a1,a2,b0,b1,b2)) return false;
+      for (size_t i=0; i<3; i++)
+        for (size_t j=0; j<3; j++)
+          if (separated(cross(ea[i],eb[j]),a0,a1,a2,b0,b1,b2)) return false;
+      for (size_t i=0; i<3; i++) {
+        if (separated(cross(na,ea[i]),a0,a1,a2,b0,b1,b2)) return false;
+        if (separated(cross(nb,eb[i]),a0,a1,a2,b0,b1,b2)) return false;
+      }
+      return true;
+    }
+
+    /*! tests a box against 4 boxes in SoA layout */
+    __forceinline size_t overlap(const BBox3f& box,
+                                 const ssef& lower_x, const ssef& lower_y, const ssef& lower_z,
+                                 const ssef& upper_x, const ssef& upper_y, const ssef& upper_z)
+    {
+      const sseb mx = (lower_x <= ssef(box.upper.x)) & (upper_x >= ssef(box.lower.x));
+      const sseb my = (lower_y <= ssef(box.upper.y)) & (upper_y >= ssef(box.lower.y));
+      const sseb mz = (lower_z <= ssef(box.upper.z)) & (upper_z >= ssef(box.lower.z));
+      return movemask(mx & my & mz);
+    }
+
+    /*! returns bounds of one child of 4 boxes in SoA layout */
+    __forceinline BBox3f extract(size_t i,
+                                 const ssef& lower_x, const ssef& lower_y, const ssef& lower_z,
+                                 const ssef& upper_x, const ssef& upper_y, const ssef& upper_z)
+    {
+      return BBox3f(Vec3fa(lower_x[i],lower_y[i],lower_z[i]),Vec3fa(upper_x[i],upper_y[i],upper_z[i]));
+    }
+
+    BVH4Collider::BVH4Collider (const BVH4* bvh0, const BVH4* bvh1, const AffineSpace3f* xfm1, RTCCollideFunc callback, void* userPtr)
+      : bvh0(bvh0), bvh1(bvh1), transformed(xfm1 != NULL), xfm1(xfm1 ? *xfm1 : AffineSpace3f(one)), callback(callback), userPtr(userPtr) {}
+
+    void BVH4Collider::childBounds1(const Node* node, ssef& lower_x, ssef& lower_y, ssef& lower_z, ssef& upper_x, ssef& upper_y, ssef& upper_z) const
+    {
+      if (!transformed) {
+        lower_x = node->lower_x; lower_y = node->lower_y; lower_z = node->lower_z;
+        upper_x = node->upper_x; upper_y = node->upper_y; upper_z = node->upper_z;
+        return;
+      }
+
+      /* transform center and extent of the 4 boxes at once */
+      const sse3f c(0.5f*(node->lower_x+node->upper_x),0.5f*(node->lower_y+node->upper_y),0.5f*(node->lower_z+node->upper_z));
+      const sse3f e(0.5f*(node->upper_x-node->lower_x),0.5f*(node->upper_y-node->lower_y),0.5f*(node->upper_z-node->lower_z));
+      const LinearSpace3f& l = xfm1.l;
+      const sse3f tc = sse3f(l.vx.x*c.x + l.vy.x*c.y + l.vz.x*c.z + xfm1.p.x,
+                             l.vx.y*c.x + l.vy.y*c.y + l.vz.y*c.z + xfm1.p.y,
+                             l.vx.z*c.x + l.vy.z*c.y + l.vz.z*c.z + xfm1.p.z);
+      const sse3f te = sse3f(abs(l.vx.x)*e.x + abs(l.vy.x)*e.y + abs(l.vz.x)*e.z,
+                             abs(l.vx.y)*e.x + abs(l.vy.y)*e.y + abs(l.vz.y)*e.z,
+                             abs(l.vx.z)*e.x + abs(l.vy.z)*e.y + abs(l.vz.z)*e.z);
+
+      /* empty children get NaN bounds that never overlap */
+      lower_x = tc.x-te.x; lower_y = tc.y-te.y; lower_z = tc.z-te.z;
+      upper_x = tc.x+te.x; upper_y = tc.y+te.y; upper_z = tc.z+te.z;
+    }
+
+    void BVH4Collider::split(const NodePair& pair, std::vector<NodePair>& pairs) const
+    {
+      /* both nodes are inner nodes, test the 4x4 children pairs */
+      if (pair.ref0.isNode() && pair.ref1.isNode())
+      {
+        const Node* node0 = pair.ref0.node();
+        const Node* node1 = pair.ref1.node();
+        ssef lower_x, lower_y, lower_z, upper_x, upper_y, upper_z;
+        childBounds1(node1,lower_x,lower_y,lower_z,upper_x,upper_y,upper_z);
+        for (size_t j=0; j<4; j++)
+        {
+          if (node1->child(j) == BVH4::emptyNode) continue;
+          const BBox3f bounds1 = extract(j,lower_x,lower_y,lower_z,upper_x,upper_y,upper_z);
+          size_t mask = overlap(bounds1,node0->lower_x,node0->lower_y,node0->lower_z,node0->upper_x,node0->upper_y,node0->upper_z);
+          while (mask) {
+            const size_t i = __bsf(mask); mask = __btc(mask,i);
+            pairs.push_back(NodePair(node0->child(i),node0->bounds(i),node1->child(j),bounds1));
+          }
+        }
+      }
+
+      /* descend the first BVH */
+      else if (pair.ref0.isNode())
+      {
+        const Node* node0 = pair.ref0.node();
+        size_t mask = overlap(pair.bounds1,node0->lower_x,node0->lower_y,node0->lower_z,node0->upper_x,node0->upper_y,node0->upper_z);
+        while (mask) {
+          const size_t i = __bsf(mask); mask = __btc(mask,i);
+          pairs.push_back(NodePair(node0->child(i),node0->bounds(i),pair.ref1,pair.bounds1));
+        }
+      }
+
+      /* descend the second BVH */
+      else
+      {
+        const Node* node1 = pair.ref1.node();
+        ssef lower_x, lower_y, lower_z, upper_x, upper_y, upper_z;
+        childBounds1(node1,lower_x,lower_y,lower_z,upper_x,upper_y,upper_z);
+        size_t mask = overlap(pair.bounds0,lower_x,lower_y,lower_z,upper_x,upper_y,upper_z);
+        while (mask) {
+          const size_t j = __bsf(mask); mask = __btc(mask,j);
+          if (node1->child(j) == BVH4::emptyNode) continue;
+          pairs.push_back(NodePair(pair.ref0,pair.bounds0,node1->child(j),extract(j,lower_x,lower_y,lower_z,upper_x,upper_y,upper_z)));
+        }
+      }
+    }
+
+    void BVH4Collider::collideLeaves(const NodePair& pair, CollisionBuffer& buffer) const
+    {
+      /* extract triangles of both leaves, the triangles of the second leaf get transformed */
+      BlockTriangle tris0[maxLeafTriangles];
+      size_t num0 = 0, blocks0; const char* prim0 = pair.ref0.leaf(blocks0);
+      for (size_t i=0; i<blocks0; i++)
+        num0 += bvh0->primTy.triangles(prim0+i*bvh0->primTy.bytes,tris0+num0);
+
+      BlockTriangle tris1[maxLeafTriangles];
+      size_t num1 = 0, blocks1; const char* prim1 = pair.ref1.leaf(blocks1);
+      for (size_t i=0; i<blocks1; i++)
+        num1 += bvh1->primTy.triangles(prim1+i*bvh1->primTy.bytes,tris1+num1);
+
+      if (transformed) {
+        for (size_t j=0; j<num1; j++) {
+          tris1[j].v0 = xfmPoint(xfm1,tris1[j].v0);
+          tris1[j].v1 = xfmPoint(xfm1,tris1[j].v1);
+          tris1[j].v2 = xfmPoint(xfm1,tris1[j].v2);
+        }
+      }
+
+      /* only test triangles whose bounds overlap the other leaf */
+      for (size_t i=0; i<num0; i++)
+      {
+        const BlockTriangle& a = tris0[i];
+        const BBox3f boundsA(min(min(a.v0,a.v1),a.v2),max(max(a.v0,a.v1),a.v2));
+        if (disjoint(boundsA,pair.bounds1)) continue;
+
+        for (size_t j=0; j<num1; j++)
+        {
+          const BlockTriangle& b = tris1[j];
+          const BBox3f boundsB(min(min(b.v0,b.v1),b.v2),max(max(b.v0,b.v1),b.v2));
+          if (disjoint(boundsA,boundsB)) continue;
+          if (!overlap(a.v0,a.v1,a.v2,b.v0,b.v1,b.v2)) continue;
+          buffer.add(a.geomID,a.primID,b.geomID,b.primID);
+        }
+      }
+    }
+
+    void BVH4Collider::traverse(const NodePair& pair, CollisionBuffer& buffer) const
+    {
+      std::vector<NodePair> stack;
+      stack.push_back(pair);
+      while (!stack.empty())
+      {
+        const NodePair cur = stack.back(); stack.pop_back();
+        if (cur.ref0.isLeaf() && cur.ref1.isLeaf()) collideLeaves(cur,buffer);
+        else split(cur,stack);
+      }
+    }
+
+    void BVH4Collider::task_collide(size_t threadIndex, size_t threadCount, size_t taskIndex, size_t taskCount, TaskScheduler::Event* event)
+    {
+      CollisionBuffer buffer(this);
+      traverse(pairs[taskIndex],buffer);
+    }
+
+    void BVH4Collider::collide(const BVH4* bvh0, const BVH4* bvh1, const AffineSpace3f* xfm1, RTCCollideFunc callback, void* userPtr)
+    {
+      BVH4Collider collider(bvh0,bvh1,xfm1,callback,userPtr);
+      const BBox3f bounds1 = xfm1 ? xfmBounds(*xfm1,bvh1->bounds) : bvh1->bounds;
+      if (disjoint(bvh0->bounds,bounds1)) return;
+
+      /* expand the upper levels breadth first until there are enough pairs to keep all threads busy */
+      std::vector<NodePair>& pairs = collider.pairs;
+      pairs.push_back(NodePair(bvh0->root,bvh0->bounds,bvh1->root,bounds1));
+      const size_t numPairs = pairsPerThread*TaskScheduler::getNumThreads();
+      while (pairs.size() < numPairs)
+      {
+        std::vector<NodePair> next;
+        bool expanded = false;
+        for (size_t i=0; i<pairs.size(); i++) {
+          if (pairs[i].ref0.isLeaf() && pairs[i].ref1.isLeaf()) next.push_back(pairs[i]);
+          else { collider.split(pairs[i],next); expanded = true; }
+        }
+        pairs.swap(next);
+        if (!expanded) break;
+      }
+      if (pairs.empty()) return;
+
+      /* process the pairs in parallel */
+      TaskScheduler::EventSync event;
+      TaskScheduler::Task task(&event,_task_collide,&collider,pairs.size(),NULL,NULL,"BVH4Collider::collide");
+      TaskScheduler::addTask(-1,TaskScheduler::GLOBAL_FRONT,&task);
+      event.sync();
+      AVX_ZERO_UPPER();
+    }
+
+    DEFINE_COLLIDER(BVH4Collide,BVH4Collider);
+  }
+}
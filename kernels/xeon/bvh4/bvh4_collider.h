@@ -0,0 +1,120 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#ifndef __EMBREE_BVH4_COLLIDER_H__
+#define __EMBREE_BVH4_COLLIDER_H__
+
+#include "bvh4.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! Collision query between two BVH4 over triangles. Both BVHs
+     *  are traversed simultaneously, the 4 children of a node of
+     *  the first BVH are tested against the 4 children of a node of
+     *  the second BVH at once. The upper levels of the traversal are
+     *  expanded into a list of node pairs that get processed in
+     *  parallel. */
+    class BVH4Collider
+    {
+      /* shortcuts for frequently used types */
+      typedef BVH4::NodeRef NodeRef;
+      typedef BVH4::Node Node;
+
+      /*! maximal number of triangles of a leaf */
+      static const size_t maxLeafTriangles = BVH4::maxLeafBlocks*PrimitiveType::maxBlockTriangles;
+
+      /*! number of node pairs per thread to create before the traversal gets parallelized */
+      static const size_t pairsPerThread = 16;
+
+      /*! number of collisions collected before the callback gets invoked */
+      static const size_t collisionBufferSize = 256;
+
+      /*! pair of nodes whose bounds overlap, the bounds of the second
+       *  node are in the space of the first BVH */
+      struct NodePair
+      {
+        __forceinline NodePair () {}
+        __forceinline NodePair (NodeRef ref0, const BBox3f& bounds0, NodeRef ref1, const BBox3f& bounds1)
+          : ref0(ref0), ref1(ref1), bounds0(bounds0), bounds1(bounds1) {}
+
+        NodeRef ref0, ref1;
+        BBox3f bounds0, bounds1;
+      };
+
+      /*! collected collisions of one task */
+      struct CollisionBuffer
+      {
+        __forceinline CollisionBuffer (const BVH4Collider* collider)
+          : collider(collider), num(0) {}
+
+        __forceinline ~CollisionBuffer () { flush(); }
+
+        __forceinline void add(unsigned geomID0, unsigned primID0, unsigned geomID1, unsigned primID1)
+        {
+          if (num == collisionBufferSize) flush();
+          RTCCollision& c = collisions[num++];
+          c.geomID0 = geomID0; c.primID0 = primID0;
+          c.geomID1 = geomID1; c.primID1 = primID1;
+        }
+
+        __forceinline void flush() {
+          if (num) collider->callback(collider->userPtr,collisions,num);
+          num = 0;
+        }
+
+        const BVH4Collider* collider;
+        size_t num;
+        RTCCollision collisions[collisionBufferSize];
+      };
+
+    public:
+      BVH4Collider (const BVH4* bvh0, const BVH4* bvh1, const AffineSpace3f* xfm1, RTCCollideFunc callback, void* userPtr);
+
+      /*! reports all overlapping triangle pairs of the two BVHs */
+      static void collide(const BVH4* bvh0, const BVH4* bvh1, const AffineSpace3f* xfm1, RTCCollideFunc callback, void* userPtr);
+
+    private:
+
+      /*! bounds of the 4 children of a node of the second BVH in the space of the first BVH */
+      void childBounds1(const Node* node, ssef& lower_x, ssef& lower_y, ssef& lower_z, ssef& upper_x, ssef& upper_y, ssef& upper_z) const;
+
+      /*! adds all overlapping children pairs of a node pair */
+      void split(const NodePair& pair, std::vector<NodePair>& pairs) const;
+
+      /*! tests all triangles of two leaves against each other */
+      void collideLeaves(const NodePair& pair, CollisionBuffer& buffer) const;
+
+      /*! processes all node pairs below a pair of nodes */
+      void traverse(const NodePair& pair, CollisionBuffer& buffer) const;
+
+      /*! processes one of the node pairs of the upper levels */
+      TASK_RUN_FUNCTION(BVH4Collider,task_collide);
+
+    private:
+      const BVH4* bvh0;               //!< first BVH
+      const BVH4* bvh1;               //!< second BVH
+      const bool transformed;         //!< true if the second BVH is transformed
+      AffineSpace3f xfm1;             //!< transformation of the second BVH
+      RTCCollideFunc callback;        //!< receives the overlapping triangle pairs
+      void* userPtr;                  //!< passed to the callback
+      std::vector<NodePair> pairs;    //!< node pairs processed in parallel
+    };
+  }
+}
+
+#endif
@@ -24,14 +24,26 @@
 #include "geometry/triangle1v_intersector1_pluecker.h"
 #include "geometry/triangle4v_intersector1_pluecker.h"
 #include "geometry/triangle4i_intersector1.h"
+#include "geometry/triangle4v_intersector1_watertight.h"
+#include "geometry/triangle4i_intersector1_watertight.h"
+#include "geometry/triangle4q_intersector1.h"
+#include "geometry/trianglemeshlet_intersector1.h"
 #include "geometry/virtual_accel_intersector1.h"
+#include "geometry/point4_intersector1.h"
+#if defined(__AVX__)
+#include "geometry/point8_intersector1.h"
+#endif
+#include "geometry/quad4_intersector1.h"
+#if defined(__AVX__)
+#include "geometry/quad8_intersector1.h"
+#endif
 
 namespace embree
 { 
   namespace isa
   {
-    template<typename PrimitiveIntersector>
-    void BVH4Intersector1<PrimitiveIntersector>::intersect(const BVH4* bvh, Ray& ray)
+    template<typename PrimitiveIntersector, bool robust>
+    void BVH4Intersector1<PrimitiveIntersector,robust>::intersect(const BVH4* bvh, Ray& ray)
     {
       /*! stack state */
       StackItem stack[stackSize];  //!< stack of nodes 
@@ -63,7 +75,7 @@ namespace embree
 #else
       /*! load the ray into SIMD registers */
       const sse3f norg(-ray.org.x,-ray.org.y,-ray.org.z);
-      const Vec3fa ray_rdir = rcp_safe(ray.dir);
+      const Vec3fa ray_rdir = robust ? Vec3fa(1.0f)/zero_fix(ray.dir) : rcp_safe(ray.dir);
       const sse3f rdir(ray_rdir.x,ray_rdir.y,ray_rdir.z);
       const Vec3fa ray_org_rdir = ray.org*ray_rdir;
       const sse3f org_rdir(ray_org_rdir.x,ray_org_rdir.y,ray_org_rdir.z);
@@ -92,34 +104,10 @@ namespace embree
           
           /*! single ray intersection with 4 boxes */
           const Node* node = cur.node();
-          const size_t farX  = nearX ^ 16, farY  = nearY ^ 16, farZ  = nearZ ^ 16;
-#if defined (__AVX2__)
-          const ssef tNearX = msub(load4f((const char*)node+nearX), rdir.x, org_rdir.x);
-          const ssef tNearY = msub(load4f((const char*)node+nearY), rdir.y, org_rdir.y);
-          const ssef tNearZ = msub(load4f((const char*)node+nearZ), rdir.z, org_rdir.z);
-          const ssef tFarX  = msub(load4f((const char*)node+farX ), rdir.x, org_rdir.x);
-          const ssef tFarY  = msub(load4f((const char*)node+farY ), rdir.y, org_rdir.y);
-          const ssef tFarZ  = msub(load4f((const char*)node+farZ ), rdir.z, org_rdir.z);
-#else
-          const ssef tNearX = (norg.x + load4f((const char*)node+nearX)) * rdir.x;
-          const ssef tNearY = (norg.y + load4f((const char*)node+nearY)) * rdir.y;
-          const ssef tNearZ = (norg.z + load4f((const char*)node+nearZ)) * rdir.z;
-          const ssef tFarX  = (norg.x + load4f((const char*)node+farX )) * rdir.x;
-          const ssef tFarY  = (norg.y + load4f((const char*)node+farY )) * rdir.y;
-          const ssef tFarZ  = (norg.z + load4f((const char*)node+farZ )) * rdir.z;
-#endif
-
-#if defined(__SSE4_1__)
-          const ssef tNear = maxi(maxi(tNearX,tNearY),maxi(tNearZ,ray_near));
-          const ssef tFar  = mini(mini(tFarX ,tFarY ),mini(tFarZ ,ray_far ));
-          const sseb vmask = cast(tNear) > cast(tFar);
-          size_t mask = movemask(vmask)^0xf;
-#else
-          const ssef tNear = max(tNearX,tNearY,tNearZ,ray_near);
-          const ssef tFar  = min(tFarX ,tFarY ,tFarZ ,ray_far);
-          const sseb vmask = tNear <= tFar;
-          size_t mask = movemask(vmask);
-#endif
+          ssef tNear;
+          size_t mask = robust 
+            ? intersectBoxRobust(node,nearX,nearY,nearZ,norg,rdir,ray_near,ray_far,tNear)
+            : intersectBox(node,nearX,nearY,nearZ,norg,rdir,org_rdir,ray_near,ray_far,tNear);
           
           /*! if no child is hit, pop next node */
           if (unlikely(mask == 0))
@@ -181,8 +169,8 @@ namespace embree
       AVX_ZERO_UPPER();
     }
     
-    template<typename PrimitiveIntersector>
-    void BVH4Intersector1<PrimitiveIntersector>::occluded(const BVH4* bvh, Ray& ray)
+    template<typename PrimitiveIntersector, bool robust>
+    void BVH4Intersector1<PrimitiveIntersector,robust>::occluded(const BVH4* bvh, Ray& ray)
     {
       /*! stack state */
       NodeRef stack[stackSize];  //!< stack of nodes that still need to get traversed
@@ -213,7 +201,7 @@ namespace embree
 #else
       /*! load the ray into SIMD registers */
       const sse3f norg(-ray.org.x,-ray.org.y,-ray.org.z);
-      const Vec3fa ray_rdir = rcp_safe(ray.dir);
+      const Vec3fa ray_rdir = robust ? Vec3fa(1.0f)/zero_fix(ray.dir) : rcp_safe(ray.dir);
       const sse3f rdir(ray_rdir.x,ray_rdir.y,ray_rdir.z);
       const Vec3fa ray_org_rdir = ray.org*ray_rdir;
       const sse3f org_rdir(ray_org_rdir.x,ray_org_rdir.y,ray_org_rdir.z);
@@ -238,34 +226,10 @@ namespace embree
           
           /*! single ray intersection with 4 boxes */
           const Node* node = cur.node();
-          const size_t farX  = nearX ^ 16, farY  = nearY ^ 16, farZ  = nearZ ^ 16;
-#if defined (__AVX2__)
-          const ssef tNearX = msub(load4f((const char*)node+nearX), rdir.x, org_rdir.x);
-          const ssef tNearY = msub(load4f((const char*)node+nearY), rdir.y, org_rdir.y);
-          const ssef tNearZ = msub(load4f((const char*)node+nearZ), rdir.z, org_rdir.z);
-          const ssef tFarX  = msub(load4f((const char*)node+farX ), rdir.x, org_rdir.x);
-          const ssef tFarY  = msub(load4f((const char*)node+farY ), rdir.y, org_rdir.y);
-          const ssef tFarZ  = msub(load4f((const char*)node+farZ ), rdir.z, org_rdir.z);
-#else
-          const ssef tNearX = (norg.x + load4f((const char*)node+nearX)) * rdir.x;
-          const ssef tNearY = (norg.y + load4f((const char*)node+nearY)) * rdir.y;
-          const ssef tNearZ = (norg.z + load4f((const char*)node+nearZ)) * rdir.z;
-          const ssef tFarX  = (norg.x + load4f((const char*)node+farX )) * rdir.x;
-          const ssef tFarY  = (norg.y + load4f((const char*)node+farY )) * rdir.y;
-          const ssef tFarZ  = (norg.z + load4f((const char*)node+farZ )) * rdir.z;
-#endif
-          
-#if defined(__SSE4_1__)
-          const ssef tNear = maxi(maxi(tNearX,tNearY),maxi(tNearZ,ray_near));
-          const ssef tFar  = mini(mini(tFarX ,tFarY ),mini(tFarZ ,ray_far ));
-          const sseb vmask = cast(tNear) > cast(tFar);
-          size_t mask = movemask(vmask)^0xf;
-#else
-          const ssef tNear = max(tNearX,tNearY,tNearZ,ray_near);
-          const ssef tFar  = min(tFarX ,tFarY ,tFarZ ,ray_far);
-          const sseb vmask = tNear <= tFar;
-          size_t mask = movemask(vmask);
-#endif
+          ssef tNear;
+          size_t mask = robust 
+            ? intersectBoxRobust(node,nearX,nearY,nearZ,norg,rdir,ray_near,ray_far,tNear)
+            : intersectBox(node,nearX,nearY,nearZ,norg,rdir,org_rdir,ray_near,ray_far,tNear);
           
           /*! if no child is hit, pop next node */
           if (unlikely(mask == 0))
@@ -318,14 +282,31 @@ namespace embree
       AVX_ZERO_UPPER();
     }
 
-    DEFINE_INTERSECTOR1(BVH4Triangle1Intersector1Moeller,BVH4Intersector1<Triangle1Intersector1MoellerTrumbore>);
-    DEFINE_INTERSECTOR1(BVH4Triangle4Intersector1Moeller,BVH4Intersector1<Triangle4Intersector1MoellerTrumbore>);
+    DEFINE_INTERSECTOR1(BVH4Triangle1Intersector1Moeller,BVH4Intersector1<Triangle1Intersector1MoellerTrumbore<KERNEL_FEATURES_ALL> >);
+    DEFINE_INTERSECTOR1(BVH4Triangle1Intersector1MoellerBasic,BVH4Intersector1<Triangle1Intersector1MoellerTrumbore<KERNEL_FEATURES_NONE> >);
+    DEFINE_INTERSECTOR1(BVH4Triangle4Intersector1Moeller,BVH4Intersector1<Triangle4Intersector1MoellerTrumbore<KERNEL_FEATURES_ALL> >);
+    DEFINE_INTERSECTOR1(BVH4Triangle4Intersector1MoellerBasic,BVH4Intersector1<Triangle4Intersector1MoellerTrumbore<KERNEL_FEATURES_NONE> >);
 #if defined(__AVX__)
-    DEFINE_INTERSECTOR1(BVH4Triangle8Intersector1Moeller,BVH4Intersector1<Triangle8Intersector1MoellerTrumbore>);
+    DEFINE_INTERSECTOR1(BVH4Triangle8Intersector1Moeller,BVH4Intersector1<Triangle8Intersector1MoellerTrumbore<KERNEL_FEATURES_ALL> >);
+    DEFINE_INTERSECTOR1(BVH4Triangle8Intersector1MoellerBasic,BVH4Intersector1<Triangle8Intersector1MoellerTrumbore<KERNEL_FEATURES_NONE> >);
 #endif
     DEFINE_INTERSECTOR1(BVH4Triangle1vIntersector1Pluecker,BVH4Intersector1<Triangle1vIntersector1Pluecker>);
     DEFINE_INTERSECTOR1(BVH4Triangle4vIntersector1Pluecker,BVH4Intersector1<Triangle4vIntersector1Pluecker>);
     DEFINE_INTERSECTOR1(BVH4Triangle4iIntersector1Pluecker,BVH4Intersector1<Triangle4iIntersector1Pluecker>);
+    DEFINE_INTERSECTOR1(BVH4Triangle4vIntersector1Watertight,BVH4Intersector1<Triangle4vIntersector1Watertight<KERNEL_FEATURES_ALL>,true>);
+    DEFINE_INTERSECTOR1(BVH4Triangle4vIntersector1WatertightBasic,BVH4Intersector1<Triangle4vIntersector1Watertight<KERNEL_FEATURES_NONE>,true>);
+    DEFINE_INTERSECTOR1(BVH4Triangle4iIntersector1Watertight,BVH4Intersector1<Triangle4iIntersector1Watertight<KERNEL_FEATURES_ALL>,true>);
+    DEFINE_INTERSECTOR1(BVH4Triangle4iIntersector1WatertightBasic,BVH4Intersector1<Triangle4iIntersector1Watertight<KERNEL_FEATURES_NONE>,true>);
+    DEFINE_INTERSECTOR1(BVH4Triangle4qIntersector1,BVH4Intersector1<Triangle4qIntersector1>);
+    DEFINE_INTERSECTOR1(BVH4TriangleMeshletIntersector1,BVH4Intersector1<TriangleMeshletIntersector1>);
     DEFINE_INTERSECTOR1(BVH4VirtualIntersector1,BVH4Intersector1<VirtualAccelIntersector1>);
+    DEFINE_INTERSECTOR1(BVH4Point4Intersector1,BVH4Intersector1<Point4Intersector1>);
+#if defined(__AVX__)
+    DEFINE_INTERSECTOR1(BVH4Point8Intersector1,BVH4Intersector1<Point8Intersector1>);
+#endif
+    DEFINE_INTERSECTOR1(BVH4Quad4Intersector1,BVH4Intersector1<Quad4Intersector1>);
+#if defined(__AVX__)
+    DEFINE_INTERSECTOR1(BVH4Quad8Intersector1,BVH4Intersector1<Quad8Intersector1>);
+#endif
   }
 }
@@ -25,9 +25,73 @@ namespace embree
 {
   namespace isa
   {
-    /*! BVH4 single ray traversal implementation. */
-    template<typename PrimitiveIntersector>
-      class BVH4Intersector1 
+    /*! Intersects a single ray with the 4 child boxes of a BVH4
+     *  node. The near offsets select the lower or upper bounds of the
+     *  node depending on the ray direction. Returns a bitmask of the
+     *  hit children and their entry distances in tNear. */
+    __forceinline size_t intersectBox(const BVH4::Node* node, const size_t nearX, const size_t nearY, const size_t nearZ,
+                                      const sse3f& norg, const sse3f& rdir, const sse3f& org_rdir, 
+                                      const ssef& ray_near, const ssef& ray_far, ssef& tNear)
+    {
+      const size_t farX  = nearX ^ 16, farY  = nearY ^ 16, farZ  = nearZ ^ 16;
+#if defined (__AVX2__)
+      const ssef tNearX = msub(load4f((const char*)node+nearX), rdir.x, org_rdir.x);
+      const ssef tNearY = msub(load4f((const char*)node+nearY), rdir.y, org_rdir.y);
+      const ssef tNearZ = msub(load4f((const char*)node+nearZ), rdir.z, org_rdir.z);
+      const ssef tFarX  = msub(load4f((const char*)node+farX ), rdir.x, org_rdir.x);
+      const ssef tFarY  = msub(load4f((const char*)node+farY ), rdir.y, org_rdir.y);
+      const ssef tFarZ  = msub(load4f((const char*)node+farZ ), rdir.z, org_rdir.z);
+#else
+      const ssef tNearX = (norg.x + load4f((const char*)node+nearX)) * rdir.x;
+      const ssef tNearY = (norg.y + load4f((const char*)node+nearY)) * rdir.y;
+      const ssef tNearZ = (norg.z + load4f((const char*)node+nearZ)) * rdir.z;
+      const ssef tFarX  = (norg.x + load4f((const char*)node+farX )) * rdir.x;
+      const ssef tFarY  = (norg.y + load4f((const char*)node+farY )) * rdir.y;
+      const ssef tFarZ  = (norg.z + load4f((const char*)node+farZ )) * rdir.z;
+#endif
+      
+#if defined(__SSE4_1__)
+      tNear = maxi(maxi(tNearX,tNearY),maxi(tNearZ,ray_near));
+      const ssef tFar  = mini(mini(tFarX ,tFarY ),mini(tFarZ ,ray_far ));
+      const sseb vmask = cast(tNear) > cast(tFar);
+      return movemask(vmask)^0xf;
+#else
+      tNear = max(tNearX,tNearY,tNearZ,ray_near);
+      const ssef tFar  = min(tFarX ,tFarY ,tFarZ ,ray_far);
+      const sseb vmask = tNear <= tFar;
+      return movemask(vmask);
+#endif
+    }
+
+    /*! Conservative variant of the box test used for robust
+     *  scenes. The slab distances are calculated without fused
+     *  operations from an exact reciprocal direction, and the entry
+     *  and exit distances are scaled to cover their rounding errors,
+     *  thus a box is never missed by a ray that hits one of its
+     *  triangles. */
+    __forceinline size_t intersectBoxRobust(const BVH4::Node* node, const size_t nearX, const size_t nearY, const size_t nearZ,
+                                            const sse3f& norg, const sse3f& rdir,
+                                            const ssef& ray_near, const ssef& ray_far, ssef& tNear)
+    {
+      const size_t farX  = nearX ^ 16, farY  = nearY ^ 16, farZ  = nearZ ^ 16;
+      const ssef tNearX = (norg.x + load4f((const char*)node+nearX)) * rdir.x;
+      const ssef tNearY = (norg.y + load4f((const char*)node+nearY)) * rdir.y;
+      const ssef tNearZ = (norg.z + load4f((const char*)node+nearZ)) * rdir.z;
+      const ssef tFarX  = (norg.x + load4f((const char*)node+farX )) * rdir.x;
+      const ssef tFarY  = (norg.y + load4f((const char*)node+farY )) * rdir.y;
+      const ssef tFarZ  = (norg.z + load4f((const char*)node+farZ )) * rdir.z;
+      const float round_down = 1.0f-2.0f*float(ulp);
+      const float round_up   = 1.0f+2.0f*float(ulp);
+      tNear = max(tNearX,tNearY,tNearZ,ray_near);
+      const ssef tFar  = min(tFarX ,tFarY ,tFarZ ,ray_far);
+      const sseb vmask = round_down*tNear <= round_up*tFar;
+      return movemask(vmask);
+    }
+
+    /*! BVH4 single ray traversal implementation. If robust is set
+     *  the conservative box test is used. */
+    template<typename PrimitiveIntersector, bool robust = false>
+      class BVH4Intersector1
     {
       /* shortcuts for frequently used types */
       typedef typename PrimitiveIntersector::Primitive Primitive;
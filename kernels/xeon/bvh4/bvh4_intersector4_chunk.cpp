@@ -24,18 +24,50 @@
 #include "geometry/triangle1v_intersector4_pluecker.h"
 #include "geometry/triangle4v_intersector4_pluecker.h"
 #include "geometry/triangle4i_intersector4.h"
+#include "geometry/triangle4v_intersector4_watertight.h"
+#include "geometry/triangle4i_intersector4_watertight.h"
+#include "geometry/triangle4q_intersector4.h"
+#include "geometry/trianglemeshlet_intersector4.h"
 #include "geometry/virtual_accel_intersector4.h"
+#include "geometry/point4_intersector4.h"
+#if defined(__AVX__)
+#include "geometry/point8_intersector4.h"
+#endif
+#include "geometry/quad4_intersector4.h"
+#if defined(__AVX__)
+#include "geometry/quad8_intersector4.h"
+#endif
 
 namespace embree
 {
   namespace isa
   {
-    template<typename PrimitiveIntersector4>
-    void BVH4Intersector4Chunk<PrimitiveIntersector4>::intersect(sseb* valid_i, BVH4* bvh, Ray4& ray)
+    /*! Conservative box test for robust scenes. The slab distances
+     *  are calculated without fused operations from an exact
+     *  reciprocal direction and the entry and exit distances are
+     *  scaled to cover their rounding errors. */
+    __forceinline sseb intersectBoxRobust(const BVH4::Node* node, const size_t i, const sse3f& org, const sse3f& rdir,
+                                          const ssef& ray_tnear, const ssef& ray_tfar, ssef& lnearP)
+    {
+      const ssef lclipMinX = (node->lower_x[i] - org.x) * rdir.x;
+      const ssef lclipMinY = (node->lower_y[i] - org.y) * rdir.y;
+      const ssef lclipMinZ = (node->lower_z[i] - org.z) * rdir.z;
+      const ssef lclipMaxX = (node->upper_x[i] - org.x) * rdir.x;
+      const ssef lclipMaxY = (node->upper_y[i] - org.y) * rdir.y;
+      const ssef lclipMaxZ = (node->upper_z[i] - org.z) * rdir.z;
+      lnearP = max(max(min(lclipMinX, lclipMaxX), min(lclipMinY, lclipMaxY)), min(lclipMinZ, lclipMaxZ));
+      const ssef lfarP = min(min(max(lclipMinX, lclipMaxX), max(lclipMinY, lclipMaxY)), max(lclipMinZ, lclipMaxZ));
+      const float round_down = 1.0f-2.0f*float(ulp);
+      const float round_up   = 1.0f+2.0f*float(ulp);
+      return round_down*max(lnearP,ray_tnear) <= round_up*min(lfarP,ray_tfar);
+    }
+
+    template<typename PrimitiveIntersector4, bool robust>
+    void BVH4Intersector4Chunk<PrimitiveIntersector4,robust>::intersect(sseb* valid_i, BVH4* bvh, Ray4& ray)
     {
       /* load ray */
       const sseb valid0 = *valid_i;
-      const sse3f rdir = rcp_safe(ray.dir);
+      const sse3f rdir = robust ? ssef(one)/zero_fix(ray.dir) : rcp_safe(ray.dir);
       const sse3f org(ray.org), org_rdir = org * rdir;
       ssef ray_tnear = select(valid0,ray.tnear,ssef(pos_inf));
       ssef ray_tfar  = select(valid0,ray.tfar ,ssef(neg_inf));
@@ -92,31 +124,36 @@ namespace embree
             const NodeRef child = node->children[i];
             if (unlikely(child == BVH4::emptyNode)) break;
             
+            ssef lnearP; sseb lhit;
+            if (robust)
+              lhit = intersectBoxRobust(node,i,org,rdir,ray_tnear,ray_tfar,lnearP);
+            else {
 #if defined(__AVX2__)
-            const ssef lclipMinX = msub(node->lower_x[i],rdir.x,org_rdir.x);
-            const ssef lclipMinY = msub(node->lower_y[i],rdir.y,org_rdir.y);
-            const ssef lclipMinZ = msub(node->lower_z[i],rdir.z,org_rdir.z);
-            const ssef lclipMaxX = msub(node->upper_x[i],rdir.x,org_rdir.x);
-            const ssef lclipMaxY = msub(node->upper_y[i],rdir.y,org_rdir.y);
-            const ssef lclipMaxZ = msub(node->upper_z[i],rdir.z,org_rdir.z);
+              const ssef lclipMinX = msub(node->lower_x[i],rdir.x,org_rdir.x);
+              const ssef lclipMinY = msub(node->lower_y[i],rdir.y,org_rdir.y);
+              const ssef lclipMinZ = msub(node->lower_z[i],rdir.z,org_rdir.z);
+              const ssef lclipMaxX = msub(node->upper_x[i],rdir.x,org_rdir.x);
+              const ssef lclipMaxY = msub(node->upper_y[i],rdir.y,org_rdir.y);
+              const ssef lclipMaxZ = msub(node->upper_z[i],rdir.z,org_rdir.z);
 #else
-            const ssef lclipMinX = (node->lower_x[i] - org.x) * rdir.x;
-            const ssef lclipMinY = (node->lower_y[i] - org.y) * rdir.y;
-            const ssef lclipMinZ = (node->lower_z[i] - org.z) * rdir.z;
-            const ssef lclipMaxX = (node->upper_x[i] - org.x) * rdir.x;
-            const ssef lclipMaxY = (node->upper_y[i] - org.y) * rdir.y;
-            const ssef lclipMaxZ = (node->upper_z[i] - org.z) * rdir.z;
+              const ssef lclipMinX = (node->lower_x[i] - org.x) * rdir.x;
+              const ssef lclipMinY = (node->lower_y[i] - org.y) * rdir.y;
+              const ssef lclipMinZ = (node->lower_z[i] - org.z) * rdir.z;
+              const ssef lclipMaxX = (node->upper_x[i] - org.x) * rdir.x;
+              const ssef lclipMaxY = (node->upper_y[i] - org.y) * rdir.y;
+              const ssef lclipMaxZ = (node->upper_z[i] - org.z) * rdir.z;
 #endif
 
 #if defined(__SSE4_1__)
-            const ssef lnearP = maxi(maxi(mini(lclipMinX, lclipMaxX), mini(lclipMinY, lclipMaxY)), mini(lclipMinZ, lclipMaxZ));
-            const ssef lfarP  = mini(mini(maxi(lclipMinX, lclipMaxX), maxi(lclipMinY, lclipMaxY)), maxi(lclipMinZ, lclipMaxZ));
-            const sseb lhit   = maxi(lnearP,ray_tnear) <= mini(lfarP,ray_tfar);      
+              lnearP = maxi(maxi(mini(lclipMinX, lclipMaxX), mini(lclipMinY, lclipMaxY)), mini(lclipMinZ, lclipMaxZ));
+              const ssef lfarP  = mini(mini(maxi(lclipMinX, lclipMaxX), maxi(lclipMinY, lclipMaxY)), maxi(lclipMinZ, lclipMaxZ));
+              lhit   = maxi(lnearP,ray_tnear) <= mini(lfarP,ray_tfar);      
 #else
-            const ssef lnearP = max(max(min(lclipMinX, lclipMaxX), min(lclipMinY, lclipMaxY)), min(lclipMinZ, lclipMaxZ));
-            const ssef lfarP  = min(min(max(lclipMinX, lclipMaxX), max(lclipMinY, lclipMaxY)), max(lclipMinZ, lclipMaxZ));
-            const sseb lhit   = max(lnearP,ray_tnear) <= min(lfarP,ray_tfar);      
+              lnearP = max(max(min(lclipMinX, lclipMaxX), min(lclipMinY, lclipMaxY)), min(lclipMinZ, lclipMaxZ));
+              const ssef lfarP  = min(min(max(lclipMinX, lclipMaxX), max(lclipMinY, lclipMaxY)), max(lclipMinZ, lclipMaxZ));
+              lhit   = max(lnearP,ray_tnear) <= min(lfarP,ray_tfar);      
 #endif
+            }
             
             /* if we hit the child we choose to continue with that child if it 
                is closer than the current next child, or we push it onto the stack */
@@ -163,13 +200,13 @@ namespace embree
       AVX_ZERO_UPPER();
     }
     
-    template<typename PrimitiveIntersector4>
-    void BVH4Intersector4Chunk<PrimitiveIntersector4>::occluded(sseb* valid_i, BVH4* bvh, Ray4& ray)
+    template<typename PrimitiveIntersector4, bool robust>
+    void BVH4Intersector4Chunk<PrimitiveIntersector4,robust>::occluded(sseb* valid_i, BVH4* bvh, Ray4& ray)
     {
       /* load ray */
       const sseb valid = *valid_i;
       sseb terminated = !valid;
-      const sse3f rdir = rcp_safe(ray.dir);
+      const sse3f rdir = robust ? ssef(one)/zero_fix(ray.dir) : rcp_safe(ray.dir);
       const sse3f org(ray.org), org_rdir = org * rdir;
       ssef ray_tnear = select(valid,ray.tnear,ssef(pos_inf));
       ssef ray_tfar  = select(valid,ray.tfar ,ssef(neg_inf));
@@ -226,31 +263,36 @@ namespace embree
             const NodeRef child = node->children[i];
             if (unlikely(child == BVH4::emptyNode)) break;
             
+            ssef lnearP; sseb lhit;
+            if (robust)
+              lhit = intersectBoxRobust(node,i,org,rdir,ray_tnear,ray_tfar,lnearP);
+            else {
 #if defined(__AVX2__)
-            const ssef lclipMinX = msub(node->lower_x[i],rdir.x,org_rdir.x);
-            const ssef lclipMinY = msub(node->lower_y[i],rdir.y,org_rdir.y);
-            const ssef lclipMinZ = msub(node->lower_z[i],rdir.z,org_rdir.z);
-            const ssef lclipMaxX = msub(node->upper_x[i],rdir.x,org_rdir.x);
-            const ssef lclipMaxY = msub(node->upper_y[i],rdir.y,org_rdir.y);
-            const ssef lclipMaxZ = msub(node->upper_z[i],rdir.z,org_rdir.z);
+              const ssef lclipMinX = msub(node->lower_x[i],rdir.x,org_rdir.x);
+              const ssef lclipMinY = msub(node->lower_y[i],rdir.y,org_rdir.y);
+              const ssef lclipMinZ = msub(node->lower_z[i],rdir.z,org_rdir.z);
+              const ssef lclipMaxX = msub(node->upper_x[i],rdir.x,org_rdir.x);
+              const ssef lclipMaxY = msub(node->upper_y[i],rdir.y,org_rdir.y);
+              const ssef lclipMaxZ = msub(node->upper_z[i],rdir.z,org_rdir.z);
 #else
-            const ssef lclipMinX = (node->lower_x[i] - org.x) * rdir.x;
-            const ssef lclipMinY = (node->lower_y[i] - org.y) * rdir.y;
-            const ssef lclipMinZ = (node->lower_z[i] - org.z) * rdir.z;
-            const ssef lclipMaxX = (node->upper_x[i] - org.x) * rdir.x;
-            const ssef lclipMaxY = (node->upper_y[i] - org.y) * rdir.y;
-            const ssef lclipMaxZ = (node->upper_z[i] - org.z) * rdir.z;
+              const ssef lclipMinX = (node->lower_x[i] - org.x) * rdir.x;
+              const ssef lclipMinY = (node->lower_y[i] - org.y) * rdir.y;
+              const ssef lclipMinZ = (node->lower_z[i] - org.z) * rdir.z;
+              const ssef lclipMaxX = (node->upper_x[i] - org.x) * rdir.x;
+              const ssef lclipMaxY = (node->upper_y[i] - org.y) * rdir.y;
+              const ssef lclipMaxZ = (node->upper_z[i] - org.z) * rdir.z;
 #endif
 
 #if defined(__SSE4_1__)
-            const ssef lnearP = maxi(maxi(mini(lclipMinX, lclipMaxX), mini(lclipMinY, lclipMaxY)), mini(lclipMinZ, lclipMaxZ));
-            const ssef lfarP  = mini(mini(maxi(lclipMinX, lclipMaxX), maxi(lclipMinY, lclipMaxY)), maxi(lclipMinZ, lclipMaxZ));
-            const sseb lhit   = maxi(lnearP,ray_tnear) <= mini(lfarP,ray_tfar);      
+              lnearP = maxi(maxi(mini(lclipMinX, lclipMaxX), mini(lclipMinY, lclipMaxY)), mini(lclipMinZ, lclipMaxZ));
+              const ssef lfarP  = mini(mini(maxi(lclipMinX, lclipMaxX), maxi(lclipMinY, lclipMaxY)), maxi(lclipMinZ, lclipMaxZ));
+              lhit   = maxi(lnearP,ray_tnear) <= mini(lfarP,ray_tfar);      
 #else
-            const ssef lnearP = max(max(min(lclipMinX, lclipMaxX), min(lclipMinY, lclipMaxY)), min(lclipMinZ, lclipMaxZ));
-            const ssef lfarP  = min(min(max(lclipMinX, lclipMaxX), max(lclipMinY, lclipMaxY)), max(lclipMinZ, lclipMaxZ));
-            const sseb lhit   = max(lnearP,ray_tnear) <= min(lfarP,ray_tfar);      
+              lnearP = max(max(min(lclipMinX, lclipMaxX), min(lclipMinY, lclipMaxY)), min(lclipMinZ, lclipMaxZ));
+              const ssef lfarP  = min(min(max(lclipMinX, lclipMaxX), max(lclipMinY, lclipMaxY)), max(lclipMinZ, lclipMaxZ));
+              lhit   = max(lnearP,ray_tnear) <= min(lfarP,ray_tfar);      
 #endif
+            }
             
             /* if we hit the child we choose to continue with that child if it 
                is closer than the current next child, or we push it onto the stack */
@@ -298,14 +340,29 @@ namespace embree
       AVX_ZERO_UPPER();
     }
     
-    DEFINE_INTERSECTOR4(BVH4Triangle1Intersector4ChunkMoeller, BVH4Intersector4Chunk<Triangle1Intersector4MoellerTrumbore>);
-    DEFINE_INTERSECTOR4(BVH4Triangle4Intersector4ChunkMoeller, BVH4Intersector4Chunk<Triangle4Intersector4MoellerTrumbore>);
+    DEFINE_INTERSECTOR4(BVH4Triangle1Intersector4ChunkMoeller, BVH4Intersector4Chunk<Triangle1Intersector4MoellerTrumbore<KERNEL_FEATURES_ALL> >);
+    DEFINE_INTERSECTOR4(BVH4Triangle1Intersector4ChunkMoellerBasic, BVH4Intersector4Chunk<Triangle1Intersector4MoellerTrumbore<KERNEL_FEATURES_NONE> >);
+    DEFINE_INTERSECTOR4(BVH4Triangle4Intersector4ChunkMoeller, BVH4Intersector4Chunk<Triangle4Intersector4MoellerTrumbore<KERNEL_FEATURES_ALL> >);
 #if defined (__AVX__)
-    DEFINE_INTERSECTOR4(BVH4Triangle8Intersector4ChunkMoeller, BVH4Intersector4Chunk<Triangle8Intersector4MoellerTrumbore>);
+    DEFINE_INTERSECTOR4(BVH4Triangle8Intersector4ChunkMoeller, BVH4Intersector4Chunk<Triangle8Intersector4MoellerTrumbore<KERNEL_FEATURES_ALL> >);
 #endif
     DEFINE_INTERSECTOR4(BVH4Triangle1vIntersector4ChunkPluecker, BVH4Intersector4Chunk<Triangle1vIntersector4Pluecker>);
     DEFINE_INTERSECTOR4(BVH4Triangle4vIntersector4ChunkPluecker, BVH4Intersector4Chunk<Triangle4vIntersector4Pluecker>);
     DEFINE_INTERSECTOR4(BVH4Triangle4iIntersector4ChunkPluecker, BVH4Intersector4Chunk<Triangle4iIntersector4Pluecker>);
+    DEFINE_INTERSECTOR4(BVH4Triangle4vIntersector4ChunkWatertight, BVH4Intersector4Chunk<Triangle4vIntersector4Watertight<KERNEL_FEATURES_ALL>,true>);
+    DEFINE_INTERSECTOR4(BVH4Triangle4vIntersector4ChunkWatertightBasic, BVH4Intersector4Chunk<Triangle4vIntersector4Watertight<KERNEL_FEATURES_NONE>,true>);
+    DEFINE_INTERSECTOR4(BVH4Triangle4iIntersector4ChunkWatertight, BVH4Intersector4Chunk<Triangle4iIntersector4Watertight<KERNEL_FEATURES_ALL>,true>);
+    DEFINE_INTERSECTOR4(BVH4Triangle4iIntersector4ChunkWatertightBasic, BVH4Intersector4Chunk<Triangle4iIntersector4Watertight<KERNEL_FEATURES_NONE>,true>);
+    DEFINE_INTERSECTOR4(BVH4Triangle4qIntersector4Chunk, BVH4Intersector4Chunk<Triangle4qIntersector4>);
+    DEFINE_INTERSECTOR4(BVH4TriangleMeshletIntersector4Chunk, BVH4Intersector4Chunk<TriangleMeshletIntersector4>);
     DEFINE_INTERSECTOR4(BVH4VirtualIntersector4Chunk, BVH4Intersector4Chunk<VirtualAccelIntersector4>);
+    DEFINE_INTERSECTOR4(BVH4Point4Intersector4Chunk, BVH4Intersector4Chunk<Point4Intersector4>);
+#if defined(__AVX__)
+    DEFINE_INTERSECTOR4(BVH4Point8Intersector4Chunk, BVH4Intersector4Chunk<Point8Intersector4>);
+#endif
+    DEFINE_INTERSECTOR4(BVH4Quad4Intersector4Chunk, BVH4Intersector4Chunk<Quad4Intersector4>);
+#if defined(__AVX__)
+    DEFINE_INTERSECTOR4(BVH4Quad8Intersector4Chunk, BVH4Intersector4Chunk<Quad8Intersector4>);
+#endif
   }
 }
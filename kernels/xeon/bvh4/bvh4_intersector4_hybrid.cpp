@@ -593,9 +593,11 @@ namespace embree
       AVX_ZERO_UPPER();
     }
     
-    DEFINE_INTERSECTOR4(BVH4Triangle4Intersector4HybridMoeller, BVH4Intersector4Hybrid<Triangle4Intersector4MoellerTrumbore>);
+    DEFINE_INTERSECTOR4(BVH4Triangle4Intersector4HybridMoeller, BVH4Intersector4Hybrid<Triangle4Intersector4MoellerTrumbore<KERNEL_FEATURES_ALL> >);
+    DEFINE_INTERSECTOR4(BVH4Triangle4Intersector4HybridMoellerBasic, BVH4Intersector4Hybrid<Triangle4Intersector4MoellerTrumbore<KERNEL_FEATURES_NONE> >);
 #if defined (__AVX__)
-    DEFINE_INTERSECTOR4(BVH4Triangle8Intersector4HybridMoeller, BVH4Intersector4Hybrid<Triangle8Intersector4MoellerTrumbore>);
+    DEFINE_INTERSECTOR4(BVH4Triangle8Intersector4HybridMoeller, BVH4Intersector4Hybrid<Triangle8Intersector4MoellerTrumbore<KERNEL_FEATURES_ALL> >);
+    DEFINE_INTERSECTOR4(BVH4Triangle8Intersector4HybridMoellerBasic, BVH4Intersector4Hybrid<Triangle8Intersector4MoellerTrumbore<KERNEL_FEATURES_NONE> >);
 #endif
     DEFINE_INTERSECTOR4(BVH4Triangle4vIntersector4HybridPluecker, BVH4Intersector4Hybrid<Triangle4vIntersector4Pluecker>);
   }
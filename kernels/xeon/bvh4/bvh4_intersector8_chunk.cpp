@@ -22,18 +22,46 @@
 #include "geometry/triangle1v_intersector8_pluecker.h"
 #include "geometry/triangle4v_intersector8_pluecker.h"
 #include "geometry/triangle4i_intersector8.h"
+#include "geometry/triangle4v_intersector8_watertight.h"
+#include "geometry/triangle4i_intersector8_watertight.h"
+#include "geometry/triangle4q_intersector8.h"
+#include "geometry/trianglemeshlet_intersector8.h"
 #include "geometry/virtual_accel_intersector8.h"
+#include "geometry/point4_intersector8.h"
+#include "geometry/point8_intersector8.h"
+#include "geometry/quad4_intersector8.h"
+#include "geometry/quad8_intersector8.h"
 
 namespace embree
 {
   namespace isa
   {
-    template<typename PrimitiveIntersector8>
-    void BVH4Intersector8Chunk<PrimitiveIntersector8>::intersect(avxb* valid_i, BVH4* bvh, Ray8& ray)
+    /*! Conservative box test for robust scenes. The slab distances
+     *  are calculated without fused operations from an exact
+     *  reciprocal direction and the entry and exit distances are
+     *  scaled to cover their rounding errors. */
+    __forceinline avxb intersectBoxRobust(const BVH4::Node* node, const size_t i, const avx3f& org, const avx3f& rdir,
+                                          const avxf& ray_tnear, const avxf& ray_tfar, avxf& lnearP)
+    {
+      const avxf lclipMinX = (node->lower_x[i] - org.x) * rdir.x;
+      const avxf lclipMinY = (node->lower_y[i] - org.y) * rdir.y;
+      const avxf lclipMinZ = (node->lower_z[i] - org.z) * rdir.z;
+      const avxf lclipMaxX = (node->upper_x[i] - org.x) * rdir.x;
+      const avxf lclipMaxY = (node->upper_y[i] - org.y) * rdir.y;
+      const avxf lclipMaxZ = (node->upper_z[i] - org.z) * rdir.z;
+      lnearP = max(max(min(lclipMinX, lclipMaxX), min(lclipMinY, lclipMaxY)), min(lclipMinZ, lclipMaxZ));
+      const avxf lfarP = min(min(max(lclipMinX, lclipMaxX), max(lclipMinY, lclipMaxY)), max(lclipMinZ, lclipMaxZ));
+      const float round_down = 1.0f-2.0f*float(ulp);
+      const float round_up   = 1.0f+2.0f*float(ulp);
+      return round_down*max(lnearP,ray_tnear) <= round_up*min(lfarP,ray_tfar);
+    }
+
+    template<typename PrimitiveIntersector8, bool robust>
+    void BVH4Intersector8Chunk<PrimitiveIntersector8,robust>::intersect(avxb* valid_i, BVH4* bvh, Ray8& ray)
     {
       /* load ray */
       const avxb valid0 = *valid_i;
-      const avx3f rdir = rcp_safe(ray.dir);
+      const avx3f rdir = robust ? avxf(one)/zero_fix(ray.dir) : rcp_safe(ray.dir);
       const avx3f org(ray.org), org_rdir = org * rdir;
       avxf ray_tnear = select(valid0,ray.tnear,pos_inf);
       avxf ray_tfar  = select(valid0,ray.tfar ,neg_inf);
@@ -90,27 +118,32 @@ namespace embree
             const NodeRef child = node->children[i];
             if (unlikely(child == BVH4::emptyNode)) break;
             
+            avxf lnearP; avxb lhit;
+            if (robust)
+              lhit = intersectBoxRobust(node,i,org,rdir,ray_tnear,ray_tfar,lnearP);
+            else {
 #if defined(__AVX2__)
-            const avxf lclipMinX = msub(node->lower_x[i],rdir.x,org_rdir.x);
-            const avxf lclipMinY = msub(node->lower_y[i],rdir.y,org_rdir.y);
-            const avxf lclipMinZ = msub(node->lower_z[i],rdir.z,org_rdir.z);
-            const avxf lclipMaxX = msub(node->upper_x[i],rdir.x,org_rdir.x);
-            const avxf lclipMaxY = msub(node->upper_y[i],rdir.y,org_rdir.y);
-            const avxf lclipMaxZ = msub(node->upper_z[i],rdir.z,org_rdir.z);
-            const avxf lnearP = maxi(maxi(mini(lclipMinX, lclipMaxX), mini(lclipMinY, lclipMaxY)), mini(lclipMinZ, lclipMaxZ));
-            const avxf lfarP  = mini(mini(maxi(lclipMinX, lclipMaxX), maxi(lclipMinY, lclipMaxY)), maxi(lclipMinZ, lclipMaxZ));
-            const avxb lhit   = maxi(lnearP,ray_tnear) <= mini(lfarP,ray_tfar);      
+              const avxf lclipMinX = msub(node->lower_x[i],rdir.x,org_rdir.x);
+              const avxf lclipMinY = msub(node->lower_y[i],rdir.y,org_rdir.y);
+              const avxf lclipMinZ = msub(node->lower_z[i],rdir.z,org_rdir.z);
+              const avxf lclipMaxX = msub(node->upper_x[i],rdir.x,org_rdir.x);
+              const avxf lclipMaxY = msub(node->upper_y[i],rdir.y,org_rdir.y);
+              const avxf lclipMaxZ = msub(node->upper_z[i],rdir.z,org_rdir.z);
+              lnearP = maxi(maxi(mini(lclipMinX, lclipMaxX), mini(lclipMinY, lclipMaxY)), mini(lclipMinZ, lclipMaxZ));
+              const avxf lfarP  = mini(mini(maxi(lclipMinX, lclipMaxX), maxi(lclipMinY, lclipMaxY)), maxi(lclipMinZ, lclipMaxZ));
+              lhit   = maxi(lnearP,ray_tnear) <= mini(lfarP,ray_tfar);      
 #else
-            const avxf lclipMinX = (node->lower_x[i] - org.x) * rdir.x;
-            const avxf lclipMinY = (node->lower_y[i] - org.y) * rdir.y;
-            const avxf lclipMinZ = (node->lower_z[i] - org.z) * rdir.z;
-            const avxf lclipMaxX = (node->upper_x[i] - org.x) * rdir.x;
-            const avxf lclipMaxY = (node->upper_y[i] - org.y) * rdir.y;
-            const avxf lclipMaxZ = (node->upper_z[i] - org.z) * rdir.z;
-            const avxf lnearP = max(max(min(lclipMinX, lclipMaxX), min(lclipMinY, lclipMaxY)), min(lclipMinZ, lclipMaxZ));
-            const avxf lfarP  = min(min(max(lclipMinX, lclipMaxX), max(lclipMinY, lclipMaxY)), max(lclipMinZ, lclipMaxZ));
-            const avxb lhit   = max(lnearP,ray_tnear) <= min(lfarP,ray_tfar);      
+              const avxf lclipMinX = (node->lower_x[i] - org.x) * rdir.x;
+              const avxf lclipMinY = (node->lower_y[i] - org.y) * rdir.y;
+              const avxf lclipMinZ = (node->lower_z[i] - org.z) * rdir.z;
+              const avxf lclipMaxX = (node->upper_x[i] - org.x) * rdir.x;
+              const avxf lclipMaxY = (node->upper_y[i] - org.y) * rdir.y;
+              const avxf lclipMaxZ = (node->upper_z[i] - org.z) * rdir.z;
+              lnearP = max(max(min(lclipMinX, lclipMaxX), min(lclipMinY, lclipMaxY)), min(lclipMinZ, lclipMaxZ));
+              const avxf lfarP  = min(min(max(lclipMinX, lclipMaxX), max(lclipMinY, lclipMaxY)), max(lclipMinZ, lclipMaxZ));
+              lhit   = max(lnearP,ray_tnear) <= min(lfarP,ray_tfar);      
 #endif
+            }
             
             /* if we hit the child we choose to continue with that child if it 
                is closer than the current next child, or we push it onto the stack */
@@ -156,13 +189,13 @@ namespace embree
       AVX_ZERO_UPPER();
     }
     
-    template<typename PrimitiveIntersector8>
-    void BVH4Intersector8Chunk<PrimitiveIntersector8>::occluded(avxb* valid_i, BVH4* bvh, Ray8& ray)
+    template<typename PrimitiveIntersector8, bool robust>
+    void BVH4Intersector8Chunk<PrimitiveIntersector8,robust>::occluded(avxb* valid_i, BVH4* bvh, Ray8& ray)
     {
       /* load ray */
       const avxb valid = *valid_i;
       avxb terminated = !valid;
-      const avx3f rdir = rcp_safe(ray.dir);
+      const avx3f rdir = robust ? avxf(one)/zero_fix(ray.dir) : rcp_safe(ray.dir);
       const avx3f org(ray.org), org_rdir = org * rdir;
       avxf ray_tnear = select(valid,ray.tnear,pos_inf);
       avxf ray_tfar  = select(valid,ray.tfar ,neg_inf);
@@ -219,27 +252,32 @@ namespace embree
             const NodeRef child = node->children[i];
             if (unlikely(child == BVH4::emptyNode)) break;
             
+            avxf lnearP; avxb lhit;
+            if (robust)
+              lhit = intersectBoxRobust(node,i,org,rdir,ray_tnear,ray_tfar,lnearP);
+            else {
 #if defined(__AVX2__)
-            const avxf lclipMinX = msub(node->lower_x[i],rdir.x,org_rdir.x);
-            const avxf lclipMinY = msub(node->lower_y[i],rdir.y,org_rdir.y);
-            const avxf lclipMinZ = msub(node->lower_z[i],rdir.z,org_rdir.z);
-            const avxf lclipMaxX = msub(node->upper_x[i],rdir.x,org_rdir.x);
-            const avxf lclipMaxY = msub(node->upper_y[i],rdir.y,org_rdir.y);
-            const avxf lclipMaxZ = msub(node->upper_z[i],rdir.z,org_rdir.z);
-            const avxf lnearP = maxi(maxi(mini(lclipMinX, lclipMaxX), mini(lclipMinY, lclipMaxY)), mini(lclipMinZ, lclipMaxZ));
-            const avxf lfarP  = mini(mini(maxi(lclipMinX, lclipMaxX), maxi(lclipMinY, lclipMaxY)), maxi(lclipMinZ, lclipMaxZ));
-            const avxb lhit   = maxi(lnearP,ray_tnear) <= mini(lfarP,ray_tfar);      
+              const avxf lclipMinX = msub(node->lower_x[i],rdir.x,org_rdir.x);
+              const avxf lclipMinY = msub(node->lower_y[i],rdir.y,org_rdir.y);
+              const avxf lclipMinZ = msub(node->lower_z[i],rdir.z,org_rdir.z);
+              const avxf lclipMaxX = msub(node->upper_x[i],rdir.x,org_rdir.x);
+              const avxf lclipMaxY = msub(node->upper_y[i],rdir.y,org_rdir.y);
+              const avxf lclipMaxZ = msub(node->upper_z[i],rdir.z,org_rdir.z);
+              lnearP = maxi(maxi(mini(lclipMinX, lclipMaxX), mini(lclipMinY, lclipMaxY)), mini(lclipMinZ, lclipMaxZ));
+              const avxf lfarP  = mini(mini(maxi(lclipMinX, lclipMaxX), maxi(lclipMinY, lclipMaxY)), maxi(lclipMinZ, lclipMaxZ));
+              lhit   = maxi(lnearP,ray_tnear) <= mini(lfarP,ray_tfar);      
 #else
-            const avxf lclipMinX = (node->lower_x[i] - org.x) * rdir.x;
-            const avxf lclipMinY = (node->lower_y[i] - org.y) * rdir.y;
-            const avxf lclipMinZ = (node->lower_z[i] - org.z) * rdir.z;
-            const avxf lclipMaxX = (node->upper_x[i] - org.x) * rdir.x;
-            const avxf lclipMaxY = (node->upper_y[i] - org.y) * rdir.y;
-            const avxf lclipMaxZ = (node->upper_z[i] - org.z) * rdir.z;
-            const avxf lnearP = max(max(min(lclipMinX, lclipMaxX), min(lclipMinY, lclipMaxY)), min(lclipMinZ, lclipMaxZ));
-            const avxf lfarP  = min(min(max(lclipMinX, lclipMaxX), max(lclipMinY, lclipMaxY)), max(lclipMinZ, lclipMaxZ));
-            const avxb lhit   = max(lnearP,ray_tnear) <= min(lfarP,ray_tfar);      
+              const avxf lclipMinX = (node->lower_x[i] - org.x) * rdir.x;
+              const avxf lclipMinY = (node->lower_y[i] - org.y) * rdir.y;
+              const avxf lclipMinZ = (node->lower_z[i] - org.z) * rdir.z;
+              const avxf lclipMaxX = (node->upper_x[i] - org.x) * rdir.x;
+              const avxf lclipMaxY = (node->upper_y[i] - org.y) * rdir.y;
+              const avxf lclipMaxZ = (node->upper_z[i] - org.z) * rdir.z;
+              lnearP = max(max(min(lclipMinX, lclipMaxX), min(lclipMinY, lclipMaxY)), min(lclipMinZ, lclipMaxZ));
+              const avxf lfarP  = min(min(max(lclipMinX, lclipMaxX), max(lclipMinY, lclipMaxY)), max(lclipMinZ, lclipMaxZ));
+              lhit   = max(lnearP,ray_tnear) <= min(lfarP,ray_tfar);      
 #endif
+            }
             
             /* if we hit the child we choose to continue with that child if it 
                is closer than the current next child, or we push it onto the stack */
@@ -287,12 +325,23 @@ namespace embree
       AVX_ZERO_UPPER();
     }
     
-    DEFINE_INTERSECTOR8(BVH4Triangle1Intersector8ChunkMoeller, BVH4Intersector8Chunk<Triangle1Intersector8MoellerTrumbore>);
-    DEFINE_INTERSECTOR8(BVH4Triangle4Intersector8ChunkMoeller, BVH4Intersector8Chunk<Triangle4Intersector8MoellerTrumbore>);
-    DEFINE_INTERSECTOR8(BVH4Triangle8Intersector8ChunkMoeller, BVH4Intersector8Chunk<Triangle8Intersector8MoellerTrumbore>);
+    DEFINE_INTERSECTOR8(BVH4Triangle1Intersector8ChunkMoeller, BVH4Intersector8Chunk<Triangle1Intersector8MoellerTrumbore<KERNEL_FEATURES_ALL> >);
+    DEFINE_INTERSECTOR8(BVH4Triangle1Intersector8ChunkMoellerBasic, BVH4Intersector8Chunk<Triangle1Intersector8MoellerTrumbore<KERNEL_FEATURES_NONE> >);
+    DEFINE_INTERSECTOR8(BVH4Triangle4Intersector8ChunkMoeller, BVH4Intersector8Chunk<Triangle4Intersector8MoellerTrumbore<KERNEL_FEATURES_ALL> >);
+    DEFINE_INTERSECTOR8(BVH4Triangle8Intersector8ChunkMoeller, BVH4Intersector8Chunk<Triangle8Intersector8MoellerTrumbore<KERNEL_FEATURES_ALL> >);
     DEFINE_INTERSECTOR8(BVH4Triangle1vIntersector8ChunkPluecker, BVH4Intersector8Chunk<Triangle1vIntersector8Pluecker>);
     DEFINE_INTERSECTOR8(BVH4Triangle4vIntersector8ChunkPluecker, BVH4Intersector8Chunk<Triangle4vIntersector8Pluecker>);
     DEFINE_INTERSECTOR8(BVH4Triangle4iIntersector8ChunkPluecker, BVH4Intersector8Chunk<Triangle4iIntersector8Pluecker>);
+    DEFINE_INTERSECTOR8(BVH4Triangle4vIntersector8ChunkWatertight, BVH4Intersector8Chunk<Triangle4vIntersector8Watertight<KERNEL_FEATURES_ALL>,true>);
+    DEFINE_INTERSECTOR8(BVH4Triangle4vIntersector8ChunkWatertightBasic, BVH4Intersector8Chunk<Triangle4vIntersector8Watertight<KERNEL_FEATURES_NONE>,true>);
+    DEFINE_INTERSECTOR8(BVH4Triangle4iIntersector8ChunkWatertight, BVH4Intersector8Chunk<Triangle4iIntersector8Watertight<KERNEL_FEATURES_ALL>,true>);
+    DEFINE_INTERSECTOR8(BVH4Triangle4iIntersector8ChunkWatertightBasic, BVH4Intersector8Chunk<Triangle4iIntersector8Watertight<KERNEL_FEATURES_NONE>,true>);
+    DEFINE_INTERSECTOR8(BVH4Triangle4qIntersector8Chunk, BVH4Intersector8Chunk<Triangle4qIntersector8>);
+    DEFINE_INTERSECTOR8(BVH4TriangleMeshletIntersector8Chunk, BVH4Intersector8Chunk<TriangleMeshletIntersector8>);
     DEFINE_INTERSECTOR8(BVH4VirtualIntersector8Chunk, BVH4Intersector8Chunk<VirtualAccelIntersector8>);
+    DEFINE_INTERSECTOR8(BVH4Point4Intersector8Chunk, BVH4Intersector8Chunk<Point4Intersector8>);
+    DEFINE_INTERSECTOR8(BVH4Point8Intersector8Chunk, BVH4Intersector8Chunk<Point8Intersector8>);
+    DEFINE_INTERSECTOR8(BVH4Quad4Intersector8Chunk, BVH4Intersector8Chunk<Quad4Intersector8>);
+    DEFINE_INTERSECTOR8(BVH4Quad8Intersector8Chunk, BVH4Intersector8Chunk<Quad8Intersector8>);
   }
 }
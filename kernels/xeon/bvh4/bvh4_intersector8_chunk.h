@@ -24,8 +24,9 @@ namespace embree
 {
   namespace isa
   {
-    /*! BVH4 packet traversal implementation. */
-    template<typename PrimitiveIntersector>
+    /*! BVH4 packet traversal implementation. If robust is set a
+     *  conservative box test is used. */
+    template<typename PrimitiveIntersector, bool robust = false>
       class BVH4Intersector8Chunk
     {
       /* shortcuts for frequently used types */
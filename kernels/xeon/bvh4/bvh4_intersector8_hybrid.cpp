@@ -581,8 +581,10 @@ namespace embree
       AVX_ZERO_UPPER();
     }
     
-    DEFINE_INTERSECTOR8(BVH4Triangle4Intersector8HybridMoeller, BVH4Intersector8Hybrid<Triangle4Intersector8MoellerTrumbore>);
-    DEFINE_INTERSECTOR8(BVH4Triangle8Intersector8HybridMoeller, BVH4Intersector8Hybrid<Triangle8Intersector8MoellerTrumbore>);
+    DEFINE_INTERSECTOR8(BVH4Triangle4Intersector8HybridMoeller, BVH4Intersector8Hybrid<Triangle4Intersector8MoellerTrumbore<KERNEL_FEATURES_ALL> >);
+    DEFINE_INTERSECTOR8(BVH4Triangle4Intersector8HybridMoellerBasic, BVH4Intersector8Hybrid<Triangle4Intersector8MoellerTrumbore<KERNEL_FEATURES_NONE> >);
+    DEFINE_INTERSECTOR8(BVH4Triangle8Intersector8HybridMoeller, BVH4Intersector8Hybrid<Triangle8Intersector8MoellerTrumbore<KERNEL_FEATURES_ALL> >);
+    DEFINE_INTERSECTOR8(BVH4Triangle8Intersector8HybridMoellerBasic, BVH4Intersector8Hybrid<Triangle8Intersector8MoellerTrumbore<KERNEL_FEATURES_NONE> >);
     DEFINE_INTERSECTOR8(BVH4Triangle4vIntersector8HybridPluecker, BVH4Intersector8Hybrid<Triangle4vIntersector8Pluecker>);
   }
 }
@@ -0,0 +1,445 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "bvh4_multi_hit.h"
+#include "bvh4_intersector1.h"
+#include "common/scene.h"
+#include "geometry/filter.h"
+#include "geometry/triangle4.h"
+#if defined(__AVX__)
+#include "geometry/triangle4_intersector8_moeller.h"
+#endif
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! maximal number of triangles of a leaf */
+    static const size_t maxLeafTriangles = BVH4::maxLeafBlocks*PrimitiveType::maxBlockTriangles;
+
+    /*! The hits found so far for one ray, sorted by distance. Once k
+     *  hits are found tfar is the distance of the k-th hit. */
+    struct MultiHitList
+    {
+      __forceinline MultiHitList (RTCHit* hits, size_t k, float tfar)
+        : hits(hits), k(k), num(0), tfar(tfar) {}
+
+      __forceinline void insert(float t, float u, float v, int geomID, int primID)
+      {
+        /* a triangle referenced by multiple leaves is reported once */
+        for (size_t i=0; i<num; i++)
+          if (hits[i].geomID == geomID && hits[i].primID == primID) return;
+
+        /* insertion sort, drops the last hit if the list is full */
+        size_t i = num < k ? num++ : k-1;
+        for (; i>0 && hits[i-1].t > t; i--) hits[i] = hits[i-1];
+        hits[i].t = t; hits[i].u = u; hits[i].v = v;
+        hits[i].geomID = geomID; hits[i].primID = primID;
+        if (num == k) tfar = hits[k-1].t;
+      }
+
+      RTCHit* hits;   //!< sorted hits
+      size_t k;       //!< maximal number of hits
+      size_t num;     //!< number of hits found
+      float tfar;     //!< end of the ray segment
+    };
+
+    /*! triangles of a leaf, packed into Triangle4 blocks */
+    struct MultiHitLeaf
+    {
+      __forceinline MultiHitLeaf (const BVH4* bvh, BVH4::NodeRef ref)
+      {
+        BlockTriangle tris[maxLeafTriangles];
+        size_t num = 0, blocks; const char* prim = ref.leaf(blocks);
+        for (size_t i=0; i<blocks; i++)
+          num += bvh->primTy.triangles(prim+i*bvh->primTy.bytes,tris+num);
+
+        /* unused slots get an invalid geomID like in Triangle4 leaves */
+        const Scene* scene = (const Scene*) bvh->geometry;
+        this->blocks = (num+3)/4;
+        for (size_t j=0; j<this->blocks; j++)
+        {
+          sse3f v0(zero), v1(zero), v2(zero);
+          ssei geomID(-1), primID(-1), mask(-1);
+          for (size_t i=0; i<4 && 4*j+i<num; i++) {
+            const BlockTriangle& tri = tris[4*j+i];
+            v0.x[i] = tri.v0.x; v0.y[i] = tri.v0.y; v0.z[i] = tri.v0.z;
+            v1.x[i] = tri.v1.x; v1.y[i] = tri.v1.y; v1.z[i] = tri.v1.z;
+            v2.x[i] = tri.v2.x; v2.y[i] = tri.v2.y; v2.z[i] = tri.v2.z;
+            geomID[i] = tri.geomID; primID[i] = tri.primID;
+#if defined(__USE_RAY_MASK__)
+            mask[i] = scene->getTriangleMesh(tri.geomID)->mask;
+#endif
+          }
+          this->tris[j] = Triangle4(v0,v1,v2,geomID,primID,mask);
+        }
+      }
+
+      size_t blocks;
+      Triangle4 tris[maxLeafTriangles/4];
+    };
+
+    /*! Intersects a ray with the triangles of a leaf and inserts all
+     *  hits into the list. Uses the same Moeller-Trumbore test as the
+     *  Triangle4 intersector to get identical barycentric
+     *  coordinates. If filter is set, the occlusion filter functions
+     *  are invoked with the ray passed as filterRay. */
+    template<bool filter>
+    __forceinline void intersect(const MultiHitLeaf& leaf, const Scene* scene,
+                                 const Vec3fa& org, const Vec3fa& dir, float tnear, int mask, MultiHitList& list, Ray* filterRay)
+    {
+      const sse3f O(org.x,org.y,org.z), D(dir.x,dir.y,dir.z);
+      for (size_t j=0; j<leaf.blocks; j++)
+      {
+        /* calculate denominator */
+        const Triangle4& tri = leaf.tris[j];
+        const sse3f C = tri.v0 - O;
+        const sse3f R = cross(D,C);
+        const ssef den = dot(tri.Ng,D);
+        const ssef absDen = abs(den);
+        const ssef sgnDen = signmsk(den);
+
+        /* perform edge tests */
+        const ssef U = dot(R,tri.e2) ^ sgnDen;
+        const ssef V = dot(R,tri.e1) ^ sgnDen;
+#if defined(__BACKFACE_CULLING__)
+        sseb valid = (den > ssef(zero)) & (U >= 0.0f) & (V >= 0.0f) & (U+V<=absDen);
+#else
+        sseb valid = (den != ssef(zero)) & (U >= 0.0f) & (V >= 0.0f) & (U+V<=absDen);
+#endif
+        if (likely(none(valid))) continue;
+
+        /* perform depth test */
+        const ssef T = dot(tri.Ng,C) ^ sgnDen;
+        valid &= (T > absDen*ssef(tnear)) & (T < absDen*ssef(list.tfar));
+#if defined(__USE_RAY_MASK__)
+        valid &= (tri.mask & ssei(mask)) != ssei(zero);
+#endif
+        if (likely(none(valid))) continue;
+
+        /* insert hits */
+        const ssef rcpAbsDen = rcp(absDen);
+        const ssef u = U * rcpAbsDen;
+        const ssef v = V * rcpAbsDen;
+        const ssef t = T * rcpAbsDen;
+        size_t m = movemask(valid);
+        while (m)
+        {
+          const size_t i = __bsf(m); m = __btc(m,i);
+          const int geomID = tri.geomID[i];
+          if (t[i] >= list.tfar) continue;
+#if defined(__INTERSECTION_FILTER__)
+          if (filter) {
+            const Geometry* geometry = scene->get(geomID);
+            if (geometry->hasOcclusionFilter1()) {
+              const Vec3fa Ng_i(tri.Ng.x[i],tri.Ng.y[i],tri.Ng.z[i]);
+              if (!runOcclusionFilter1(geometry,*filterRay,u[i],v[i],t[i],Ng_i,geomID,tri.primID[i])) continue;
+            }
+          }
+#endif
+          list.insert(t[i],u[i],v[i],geomID,tri.primID[i]);
+        }
+      }
+    }
+
+    size_t BVH4MultiHit::intersect(const BVH4* bvh, const Ray& ray_i, RTCHit* hits, size_t k)
+    {
+      if (k == 0) return 0;
+      Ray ray(ray_i); NodeRef leaf;
+      return traverse<false>(bvh,ray,hits,k,leaf);
+    }
+
+    void BVH4MultiHit::occluded(const BVH4* bvh, Ray& ray, RTCOccluderHint& hint)
+    {
+      Scene* scene = (Scene*) bvh->geometry;
+      RTCHit hit;
+
+      /* without a hint, traverse until the first occluder and remember its leaf */
+      if (hint.geomID == RTC_INVALID_GEOMETRY_ID) 
+      {
+        NodeRef leaf;
+        if (traverse<true>(bvh,ray,&hit,1,leaf)) {
+          hint.geomID = hit.geomID;
+          hint.primID = hit.primID;
+          hint.leaf = leaf;
+          ray.geomID = 0;
+        }
+        return;
+      }
+
+      /* test only the leaf of the last occluder and skip the traversal if it blocks the ray */
+      MultiHitList list(&hit,1,ray.tfar);
+      isa::intersect<true>(MultiHitLeaf(bvh,NodeRef(hint.leaf)),scene,ray.org,ray.dir,ray.tnear,ray.mask,list,&ray);
+      AVX_ZERO_UPPER();
+      if (list.num) {
+        hint.geomID = hit.geomID;
+        hint.primID = hit.primID;
+        ray.geomID = 0;
+        return;
+      }
+
+      /* otherwise the regular occlusion kernel of the scene traverses the BVH and the hint is kept */
+      scene->occluded((RTCRay&)ray);
+    }
+
+    template<bool occlusion>
+    size_t BVH4MultiHit::traverse(const BVH4* bvh, Ray& ray, RTCHit* hits, size_t k, NodeRef& hitLeaf)
+    {
+      MultiHitList list(hits,k,ray.tfar);
+      const Scene* scene = (const Scene*) bvh->geometry;
+
+      /*! stack state */
+      StackItem stack[stackSize];  //!< stack of nodes
+      StackItem* stackPtr = stack+1;        //!< current stack pointer
+      StackItem* stackEnd = stack+stackSize;
+      stack[0].ptr = bvh->root;
+      stack[0].dist = neg_inf;
+
+      /*! offsets to select the side that becomes the lower or upper bound */
+      const size_t nearX = ray.dir.x >= 0.0f ? 0*sizeof(ssef) : 1*sizeof(ssef);
+      const size_t nearY = ray.dir.y >= 0.0f ? 2*sizeof(ssef) : 3*sizeof(ssef);
+      const size_t nearZ = ray.dir.z >= 0.0f ? 4*sizeof(ssef) : 5*sizeof(ssef);
+
+      /*! load the ray into SIMD registers */
+      const sse3f norg(-ray.org.x,-ray.org.y,-ray.org.z);
+      const Vec3fa ray_rdir = rcp_safe(ray.dir);
+      const sse3f rdir(ray_rdir.x,ray_rdir.y,ray_rdir.z);
+      const Vec3fa ray_org_rdir = ray.org*ray_rdir;
+      const sse3f org_rdir(ray_org_rdir.x,ray_org_rdir.y,ray_org_rdir.z);
+      const ssef  ray_near(ray.tnear);
+      ssef ray_far(list.tfar);
+
+      /* pop loop */
+      while (true) pop:
+      {
+        /*! pop next node */
+        if (unlikely(stackPtr == stack)) break;
+        stackPtr--;
+        NodeRef cur = NodeRef(stackPtr->ptr);
+
+        /*! if popped node is behind the k-th hit, pop next one */
+        if (unlikely(stackPtr->dist > list.tfar))
+          continue;
+
+        /* downtraversal loop */
+        while (true)
+        {
+          /*! stop if we found a leaf */
+          if (unlikely(cur.isLeaf())) break;
+
+          /*! single ray intersection with 4 boxes */
+          const Node* node = cur.node();
+          ssef tNear;
+          size_t mask = intersectBox(node,nearX,nearY,nearZ,norg,rdir,org_rdir,ray_near,ray_far,tNear);
+
+          /*! if no child is hit, pop next node */
+          if (unlikely(mask == 0))
+            goto pop;
+
+          /*! one child is hit, continue with that child */
+          size_t r = bitscan(mask); mask = __btc(mask,r);
+          if (likely(mask == 0)) {
+            cur = node->child(r);
+            assert(cur != BVH4::emptyNode);
+            continue;
+          }
+
+          /*! push all hit children onto the stack, sort them, and continue with the closest child */
+          NodeRef c = node->child(r);
+          assert(c != BVH4::emptyNode);
+          stackPtr->ptr = c; stackPtr->dist = tNear[r]; stackPtr++;
+          size_t num = 1;
+          while (mask) {
+            r = bitscan(mask); mask = __btc(mask,r);
+            c = node->child(r);
+            assert(c != BVH4::emptyNode);
+            assert(stackPtr < stackEnd);
+            stackPtr->ptr = c; stackPtr->dist = tNear[r]; stackPtr++;
+            num++;
+          }
+          if      (num == 2) sort(stackPtr[-1],stackPtr[-2]);
+          else if (num == 3) sort(stackPtr[-1],stackPtr[-2],stackPtr[-3]);
+          else               sort(stackPtr[-1],stackPtr[-2],stackPtr[-3],stackPtr[-4]);
+          cur = (NodeRef) stackPtr[-1].ptr; stackPtr--;
+        }
+
+        /*! this is a leaf node */
+        const MultiHitLeaf leaf(bvh,cur);
+        isa::intersect<occlusion>(leaf,scene,ray.org,ray.dir,ray.tnear,ray.mask,list,&ray);
+        ray_far = list.tfar;
+
+        /*! for occlusion queries the first hit terminates the traversal */
+        if (occlusion && list.num) {
+          hitLeaf = cur;
+          break;
+        }
+      }
+      AVX_ZERO_UPPER();
+      return list.num;
+    }
+
+#if defined(__AVX__)
+
+    void BVH4MultiHit8::intersect(const avxb* valid_i, const BVH4* bvh, const Ray8& ray_i, RTCHit* hits, size_t k, size_t* numHits)
+    {
+      const avxb valid0 = *valid_i;
+      for (size_t i=0; i<8; i++) numHits[i] = 0;
+      if (k == 0 || none(valid0)) return;
+
+      /* the ray segments get shrunk to the k-th hit of each ray */
+      Ray8 ray(ray_i);
+
+      /* each ray collects its hits in its own part of the hit array */
+      MultiHitList lists[8] = {
+        MultiHitList(hits+0*k,k,ray.tfar[0]), MultiHitList(hits+1*k,k,ray.tfar[1]),
+        MultiHitList(hits+2*k,k,ray.tfar[2]), MultiHitList(hits+3*k,k,ray.tfar[3]),
+        MultiHitList(hits+4*k,k,ray.tfar[4]), MultiHitList(hits+5*k,k,ray.tfar[5]),
+        MultiHitList(hits+6*k,k,ray.tfar[6]), MultiHitList(hits+7*k,k,ray.tfar[7])
+      };
+
+      /* load ray */
+      const avx3f rdir = rcp_safe(ray.dir);
+      const avx3f org(ray.org);
+      const avxf ray_tnear = select(valid0,ray.tnear,pos_inf);
+      avxf ray_tfar  = select(valid0,ray.tfar ,neg_inf);
+      const avxf inf = avxf(pos_inf);
+
+      /* allocate stack and push root node */
+      avxf    stack_near[stackSize];
+      NodeRef stack_node[stackSize];
+      stack_node[0] = BVH4::invalidNode;
+      stack_near[0] = inf;
+      stack_node[1] = bvh->root;
+      stack_near[1] = ray_tnear;
+      NodeRef* stackEnd = stack_node+stackSize;
+      NodeRef* __restrict__ sptr_node = stack_node + 2;
+      avxf*    __restrict__ sptr_near = stack_near + 2;
+
+      while (1)
+      {
+        /* pop next node from stack */
+        assert(sptr_node > stack_node);
+        sptr_node--;
+        sptr_near--;
+        NodeRef curNode = *sptr_node;
+        if (unlikely(curNode == BVH4::invalidNode)) {
+          assert(sptr_node == stack_node);
+          break;
+        }
+
+        /* cull node if behind the k-th hit of all rays */
+        avxf curDist = *sptr_near;
+        if (unlikely(none(ray_tfar > curDist)))
+          continue;
+
+        while (1)
+        {
+          /* test if this is a leaf node */
+          if (unlikely(curNode.isLeaf()))
+            break;
+
+          const Node* __restrict__ const node = curNode.node();
+
+          /* pop of next node */
+          assert(sptr_node > stack_node);
+          sptr_node--;
+          sptr_near--;
+          curNode = *sptr_node;
+          curDist = *sptr_near;
+
+          for (unsigned i=0; i<4; i++)
+          {
+            const NodeRef child = node->children[i];
+            if (unlikely(child == BVH4::emptyNode)) break;
+
+            const avxf lclipMinX = (node->lower_x[i] - org.x) * rdir.x;
+            const avxf lclipMinY = (node->lower_y[i] - org.y) * rdir.y;
+            const avxf lclipMinZ = (node->lower_z[i] - org.z) * rdir.z;
+            const avxf lclipMaxX = (node->upper_x[i] - org.x) * rdir.x;
+            const avxf lclipMaxY = (node->upper_y[i] - org.y) * rdir.y;
+            const avxf lclipMaxZ = (node->upper_z[i] - org.z) * rdir.z;
+            const avxf lnearP = max(max(min(lclipMinX, lclipMaxX), min(lclipMinY, lclipMaxY)), min(lclipMinZ, lclipMaxZ));
+            const avxf lfarP  = min(min(max(lclipMinX, lclipMaxX), max(lclipMinY, lclipMaxY)), max(lclipMinZ, lclipMaxZ));
+            const avxb lhit   = max(lnearP,ray_tnear) <= min(lfarP,ray_tfar);
+
+            /* if we hit the child we choose to continue with that child if it
+               is closer than the current next child, or we push it onto the stack */
+            if (likely(any(lhit)))
+            {
+              assert(sptr_node < stackEnd);
+              const avxf childDist = select(lhit,lnearP,inf);
+              sptr_node++;
+              sptr_near++;
+
+              /* push cur node onto stack and continue with hit child */
+              if (any(childDist < curDist))
+              {
+                *(sptr_node-1) = curNode;
+                *(sptr_near-1) = curDist;
+                curDist = childDist;
+                curNode = child;
+              }
+
+              /* push hit child onto stack */
+              else {
+                *(sptr_node-1) = child;
+                *(sptr_near-1) = childDist;
+              }
+            }
+          }
+        }
+
+        /* return if stack is empty */
+        if (unlikely(curNode == BVH4::invalidNode)) {
+          assert(sptr_node == stack_node);
+          break;
+        }
+
+        /* intersect the active rays with each triangle of the leaf and insert the hits */
+        const avxb valid_leaf = ray_tfar > curDist;
+        const MultiHitLeaf leaf(bvh,curNode);
+        for (size_t j=0; j<leaf.blocks; j++)
+        {
+          const Triangle4& tri = leaf.tris[j];
+          for (size_t i=0; i<tri.size(); i++)
+          {
+            avxf u, v, t; avx3f Ng;
+            const avxb valid = Triangle4Intersector8MoellerTrumbore<KERNEL_FEATURE_RAY_MASK>::intersect(valid_leaf,ray,tri,i,u,v,t,Ng);
+            size_t m = movemask(valid);
+            while (m)
+            {
+              const size_t r = __bsf(m); m = __btc(m,r);
+              if (t[r] >= lists[r].tfar) continue;
+              lists[r].insert(t[r],u[r],v[r],tri.geomID[i],tri.primID[i]);
+              ray.tfar[r] = lists[r].tfar;
+            }
+          }
+        }
+        ray_tfar = select(valid0,ray.tfar,neg_inf);
+      }
+
+      for (size_t i=0; i<8; i++) numHits[i] = lists[i].num;
+      AVX_ZERO_UPPER();
+    }
+#endif
+
+    DEFINE_MULTI_HIT(BVH4MultiHitIntersector,BVH4MultiHit);
+    DEFINE_OCCLUDED_HINT(BVH4OccludedHintIntersector,BVH4MultiHit);
+#if defined(__AVX__)
+    DEFINE_MULTI_HIT8(BVH4MultiHitIntersector8,BVH4MultiHit8);
+#endif
+  }
+}
@@ -0,0 +1,79 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#ifndef __EMBREE_BVH4_MULTI_HIT_H__
+#define __EMBREE_BVH4_MULTI_HIT_H__
+
+#include "bvh4.h"
+#include "common/ray.h"
+#include "common/stack_item.h"
+#if defined(__AVX__)
+#include "common/ray8.h"
+#endif
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! Multi-hit query for BVH4 over triangles. Collects the k
+     *  closest hits along a single ray, the ray segment gets shrunk
+     *  to the k-th hit once k hits are found. Triangles are taken
+     *  from the leaves through PrimitiveType::triangles, thus one
+     *  implementation serves all triangle leaf types. The same
+     *  traversal also implements occlusion queries that report the
+     *  occluder found. */
+    class BVH4MultiHit
+    {
+      /* shortcuts for frequently used types */
+      typedef BVH4::NodeRef NodeRef;
+      typedef BVH4::Node Node;
+      typedef StackItemT<size_t> StackItem;
+      static const size_t stackSize = 1+3*BVH4::maxDepth;
+
+    public:
+      /*! finds the k closest hits along the ray */
+      static size_t intersect(const BVH4* bvh, const Ray& ray, RTCHit* hits, size_t k);
+
+      /*! tests the leaf of the hinted occluder first, then the BVH, and stores the occluder found in the hint */
+      static void occluded(const BVH4* bvh, Ray& ray, RTCOccluderHint& hint);
+
+    private:
+      /*! collects up to k hits, occlusion queries stop at the first hit and return its leaf */
+      template<bool occlusion>
+        static size_t traverse(const BVH4* bvh, Ray& ray, RTCHit* hits, size_t k, NodeRef& hitLeaf);
+    };
+
+#if defined(__AVX__)
+
+    /*! Multi-hit query for ray packets of size 8. The packet
+     *  traverses the BVH4 together like the chunk intersector and
+     *  tests the triangles of a leaf with the Triangle4 packet
+     *  intersector, each ray keeps its own list of hits. */
+    class BVH4MultiHit8
+    {
+      /* shortcuts for frequently used types */
+      typedef BVH4::NodeRef NodeRef;
+      typedef BVH4::Node Node;
+      static const size_t stackSize = 1+3*BVH4::maxDepth;
+
+    public:
+      static void intersect(const avxb* valid, const BVH4* bvh, const Ray8& ray, RTCHit* hits, size_t k, size_t* numHits);
+    };
+#endif
+  }
+}
+
+#endif
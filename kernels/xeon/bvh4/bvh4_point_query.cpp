@@ -0,0 +1,214 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "bvh4_point_query.h"
+#include "common/scene.h"
+#include "geometry/triangle1.h"
+#include "geometry/triangle4.h"
+#include "geometry/triangle1v.h"
+#include "geometry/triangle4v.h"
+#include "geometry/triangle4i.h"
+#include "geometry/triangle4q.h"
+#include "geometry/trianglemeshlet.h"
+#if defined(__AVX__)
+#include "geometry/triangle8.h"
+#endif
+
+namespace embree
+{ 
+  namespace isa
+  {
+    /*! tests if the mesh of a triangle passes the query mask */
+    __forceinline bool validMask(const Scene* scene, int geomID, int mask) {
+      return (scene->getTriangleMesh(geomID)->mask & mask) != 0;
+    }
+
+    /*! closest point query for the different leaf types, triangles
+     *  are reconstructed from the leaf data as the meshes of static
+     *  scenes do not keep their vertices */
+    __forceinline void pointQuery(PointQuery& query, const Triangle1& tri, const Scene* scene)
+    {
+      if (!validMask(scene,tri.geomID(),query.mask)) return;
+      pointQueryTriangle(query,tri.v0,tri.v1,tri.v2,tri.geomID(),tri.primID());
+    }
+
+    __forceinline void pointQuery(PointQuery& query, const Triangle1v& tri, const Scene* scene)
+    {
+      if (!validMask(scene,tri.geomID(),query.mask)) return;
+      pointQueryTriangle(query,tri.v0,tri.v1,tri.v2,tri.geomID(),tri.primID());
+    }
+
+    __forceinline void pointQuery(PointQuery& query, const Triangle4& tri, const Scene* scene)
+    {
+      for (size_t i=0; i<tri.size(); i++) 
+      {
+        if (!validMask(scene,tri.geomID[i],query.mask)) continue;
+        const Vec3fa v0(tri.v0.x[i],tri.v0.y[i],tri.v0.z[i]);
+        const Vec3fa e1(tri.e1.x[i],tri.e1.y[i],tri.e1.z[i]);
+        const Vec3fa e2(tri.e2.x[i],tri.e2.y[i],tri.e2.z[i]);
+        pointQueryTriangle(query,v0,v0-e1,v0+e2,tri.geomID[i],tri.primID[i]);
+      }
+    }
+
+#if defined(__AVX__)
+    __forceinline void pointQuery(PointQuery& query, const Triangle8& tri, const Scene* scene)
+    {
+      for (size_t i=0; i<tri.size(); i++) 
+      {
+        if (!validMask(scene,tri.geomID[i],query.mask)) continue;
+        const Vec3fa v0(tri.v0.x[i],tri.v0.y[i],tri.v0.z[i]);
+        const Vec3fa e1(tri.e1.x[i],tri.e1.y[i],tri.e1.z[i]);
+        const Vec3fa e2(tri.e2.x[i],tri.e2.y[i],tri.e2.z[i]);
+        pointQueryTriangle(query,v0,v0-e1,v0+e2,tri.geomID[i],tri.primID[i]);
+      }
+    }
+#endif
+
+    __forceinline void pointQuery(PointQuery& query, const Triangle4v& tri, const Scene* scene)
+    {
+      for (size_t i=0; i<tri.size(); i++) 
+      {
+        if (!validMask(scene,tri.geomID[i],query.mask)) continue;
+        const Vec3fa v0(tri.v0.x[i],tri.v0.y[i],tri.v0.z[i]);
+        const Vec3fa v1(tri.v1.x[i],tri.v1.y[i],tri.v1.z[i]);
+        const Vec3fa v2(tri.v2.x[i],tri.v2.y[i],tri.v2.z[i]);
+        pointQueryTriangle(query,v0,v1,v2,tri.geomID[i],tri.primID[i]);
+      }
+    }
+
+    __forceinline void pointQuery(PointQuery& query, const Triangle4i& tri, const Scene* scene)
+    {
+      for (size_t i=0; i<tri.size(); i++) 
+      {
+        if (!validMask(scene,tri.geomID[i],query.mask)) continue;
+        const Vec3fa& v0 = tri.v0[i][0];
+        const Vec3fa& v1 = tri.v0[i][tri.v1[i]];
+        const Vec3fa& v2 = tri.v0[i][tri.v2[i]];
+        pointQueryTriangle(query,v0,v1,v2,tri.geomID[i],tri.primID[i]);
+      }
+    }
+
+    __forceinline void pointQuery(PointQuery& query, const Triangle4q& tri, const Scene* scene)
+    {
+      if (!validMask(scene,tri.geomID,query.mask)) return;
+      const sse3f v0 = tri.vertex(0), v1 = tri.vertex(1), v2 = tri.vertex(2);
+      for (size_t i=0; i<tri.size(); i++) 
+      {
+        pointQueryTriangle(query,Vec3fa(v0.x[i],v0.y[i],v0.z[i]),Vec3fa(v1.x[i],v1.y[i],v1.z[i]),Vec3fa(v2.x[i],v2.y[i],v2.z[i]),tri.geomID,tri.primID(i));
+      }
+    }
+
+    __forceinline void pointQuery(PointQuery& query, const TriangleMeshlet& meshlet, const Scene* scene)
+    {
+      for (size_t i=0; i<meshlet.size(); i++) 
+      {
+        if (!validMask(scene,meshlet.geomID[i],query.mask)) continue;
+        const Vec3f& v0 = meshlet.vertex(0,i), &v1 = meshlet.vertex(1,i), &v2 = meshlet.vertex(2,i);
+        pointQueryTriangle(query,Vec3fa(v0.x,v0.y,v0.z),Vec3fa(v1.x,v1.y,v1.z),Vec3fa(v2.x,v2.y,v2.z),meshlet.geomID[i],meshlet.primID[i]);
+      }
+    }
+
+    template<typename Primitive>
+    void BVH4PointQuery<Primitive>::query(const BVH4* bvh, PointQuery& query)
+    {
+      /*! stack state */
+      StackItem stack[stackSize];  //!< stack of nodes 
+      StackItem* stackPtr = stack+1;        //!< current stack pointer
+      StackItem* stackEnd = stack+stackSize;
+      stack[0].ptr = bvh->root;
+      stack[0].dist = neg_inf;
+      const Scene* scene = (const Scene*) bvh->geometry;
+
+      /*! load the query point into SIMD registers */
+      const sse3f p(query.p.x,query.p.y,query.p.z);
+      
+      /* pop loop */
+      while (true) pop:
+      {
+        /*! pop next node */
+        if (unlikely(stackPtr == stack)) break;
+        stackPtr--;
+        NodeRef cur = NodeRef(stackPtr->ptr);
+        
+        /*! if popped node is too far, pop next one */
+        if (unlikely(stackPtr->dist > query.radius*query.radius))
+          continue;
+        
+        /* downtraversal loop */
+        while (true)
+        {
+          /*! stop if we found a leaf */
+          if (unlikely(cur.isLeaf())) break;
+          
+          /*! squared distance of query point to the 4 boxes */
+          const Node* node = cur.node();
+          const ssef dx = max(node->lower_x-p.x,ssef(zero),p.x-node->upper_x);
+          const ssef dy = max(node->lower_y-p.y,ssef(zero),p.y-node->upper_y);
+          const ssef dz = max(node->lower_z-p.z,ssef(zero),p.z-node->upper_z);
+          const ssef dist = dx*dx + dy*dy + dz*dz;
+          size_t mask = movemask((dist <= ssef(query.radius*query.radius)) & (dist < ssef(pos_inf)));
+          
+          /*! if no child is in range, pop next node */
+          if (unlikely(mask == 0))
+            goto pop;
+          
+          /*! one child is in range, continue with that child */
+          size_t r = bitscan(mask); mask = __btc(mask,r);
+          if (likely(mask == 0)) {
+            cur = node->child(r);
+            assert(cur != BVH4::emptyNode);
+            continue;
+          }
+          
+          /*! push all children in range onto the stack, sort them, and continue with the closest child */
+          NodeRef c = node->child(r); 
+          assert(c != BVH4::emptyNode);
+          stackPtr->ptr = c; stackPtr->dist = dist[r]; stackPtr++;
+          size_t num = 1;
+          while (mask) {
+            r = bitscan(mask); mask = __btc(mask,r);
+            c = node->child(r);
+            assert(c != BVH4::emptyNode);
+            assert(stackPtr < stackEnd); 
+            stackPtr->ptr = c; stackPtr->dist = dist[r]; stackPtr++;
+            num++;
+          }
+          if      (num == 2) sort(stackPtr[-1],stackPtr[-2]);
+          else if (num == 3) sort(stackPtr[-1],stackPtr[-2],stackPtr[-3]);
+          else               sort(stackPtr[-1],stackPtr[-2],stackPtr[-3],stackPtr[-4]);
+          cur = (NodeRef) stackPtr[-1].ptr; stackPtr--;
+        }
+        
+        /*! this is a leaf node */
+        size_t num; Primitive* prim = (Primitive*) cur.leaf(num);
+        for (size_t i=0; i<num; i++)
+          pointQuery(query,prim[i],scene);
+      }
+      AVX_ZERO_UPPER();
+    }
+
+    DEFINE_POINT_QUERY(BVH4Triangle1PointQuery,BVH4PointQuery<Triangle1>);
+    DEFINE_POINT_QUERY(BVH4Triangle4PointQuery,BVH4PointQuery<Triangle4>);
+#if defined(__AVX__)
+    DEFINE_POINT_QUERY(BVH4Triangle8PointQuery,BVH4PointQuery<Triangle8>);
+#endif
+    DEFINE_POINT_QUERY(BVH4Triangle1vPointQuery,BVH4PointQuery<Triangle1v>);
+    DEFINE_POINT_QUERY(BVH4Triangle4vPointQuery,BVH4PointQuery<Triangle4v>);
+    DEFINE_POINT_QUERY(BVH4Triangle4iPointQuery,BVH4PointQuery<Triangle4i>);
+    DEFINE_POINT_QUERY(BVH4Triangle4qPointQuery,BVH4PointQuery<Triangle4q>);
+    DEFINE_POINT_QUERY(BVH4TriangleMeshletPointQuery,BVH4PointQuery<TriangleMeshlet>);
+  }
+}
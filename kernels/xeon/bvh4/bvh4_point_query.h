@@ -0,0 +1,47 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#ifndef __EMBREE_BVH4_POINT_QUERY_H__
+#define __EMBREE_BVH4_POINT_QUERY_H__
+
+#include "bvh4.h"
+#include "common/point_query.h"
+#include "common/stack_item.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! Closest point query for BVH4 over triangles. The 4 children
+     *  of a node are tested in parallel against the search sphere
+     *  and traversed in order of their distance to the query
+     *  point. */
+    template<typename Primitive>
+      class BVH4PointQuery
+    {
+      /* shortcuts for frequently used types */
+      typedef typename BVH4::NodeRef NodeRef;
+      typedef typename BVH4::Node Node;
+      typedef StackItemT<size_t> StackItem;
+      static const size_t stackSize = 1+3*BVH4::maxDepth;
+      
+    public:
+      static void query(const BVH4* This, PointQuery& query);
+    };
+  }
+}
+
+#endif
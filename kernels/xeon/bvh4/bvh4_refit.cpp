@@ -36,11 +36,14 @@ namespace embree
     }
     
     BVH4Refit::BVH4Refit (BVH4* bvh, Builder* builder, TriangleMeshScene::TriangleMesh* mesh)
-    : builder(builder), mesh(mesh), primTy(bvh->primTy), bvh(bvh) 
+    : builder(builder), mesh(mesh), geometry(mesh), parallel(false), primTy(bvh->primTy), bvh(bvh) 
     {
       needAllThreads = builder->needAllThreads;
     }
 
+    BVH4Refit::BVH4Refit (BVH4* bvh, void* geometry)
+    : builder(NULL), mesh(NULL), geometry(geometry), parallel(bvh->numPrimitives > 2*block_size), primTy(bvh->primTy), bvh(bvh) {}
+
     BVH4Refit::~BVH4Refit () {
       delete builder;
     }
@@ -49,7 +52,9 @@ namespace embree
     {
       /* build initial BVH */
       if (builder) {
+        size_t taskID = TaskLogger::beginTask(threadIndex,"BVH4Refit::build",0);
         builder->build(threadIndex,threadCount);
+        TaskLogger::endTask(threadIndex,taskID);
         if (false) { //bvh->numPrimitives > 50000) {
           annotate_tree_sizes(bvh->root);
           calculate_refit_roots();
@@ -59,6 +64,13 @@ namespace embree
         }
         delete builder; builder = NULL;
       }
+
+      /* the subtree sizes are stored in the nodes, thus the split is done right before the refit rewrites the bounds */
+      if (parallel) {
+        annotate_tree_sizes(bvh->root);
+        calculate_refit_roots();
+        parallel = false;
+      }
       
       /* refit BVH */
       double t0 = 0.0;
@@ -80,7 +92,7 @@ namespace embree
       if (g_verbose >= 2) {
         double t1 = getSeconds();
         std::cout << "[DONE]" << std::endl;
-        std::cout << "  dt = " << 1000.0f*(t1-t0) << "ms, perf = " << 1E-6*double(mesh->numTriangles)/(t1-t0) << " Mprim/s" << std::endl;
+        std::cout << "  dt = " << 1000.0f*(t1-t0) << "ms, perf = " << 1E-6*double(bvh->numPrimitives)/(t1-t0) << " Mprim/s" << std::endl;
         std::cout << BVH4Statistics(bvh).str();
       }
     }
@@ -114,13 +126,13 @@ namespace embree
       roots.push_back(&bvh->root);
       std::make_heap (roots.begin(), roots.end(), compare);
       
-      while (true)
+      while (!roots.empty())
       {
         std::pop_heap(roots.begin(), roots.end(), compare);
         BVH4::NodeRef* node = roots.back();
-        roots.pop_back();
         if (*(size_t*)node->node() < block_size) 
           break;
+        roots.pop_back();
         
         for (size_t i=0; i<BVH4::N; i++) {
           BVH4::NodeRef* child = &node->node()->child(i);
@@ -136,7 +148,7 @@ namespace embree
     {
       size_t num; char* tri = ref.leaf(num);
       if (unlikely(num == 0)) return empty;
-      return bvh->primTy.update(tri,num,mesh);
+      return bvh->primTy.update(tri,num,geometry);
     }
     
     __forceinline BBox3f BVH4Refit::node_bounds(NodeRef& ref)
@@ -244,6 +256,10 @@ namespace embree
 
     Builder* BVH4BuilderObjectSplit4TriangleMeshFast (void* bvh, TriangleMeshScene::TriangleMesh* mesh, const size_t minLeafSize, const size_t maxLeafSize);
 
+    Builder* BVH4RefitBuilder (void* accel, void* geometry) {
+      return new BVH4Refit((BVH4*)accel,geometry);
+    }
+
     Builder* BVH4BuilderRefitObjectSplit4TriangleMeshFast (void* accel, TriangleMeshScene::TriangleMesh* mesh, const size_t minLeafSize, const size_t maxLeafSize) {
       Builder* builder = BVH4BuilderObjectSplit4TriangleMeshFast(accel,mesh,minLeafSize,maxLeafSize);
       return new BVH4Refit((BVH4*)accel,builder,mesh);
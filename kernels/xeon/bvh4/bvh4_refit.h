@@ -39,6 +39,9 @@ namespace embree
       /*! Constructor. */
       BVH4Refit (BVH4* bvh, Builder* builder, TriangleMeshScene::TriangleMesh* mesh);
 
+      /*! Constructor for refitting an already built BVH, large BVHs get refitted in parallel. */
+      BVH4Refit (BVH4* bvh, void* geometry);
+
       ~BVH4Refit();
 
       TASK_COMPLETE_FUNCTION(BVH4Refit,refit_sequential);
@@ -57,8 +60,9 @@ namespace embree
       
     private:
       //BuildSource* source;           //!< input geometry
-      //void* geometry;                //!< input geometry
       TriangleMeshScene::TriangleMesh* mesh;
+      void* geometry;                 //!< input geometry passed to the primitive type
+      bool parallel;                  //!< split the BVH into subtrees for parallel refit at the first refit
       
     public:
       const PrimitiveType& primTy;   //!< primitve type stored in BVH
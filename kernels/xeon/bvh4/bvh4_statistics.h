@@ -37,6 +37,9 @@ namespace embree
     /*! memory required to store BVH4 */
     size_t bytesUsed();
 
+    /*! SAH cost of the BVH4 relative to the surface area of its bounds */
+    float sah() const { return bvhSAH; }
+
   private:
     void statistics(NodeRef node, const BBox3f& bounds, size_t& depth);
 
@@ -17,6 +17,7 @@
 #include "twolevel_accel.h"
 #include "virtual_accel.h"
 #include "common/scene.h"
+#include "sys/tasklogger.h"
 
 #include "bvh4/bvh4.h"
 #include "bvh4i/bvh4i.h"
@@ -56,11 +57,15 @@ namespace embree
   void TwoLevelAccel::build(size_t threadIndex, size_t threadCount)
   {
     /* build all object accels */
+    size_t taskID = TaskLogger::beginTask(threadIndex,"TwoLevelAccel::objects",0);
     enabled_accels.clear();
     buildUserGeometryAccels(threadIndex,threadCount);
+    TaskLogger::endTask(threadIndex,taskID);
 
     /* build toplevel accel */
+    taskID = TaskLogger::beginTask(threadIndex,"TwoLevelAccel::toplevel",0);
     accel->build(threadIndex,threadCount);
+    TaskLogger::endTask(threadIndex,taskID);
     bounds = accel->bounds;
     intersectors = accel->intersectors;
   }
@@ -17,6 +17,7 @@
 #include "virtual_accel.h"
 
 #include "bvh4/bvh4.h"
+#include "bvh4/bvh4_statistics.h"
 #include "bvh4i/bvh4i.h"
 
 namespace embree
@@ -33,9 +34,10 @@ namespace embree
   extern Accel::Intersector8 BVH4iVirtualIntersector8Chunk;
 
   Builder* BVH4BuilderObjectSplit1 (void* bvh, BuildSource* source, void* geometry, const size_t minLeafSize, const size_t maxLeafSize);
+  namespace isa { Builder* BVH4RefitBuilder (void* accel, void* geometry); }
 
   VirtualAccel::VirtualAccel (const std::string& ty, std::vector<AccelSet*>& accels)
-    : source(accels)
+    : refitter(NULL), source(accels), numRefits(0), builtSAH(0.0f)
   {
     if (ty == "bvh4" || ty == "default")
     {
@@ -54,11 +56,40 @@ namespace embree
   {
     delete accel;
     delete builder;
+    delete refitter;
+  }
+
+  bool VirtualAccel::sameObjects() const 
+  {
+    if (objects.size() != source.accels.size()) return false;
+    for (size_t i=0; i<objects.size(); i++)
+      if (!(objects[i] == BuiltObject(source.accels[i]))) return false;
+    return true;
   }
 
   void VirtualAccel::build (size_t threadIndex, size_t threadCount) 
   {
+    /* only refit if just the bounds of the objects changed, rebuild every g_top_rebuild commits to restore quality */
+    if (refitter && sameObjects() && (g_top_rebuild == 0 || ++numRefits < g_top_rebuild)) 
+    {
+      refitter->build(threadIndex,threadCount);
+      bounds = accel->bounds;
+
+      /* objects moving apart let the refitted nodes overlap, rebuild once the SAH cost grew too much */
+      const float sah = BVH4Statistics((BVH4*)accel).sah();
+      if (g_top_rebuild_sah == 0 || sah <= (1.0f+0.01f*g_top_rebuild_sah)*builtSAH) 
+        return;
+    }
+
     builder->build(threadIndex,threadCount);
     bounds = accel->bounds;
+    builtSAH = bounds.empty() ? 0.0f : BVH4Statistics((BVH4*)accel).sah();
+
+    objects.clear();
+    for (size_t i=0; i<source.accels.size(); i++)
+      objects.push_back(BuiltObject(source.accels[i]));
+    delete refitter; refitter = NULL;
+    if (!objects.empty()) refitter = isa::BVH4RefitBuilder(accel,NULL);
+    numRefits = 0;
   }
 }
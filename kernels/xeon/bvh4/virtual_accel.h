@@ -42,15 +42,16 @@ namespace embree
       
       size_t prims (size_t group, size_t* pNumVertices) const {
         if (pNumVertices) *pNumVertices = 0;
-        return accels[group]->size();
+        return accels[group]->blocks();
       }
       
       const BBox3f bounds(size_t group, size_t prim) const {
-        return accels[group]->bounds(prim);
+        return accels[group]->blockBounds(prim);
       }
 
       void bounds(size_t group, size_t begin, size_t end, BBox3f* bounds_o) const {
-        assert(false); // FIXME
+        for (size_t i=begin; i<end; i++) 
+          bounds_o[i-begin] = accels[group]->blockBounds(i);
       }
       
       std::vector<AccelSet*>& accels;
@@ -75,9 +76,34 @@ namespace embree
         std::vector<AccelSet*>* accels = (std::vector<AccelSet*>*) geom;
         AccelSetItem* dst = (AccelSetItem*)This;
         dst->accel = (*accels)[prim.geomID()];
-        dst->item = prim.primID();
+        dst->item = prim.primID()*dst->accel->blockSize;
         prims++;
       }
+
+      BBox3f update(char* prim, size_t num, void* geom) const 
+      {
+        BBox3f bounds = empty;
+        for (size_t i=0; i<num; i++) {
+          const AccelSetItem& item = ((AccelSetItem*)prim)[i];
+          bounds.extend(item.accel->blockBounds(item.item/item.accel->blockSize));
+        }
+        return bounds;
+      }
+    };
+
+    /*! object the BVH got built over */
+    struct BuiltObject 
+    {
+      BuiltObject (AccelSet* accel) 
+        : accel(accel), numItems(accel->numItems), blockSize(accel->blockSize) {}
+
+      __forceinline bool operator==(const BuiltObject& other) const { 
+        return accel == other.accel && numItems == other.numItems && blockSize == other.blockSize; 
+      }
+
+      AccelSet* accel;
+      size_t numItems;
+      size_t blockSize;
     };
     
   public:
@@ -86,11 +112,19 @@ namespace embree
     
   public:
     void build (size_t threadIndex, size_t threadCount);
+
+  private:
+    /*! checks if the BVH got built over the same objects */
+    bool sameObjects() const;
     
   public:
     Bounded* accel;
     Builder* builder;
+    Builder* refitter;                   //!< refits the BVH if only the bounds of the objects changed
     VirtualBuildSource source;
+    std::vector<BuiltObject> objects;    //!< objects of the last build
+    size_t numRefits;                    //!< number of refits since the last build
+    float builtSAH;                      //!< SAH cost of the BVH after the last build
   };
 }
 
@@ -151,7 +151,7 @@ namespace embree
 
   Accel* BVH4i::BVH4iTriangle1(Scene* scene)
   { 
-    BVH4i* accel = new BVH4i(SceneTriangle1::type);
+    BVH4i* accel = new BVH4i(SceneTriangle1::type,scene);
     
     Builder* builder = NULL;
     if      (g_builder == "default"     ) builder = BVH4iBuilderObjectSplit1(accel,&scene->flat_triangle_source_1,scene,1,inf);
@@ -168,7 +168,7 @@ namespace embree
   
   Accel* BVH4i::BVH4iTriangle4(Scene* scene)
   { 
-    BVH4i* accel = new BVH4i(SceneTriangle4::type);
+    BVH4i* accel = new BVH4i(SceneTriangle4::type,scene);
     
     Builder* builder = NULL;
     if      (g_builder == "default"     ) builder = BVH4iBuilderObjectSplit4(accel,&scene->flat_triangle_source_1,scene,1,inf);
@@ -182,7 +182,7 @@ namespace embree
   
   Accel* BVH4i::BVH4iTriangle1_v1(Scene* scene)
   { 
-    BVH4i* accel = new BVH4i(SceneTriangle1::type);
+    BVH4i* accel = new BVH4i(SceneTriangle1::type,scene);
     Builder* builder = BVH4iTriangle1BuilderObjectSplit4Fast(accel,&scene->flat_triangle_source_1,scene,1,inf);
     
     Accel::Intersectors intersectors = BVH4iTriangle1Intersectors(accel);
@@ -191,7 +191,7 @@ namespace embree
   
   Accel* BVH4i::BVH4iTriangle1_v2(Scene* scene)
   { 
-    BVH4i* accel = new BVH4i(SceneTriangle1::type);
+    BVH4i* accel = new BVH4i(SceneTriangle1::type,scene);
     Builder* builder = BVH4iTriangle1BuilderObjectSplit4Fast(accel,&scene->flat_triangle_source_1,scene,1,inf);
     
     Accel::Intersectors intersectors = BVH4iTriangle1Intersectors(accel);
@@ -203,7 +203,7 @@ namespace embree
   
   Accel* BVH4i::BVH4iTriangle1_morton(Scene* scene)
   { 
-    BVH4i* accel = new BVH4i(SceneTriangle1::type);
+    BVH4i* accel = new BVH4i(SceneTriangle1::type,scene);
     Builder* builder = BVH4iTriangle1BuilderMorton(accel,&scene->flat_triangle_source_1,scene,1,inf);
     Accel::Intersectors intersectors = BVH4iTriangle1Intersectors(accel);
     return new AccelInstance(accel,builder,intersectors);
@@ -211,7 +211,7 @@ namespace embree
   
   Accel* BVH4i::BVH4iTriangle1_morton_enhanced(Scene* scene)
   { 
-    BVH4i* accel = new BVH4i(SceneTriangle1::type);
+    BVH4i* accel = new BVH4i(SceneTriangle1::type,scene);
     Builder* builder = BVH4iTriangle1BuilderMortonEnhanced(accel,&scene->flat_triangle_source_1,scene,1,inf);
     Accel::Intersectors intersectors = BVH4iTriangle1Intersectors(accel);
     return new AccelInstance(accel,builder,intersectors);
@@ -219,7 +219,7 @@ namespace embree
   
   Accel* BVH4i::BVH4iTriangle1(TriangleMeshScene::TriangleMesh* mesh)
   {
-    BVH4i* accel = new BVH4i(TriangleMeshTriangle1::type);
+    BVH4i* accel = new BVH4i(TriangleMeshTriangle1::type,mesh->parent);
 
     Builder* builder = NULL;
     if      (g_builder == "default"     ) builder = BVH4iBuilderObjectSplit1(accel,mesh,mesh,1,inf);
@@ -233,7 +233,7 @@ namespace embree
 
   Accel* BVH4i::BVH4iTriangle4(TriangleMeshScene::TriangleMesh* mesh)
   {
-    BVH4i* accel = new BVH4i(TriangleMeshTriangle4::type);
+    BVH4i* accel = new BVH4i(TriangleMeshTriangle4::type,mesh->parent);
 
     Builder* builder = NULL;
     if      (g_builder == "default"     ) builder = BVH4iBuilderObjectSplit4(accel,mesh,mesh,1,inf);
@@ -247,7 +247,7 @@ namespace embree
 
   Accel* BVH4i::BVH4iTriangle1v(TriangleMeshScene::TriangleMesh* mesh)
   {
-    BVH4i* accel = new BVH4i(TriangleMeshTriangle1v::type);
+    BVH4i* accel = new BVH4i(TriangleMeshTriangle1v::type,mesh->parent);
 
     Builder* builder = NULL;
     if      (g_builder == "default"     ) builder = BVH4iBuilderObjectSplit1(accel,mesh,mesh,1,inf);
@@ -261,7 +261,7 @@ namespace embree
 
   Accel* BVH4i::BVH4iTriangle4v(TriangleMeshScene::TriangleMesh* mesh)
   {
-    BVH4i* accel = new BVH4i(TriangleMeshTriangle4v::type);
+    BVH4i* accel = new BVH4i(TriangleMeshTriangle4v::type,mesh->parent);
 
     Builder* builder = NULL;
     if      (g_builder == "default"     ) builder = BVH4iBuilderObjectSplit4(accel,mesh,mesh,1,inf);
@@ -19,6 +19,7 @@
 #include "bvh4i_statistics.h"
 #include "bvh4i_builder_util.h"
 #include "bvh4i_builder_binner.h"
+#include "sys/tasklogger.h"
 
 #define BVH_NODE_PREALLOC_FACTOR 1.0f
 #define QBVH_BUILDER_LEAF_ITEM_THRESHOLD 4
@@ -132,6 +133,7 @@ namespace embree
 #if 1
     void BVH4iBuilderFast::computePrimRefs(const size_t threadID, const size_t numThreads)
     {
+      size_t taskID = TaskLogger::beginTask(threadID,"BVH4iBuilderFast::computePrimRefs",0);
       const size_t numGroups = source->groups();
       const size_t startID = (threadID+0)*numPrimitives/numThreads;
       const size_t endID   = (threadID+1)*numPrimitives/numThreads;
@@ -175,6 +177,7 @@ namespace embree
         offset = 0;
       }
       global_bounds.extend_atomic(bounds);    
+      TaskLogger::endTask(threadID,taskID);
     }
     
 #else
@@ -247,6 +250,7 @@ namespace embree
     
     void BVH4iBuilderFast::convertToSOALayout(const size_t threadID, const size_t numThreads)
     {
+      size_t taskID = TaskLogger::beginTask(threadID,"BVH4iBuilderFast::convertToSOALayout",0);
       const size_t startID = (threadID+0)*numNodes/numThreads;
       const size_t endID   = (threadID+1)*numNodes/numThreads;
       
@@ -255,6 +259,7 @@ namespace embree
       for (size_t n=startID; n<endID; n++, bptr+=4)
         convertToSOALayoutBlock4(bptr);
       
+      TaskLogger::endTask(threadID,taskID);
     }
     
     __forceinline void computeAccelerationData(const size_t geomID,
@@ -281,6 +286,7 @@ namespace embree
     
     void BVH4iBuilderFast::createTriangle1(const size_t threadID, const size_t numThreads)
     {
+      size_t taskID = TaskLogger::beginTask(threadID,"BVH4iBuilderFast::createTriangle1",0);
       const size_t startID = (threadID+0)*numPrimitives/numThreads;
       const size_t endID   = (threadID+1)*numPrimitives/numThreads;
       
@@ -289,10 +295,12 @@ namespace embree
       
       for (size_t j=startID; j<endID; j++, bptr++, acc++)
         computeAccelerationData(bptr->geomID(),bptr->primID(),(Scene*)geometry,acc);
+      TaskLogger::endTask(threadID,taskID);
     }
     
     void BVH4iBuilderFast::buildSubTrees(const size_t threadID, const size_t numThreads)
     {
+      size_t taskID = TaskLogger::beginTask(threadID,"BVH4iBuilderFast::buildSubTrees",0);
       while (true) 
       {
         BuildRecord br;
@@ -316,6 +324,7 @@ namespace embree
         while (thread_workStack[threadID].pop_largest(br))
           recurseSAH(br,RECURSE,threadID,numThreads);
       }
+      TaskLogger::endTask(threadID,taskID);
     }
     
     // =======================================================================================================
@@ -566,12 +575,14 @@ namespace embree
       global_workStack.push_nolock(br);    
       
       /* work in multithreaded toplevel mode until sufficient subtasks got generated */
+      size_t taskID = TaskLogger::beginTask(threadIndex,"BVH4iBuilderFast::toplevel",0);
       while (global_workStack.size() < 4*threadCount && global_workStack.size()+BVH4i::N <= SIZE_WORK_STACK) 
       {
         BuildRecord br;
         if (!global_workStack.pop_nolock_largest(br)) break;
         recurseSAH(br,BUILD_TOP_LEVEL,threadIndex,threadCount);
       }
+      TaskLogger::endTask(threadIndex,taskID);
       
       /* now process all created subtasks on multiple threads */
       LockStepTaskScheduler::dispatchTask(task_buildSubTrees, this, threadIndex, threadCount );
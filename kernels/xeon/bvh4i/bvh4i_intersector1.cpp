@@ -269,8 +269,8 @@ namespace embree
       AVX_ZERO_UPPER();
     }
     
-    DEFINE_INTERSECTOR1(BVH4iTriangle1Intersector1Moeller,BVH4iIntersector1<Triangle1Intersector1MoellerTrumbore>);
-    DEFINE_INTERSECTOR1(BVH4iTriangle4Intersector1Moeller,BVH4iIntersector1<Triangle4Intersector1MoellerTrumbore>);
+    DEFINE_INTERSECTOR1(BVH4iTriangle1Intersector1Moeller,BVH4iIntersector1<Triangle1Intersector1MoellerTrumbore<KERNEL_FEATURES_ALL> >);
+    DEFINE_INTERSECTOR1(BVH4iTriangle4Intersector1Moeller,BVH4iIntersector1<Triangle4Intersector1MoellerTrumbore<KERNEL_FEATURES_ALL> >);
     DEFINE_INTERSECTOR1(BVH4iTriangle1vIntersector1Pluecker,BVH4iIntersector1<Triangle1vIntersector1Pluecker>);
     DEFINE_INTERSECTOR1(BVH4iTriangle4vIntersector1Pluecker,BVH4iIntersector1<Triangle4vIntersector1Pluecker>);
     DEFINE_INTERSECTOR1(BVH4iVirtualIntersector1,BVH4iIntersector1<VirtualAccelIntersector1>);
@@ -328,7 +328,7 @@ namespace embree
       AVX_ZERO_UPPER();
     }
     
-    DEFINE_INTERSECTOR1(BVH4iTriangle1Intersector1ScalarMoeller,BVH4iIntersector1Scalar<Triangle1Intersector1MoellerTrumbore>);
+    DEFINE_INTERSECTOR1(BVH4iTriangle1Intersector1ScalarMoeller,BVH4iIntersector1Scalar<Triangle1Intersector1MoellerTrumbore<KERNEL_FEATURES_ALL> >);
     DEFINE_INTERSECTOR1(BVH4iVirtualIntersector1Scalar,BVH4iIntersector1Scalar<VirtualAccelIntersector1>);
   }
 }
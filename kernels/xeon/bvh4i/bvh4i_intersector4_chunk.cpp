@@ -277,8 +277,8 @@ namespace embree
       AVX_ZERO_UPPER();
     }
     
-    DEFINE_INTERSECTOR4(BVH4iTriangle1Intersector4ChunkMoeller, BVH4iIntersector4Chunk<Triangle1Intersector4MoellerTrumbore>);
-    DEFINE_INTERSECTOR4(BVH4iTriangle4Intersector4ChunkMoeller, BVH4iIntersector4Chunk<Triangle4Intersector4MoellerTrumbore>);
+    DEFINE_INTERSECTOR4(BVH4iTriangle1Intersector4ChunkMoeller, BVH4iIntersector4Chunk<Triangle1Intersector4MoellerTrumbore<KERNEL_FEATURES_ALL> >);
+    DEFINE_INTERSECTOR4(BVH4iTriangle4Intersector4ChunkMoeller, BVH4iIntersector4Chunk<Triangle4Intersector4MoellerTrumbore<KERNEL_FEATURES_ALL> >);
     DEFINE_INTERSECTOR4(BVH4iTriangle1vIntersector4ChunkPluecker, BVH4iIntersector4Chunk<Triangle1vIntersector4Pluecker>);
     DEFINE_INTERSECTOR4(BVH4iTriangle4vIntersector4ChunkPluecker, BVH4iIntersector4Chunk<Triangle4vIntersector4Pluecker>);
     DEFINE_INTERSECTOR4(BVH4iVirtualIntersector4Chunk, BVH4iIntersector4Chunk<VirtualAccelIntersector4>);
@@ -278,8 +278,8 @@ namespace embree
       AVX_ZERO_UPPER();
     }
 
-    DEFINE_INTERSECTOR8(BVH4iTriangle1Intersector8ChunkMoeller, BVH4iIntersector8Chunk<Triangle1Intersector8MoellerTrumbore>);
-    DEFINE_INTERSECTOR8(BVH4iTriangle4Intersector8ChunkMoeller, BVH4iIntersector8Chunk<Triangle4Intersector8MoellerTrumbore>);
+    DEFINE_INTERSECTOR8(BVH4iTriangle1Intersector8ChunkMoeller, BVH4iIntersector8Chunk<Triangle1Intersector8MoellerTrumbore<KERNEL_FEATURES_ALL> >);
+    DEFINE_INTERSECTOR8(BVH4iTriangle4Intersector8ChunkMoeller, BVH4iIntersector8Chunk<Triangle4Intersector8MoellerTrumbore<KERNEL_FEATURES_ALL> >);
     DEFINE_INTERSECTOR8(BVH4iTriangle1vIntersector8ChunkPluecker, BVH4iIntersector8Chunk<Triangle1vIntersector8Pluecker>);
     DEFINE_INTERSECTOR8(BVH4iTriangle4vIntersector8ChunkPluecker, BVH4iIntersector8Chunk<Triangle4vIntersector8Pluecker>);
     DEFINE_INTERSECTOR8(BVH4iVirtualIntersector8Chunk, BVH4iIntersector8Chunk<VirtualAccelIntersector8>);
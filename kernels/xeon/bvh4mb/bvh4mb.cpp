@@ -23,6 +23,9 @@ namespace embree
   DECLARE_SYMBOL(Accel::Intersector1,BVH4MBTriangle1vIntersector1Moeller);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4MBTriangle1vIntersector4ChunkMoeller);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4MBTriangle1vIntersector8ChunkMoeller);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH4MBTriangle1vIntersector1MoellerBasic);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4MBTriangle1vIntersector4ChunkMoellerBasic);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4MBTriangle1vIntersector8ChunkMoellerBasic);
 
   Builder* BVH4MBBuilderObjectSplit1 (void* bvh, BuildSource* source, void* geometry, const size_t minLeafSize, const size_t maxLeafSize);
   Builder* BVH4MBBuilderObjectSplit4 (void* bvh, BuildSource* source, void* geometry, const size_t minLeafSize, const size_t maxLeafSize);
@@ -34,11 +37,14 @@ namespace embree
     SELECT_SYMBOL_DEFAULT_AVX_AVX2(features,BVH4MBTriangle1vIntersector1Moeller);
     SELECT_SYMBOL_DEFAULT_AVX_AVX2(features,BVH4MBTriangle1vIntersector4ChunkMoeller);
     SELECT_SYMBOL_AVX_AVX2(features,BVH4MBTriangle1vIntersector8ChunkMoeller);
+    SELECT_SYMBOL_DEFAULT_AVX_AVX2(features,BVH4MBTriangle1vIntersector1MoellerBasic);
+    SELECT_SYMBOL_DEFAULT_AVX_AVX2(features,BVH4MBTriangle1vIntersector4ChunkMoellerBasic);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH4MBTriangle1vIntersector8ChunkMoellerBasic);
   }
 
   Accel* BVH4MB::BVH4MBTriangle1v(Scene* scene)
   { 
-    BVH4MB* accel = new BVH4MB(SceneTriangle1vMB::type);
+    BVH4MB* accel = new BVH4MB(SceneTriangle1vMB::type,scene);
 
     Builder* builder = NULL;
     if      (g_builder == "default"     ) builder = BVH4MBBuilderObjectSplit1(accel,&scene->flat_triangle_source_2,scene,1,inf);
@@ -51,13 +57,21 @@ namespace embree
     intersectors.intersector4 = BVH4MBTriangle1vIntersector4ChunkMoeller;
     intersectors.intersector8 = BVH4MBTriangle1vIntersector8ChunkMoeller;
     intersectors.intersector16 = NULL;
+    intersectors.features = KERNEL_FEATURES_ALL;
 
-    return new AccelInstance(accel,builder,intersectors);
+    Accel::Intersectors basicIntersectors;
+    basicIntersectors.ptr = accel;
+    basicIntersectors.intersector1 = BVH4MBTriangle1vIntersector1MoellerBasic;
+    basicIntersectors.intersector4 = BVH4MBTriangle1vIntersector4ChunkMoellerBasic;
+    basicIntersectors.intersector8 = BVH4MBTriangle1vIntersector8ChunkMoellerBasic;
+    basicIntersectors.intersector16 = NULL;
+
+    return new AccelInstance(accel,builder,intersectors,basicIntersectors);
   }
 
   Accel* BVH4MB::BVH4MBTriangle1vObjectSplit(TriangleMeshScene::TriangleMesh* mesh)
   {
-    BVH4MB* accel = new BVH4MB(TriangleMeshTriangle1vMB::type);
+    BVH4MB* accel = new BVH4MB(TriangleMeshTriangle1vMB::type,mesh->parent);
     Builder* builder = BVH4MBBuilderObjectSplit1(accel,mesh,mesh,1,inf);
 
     Accel::Intersectors intersectors;
@@ -66,6 +80,7 @@ namespace embree
     intersectors.intersector4 = BVH4MBTriangle1vIntersector4ChunkMoeller;
     intersectors.intersector8 = BVH4MBTriangle1vIntersector8ChunkMoeller;
     intersectors.intersector16 = NULL;
+    intersectors.features = KERNEL_FEATURES_ALL;
 
     return new AccelInstance(accel,builder,intersectors);
   }  
@@ -235,7 +235,8 @@ namespace embree
       AVX_ZERO_UPPER();
     }
 
-    DEFINE_INTERSECTOR1(BVH4MBTriangle1vIntersector1Moeller,BVH4MBIntersector1<Triangle1vIntersector1MoellerTrumboreMB>);
+    DEFINE_INTERSECTOR1(BVH4MBTriangle1vIntersector1Moeller,BVH4MBIntersector1<Triangle1vIntersector1MoellerTrumboreMB<KERNEL_FEATURES_ALL> >);
+    DEFINE_INTERSECTOR1(BVH4MBTriangle1vIntersector1MoellerBasic,BVH4MBIntersector1<Triangle1vIntersector1MoellerTrumboreMB<KERNEL_FEATURES_NONE> >);
     //DEFINE_INTERSECTOR1(BVH4MBTriangle4vIntersector1Moeller,BVH4MBIntersector1<Triangle4vIntersector1MoellerTrumboreMB>);
   }
 }
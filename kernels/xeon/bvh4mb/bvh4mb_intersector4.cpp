@@ -252,6 +252,7 @@ namespace embree
       AVX_ZERO_UPPER();
     }
     
-    DEFINE_INTERSECTOR4(BVH4MBTriangle1vIntersector4ChunkMoeller, BVH4MBIntersector4Chunk<Triangle1vIntersector4MoellerTrumboreMB>);
+    DEFINE_INTERSECTOR4(BVH4MBTriangle1vIntersector4ChunkMoeller, BVH4MBIntersector4Chunk<Triangle1vIntersector4MoellerTrumboreMB<KERNEL_FEATURES_ALL> >);
+    DEFINE_INTERSECTOR4(BVH4MBTriangle1vIntersector4ChunkMoellerBasic, BVH4MBIntersector4Chunk<Triangle1vIntersector4MoellerTrumboreMB<KERNEL_FEATURES_NONE> >);
   }
 }
@@ -252,6 +252,7 @@ namespace embree
       AVX_ZERO_UPPER();
     }
 
-    DEFINE_INTERSECTOR8(BVH4MBTriangle1vIntersector8ChunkMoeller, BVH4MBIntersector8Chunk<Triangle1vIntersector8MoellerTrumboreMB>);
+    DEFINE_INTERSECTOR8(BVH4MBTriangle1vIntersector8ChunkMoeller, BVH4MBIntersector8Chunk<Triangle1vIntersector8MoellerTrumboreMB<KERNEL_FEATURES_ALL> >);
+    DEFINE_INTERSECTOR8(BVH4MBTriangle1vIntersector8ChunkMoellerBasic, BVH4MBIntersector8Chunk<Triangle1vIntersector8MoellerTrumboreMB<KERNEL_FEATURES_NONE> >);
   }
 }
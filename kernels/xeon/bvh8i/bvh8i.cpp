@@ -45,7 +45,7 @@ namespace embree
 
   Accel* BVH8i::BVH8iTriangle1(Scene* scene)
   { 
-    BVH8i* accel = new BVH8i(SceneTriangle1::type);
+    BVH8i* accel = new BVH8i(SceneTriangle1::type,scene);
     Builder* builder = BVH8iTriangle1BuilderObjectSplit4(accel,&scene->flat_triangle_source_1,scene,1,inf);
 
     Accel::Intersectors intersectors;
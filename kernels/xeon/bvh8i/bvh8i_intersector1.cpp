@@ -89,26 +89,13 @@ namespace embree
           
           const BVH8i::BVH8iNode* __restrict__ const bptr = BVH8i::bvh8ChildPtrNoMask(bvh8,curNode);
           
-          const avxf tNearX = load8f((float*)((const char*)bptr + (size_t)nearX)) * rdir_x - org_rdir_x;
-          const avxf tNearY = load8f((float*)((const char*)bptr + (size_t)nearY)) * rdir_y - org_rdir_y;
-          const avxf tNearZ = load8f((float*)((const char*)bptr + (size_t)nearZ)) * rdir_z - org_rdir_z;
-          
-          const avxf tFarX = load8f((float*)((const char*)bptr + ((size_t)nearX ^ sizeof(avxf)))) * rdir_x - org_rdir_x;
-          const avxf tFarY = load8f((float*)((const char*)bptr + ((size_t)nearY ^ sizeof(avxf)))) * rdir_y - org_rdir_y;
-          const avxf tFarZ = load8f((float*)((const char*)bptr + ((size_t)nearZ ^ sizeof(avxf)))) * rdir_z - org_rdir_z;
-          
-          const avxi near8 = max(max(cast(tNearX),cast(tNearY)),max(cast(tNearZ),cast(avxf(ray.tnear))));
-          const avxi far8  = min(min(cast(tFarX) ,cast(tFarY )),min(cast(tFarZ ),cast(avxf(ray.tfar))));
+          avxi near8;
+          const unsigned int m_near_far = intersectBox(bptr,nearX,nearY,nearZ,rdir_x,rdir_y,rdir_z,org_rdir_x,org_rdir_y,org_rdir_z,ray.tnear,ray.tfar,near8);
           
           curNode = stack[sindex-1].node;
           
           sindex--;
           
-          const avxb near_far = near8 > far8;
-          
-          DBG(DBG_PRINT(near_far));
-          
-          const unsigned int m_near_far = movemask(near_far) ^ 0xff;
           if (likely((m_near_far) == 0)) continue;
           
           size_t i_lr_hit = m_near_far;
@@ -380,32 +367,12 @@ namespace embree
           
           const BVH8i::BVH8iNode* __restrict__ const bptr = BVH8i::bvh8ChildPtrNoMask(bvh8,curNode);
           
-          const avxf tNearX = load8f((float*)((const char*)bptr + (size_t)nearX)) * rdir_x - org_rdir_x;
-          const avxf tNearY = load8f((float*)((const char*)bptr + (size_t)nearY)) * rdir_y - org_rdir_y;
-          const avxf tNearZ = load8f((float*)((const char*)bptr + (size_t)nearZ)) * rdir_z - org_rdir_z;
-          
-          const avxf tFarX = load8f((float*)((const char*)bptr + ((size_t)nearX ^ sizeof(avxf)))) * rdir_x - org_rdir_x;
-          const avxf tFarY = load8f((float*)((const char*)bptr + ((size_t)nearY ^ sizeof(avxf)))) * rdir_y - org_rdir_y;
-          const avxf tFarZ = load8f((float*)((const char*)bptr + ((size_t)nearZ ^ sizeof(avxf)))) * rdir_z - org_rdir_z;
-          
-#if 0
-          const avxf near8 = max(max(tNearX,tNearY),max(tNearZ,ray.tnear));
-          const avxf far8  = min(min(tFarX ,tFarY ),min( tFarZ,ray.tfar));
-#else
-          const avxi near8 = max(max(cast(tNearX),cast(tNearY)),max(cast(tNearZ),cast(avxf(ray.tnear))));
-          const avxi far8  = min(min(cast(tFarX) ,cast(tFarY )),min(cast(tFarZ ),cast(avxf(ray.tfar))));
-          
-#endif
+          avxi near8;
+          const unsigned int m_near_far = intersectBox(bptr,nearX,nearY,nearZ,rdir_x,rdir_y,rdir_z,org_rdir_x,org_rdir_y,org_rdir_z,ray.tnear,ray.tfar,near8);
           
           curNode = stack[sindex-1].node;
           
           sindex--;
-          
-          const avxb near_far = near8 > far8;
-          
-          DBG(DBG_PRINT(near_far));
-          
-          const unsigned int m_near_far = movemask(near_far) ^ 0xff;
           if (likely((m_near_far) == 0)) continue;
           
           size_t i_lr_hit = m_near_far;
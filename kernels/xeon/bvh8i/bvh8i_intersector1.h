@@ -25,6 +25,28 @@ namespace embree
 {
   namespace isa
   {
+    /*! Intersects a single ray with the 8 child boxes of a BVH8i
+     *  node. Returns a bitmask of the hit children and their entry
+     *  distances as integers in near8. */
+    __forceinline unsigned int intersectBox(const BVH8i::BVH8iNode* node, const size_t nearX, const size_t nearY, const size_t nearZ,
+                                            const avxf& rdir_x, const avxf& rdir_y, const avxf& rdir_z,
+                                            const avxf& org_rdir_x, const avxf& org_rdir_y, const avxf& org_rdir_z,
+                                            const float tnear, const float tfar, avxi& near8)
+    {
+      const avxf tNearX = load8f((float*)((const char*)node + (size_t)nearX)) * rdir_x - org_rdir_x;
+      const avxf tNearY = load8f((float*)((const char*)node + (size_t)nearY)) * rdir_y - org_rdir_y;
+      const avxf tNearZ = load8f((float*)((const char*)node + (size_t)nearZ)) * rdir_z - org_rdir_z;
+      
+      const avxf tFarX = load8f((float*)((const char*)node + ((size_t)nearX ^ sizeof(avxf)))) * rdir_x - org_rdir_x;
+      const avxf tFarY = load8f((float*)((const char*)node + ((size_t)nearY ^ sizeof(avxf)))) * rdir_y - org_rdir_y;
+      const avxf tFarZ = load8f((float*)((const char*)node + ((size_t)nearZ ^ sizeof(avxf)))) * rdir_z - org_rdir_z;
+      
+      near8 = max(max(cast(tNearX),cast(tNearY)),max(cast(tNearZ),cast(avxf(tnear))));
+      const avxi far8  = min(min(cast(tFarX) ,cast(tFarY )),min(cast(tFarZ ),cast(avxf(tfar))));
+      const avxb near_far = near8 > far8;
+      return movemask(near_far) ^ 0xff;
+    }
+
     /*! BVH8i Traverser. Single ray traversal implementation for a Quad BVH. */
     class BVH8iIntersector1
     {
@@ -0,0 +1,351 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#ifndef __EMBREE_ACCEL_FILTER_H__
+#define __EMBREE_ACCEL_FILTER_H__
+
+#include "../common/default.h"
+#include "../common/ray.h"
+#include "../common/ray4.h"
+#if defined(__AVX__)
+#include "../common/ray8.h"
+#endif
+#include "common/scene.h"
+#include "embree2/rtcore_ray.h"
+
+/*! The filter functions are only compiled into the kernels when
+ *  RTCORE_INTERSECTION_FILTER is enabled. The primitive intersectors
+ *  call them with the candidate hit before committing it, a filter
+ *  rejects the hit by setting geomID to RTC_INVALID_GEOMETRY_ID. */
+
+#if defined(__INTERSECTION_FILTER__)
+
+namespace embree
+{
+  /*! Returns the geometry that belongs to some geomID. The geom
+   *  pointer passed to the primitive intersectors is the scene. */
+  __forceinline const Geometry* getGeometry(const void* geom, const int geomID) {
+    return ((const Scene*)geom)->get(geomID);
+  }
+
+  /*! Invokes the intersection filter of a single ray. Returns true
+   *  when the hit got accepted, otherwise the previous hit is
+   *  restored. */
+  __forceinline bool runIntersectionFilter1(const Geometry* const geometry, Ray& ray,
+                                            const float u, const float v, const float t, const Vec3fa& Ng,
+                                            const int geomID, const int primID)
+  {
+    /* temporarily update hit information */
+    const float  ray_u = ray.u;           ray.u = u;
+    const float  ray_v = ray.v;           ray.v = v;
+    const float  ray_tfar = ray.tfar;     ray.tfar = t;
+    const Vec3fa ray_Ng = ray.Ng;         ray.Ng = Ng;
+    const int    ray_geomID = ray.geomID; ray.geomID = geomID;
+    const int    ray_primID = ray.primID; ray.primID = primID;
+
+    /* invoke filter function */
+    geometry->intersectionFilter1(geometry->userPtr,(RTCRay&)ray);
+
+    /* restore hit if filter not passed */
+    if (unlikely(ray.geomID == -1)) {
+      ray.u = ray_u; ray.v = ray_v; ray.tfar = ray_tfar; ray.Ng = ray_Ng;
+      ray.geomID = ray_geomID; ray.primID = ray_primID;
+      return false;
+    }
+    return true;
+  }
+
+  /*! Invokes the occlusion filter of a single ray. Returns true when
+   *  the hit got accepted. */
+  __forceinline bool runOcclusionFilter1(const Geometry* const geometry, Ray& ray,
+                                         const float u, const float v, const float t, const Vec3fa& Ng,
+                                         const int geomID, const int primID)
+  {
+    /* temporarily update hit information */
+    const float ray_tfar = ray.tfar;
+    const int   ray_geomID = ray.geomID;
+    ray.u = u; ray.v = v; ray.tfar = t; ray.Ng = Ng;
+    ray.geomID = geomID; ray.primID = primID;
+
+    /* invoke filter function */
+    geometry->occlusionFilter1(geometry->userPtr,(RTCRay&)ray);
+
+    /* restore hit if filter not passed */
+    const bool hit = ray.geomID != -1;
+    if (unlikely(!hit)) {
+      ray.tfar = ray_tfar;
+      ray.geomID = ray_geomID;
+    }
+    return hit;
+  }
+
+  /*! Invokes the intersection filter of a ray packet of size 4 for
+   *  all valid rays. Returns the mask of accepted hits. */
+  __forceinline sseb runIntersectionFilter4(const sseb& valid, const Geometry* const geometry, Ray4& ray,
+                                            const ssef& u, const ssef& v, const ssef& t, const sse3f& Ng,
+                                            const int geomID, const int primID)
+  {
+    /* temporarily update hit information */
+    const ssef  ray_u = ray.u;           ray.u = select(valid,u,ray_u);
+    const ssef  ray_v = ray.v;           ray.v = select(valid,v,ray_v);
+    const ssef  ray_tfar = ray.tfar;     ray.tfar = select(valid,t,ray_tfar);
+    const sse3f ray_Ng = ray.Ng;
+    ray.Ng.x = select(valid,Ng.x,ray_Ng.x);
+    ray.Ng.y = select(valid,Ng.y,ray_Ng.y);
+    ray.Ng.z = select(valid,Ng.z,ray_Ng.z);
+    const ssei  ray_geomID = ray.geomID; ray.geomID = select(valid,ssei(geomID),ray_geomID);
+    const ssei  ray_primID = ray.primID; ray.primID = select(valid,ssei(primID),ray_primID);
+
+    /* invoke filter function */
+    const ssei valid_i = select(valid,ssei(-1),ssei(0));
+    geometry->intersectionFilter4(&valid_i,geometry->userPtr,(RTCRay4&)ray);
+    const sseb valid_failed = valid & (ray.geomID == ssei(-1));
+    const sseb valid_passed = valid & !valid_failed;
+
+    /* restore hit if filter not passed */
+    if (unlikely(any(valid_failed)))
+    {
+      ray.u    = select(valid_failed,ray_u,ray.u);
+      ray.v    = select(valid_failed,ray_v,ray.v);
+      ray.tfar = select(valid_failed,ray_tfar,ray.tfar);
+      ray.Ng.x = select(valid_failed,ray_Ng.x,ray.Ng.x);
+      ray.Ng.y = select(valid_failed,ray_Ng.y,ray.Ng.y);
+      ray.Ng.z = select(valid_failed,ray_Ng.z,ray.Ng.z);
+      ray.geomID = select(valid_failed,ray_geomID,ray.geomID);
+      ray.primID = select(valid_failed,ray_primID,ray.primID);
+    }
+    return valid_passed;
+  }
+
+  /*! Invokes the intersection filter for ray k of a ray packet of
+   *  size 4. Returns true when the hit got accepted. */
+  __forceinline bool runIntersectionFilter4(const Geometry* const geometry, Ray4& ray, const size_t k,
+                                            const float u, const float v, const float t, const Vec3fa& Ng,
+                                            const int geomID, const int primID)
+  {
+    /* temporarily update hit information */
+    const float ray_u = ray.u[k];           ray.u[k] = u;
+    const float ray_v = ray.v[k];           ray.v[k] = v;
+    const float ray_tfar = ray.tfar[k];     ray.tfar[k] = t;
+    const float ray_Ng_x = ray.Ng.x[k];     ray.Ng.x[k] = Ng.x;
+    const float ray_Ng_y = ray.Ng.y[k];     ray.Ng.y[k] = Ng.y;
+    const float ray_Ng_z = ray.Ng.z[k];     ray.Ng.z[k] = Ng.z;
+    const int   ray_geomID = ray.geomID[k]; ray.geomID[k] = geomID;
+    const int   ray_primID = ray.primID[k]; ray.primID[k] = primID;
+
+    /* invoke filter function */
+    const ssei valid_i = select(sseb(1 << k),ssei(-1),ssei(0));
+    geometry->intersectionFilter4(&valid_i,geometry->userPtr,(RTCRay4&)ray);
+
+    /* restore hit if filter not passed */
+    if (unlikely(ray.geomID[k] == -1))
+    {
+      ray.u[k] = ray_u; ray.v[k] = ray_v; ray.tfar[k] = ray_tfar;
+      ray.Ng.x[k] = ray_Ng_x; ray.Ng.y[k] = ray_Ng_y; ray.Ng.z[k] = ray_Ng_z;
+      ray.geomID[k] = ray_geomID; ray.primID[k] = ray_primID;
+      return false;
+    }
+    return true;
+  }
+
+  /*! Invokes the occlusion filter of a ray packet of size 4 for all
+   *  valid rays. Returns the mask of accepted hits. */
+  __forceinline sseb runOcclusionFilter4(const sseb& valid, const Geometry* const geometry, Ray4& ray,
+                                         const ssef& u, const ssef& v, const ssef& t, const sse3f& Ng,
+                                         const int geomID, const int primID)
+  {
+    /* temporarily update hit information */
+    const ssef ray_tfar = ray.tfar;
+    const ssei ray_geomID = ray.geomID;
+    ray.u = select(valid,u,ray.u);
+    ray.v = select(valid,v,ray.v);
+    ray.tfar = select(valid,t,ray_tfar);
+    ray.Ng.x = select(valid,Ng.x,ray.Ng.x);
+    ray.Ng.y = select(valid,Ng.y,ray.Ng.y);
+    ray.Ng.z = select(valid,Ng.z,ray.Ng.z);
+    ray.geomID = select(valid,ssei(geomID),ray_geomID);
+    ray.primID = select(valid,ssei(primID),ray.primID);
+
+    /* invoke filter function */
+    const ssei valid_i = select(valid,ssei(-1),ssei(0));
+    geometry->occlusionFilter4(&valid_i,geometry->userPtr,(RTCRay4&)ray);
+    const sseb valid_failed = valid & (ray.geomID == ssei(-1));
+    const sseb valid_passed = valid & !valid_failed;
+
+    /* restore hit if filter not passed */
+    ray.tfar = select(valid_failed,ray_tfar,ray.tfar);
+    ray.geomID = select(valid_failed,ray_geomID,ray.geomID);
+    return valid_passed;
+  }
+
+  /*! Invokes the occlusion filter for ray k of a ray packet of size
+   *  4. Returns true when the hit got accepted. */
+  __forceinline bool runOcclusionFilter4(const Geometry* const geometry, Ray4& ray, const size_t k,
+                                         const float u, const float v, const float t, const Vec3fa& Ng,
+                                         const int geomID, const int primID)
+  {
+    /* temporarily update hit information */
+    const float ray_tfar = ray.tfar[k];
+    const int   ray_geomID = ray.geomID[k];
+    ray.u[k] = u; ray.v[k] = v; ray.tfar[k] = t;
+    ray.Ng.x[k] = Ng.x; ray.Ng.y[k] = Ng.y; ray.Ng.z[k] = Ng.z;
+    ray.geomID[k] = geomID; ray.primID[k] = primID;
+
+    /* invoke filter function */
+    const ssei valid_i = select(sseb(1 << k),ssei(-1),ssei(0));
+    geometry->occlusionFilter4(&valid_i,geometry->userPtr,(RTCRay4&)ray);
+
+    /* restore hit if filter not passed */
+    const bool hit = ray.geomID[k] != -1;
+    if (unlikely(!hit)) {
+      ray.tfar[k] = ray_tfar;
+      ray.geomID[k] = ray_geomID;
+    }
+    return hit;
+  }
+
+#if defined(__AVX__)
+
+  /*! Invokes the intersection filter of a ray packet of size 8 for
+   *  all valid rays. Returns the mask of accepted hits. */
+  __forceinline avxb runIntersectionFilter8(const avxb& valid, const Geometry* const geometry, Ray8& ray,
+                                            const avxf& u, const avxf& v, const avxf& t, const avx3f& Ng,
+                                            const int geomID, const int primID)
+  {
+    /* temporarily update hit information */
+    const avxf  ray_u = ray.u;           ray.u = select(valid,u,ray_u);
+    const avxf  ray_v = ray.v;           ray.v = select(valid,v,ray_v);
+    const avxf  ray_tfar = ray.tfar;     ray.tfar = select(valid,t,ray_tfar);
+    const avx3f ray_Ng = ray.Ng;
+    ray.Ng.x = select(valid,Ng.x,ray_Ng.x);
+    ray.Ng.y = select(valid,Ng.y,ray_Ng.y);
+    ray.Ng.z = select(valid,Ng.z,ray_Ng.z);
+    const avxi  ray_geomID = ray.geomID; ray.geomID = select(valid,avxi(geomID),ray_geomID);
+    const avxi  ray_primID = ray.primID; ray.primID = select(valid,avxi(primID),ray_primID);
+
+    /* invoke filter function */
+    const avxi valid_i = select(valid,avxi(-1),avxi(0));
+    geometry->intersectionFilter8(&valid_i,geometry->userPtr,(RTCRay8&)ray);
+    const avxb valid_failed = valid & (ray.geomID == avxi(-1));
+    const avxb valid_passed = valid & !valid_failed;
+
+    /* restore hit if filter not passed */
+    if (unlikely(any(valid_failed)))
+    {
+      ray.u    = select(valid_failed,ray_u,ray.u);
+      ray.v    = select(valid_failed,ray_v,ray.v);
+      ray.tfar = select(valid_failed,ray_tfar,ray.tfar);
+      ray.Ng.x = select(valid_failed,ray_Ng.x,ray.Ng.x);
+      ray.Ng.y = select(valid_failed,ray_Ng.y,ray.Ng.y);
+      ray.Ng.z = select(valid_failed,ray_Ng.z,ray.Ng.z);
+      ray.geomID = select(valid_failed,ray_geomID,ray.geomID);
+      ray.primID = select(valid_failed,ray_primID,ray.primID);
+    }
+    return valid_passed;
+  }
+
+  /*! Invokes the intersection filter for ray k of a ray packet of
+   *  size 8. Returns true when the hit got accepted. */
+  __forceinline bool runIntersectionFilter8(const Geometry* const geometry, Ray8& ray, const size_t k,
+                                            const float u, const float v, const float t, const Vec3fa& Ng,
+                                            const int geomID, const int primID)
+  {
+    /* temporarily update hit information */
+    const float ray_u = ray.u[k];           ray.u[k] = u;
+    const float ray_v = ray.v[k];           ray.v[k] = v;
+    const float ray_tfar = ray.tfar[k];     ray.tfar[k] = t;
+    const float ray_Ng_x = ray.Ng.x[k];     ray.Ng.x[k] = Ng.x;
+    const float ray_Ng_y = ray.Ng.y[k];     ray.Ng.y[k] = Ng.y;
+    const float ray_Ng_z = ray.Ng.z[k];     ray.Ng.z[k] = Ng.z;
+    const int   ray_geomID = ray.geomID[k]; ray.geomID[k] = geomID;
+    const int   ray_primID = ray.primID[k]; ray.primID[k] = primID;
+
+    /* invoke filter function */
+    const avxi valid_i = select(avxi(step) == avxi(int(k)),avxi(-1),avxi(0));
+    geometry->intersectionFilter8(&valid_i,geometry->userPtr,(RTCRay8&)ray);
+
+    /* restore hit if filter not passed */
+    if (unlikely(ray.geomID[k] == -1))
+    {
+      ray.u[k] = ray_u; ray.v[k] = ray_v; ray.tfar[k] = ray_tfar;
+      ray.Ng.x[k] = ray_Ng_x; ray.Ng.y[k] = ray_Ng_y; ray.Ng.z[k] = ray_Ng_z;
+      ray.geomID[k] = ray_geomID; ray.primID[k] = ray_primID;
+      return false;
+    }
+    return true;
+  }
+
+  /*! Invokes the occlusion filter of a ray packet of size 8 for all
+   *  valid rays. Returns the mask of accepted hits. */
+  __forceinline avxb runOcclusionFilter8(const avxb& valid, const Geometry* const geometry, Ray8& ray,
+                                         const avxf& u, const avxf& v, const avxf& t, const avx3f& Ng,
+                                         const int geomID, const int primID)
+  {
+    /* temporarily update hit information */
+    const avxf ray_tfar = ray.tfar;
+    const avxi ray_geomID = ray.geomID;
+    ray.u = select(valid,u,ray.u);
+    ray.v = select(valid,v,ray.v);
+    ray.tfar = select(valid,t,ray_tfar);
+    ray.Ng.x = select(valid,Ng.x,ray.Ng.x);
+    ray.Ng.y = select(valid,Ng.y,ray.Ng.y);
+    ray.Ng.z = select(valid,Ng.z,ray.Ng.z);
+    ray.geomID = select(valid,avxi(geomID),ray_geomID);
+    ray.primID = select(valid,avxi(primID),ray.primID);
+
+    /* invoke filter function */
+    const avxi valid_i = select(valid,avxi(-1),avxi(0));
+    geometry->occlusionFilter8(&valid_i,geometry->userPtr,(RTCRay8&)ray);
+    const avxb valid_failed = valid & (ray.geomID == avxi(-1));
+    const avxb valid_passed = valid & !valid_failed;
+
+    /* restore hit if filter not passed */
+    ray.tfar = select(valid_failed,ray_tfar,ray.tfar);
+    ray.geomID = select(valid_failed,ray_geomID,ray.geomID);
+    return valid_passed;
+  }
+
+  /*! Invokes the occlusion filter for ray k of a ray packet of size
+   *  8. Returns true when the hit got accepted. */
+  __forceinline bool runOcclusionFilter8(const Geometry* const geometry, Ray8& ray, const size_t k,
+                                         const float u, const float v, const float t, const Vec3fa& Ng,
+                                         const int geomID, const int primID)
+  {
+    /* temporarily update hit information */
+    const float ray_tfar = ray.tfar[k];
+    const int   ray_geomID = ray.geomID[k];
+    ray.u[k] = u; ray.v[k] = v; ray.tfar[k] = t;
+    ray.Ng.x[k] = Ng.x; ray.Ng.y[k] = Ng.y; ray.Ng.z[k] = Ng.z;
+    ray.geomID[k] = geomID; ray.primID[k] = primID;
+
+    /* invoke filter function */
+    const avxi valid_i = select(avxi(step) == avxi(int(k)),avxi(-1),avxi(0));
+    geometry->occlusionFilter8(&valid_i,geometry->userPtr,(RTCRay8&)ray);
+
+    /* restore hit if filter not passed */
+    const bool hit = ray.geomID[k] != -1;
+    if (unlikely(!hit)) {
+      ray.tfar[k] = ray_tfar;
+      ray.geomID[k] = ray_geomID;
+    }
+    return hit;
+  }
+
+#endif
+}
+
+#endif
+#endif
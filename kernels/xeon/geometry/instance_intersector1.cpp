@@ -22,47 +22,66 @@ namespace embree
   {
     void InstanceBoundsFunction(const UserGeometryScene::Instance* instance, size_t item, BBox3f& bounds_o)
     {
+      /* the keys get interpolated linearly, thus the bounds of all keys enclose the motion */
       Vec3fa lower = instance->object->bounds.lower;
       Vec3fa upper = instance->object->bounds.upper;
-      AffineSpace3f local2world = instance->local2world;
-      Vec3fa p000 = xfmPoint(local2world,Vec3fa(lower.x,lower.y,lower.z));
-      Vec3fa p001 = xfmPoint(local2world,Vec3fa(lower.x,lower.y,upper.z));
-      Vec3fa p010 = xfmPoint(local2world,Vec3fa(lower.x,upper.y,lower.z));
-      Vec3fa p011 = xfmPoint(local2world,Vec3fa(lower.x,upper.y,upper.z));
-      Vec3fa p100 = xfmPoint(local2world,Vec3fa(upper.x,lower.y,lower.z));
-      Vec3fa p101 = xfmPoint(local2world,Vec3fa(upper.x,lower.y,upper.z));
-      Vec3fa p110 = xfmPoint(local2world,Vec3fa(upper.x,upper.y,lower.z));
-      Vec3fa p111 = xfmPoint(local2world,Vec3fa(upper.x,upper.y,upper.z));
-      bounds_o.lower = min(min(min(p000,p001),min(p010,p011)),min(min(p100,p101),min(p110,p111)));
-      bounds_o.upper = max(max(max(p000,p001),max(p010,p011)),max(max(p100,p101),max(p110,p111)));
+      bounds_o = empty;
+      for (size_t i=0; i<instance->numTimeSteps; i++)
+      {
+        const AffineSpace3f& local2world = instance->local2world[i];
+        Vec3fa p000 = xfmPoint(local2world,Vec3fa(lower.x,lower.y,lower.z));
+        Vec3fa p001 = xfmPoint(local2world,Vec3fa(lower.x,lower.y,upper.z));
+        Vec3fa p010 = xfmPoint(local2world,Vec3fa(lower.x,upper.y,lower.z));
+        Vec3fa p011 = xfmPoint(local2world,Vec3fa(lower.x,upper.y,upper.z));
+        Vec3fa p100 = xfmPoint(local2world,Vec3fa(upper.x,lower.y,lower.z));
+        Vec3fa p101 = xfmPoint(local2world,Vec3fa(upper.x,lower.y,upper.z));
+        Vec3fa p110 = xfmPoint(local2world,Vec3fa(upper.x,upper.y,lower.z));
+        Vec3fa p111 = xfmPoint(local2world,Vec3fa(upper.x,upper.y,upper.z));
+        bounds_o.lower = min(bounds_o.lower,min(min(min(p000,p001),min(p010,p011)),min(min(p100,p101),min(p110,p111))));
+        bounds_o.upper = max(bounds_o.upper,max(max(max(p000,p001),max(p010,p011)),max(max(p100,p101),max(p110,p111))));
+      }
     }
 
     RTCBoundsFunc InstanceBoundsFunc = (RTCBoundsFunc) InstanceBoundsFunction;
 
     void FastInstanceIntersector1::intersect(const UserGeometryScene::Instance* instance, Ray& ray, size_t item)
     {
-      const Vec3fa ray_org = ray.org;
-      const Vec3fa ray_dir = ray.dir;
-      const int ray_geomID = ray.geomID;
-      ray.org = xfmPoint (instance->world2local,ray_org);
-      ray.dir = xfmVector(instance->world2local,ray_dir);
-      ray.geomID = -1;
-      instance->object->intersect((RTCRay&)ray);
-      ray.org = ray_org;
-      ray.dir = ray_dir;
-      if (ray.geomID == -1) ray.geomID = ray_geomID;
-      else ray.instID = instance->id;
+#if defined(__USE_RAY_MASK__)
+      /* skip the instanced scene if the ray cannot hit any of its geometries */
+      if ((instance->mask & ray.mask) == 0 || (instance->objectMask & ray.mask) == 0) return;
+#endif
+      /* trace a transformed copy of the ray, the ray of the caller only receives the hit */
+      const AffineSpace3f world2local = instance->getWorld2Local(ray.time);
+      Ray lray(xfmPoint (world2local,ray.org),
+               xfmVector(world2local,ray.dir),
+               ray.tnear,ray.tfar,ray.time,ray.mask);
+      instance->object->intersect((RTCRay&)lray);
+      if (lray.geomID == -1) return;
+      ray.tfar = lray.tfar;
+      ray.u = lray.u;
+      ray.v = lray.v;
+      ray.Ng = lray.Ng;
+      ray.geomID = lray.geomID;
+      ray.primID = lray.primID;
+      ray.instID = instance->id;
+
+      /* this instance becomes the outermost level of the instance stack */
+      ray.instStack[0] = instance->id;
+      for (size_t i=1; i<RTC_MAX_INSTANCE_DEPTH; i++) ray.instStack[i] = lray.instStack[i-1];
     }
     
     void FastInstanceIntersector1::occluded (const UserGeometryScene::Instance* instance, Ray& ray, size_t item)
     {
-      const Vec3fa ray_org = ray.org;
-      const Vec3fa ray_dir = ray.dir;
-      ray.org = xfmPoint (instance->world2local,ray_org);
-      ray.dir = xfmVector(instance->world2local,ray_dir);
-      instance->object->occluded((RTCRay&)ray);
-      ray.org = ray_org;
-      ray.dir = ray_dir;
+#if defined(__USE_RAY_MASK__)
+      /* skip the instanced scene if the ray cannot hit any of its geometries */
+      if ((instance->mask & ray.mask) == 0 || (instance->objectMask & ray.mask) == 0) return;
+#endif
+      const AffineSpace3f world2local = instance->getWorld2Local(ray.time);
+      Ray lray(xfmPoint (world2local,ray.org),
+               xfmVector(world2local,ray.dir),
+               ray.tnear,ray.tfar,ray.time,ray.mask);
+      instance->object->occluded((RTCRay&)lray);
+      if (lray.geomID == 0) ray.geomID = 0;
     }
     
     DEFINE_SET_INTERSECTOR1(InstanceIntersector1,FastInstanceIntersector1);
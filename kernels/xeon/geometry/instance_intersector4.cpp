@@ -22,34 +22,54 @@ namespace embree
   {
     typedef AffineSpaceT<LinearSpace3<sse3f> > AffineSpace3fSSE;
     
-    void FastInstanceIntersector4::intersect(sseb* valid, const UserGeometryScene::Instance* instance, Ray4& ray, size_t item)
+    void FastInstanceIntersector4::intersect(sseb* valid_i, const UserGeometryScene::Instance* instance, Ray4& ray, size_t item)
     {
-      const sse3f ray_org = ray.org;
-      const sse3f ray_dir = ray.dir;
-      const ssei ray_geomID = ray.geomID;
-      const AffineSpace3fSSE world2local(instance->world2local);
-      ray.org = xfmPoint (world2local,ray_org);
-      ray.dir = xfmVector(world2local,ray_dir);
-      ray.geomID = -1;
-      instance->object->intersect4(valid,(RTCRay4&)ray);
-      ray.org = ray_org;
-      ray.dir = ray_dir;
-      sseb nohit = ray.geomID == ssei(-1);
-      ray.geomID = select(nohit,ray_geomID,ray.geomID);
-      ray.instID = select(nohit,ray.instID,ssei(instance->id));
+      sseb valid = *valid_i;
+#if defined(__USE_RAY_MASK__)
+      /* skip the instanced scene for rays that cannot hit any of its geometries */
+      valid &= (int(instance->mask) & ray.mask) != 0;
+      valid &= (int(instance->objectMask) & ray.mask) != 0;
+      if (none(valid)) return;
+#endif
+      /* trace a transformed copy of the packet, the packet of the caller only receives the hits */
+      const AffineSpace3fSSE world2local = instance->getWorld2Local<AffineSpace3fSSE>(ray.time);
+      Ray4 lray(xfmPoint (world2local,ray.org),
+                xfmVector(world2local,ray.dir),
+                ray.tnear,ray.tfar,ray.time,ray.mask);
+      instance->object->intersect4(&valid,(RTCRay4&)lray);
+      const sseb hit = lray.geomID != ssei(-1);
+      if (none(hit)) return;
+      ray.tfar   = select(hit,lray.tfar,ray.tfar);
+      ray.u      = select(hit,lray.u,ray.u);
+      ray.v      = select(hit,lray.v,ray.v);
+      ray.Ng.x   = select(hit,lray.Ng.x,ray.Ng.x);
+      ray.Ng.y   = select(hit,lray.Ng.y,ray.Ng.y);
+      ray.Ng.z   = select(hit,lray.Ng.z,ray.Ng.z);
+      ray.geomID = select(hit,lray.geomID,ray.geomID);
+      ray.primID = select(hit,lray.primID,ray.primID);
+      ray.instID = select(hit,ssei(instance->id),ray.instID);
+
+      /* this instance becomes the outermost level of the instance stack */
+      ray.instStack[0] = select(hit,ssei(instance->id),ray.instStack[0]);
+      for (size_t i=1; i<RTC_MAX_INSTANCE_DEPTH; i++)
+        ray.instStack[i] = select(hit,lray.instStack[i-1],ray.instStack[i]);
     }
     
-    void FastInstanceIntersector4::occluded (sseb* valid, const UserGeometryScene::Instance* instance, Ray4& ray, size_t item)
+    void FastInstanceIntersector4::occluded (sseb* valid_i, const UserGeometryScene::Instance* instance, Ray4& ray, size_t item)
     {
-      const sse3f ray_org = ray.org;
-      const sse3f ray_dir = ray.dir;
-      const ssei ray_geomID = ray.geomID;
-      const AffineSpace3fSSE world2local(instance->world2local);
-      ray.org = xfmPoint (world2local,ray_org);
-      ray.dir = xfmVector(world2local,ray_dir);
-      instance->object->occluded4(valid,(RTCRay4&)ray);
-      ray.org = ray_org;
-      ray.dir = ray_dir;
+      sseb valid = *valid_i;
+#if defined(__USE_RAY_MASK__)
+      /* skip the instanced scene for rays that cannot hit any of its geometries */
+      valid &= (int(instance->mask) & ray.mask) != 0;
+      valid &= (int(instance->objectMask) & ray.mask) != 0;
+      if (none(valid)) return;
+#endif
+      const AffineSpace3fSSE world2local = instance->getWorld2Local<AffineSpace3fSSE>(ray.time);
+      Ray4 lray(xfmPoint (world2local,ray.org),
+                xfmVector(world2local,ray.dir),
+                ray.tnear,ray.tfar,ray.time,ray.mask);
+      instance->object->occluded4(&valid,(RTCRay4&)lray);
+      ray.geomID = select(lray.geomID == ssei(0),ssei(0),ray.geomID);
     }
 
     DEFINE_SET_INTERSECTOR4(InstanceIntersector4,FastInstanceIntersector4);
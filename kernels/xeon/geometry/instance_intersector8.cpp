@@ -22,34 +22,54 @@ namespace embree
   {
     typedef AffineSpaceT<LinearSpace3<avx3f> > AffineSpace3fAVX;
     
-    void FastInstanceIntersector8::intersect(avxb* valid, const UserGeometryScene::Instance* instance, Ray8& ray, size_t item)
+    void FastInstanceIntersector8::intersect(avxb* valid_i, const UserGeometryScene::Instance* instance, Ray8& ray, size_t item)
     {
-      const avx3f ray_org = ray.org;
-      const avx3f ray_dir = ray.dir;
-      const avxi ray_geomID = ray.geomID;
-      const AffineSpace3fAVX world2local(instance->world2local);
-      ray.org = xfmPoint (world2local,ray_org);
-      ray.dir = xfmVector(world2local,ray_dir);
-      ray.geomID = -1;
-      instance->object->intersect8(valid,(RTCRay8&)ray);
-      ray.org = ray_org;
-      ray.dir = ray_dir;
-      avxb nohit = ray.geomID == avxi(-1);
-      ray.geomID = select(nohit,ray_geomID,ray.geomID);
-      ray.instID = select(nohit,ray.instID,instance->id);
+      avxb valid = *valid_i;
+#if defined(__USE_RAY_MASK__)
+      /* skip the instanced scene for rays that cannot hit any of its geometries */
+      valid &= (int(instance->mask) & ray.mask) != 0;
+      valid &= (int(instance->objectMask) & ray.mask) != 0;
+      if (none(valid)) return;
+#endif
+      /* trace a transformed copy of the packet, the packet of the caller only receives the hits */
+      const AffineSpace3fAVX world2local = instance->getWorld2Local<AffineSpace3fAVX>(ray.time);
+      Ray8 lray(xfmPoint (world2local,ray.org),
+                xfmVector(world2local,ray.dir),
+                ray.tnear,ray.tfar,ray.time,ray.mask);
+      instance->object->intersect8(&valid,(RTCRay8&)lray);
+      const avxb hit = lray.geomID != avxi(-1);
+      if (none(hit)) return;
+      ray.tfar   = select(hit,lray.tfar,ray.tfar);
+      ray.u      = select(hit,lray.u,ray.u);
+      ray.v      = select(hit,lray.v,ray.v);
+      ray.Ng.x   = select(hit,lray.Ng.x,ray.Ng.x);
+      ray.Ng.y   = select(hit,lray.Ng.y,ray.Ng.y);
+      ray.Ng.z   = select(hit,lray.Ng.z,ray.Ng.z);
+      ray.geomID = select(hit,lray.geomID,ray.geomID);
+      ray.primID = select(hit,lray.primID,ray.primID);
+      ray.instID = select(hit,avxi(instance->id),ray.instID);
+
+      /* this instance becomes the outermost level of the instance stack */
+      ray.instStack[0] = select(hit,avxi(instance->id),ray.instStack[0]);
+      for (size_t i=1; i<RTC_MAX_INSTANCE_DEPTH; i++)
+        ray.instStack[i] = select(hit,lray.instStack[i-1],ray.instStack[i]);
     }
     
-    void FastInstanceIntersector8::occluded (avxb* valid, const UserGeometryScene::Instance* instance, Ray8& ray, size_t item)
+    void FastInstanceIntersector8::occluded (avxb* valid_i, const UserGeometryScene::Instance* instance, Ray8& ray, size_t item)
     {
-      const avx3f ray_org = ray.org;
-      const avx3f ray_dir = ray.dir;
-      const avxi ray_geomID = ray.geomID;
-      const AffineSpace3fAVX world2local(instance->world2local);
-      ray.org = xfmPoint (world2local,ray_org);
-      ray.dir = xfmVector(world2local,ray_dir);
-      instance->object->occluded8(valid,(RTCRay8&)ray);
-      ray.org = ray_org;
-      ray.dir = ray_dir;
+      avxb valid = *valid_i;
+#if defined(__USE_RAY_MASK__)
+      /* skip the instanced scene for rays that cannot hit any of its geometries */
+      valid &= (int(instance->mask) & ray.mask) != 0;
+      valid &= (int(instance->objectMask) & ray.mask) != 0;
+      if (none(valid)) return;
+#endif
+      const AffineSpace3fAVX world2local = instance->getWorld2Local<AffineSpace3fAVX>(ray.time);
+      Ray8 lray(xfmPoint (world2local,ray.org),
+                xfmVector(world2local,ray.dir),
+                ray.tnear,ray.tfar,ray.time,ray.mask);
+      instance->object->occluded8(&valid,(RTCRay8&)lray);
+      ray.geomID = select(lray.geomID == avxi(0),avxi(0),ray.geomID);
     }
 
     DEFINE_SET_INTERSECTOR8(InstanceIntersector8,FastInstanceIntersector8);
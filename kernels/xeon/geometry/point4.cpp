@@ -0,0 +1,66 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "point4.h"
+#if defined(__TARGET_AVX__)
+#include "point8.h"
+#endif
+#include "common/scene.h"
+
+namespace embree
+{
+  ScenePoint4 ScenePoint4::type;
+
+  Point4Type::Point4Type ()
+  : PrimitiveType("point4",sizeof(Point4),4,false,1) {}
+
+#if defined(__TARGET_AVX__)
+  ScenePoint8 ScenePoint8::type;
+
+  Point8Type::Point8Type ()
+  : PrimitiveType("point8",2*sizeof(Point4),8,false,1) {}
+#endif
+
+  size_t Point4Type::blocks(size_t x) const {
+    return (x+3)/4;
+  }
+
+  size_t Point4Type::size(const char* This) const {
+    return ((Point4*)This)->size();
+  }
+
+  void ScenePoint4::pack(char* This, atomic_set<PrimRefBlock>::block_iterator_unsafe& prims, void* geom) const
+  {
+    Scene* scene = (Scene*) geom;
+
+    ssei geomID = -1, primID = -1, mask = -1;
+    sse3f p = zero; ssef r = zero;
+
+    for (size_t i=0; i<4 && prims; i++, prims++)
+    {
+      const PrimRef& prim = *prims;
+      const PointsScene::Points* points = scene->getPoints(prim.geomID());
+      const Vec3fa& c = points->vertex(prim.primID());
+      const float radius = points->radius(prim.primID());
+      geomID [i] = prim.geomID();
+      primID [i] = prim.primID();
+      mask   [i] = points->mask;
+      p.x[i] = c.x; p.y[i] = c.y; p.z[i] = c.z;
+      r[i] = points->isDisc() ? -radius : radius;
+    }
+    new (This) Point4(p,r,geomID,primID,mask);
+  }
+}
@@ -0,0 +1,97 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#ifndef __EMBREE_ACCEL_POINT4_H__
+#define __EMBREE_ACCEL_POINT4_H__
+
+#include "primitive.h"
+
+namespace embree
+{
+  /*! Stores 4 spheres or ray facing discs. The radius of discs is
+   *  stored negated, such that the point type does not need any
+   *  additional storage. */
+  struct Point4
+  {
+  public:
+
+    /*! Default constructor. */
+    __forceinline Point4 () {}
+
+    /*! Construction from centers, signed radii, and IDs. */
+    __forceinline Point4 (const sse3f& p, const ssef& r, const ssei& geomID, const ssei& primID, const ssei& mask)
+      : p(p), r(r), geomID(geomID), primID(primID)
+    {
+#if defined(__USE_RAY_MASK__)
+      this->mask = mask;
+#endif
+    }
+
+    /*! Returns a mask that tells which points are valid. */
+    __forceinline sseb valid() const { return geomID != ssei(-1); }
+
+    /*! Returns a mask that tells which points are discs. */
+    __forceinline sseb disc() const { return r < ssef(zero); }
+
+    /*! Returns the radii of the points. */
+    __forceinline ssef radius() const { return abs(r); }
+
+    /*! Returns the number of stored points. */
+    __forceinline size_t size() const {
+      return bitscan(~movemask(valid()));
+    }
+
+    /*! calculate the bounds of the points */
+    __forceinline BBox3f bounds() const
+    {
+      const ssef rad = radius();
+      sse3f lower = p-sse3f(rad);
+      sse3f upper = p+sse3f(rad);
+      sseb mask = valid();
+      lower.x = select(mask,lower.x,ssef(pos_inf));
+      lower.y = select(mask,lower.y,ssef(pos_inf));
+      lower.z = select(mask,lower.z,ssef(pos_inf));
+      upper.x = select(mask,upper.x,ssef(neg_inf));
+      upper.y = select(mask,upper.y,ssef(neg_inf));
+      upper.z = select(mask,upper.z,ssef(neg_inf));
+      return BBox3f(Vec3fa(reduce_min(lower.x),reduce_min(lower.y),reduce_min(lower.z)),
+                    Vec3fa(reduce_max(upper.x),reduce_max(upper.y),reduce_max(upper.z)));
+    }
+
+  public:
+    sse3f p;       //!< centers of the points
+    ssef r;        //!< radii of the points, negative for discs
+    ssei geomID;   //!< user geometry ID
+    ssei primID;   //!< primitive ID
+#if defined(__USE_RAY_MASK__)
+    ssei mask;     //!< geometry mask
+#endif
+  };
+
+  struct Point4Type : public PrimitiveType {
+    Point4Type ();
+    size_t blocks(size_t x) const;
+    size_t size(const char* This) const;
+  };
+
+  struct ScenePoint4 : public Point4Type
+  {
+    static ScenePoint4 type;
+    void pack(char* This, atomic_set<PrimRefBlock>::block_iterator_unsafe& prims, void* geom) const;
+  };
+}
+
+#endif
@@ -0,0 +1,126 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#ifndef __EMBREE_ACCEL_POINT4_INTERSECTOR1_H__
+#define __EMBREE_ACCEL_POINT4_INTERSECTOR1_H__
+
+#include "../common/default.h"
+#include "point4.h"
+#include "../common/ray.h"
+
+namespace embree
+{
+  /*! Intersector for a single ray with 4 spheres or ray facing
+   *  discs. Both shapes are hit iff the distance of the ray to the
+   *  center is at most the radius. Spheres report the nearest root
+   *  in front of tnear, discs the point of closest approach to the
+   *  center. */
+  struct Point4Intersector1
+  {
+    typedef Point4 Primitive;
+
+    /*! Intersect a ray with the 4 points and updates the hit. */
+    static __forceinline void intersect(Ray& ray, const Point4& pts, void* geom)
+    {
+      /* test distance of ray to point centers */
+      STAT3(normal.trav_prims,1,1,1);
+      const sse3f O = sse3f(ray.org);
+      const sse3f D = sse3f(ray.dir);
+      const sse3f C = pts.p - O;
+      const ssef rad = pts.radius();
+      const ssef A = dot(D,D);
+      const ssef B = dot(C,D);
+      const ssef Q = B*B - A*(dot(C,C)-rad*rad);
+      sseb valid = pts.valid() & (Q >= ssef(zero));
+      if (likely(none(valid))) return;
+
+      /* perform depth test */
+      const ssef rcpA = rcp(A);
+      const ssef Tc = B*rcpA;
+      const ssef dT = select(pts.disc(),ssef(zero),sqrt(max(Q,ssef(zero)))*rcpA);
+      const ssef T0 = Tc-dT;
+      const ssef T = select(T0 > ssef(ray.tnear),T0,Tc+dT);
+      valid &= (T > ssef(ray.tnear)) & (T < ssef(ray.tfar));
+      if (likely(none(valid))) return;
+
+      /* ray masking test */
+#if defined(__USE_RAY_MASK__)
+      valid &= (pts.mask & ray.mask) != 0;
+      if (unlikely(none(valid))) return;
+#endif
+
+      /* update hit information */
+      const size_t i = select_min(valid,T);
+      const float t = T[i];
+      ray.u = 0.0f;
+      ray.v = 0.0f;
+      ray.tfar = t;
+      if (pts.r[i] < 0.0f) ray.Ng = -ray.dir;
+      else ray.Ng = ray.org + t*ray.dir - Vec3fa(pts.p.x[i],pts.p.y[i],pts.p.z[i]);
+      ray.geomID = pts.geomID[i];
+      ray.primID = pts.primID[i];
+    }
+
+    static __forceinline void intersect(Ray& ray, const Point4* pts, size_t num, void* geom)
+    {
+      for (size_t i=0; i<num; i++)
+        intersect(ray,pts[i],geom);
+    }
+
+    /*! Test if the ray is occluded by one of the points. */
+    static __forceinline bool occluded(Ray& ray, const Point4& pts, void* geom)
+    {
+      /* test distance of ray to point centers */
+      STAT3(shadow.trav_prims,1,1,1);
+      const sse3f O = sse3f(ray.org);
+      const sse3f D = sse3f(ray.dir);
+      const sse3f C = pts.p - O;
+      const ssef rad = pts.radius();
+      const ssef A = dot(D,D);
+      const ssef B = dot(C,D);
+      const ssef Q = B*B - A*(dot(C,C)-rad*rad);
+      sseb valid = pts.valid() & (Q >= ssef(zero));
+      if (likely(none(valid))) return false;
+
+      /* perform depth test */
+      const ssef rcpA = rcp(A);
+      const ssef Tc = B*rcpA;
+      const ssef dT = select(pts.disc(),ssef(zero),sqrt(max(Q,ssef(zero)))*rcpA);
+      const ssef T0 = Tc-dT;
+      const ssef T = select(T0 >= ssef(ray.tnear),T0,Tc+dT);
+      valid &= (T >= ssef(ray.tnear)) & (T <= ssef(ray.tfar));
+      if (likely(none(valid))) return false;
+
+      /* ray masking test */
+#if defined(__USE_RAY_MASK__)
+      valid &= (pts.mask & ray.mask) != 0;
+      if (unlikely(none(valid))) return false;
+#endif
+      return true;
+    }
+
+    static __forceinline bool occluded(Ray& ray, const Point4* pts, size_t num, void* geom)
+    {
+      for (size_t i=0; i<num; i++)
+        if (occluded(ray,pts[i],geom))
+          return true;
+
+      return false;
+    }
+  };
+}
+
+#endif
@@ -0,0 +1,142 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#ifndef __EMBREE_ACCEL_POINT4_INTERSECTOR8_H__
+#define __EMBREE_ACCEL_POINT4_INTERSECTOR8_H__
+
+#include "point4.h"
+#include "../common/ray8.h"
+
+namespace embree
+{
+  /*! Intersector for 4 spheres or ray facing discs with 8 rays. */
+  struct Point4Intersector8
+  {
+    typedef Point4 Primitive;
+
+    /*! Intersects 8 rays with 4 points. */
+    static __forceinline void intersect(const avxb& valid_i, Ray8& ray, const Point4& pts, void* geom)
+    {
+      for (size_t i=0; i<pts.size(); i++)
+      {
+        STAT3(normal.trav_prims,1,popcnt(valid_i),8);
+
+        /* test distance of rays to point center */
+        avxb valid = valid_i;
+        const avx3f p = broadcast8f(pts.p,i);
+        const bool disc = pts.r[i] < 0.0f;
+        const avxf rad = avxf(abs(pts.r[i]));
+        const avx3f C = p - ray.org;
+        const avxf A = dot(ray.dir,ray.dir);
+        const avxf B = dot(C,ray.dir);
+        const avxf Q = B*B - A*(dot(C,C)-rad*rad);
+        valid &= Q >= avxf(zero);
+        if (likely(none(valid))) continue;
+
+        /* perform depth test */
+        const avxf rcpA = rcp(A);
+        const avxf Tc = B*rcpA;
+        avxf T = Tc;
+        if (!disc) {
+          const avxf dT = sqrt(max(Q,avxf(zero)))*rcpA;
+          T = select(Tc-dT > ray.tnear,Tc-dT,Tc+dT);
+        }
+        valid &= (T > ray.tnear) & (T < ray.tfar);
+        if (likely(none(valid))) continue;
+
+        /* ray masking test */
+#if defined(__USE_RAY_MASK__)
+        valid &= (pts.mask[i] & ray.mask) != 0;
+        if (unlikely(none(valid))) continue;
+#endif
+
+        /* update hit information for all rays that hit the point */
+        const avx3f Ng = disc ? -ray.dir : ray.org + T*ray.dir - p;
+        store8f(valid,&ray.u,avxf(zero));
+        store8f(valid,&ray.v,avxf(zero));
+        store8f(valid,&ray.tfar,T);
+        store8i(valid,&ray.geomID,pts.geomID[i]);
+        store8i(valid,&ray.primID,pts.primID[i]);
+        store8f(valid,&ray.Ng.x,Ng.x);
+        store8f(valid,&ray.Ng.y,Ng.y);
+        store8f(valid,&ray.Ng.z,Ng.z);
+      }
+    }
+
+    static __forceinline void intersect(const avxb& valid, Ray8& ray, const Point4* pts, size_t num, void* geom)
+    {
+      for (size_t i=0; i<num; i++)
+        intersect(valid,ray,pts[i],geom);
+    }
+
+    /*! Test for 8 rays if they are occluded by any of the 4 points. */
+    static __forceinline avxb occluded(const avxb& valid_i, Ray8& ray, const Point4& pts, void* geom)
+    {
+      avxb valid0 = valid_i;
+
+      for (size_t i=0; i<pts.size(); i++)
+      {
+        STAT3(shadow.trav_prims,1,popcnt(valid0),8);
+
+        /* test distance of rays to point center */
+        avxb valid = valid0;
+        const avx3f p = broadcast8f(pts.p,i);
+        const bool disc = pts.r[i] < 0.0f;
+        const avxf rad = avxf(abs(pts.r[i]));
+        const avx3f C = p - ray.org;
+        const avxf A = dot(ray.dir,ray.dir);
+        const avxf B = dot(C,ray.dir);
+        const avxf Q = B*B - A*(dot(C,C)-rad*rad);
+        valid &= Q >= avxf(zero);
+        if (likely(none(valid))) continue;
+
+        /* perform depth test */
+        const avxf rcpA = rcp(A);
+        const avxf Tc = B*rcpA;
+        avxf T = Tc;
+        if (!disc) {
+          const avxf dT = sqrt(max(Q,avxf(zero)))*rcpA;
+          T = select(Tc-dT >= ray.tnear,Tc-dT,Tc+dT);
+        }
+        valid &= (T >= ray.tnear) & (T <= ray.tfar);
+        if (likely(none(valid))) continue;
+
+        /* ray masking test */
+#if defined(__USE_RAY_MASK__)
+        valid &= (pts.mask[i] & ray.mask) != 0;
+        if (unlikely(none(valid))) continue;
+#endif
+
+        /* update occlusion */
+        valid0 &= !valid;
+        if (none(valid0)) break;
+      }
+      return !valid0;
+    }
+
+    static __forceinline avxb occluded(const avxb& valid, Ray8& ray, const Point4* pts, size_t num, void* geom)
+    {
+      avxb valid0 = valid;
+      for (size_t i=0; i<num; i++) {
+        valid0 &= !occluded(valid0,ray,pts[i],geom);
+        if (none(valid0)) break;
+      }
+      return !valid0;
+    }
+  };
+}
+
+#endif
@@ -0,0 +1,102 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#ifndef __EMBREE_ACCEL_POINT8_H__
+#define __EMBREE_ACCEL_POINT8_H__
+
+#include "primitive.h"
+
+namespace embree
+{
+#if defined __AVX__
+
+  /*! Stores 8 spheres or ray facing discs. The radius of discs is
+   *  stored negated, such that the point type does not need any
+   *  additional storage. */
+  struct Point8
+  {
+  public:
+
+    /*! Default constructor. */
+    __forceinline Point8 () {}
+
+    /*! Construction from centers, signed radii, and IDs. */
+    __forceinline Point8 (const avx3f& p, const avxf& r, const avxi& geomID, const avxi& primID, const avxi& mask)
+      : p(p), r(r), geomID(geomID), primID(primID)
+    {
+#if defined(__USE_RAY_MASK__)
+      this->mask = mask;
+#endif
+    }
+
+    /*! Returns a mask that tells which points are valid. */
+    __forceinline avxb valid() const { return geomID != avxi(-1); }
+
+    /*! Returns a mask that tells which points are discs. */
+    __forceinline avxb disc() const { return r < avxf(zero); }
+
+    /*! Returns the radii of the points. */
+    __forceinline avxf radius() const { return abs(r); }
+
+    /*! Returns the number of stored points. */
+    __forceinline size_t size() const {
+      return __bsf(~movemask(valid()));
+    }
+
+    /*! calculate the bounds of the points */
+    __forceinline BBox3f bounds() const
+    {
+      const avxf rad = radius();
+      avx3f lower = p-avx3f(rad);
+      avx3f upper = p+avx3f(rad);
+      avxb mask = valid();
+      lower.x = select(mask,lower.x,avxf(pos_inf));
+      lower.y = select(mask,lower.y,avxf(pos_inf));
+      lower.z = select(mask,lower.z,avxf(pos_inf));
+      upper.x = select(mask,upper.x,avxf(neg_inf));
+      upper.y = select(mask,upper.y,avxf(neg_inf));
+      upper.z = select(mask,upper.z,avxf(neg_inf));
+      return BBox3f(Vec3fa(reduce_min(lower.x),reduce_min(lower.y),reduce_min(lower.z)),
+                    Vec3fa(reduce_max(upper.x),reduce_max(upper.y),reduce_max(upper.z)));
+    }
+
+  public:
+    avx3f p;       //!< centers of the points
+    avxf r;        //!< radii of the points, negative for discs
+    avxi geomID;   //!< user geometry ID
+    avxi primID;   //!< primitive ID
+#if defined(__USE_RAY_MASK__)
+    avxi mask;     //!< geometry mask
+#endif
+  };
+#endif
+
+#if defined(__TARGET_AVX__)
+  struct Point8Type : public PrimitiveType {
+    Point8Type ();
+    size_t blocks(size_t x) const;
+    size_t size(const char* This) const;
+  };
+
+  struct ScenePoint8 : public Point8Type
+  {
+    static ScenePoint8 type;
+    void pack(char* This, atomic_set<PrimRefBlock>::block_iterator_unsafe& prims, void* geom) const;
+  };
+#endif
+}
+
+#endif
@@ -0,0 +1,126 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#ifndef __EMBREE_ACCEL_POINT8_INTERSECTOR1_H__
+#define __EMBREE_ACCEL_POINT8_INTERSECTOR1_H__
+
+#include "../common/default.h"
+#include "point8.h"
+#include "../common/ray.h"
+
+namespace embree
+{
+  /*! Intersector for a single ray with 8 spheres or ray facing
+   *  discs. Both shapes are hit iff the distance of the ray to the
+   *  center is at most the radius. Spheres report the nearest root
+   *  in front of tnear, discs the point of closest approach to the
+   *  center. */
+  struct Point8Intersector1
+  {
+    typedef Point8 Primitive;
+
+    /*! Intersect a ray with the 8 points and updates the hit. */
+    static __forceinline void intersect(Ray& ray, const Point8& pts, void* geom)
+    {
+      /* test distance of ray to point centers */
+      STAT3(normal.trav_prims,1,1,1);
+      const avx3f O = avx3f(ray.org);
+      const avx3f D = avx3f(ray.dir);
+      const avx3f C = pts.p - O;
+      const avxf rad = pts.radius();
+      const avxf A = dot(D,D);
+      const avxf B = dot(C,D);
+      const avxf Q = B*B - A*(dot(C,C)-rad*rad);
+      avxb valid = pts.valid() & (Q >= avxf(zero));
+      if (likely(none(valid))) return;
+
+      /* perform depth test */
+      const avxf rcpA = rcp(A);
+      const avxf Tc = B*rcpA;
+      const avxf dT = select(pts.disc(),avxf(zero),sqrt(max(Q,avxf(zero)))*rcpA);
+      const avxf T0 = Tc-dT;
+      const avxf T = select(T0 > avxf(ray.tnear),T0,Tc+dT);
+      valid &= (T > avxf(ray.tnear)) & (T < avxf(ray.tfar));
+      if (likely(none(valid))) return;
+
+      /* ray masking test */
+#if defined(__USE_RAY_MASK__)
+      valid &= (pts.mask & ray.mask) != 0;
+      if (unlikely(none(valid))) return;
+#endif
+
+      /* update hit information */
+      const size_t i = select_min(valid,T);
+      const float t = T[i];
+      ray.u = 0.0f;
+      ray.v = 0.0f;
+      ray.tfar = t;
+      if (pts.r[i] < 0.0f) ray.Ng = -ray.dir;
+      else ray.Ng = ray.org + t*ray.dir - Vec3fa(pts.p.x[i],pts.p.y[i],pts.p.z[i]);
+      ray.geomID = pts.geomID[i];
+      ray.primID = pts.primID[i];
+    }
+
+    static __forceinline void intersect(Ray& ray, const Point8* pts, size_t num, void* geom)
+    {
+      for (size_t i=0; i<num; i++)
+        intersect(ray,pts[i],geom);
+    }
+
+    /*! Test if the ray is occluded by one of the points. */
+    static __forceinline bool occluded(Ray& ray, const Point8& pts, void* geom)
+    {
+      /* test distance of ray to point centers */
+      STAT3(shadow.trav_prims,1,1,1);
+      const avx3f O = avx3f(ray.org);
+      const avx3f D = avx3f(ray.dir);
+      const avx3f C = pts.p - O;
+      const avxf rad = pts.radius();
+      const avxf A = dot(D,D);
+      const avxf B = dot(C,D);
+      const avxf Q = B*B - A*(dot(C,C)-rad*rad);
+      avxb valid = pts.valid() & (Q >= avxf(zero));
+      if (likely(none(valid))) return false;
+
+      /* perform depth test */
+      const avxf rcpA = rcp(A);
+      const avxf Tc = B*rcpA;
+      const avxf dT = select(pts.disc(),avxf(zero),sqrt(max(Q,avxf(zero)))*rcpA);
+      const avxf T0 = Tc-dT;
+      const avxf T = select(T0 >= avxf(ray.tnear),T0,Tc+dT);
+      valid &= (T >= avxf(ray.tnear)) & (T <= avxf(ray.tfar));
+      if (likely(none(valid))) return false;
+
+      /* ray masking test */
+#if defined(__USE_RAY_MASK__)
+      valid &= (pts.mask & ray.mask) != 0;
+      if (unlikely(none(valid))) return false;
+#endif
+      return true;
+    }
+
+    static __forceinline bool occluded(Ray& ray, const Point8* pts, size_t num, void* geom)
+    {
+      for (size_t i=0; i<num; i++)
+        if (occluded(ray,pts[i],geom))
+          return true;
+
+      return false;
+    }
+  };
+}
+
+#endif
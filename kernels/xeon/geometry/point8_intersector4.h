@@ -0,0 +1,142 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#ifndef __EMBREE_ACCEL_POINT8_INTERSECTOR4_H__
+#define __EMBREE_ACCEL_POINT8_INTERSECTOR4_H__
+
+#include "point8.h"
+#include "../common/ray4.h"
+
+namespace embree
+{
+  /*! Intersector for 8 spheres or ray facing discs with 4 rays. */
+  struct Point8Intersector4
+  {
+    typedef Point8 Primitive;
+
+    /*! Intersects 4 rays with 8 points. */
+    static __forceinline void intersect(const sseb& valid_i, Ray4& ray, const Point8& pts, void* geom)
+    {
+      for (size_t i=0; i<pts.size(); i++)
+      {
+        STAT3(normal.trav_prims,1,popcnt(valid_i),4);
+
+        /* test distance of rays to point center */
+        sseb valid = valid_i;
+        const sse3f p = broadcast4f(pts.p,i);
+        const bool disc = pts.r[i] < 0.0f;
+        const ssef rad = ssef(abs(pts.r[i]));
+        const sse3f C = p - ray.org;
+        const ssef A = dot(ray.dir,ray.dir);
+        const ssef B = dot(C,ray.dir);
+        const ssef Q = B*B - A*(dot(C,C)-rad*rad);
+        valid &= Q >= ssef(zero);
+        if (likely(none(valid))) continue;
+
+        /* perform depth test */
+        const ssef rcpA = rcp(A);
+        const ssef Tc = B*rcpA;
+        ssef T = Tc;
+        if (!disc) {
+          const ssef dT = sqrt(max(Q,ssef(zero)))*rcpA;
+          T = select(Tc-dT > ray.tnear,Tc-dT,Tc+dT);
+        }
+        valid &= (T > ray.tnear) & (T < ray.tfar);
+        if (likely(none(valid))) continue;
+
+        /* ray masking test */
+#if defined(__USE_RAY_MASK__)
+        valid &= (pts.mask[i] & ray.mask) != 0;
+        if (unlikely(none(valid))) continue;
+#endif
+
+        /* update hit information for all rays that hit the point */
+        const sse3f Ng = disc ? -ray.dir : ray.org + T*ray.dir - p;
+        ray.u    = select(valid,ssef(zero),ray.u);
+        ray.v    = select(valid,ssef(zero),ray.v);
+        ray.tfar = select(valid,T,ray.tfar);
+        ray.geomID = select(valid,pts.geomID[i],ray.geomID);
+        ray.primID = select(valid,pts.primID[i],ray.primID);
+        ray.Ng.x = select(valid,Ng.x,ray.Ng.x);
+        ray.Ng.y = select(valid,Ng.y,ray.Ng.y);
+        ray.Ng.z = select(valid,Ng.z,ray.Ng.z);
+      }
+    }
+
+    static __forceinline void intersect(const sseb& valid, Ray4& ray, const Point8* pts, size_t num, void* geom)
+    {
+      for (size_t i=0; i<num; i++)
+        intersect(valid,ray,pts[i],geom);
+    }
+
+    /*! Test for 4 rays if they are occluded by any of the 8 points. */
+    static __forceinline sseb occluded(const sseb& valid_i, Ray4& ray, const Point8& pts, void* geom)
+    {
+      sseb valid0 = valid_i;
+
+      for (size_t i=0; i<pts.size(); i++)
+      {
+        STAT3(shadow.trav_prims,1,popcnt(valid0),4);
+
+        /* test distance of rays to point center */
+        sseb valid = valid0;
+        const sse3f p = broadcast4f(pts.p,i);
+        const bool disc = pts.r[i] < 0.0f;
+        const ssef rad = ssef(abs(pts.r[i]));
+        const sse3f C = p - ray.org;
+        const ssef A = dot(ray.dir,ray.dir);
+        const ssef B = dot(C,ray.dir);
+        const ssef Q = B*B - A*(dot(C,C)-rad*rad);
+        valid &= Q >= ssef(zero);
+        if (likely(none(valid))) continue;
+
+        /* perform depth test */
+        const ssef rcpA = rcp(A);
+        const ssef Tc = B*rcpA;
+        ssef T = Tc;
+        if (!disc) {
+          const ssef dT = sqrt(max(Q,ssef(zero)))*rcpA;
+          T = select(Tc-dT >= ray.tnear,Tc-dT,Tc+dT);
+        }
+        valid &= (T >= ray.tnear) & (T <= ray.tfar);
+        if (likely(none(valid))) continue;
+
+        /* ray masking test */
+#if defined(__USE_RAY_MASK__)
+        valid &= (pts.mask[i] & ray.mask) != 0;
+        if (unlikely(none(valid))) continue;
+#endif
+
+        /* update occlusion */
+        valid0 &= !valid;
+        if (none(valid0)) break;
+      }
+      return !valid0;
+    }
+
+    static __forceinline sseb occluded(const sseb& valid, Ray4& ray, const Point8* pts, size_t num, void* geom)
+    {
+      sseb valid0 = valid;
+      for (size_t i=0; i<num; i++) {
+        valid0 &= !occluded(valid0,ray,pts[i],geom);
+        if (none(valid0)) break;
+      }
+      return !valid0;
+    }
+  };
+}
+
+#endif
@@ -22,6 +22,14 @@
 
 namespace embree
 {
+  /*! Triangle extracted from a primitive block. */
+  struct BlockTriangle
+  {
+    Vec3fa v0,v1,v2;      //!< vertices of the triangle
+    unsigned int geomID;  //!< geometry ID of the triangle
+    unsigned int primID;  //!< primitive ID of the triangle
+  };
+
   struct PrimitiveType
   {
     /*! constructs the triangle type */
@@ -31,6 +39,11 @@ namespace embree
     /*! Computes the number of blocks required to store a number of triangles. */
     virtual size_t blocks(size_t x) const = 0;
 
+    /*! Computes the number of blocks required to store a specific list
+     *  of primitives. Types whose blocks hold a varying number of
+     *  primitives override this to compute the exact count. */
+    virtual size_t leafBlocks(atomic_set<PrimRefBlock>& prims, size_t num, void* geom) const { return blocks(num); }
+
     /*! Returns the number of stored primitives in a block. */
     virtual size_t size(const char* This) const = 0;
 
@@ -43,6 +56,14 @@ namespace embree
     /*! Updates all primitives stored in a leaf */
     virtual std::pair<BBox3f,BBox3f> update2(char* prim, size_t num, void* geom) const { return std::pair<BBox3f,BBox3f>(empty,empty); }
 
+    /*! Extracts the triangles stored in a block and returns their
+     *  number, at most maxBlockTriangles are written. Types that do
+     *  not store plain triangles return 0. */
+    virtual size_t triangles(const char* This, BlockTriangle* tris) const { return 0; }
+
+    /*! maximal number of triangles stored in a block */
+    static const size_t maxBlockTriangles = 16;
+
   public:
     std::string name;       //!< name of this primitive type
     size_t bytes;           //!< number of bytes of the triangle data
@@ -0,0 +1,71 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "quad4.h"
+#if defined(__TARGET_AVX__)
+#include "quad8.h"
+#endif
+#include "common/scene.h"
+
+namespace embree
+{
+  SceneQuad4 SceneQuad4::type;
+
+  Quad4Type::Quad4Type ()
+  : PrimitiveType("quad4",sizeof(Quad4),4,false,2) {}
+
+#if defined(__TARGET_AVX__)
+  SceneQuad8 SceneQuad8::type;
+
+  Quad8Type::Quad8Type ()
+  : PrimitiveType("quad8",2*sizeof(Quad4),8,false,2) {}
+#endif
+
+  size_t Quad4Type::blocks(size_t x) const {
+    return (x+3)/4;
+  }
+
+  size_t Quad4Type::size(const char* This) const {
+    return ((Quad4*)This)->size();
+  }
+
+  void SceneQuad4::pack(char* This, atomic_set<PrimRefBlock>::block_iterator_unsafe& prims, void* geom) const
+  {
+    Scene* scene = (Scene*) geom;
+
+    ssei geomID = -1, primID = -1, mask = -1;
+    sse3f v0 = zero, v1 = zero, v2 = zero, v3 = zero;
+
+    for (size_t i=0; i<4 && prims; i++, prims++)
+    {
+      const PrimRef& prim = *prims;
+      const QuadMeshScene::QuadMesh* mesh = scene->getQuadMesh(prim.geomID());
+      const QuadMeshScene::QuadMesh::Quad& quad = mesh->quad(prim.primID());
+      const Vec3fa& p0 = mesh->vertex(quad.v[0]);
+      const Vec3fa& p1 = mesh->vertex(quad.v[1]);
+      const Vec3fa& p2 = mesh->vertex(quad.v[2]);
+      const Vec3fa& p3 = mesh->vertex(quad.v[3]);
+      geomID [i] = prim.geomID();
+      primID [i] = prim.primID();
+      mask   [i] = mesh->mask;
+      v0.x[i] = p0.x; v0.y[i] = p0.y; v0.z[i] = p0.z;
+      v1.x[i] = p1.x; v1.y[i] = p1.y; v1.z[i] = p1.z;
+      v2.x[i] = p2.x; v2.y[i] = p2.y; v2.z[i] = p2.z;
+      v3.x[i] = p3.x; v3.y[i] = p3.y; v3.z[i] = p3.z;
+    }
+    new (This) Quad4(v0,v1,v2,v3,geomID,primID,mask);
+  }
+}
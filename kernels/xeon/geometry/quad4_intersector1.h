@@ -0,0 +1,94 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#ifndef __EMBREE_ACCEL_QUAD4_INTERSECTOR1_H__
+#define __EMBREE_ACCEL_QUAD4_INTERSECTOR1_H__
+
+#include "quad4.h"
+#include "quad_intersector_pluecker.h"
+#include "../common/ray.h"
+
+namespace embree
+{
+  /*! Intersector for a single ray with 4 quads. */
+  struct Quad4Intersector1
+  {
+    typedef Quad4 Primitive;
+
+    /*! Intersect a ray with the 4 quads and updates the hit. */
+    static __forceinline void intersect(Ray& ray, const Quad4& quad, void* geom)
+    {
+      /* perform quad test */
+      STAT3(normal.trav_prims,1,1,1);
+      ssef u, v, t; sse3f Ng;
+      sseb valid = QuadIntersectorPluecker::intersect(quad.valid(),sse3f(ray.org),sse3f(ray.dir),ssef(ray.tnear),ssef(ray.tfar),
+                                                      quad.v0,quad.v1,quad.v2,quad.v3,u,v,t,Ng);
+      if (likely(none(valid))) return;
+
+      /* ray masking test */
+#if defined(__USE_RAY_MASK__)
+      valid &= (quad.mask & ray.mask) != 0;
+      if (unlikely(none(valid))) return;
+#endif
+
+      /* update hit information */
+      const size_t i = select_min(valid,t);
+      ray.tfar = t[i];
+      ray.u = u[i];
+      ray.v = v[i];
+      ray.Ng.x = Ng.x[i];
+      ray.Ng.y = Ng.y[i];
+      ray.Ng.z = Ng.z[i];
+      ray.geomID = quad.geomID[i];
+      ray.primID = quad.primID[i];
+    }
+
+    static __forceinline void intersect(Ray& ray, const Quad4* quad, size_t num, void* geom)
+    {
+      for (size_t i=0; i<num; i++)
+        intersect(ray,quad[i],geom);
+    }
+
+    /*! Test if the ray is occluded by one of the quads. */
+    static __forceinline bool occluded(Ray& ray, const Quad4& quad, void* geom)
+    {
+      /* perform quad test */
+      STAT3(shadow.trav_prims,1,1,1);
+      ssef u, v, t; sse3f Ng;
+      sseb valid = QuadIntersectorPluecker::intersect(quad.valid(),sse3f(ray.org),sse3f(ray.dir),ssef(ray.tnear),ssef(ray.tfar),
+                                                      quad.v0,quad.v1,quad.v2,quad.v3,u,v,t,Ng);
+      if (likely(none(valid))) return false;
+
+      /* ray masking test */
+#if defined(__USE_RAY_MASK__)
+      valid &= (quad.mask & ray.mask) != 0;
+      if (unlikely(none(valid))) return false;
+#endif
+      return true;
+    }
+
+    static __forceinline bool occluded(Ray& ray, const Quad4* quad, size_t num, void* geom)
+    {
+      for (size_t i=0; i<num; i++)
+        if (occluded(ray,quad[i],geom))
+          return true;
+
+      return false;
+    }
+  };
+}
+
+#endif
@@ -0,0 +1,110 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#ifndef __EMBREE_ACCEL_QUAD4_INTERSECTOR8_H__
+#define __EMBREE_ACCEL_QUAD4_INTERSECTOR8_H__
+
+#include "quad4.h"
+#include "quad_intersector_pluecker.h"
+#include "../common/ray8.h"
+
+namespace embree
+{
+  /*! Intersector for 4 quads with 8 rays. */
+  struct Quad4Intersector8
+  {
+    typedef Quad4 Primitive;
+
+    /*! Intersects 8 rays with 4 quads. */
+    static __forceinline void intersect(const avxb& valid_i, Ray8& ray, const Quad4& quad, void* geom)
+    {
+      for (size_t i=0; i<quad.size(); i++)
+      {
+        STAT3(normal.trav_prims,1,popcnt(valid_i),8);
+
+        /* perform quad test */
+        avxf u, v, t; avx3f Ng;
+        avxb valid = QuadIntersectorPluecker::intersect(valid_i,ray.org,ray.dir,ray.tnear,ray.tfar,
+                                                        broadcast8f(quad.v0,i),broadcast8f(quad.v1,i),
+                                                        broadcast8f(quad.v2,i),broadcast8f(quad.v3,i),u,v,t,Ng);
+        if (likely(none(valid))) continue;
+
+        /* ray masking test */
+#if defined(__USE_RAY_MASK__)
+        valid &= (quad.mask[i] & ray.mask) != 0;
+        if (unlikely(none(valid))) continue;
+#endif
+
+        /* update hit information for all rays that hit the quad */
+        store8f(valid,&ray.u,u);
+        store8f(valid,&ray.v,v);
+        store8f(valid,&ray.tfar,t);
+        store8i(valid,&ray.geomID,quad.geomID[i]);
+        store8i(valid,&ray.primID,quad.primID[i]);
+        store8f(valid,&ray.Ng.x,Ng.x);
+        store8f(valid,&ray.Ng.y,Ng.y);
+        store8f(valid,&ray.Ng.z,Ng.z);
+      }
+    }
+
+    static __forceinline void intersect(const avxb& valid, Ray8& ray, const Quad4* quad, size_t num, void* geom)
+    {
+      for (size_t i=0; i<num; i++)
+        intersect(valid,ray,quad[i],geom);
+    }
+
+    /*! Test for 8 rays if they are occluded by any of the 4 quads. */
+    static __forceinline avxb occluded(const avxb& valid_i, Ray8& ray, const Quad4& quad, void* geom)
+    {
+      avxb valid0 = valid_i;
+
+      for (size_t i=0; i<quad.size(); i++)
+      {
+        STAT3(shadow.trav_prims,1,popcnt(valid0),8);
+
+        /* perform quad test */
+        avxf u, v, t; avx3f Ng;
+        avxb valid = QuadIntersectorPluecker::intersect(valid0,ray.org,ray.dir,ray.tnear,ray.tfar,
+                                                        broadcast8f(quad.v0,i),broadcast8f(quad.v1,i),
+                                                        broadcast8f(quad.v2,i),broadcast8f(quad.v3,i),u,v,t,Ng);
+        if (likely(none(valid))) continue;
+
+        /* ray masking test */
+#if defined(__USE_RAY_MASK__)
+        valid &= (quad.mask[i] & ray.mask) != 0;
+        if (unlikely(none(valid))) continue;
+#endif
+
+        /* update occlusion */
+        valid0 &= !valid;
+        if (none(valid0)) break;
+      }
+      return !valid0;
+    }
+
+    static __forceinline avxb occluded(const avxb& valid, Ray8& ray, const Quad4* quad, size_t num, void* geom)
+    {
+      avxb valid0 = valid;
+      for (size_t i=0; i<num; i++) {
+        valid0 &= !occluded(valid0,ray,quad[i],geom);
+        if (none(valid0)) break;
+      }
+      return !valid0;
+    }
+  };
+}
+
+#endif
@@ -0,0 +1,99 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#ifndef __EMBREE_ACCEL_QUAD8_H__
+#define __EMBREE_ACCEL_QUAD8_H__
+
+#include "primitive.h"
+
+namespace embree
+{
+#if defined __AVX__
+
+  /*! Stores 8 quads of a quad mesh. Each quad is a pair of triangles
+   *  (v0,v1,v3) and (v2,v3,v1) that share the vertices along the
+   *  diagonal, thus the leaf needs 4 instead of 6 vertices per
+   *  quad. */
+  struct Quad8
+  {
+  public:
+
+    /*! Default constructor. */
+    __forceinline Quad8 () {}
+
+    /*! Construction from vertices and IDs. */
+    __forceinline Quad8 (const avx3f& v0, const avx3f& v1, const avx3f& v2, const avx3f& v3, 
+                         const avxi& geomID, const avxi& primID, const avxi& mask)
+      : v0(v0), v1(v1), v2(v2), v3(v3), geomID(geomID), primID(primID)
+    {
+#if defined(__USE_RAY_MASK__)
+      this->mask = mask;
+#endif
+    }
+
+    /*! Returns a mask that tells which quads are valid. */
+    __forceinline avxb valid() const { return geomID != avxi(-1); }
+
+    /*! Returns the number of stored quads. */
+    __forceinline size_t size() const {
+      return __bsf(~movemask(valid()));
+    }
+
+    /*! calculate the bounds of the quads */
+    __forceinline BBox3f bounds() const
+    {
+      avx3f lower = min(min(v0,v1),min(v2,v3));
+      avx3f upper = max(max(v0,v1),max(v2,v3));
+      avxb mask = valid();
+      lower.x = select(mask,lower.x,avxf(pos_inf));
+      lower.y = select(mask,lower.y,avxf(pos_inf));
+      lower.z = select(mask,lower.z,avxf(pos_inf));
+      upper.x = select(mask,upper.x,avxf(neg_inf));
+      upper.y = select(mask,upper.y,avxf(neg_inf));
+      upper.z = select(mask,upper.z,avxf(neg_inf));
+      return BBox3f(Vec3fa(reduce_min(lower.x),reduce_min(lower.y),reduce_min(lower.z)),
+                    Vec3fa(reduce_max(upper.x),reduce_max(upper.y),reduce_max(upper.z)));
+    }
+
+  public:
+    avx3f v0;      //!< 1st vertex of the quads
+    avx3f v1;      //!< 2nd vertex of the quads
+    avx3f v2;      //!< 3rd vertex of the quads
+    avx3f v3;      //!< 4th vertex of the quads
+    avxi geomID;   //!< user geometry ID
+    avxi primID;   //!< primitive ID
+#if defined(__USE_RAY_MASK__)
+    avxi mask;     //!< geometry mask
+#endif
+  };
+#endif
+
+#if defined(__TARGET_AVX__)
+  struct Quad8Type : public PrimitiveType {
+    Quad8Type ();
+    size_t blocks(size_t x) const;
+    size_t size(const char* This) const;
+  };
+
+  struct SceneQuad8 : public Quad8Type
+  {
+    static SceneQuad8 type;
+    void pack(char* This, atomic_set<PrimRefBlock>::block_iterator_unsafe& prims, void* geom) const;
+  };
+#endif
+}
+
+#endif
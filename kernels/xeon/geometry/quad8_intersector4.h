@@ -0,0 +1,110 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#ifndef __EMBREE_ACCEL_QUAD8_INTERSECTOR4_H__
+#define __EMBREE_ACCEL_QUAD8_INTERSECTOR4_H__
+
+#include "quad8.h"
+#include "quad_intersector_pluecker.h"
+#include "../common/ray4.h"
+
+namespace embree
+{
+  /*! Intersector for 8 quads with 4 rays. */
+  struct Quad8Intersector4
+  {
+    typedef Quad8 Primitive;
+
+    /*! Intersects 4 rays with 8 quads. */
+    static __forceinline void intersect(const sseb& valid_i, Ray4& ray, const Quad8& quad, void* geom)
+    {
+      for (size_t i=0; i<quad.size(); i++)
+      {
+        STAT3(normal.trav_prims,1,popcnt(valid_i),4);
+
+        /* perform quad test */
+        ssef u, v, t; sse3f Ng;
+        sseb valid = QuadIntersectorPluecker::intersect(valid_i,ray.org,ray.dir,ray.tnear,ray.tfar,
+                                                        broadcast4f(quad.v0,i),broadcast4f(quad.v1,i),
+                                                        broadcast4f(quad.v2,i),broadcast4f(quad.v3,i),u,v,t,Ng);
+        if (likely(none(valid))) continue;
+
+        /* ray masking test */
+#if defined(__USE_RAY_MASK__)
+        valid &= (quad.mask[i] & ray.mask) != 0;
+        if (unlikely(none(valid))) continue;
+#endif
+
+        /* update hit information for all rays that hit the quad */
+        ray.u    = select(valid,u,ray.u);
+        ray.v    = select(valid,v,ray.v);
+        ray.tfar = select(valid,t,ray.tfar);
+        ray.geomID = select(valid,quad.geomID[i],ray.geomID);
+        ray.primID = select(valid,quad.primID[i],ray.primID);
+        ray.Ng.x = select(valid,Ng.x,ray.Ng.x);
+        ray.Ng.y = select(valid,Ng.y,ray.Ng.y);
+        ray.Ng.z = select(valid,Ng.z,ray.Ng.z);
+      }
+    }
+
+    static __forceinline void intersect(const sseb& valid, Ray4& ray, const Quad8* quad, size_t num, void* geom)
+    {
+      for (size_t i=0; i<num; i++)
+        intersect(valid,ray,quad[i],geom);
+    }
+
+    /*! Test for 4 rays if they are occluded by any of the 8 quads. */
+    static __forceinline sseb occluded(const sseb& valid_i, Ray4& ray, const Quad8& quad, void* geom)
+    {
+      sseb valid0 = valid_i;
+
+      for (size_t i=0; i<quad.size(); i++)
+      {
+        STAT3(shadow.trav_prims,1,popcnt(valid0),4);
+
+        /* perform quad test */
+        ssef u, v, t; sse3f Ng;
+        sseb valid = QuadIntersectorPluecker::intersect(valid0,ray.org,ray.dir,ray.tnear,ray.tfar,
+                                                        broadcast4f(quad.v0,i),broadcast4f(quad.v1,i),
+                                                        broadcast4f(quad.v2,i),broadcast4f(quad.v3,i),u,v,t,Ng);
+        if (likely(none(valid))) continue;
+
+        /* ray masking test */
+#if defined(__USE_RAY_MASK__)
+        valid &= (quad.mask[i] & ray.mask) != 0;
+        if (unlikely(none(valid))) continue;
+#endif
+
+        /* update occlusion */
+        valid0 &= !valid;
+        if (none(valid0)) break;
+      }
+      return !valid0;
+    }
+
+    static __forceinline sseb occluded(const sseb& valid, Ray4& ray, const Quad8* quad, size_t num, void* geom)
+    {
+      sseb valid0 = valid;
+      for (size_t i=0; i<num; i++) {
+        valid0 &= !occluded(valid0,ray,quad[i],geom);
+        if (none(valid0)) break;
+      }
+      return !valid0;
+    }
+  };
+}
+
+#endif
@@ -0,0 +1,102 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#ifndef __EMBREE_ACCEL_QUAD_INTERSECTOR_PLUECKER_H__
+#define __EMBREE_ACCEL_QUAD_INTERSECTOR_PLUECKER_H__
+
+#include "../common/default.h"
+
+namespace embree
+{
+  /*! Pluecker test of rays against quads (q0,q1,q2,q3) that are
+   *  split into the triangles (q0,q1,q3) and (q2,q3,q1). The edge
+   *  function of an edge is exactly negated if its vertices are
+   *  swapped, thus both triangles evaluate the shared diagonal
+   *  identically and rays cannot leak through it. The hit is reported
+   *  in u/v coordinates of the quad, where q0 is at (0,0), q1 at
+   *  (1,0), q2 at (1,1), and q3 at (0,1). */
+  struct QuadIntersectorPluecker
+  {
+    template<typename vfloat, typename vbool>
+      static __forceinline vbool intersect(const vbool& valid_i, 
+                                           const Vec3<vfloat>& O, const Vec3<vfloat>& D, 
+                                           const vfloat& tnear, const vfloat& tfar,
+                                           const Vec3<vfloat>& q0, const Vec3<vfloat>& q1, 
+                                           const Vec3<vfloat>& q2, const Vec3<vfloat>& q3,
+                                           vfloat& u_o, vfloat& v_o, vfloat& t_o, Vec3<vfloat>& Ng_o)
+    {
+      /* calculate vertices relative to ray origin */
+      const Vec3<vfloat> v0 = q0-O;
+      const Vec3<vfloat> v1 = q1-O;
+      const Vec3<vfloat> v2 = q2-O;
+      const Vec3<vfloat> v3 = q3-O;
+
+      /* calculate geometry normals and denominators */
+      const Vec3<vfloat> NgA = cross(v0-v1,v3-v0);
+      const Vec3<vfloat> NgA2 = NgA+NgA;
+      const vfloat denA = dot(NgA2,D);
+      const vfloat absDenA = abs(denA);
+      const vfloat sgnDenA = signmsk(denA);
+
+      const Vec3<vfloat> NgB = cross(v2-v3,v1-v2);
+      const Vec3<vfloat> NgB2 = NgB+NgB;
+      const vfloat denB = dot(NgB2,D);
+      const vfloat absDenB = abs(denB);
+      const vfloat sgnDenB = signmsk(denB);
+
+      /* perform edge tests, the diagonal is shared by both triangles */
+      const vfloat E31 = dot(cross(v3+v1,v1-v3),D);
+      const vfloat UA = dot(cross(v0+v3,v3-v0),D) ^ sgnDenA;
+      const vfloat VA = dot(cross(v1+v0,v0-v1),D) ^ sgnDenA;
+      const vfloat WA = E31 ^ sgnDenA;
+      const vfloat UB = dot(cross(v2+v1,v1-v2),D) ^ sgnDenB;
+      const vfloat VB = dot(cross(v3+v2,v2-v3),D) ^ sgnDenB;
+      const vfloat WB = (-E31) ^ sgnDenB;
+      vbool validA = valid_i & (UA >= vfloat(zero)) & (VA >= vfloat(zero)) & (WA >= vfloat(zero));
+      vbool validB = valid_i & (UB >= vfloat(zero)) & (VB >= vfloat(zero)) & (WB >= vfloat(zero));
+      if (likely(none(validA | validB))) return validA;
+
+      /* perform depth test */
+      const vfloat TA = dot(v0,NgA2) ^ sgnDenA;
+      const vfloat TB = dot(v2,NgB2) ^ sgnDenB;
+      validA &= (TA >= absDenA*tnear) & (absDenA*tfar >= TA);
+      validB &= (TB >= absDenB*tnear) & (absDenB*tfar >= TB);
+
+      /* perform backface culling */
+#if defined(__BACKFACE_CULLING__)
+      validA &= denA > vfloat(zero);
+      validB &= denB > vfloat(zero);
+#else
+      validA &= denA != vfloat(zero);
+      validB &= denB != vfloat(zero);
+#endif
+
+      /* a folded quad may get hit twice, take the closer triangle */
+      const vfloat tA = TA / absDenA;
+      const vfloat tB = TB / absDenB;
+      const vbool selB = validB & (!validA | (tB < tA));
+      u_o = select(selB,vfloat(one) - UB/absDenB,UA/absDenA);
+      v_o = select(selB,vfloat(one) - VB/absDenB,VA/absDenA);
+      t_o = select(selB,tB,tA);
+      Ng_o.x = select(selB,NgB2.x,NgA2.x);
+      Ng_o.y = select(selB,NgB2.y,NgA2.y);
+      Ng_o.z = select(selB,NgB2.z,NgA2.z);
+      return validA | validB;
+    }
+  };
+}
+
+#endif
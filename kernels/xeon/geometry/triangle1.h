@@ -53,6 +53,7 @@ namespace embree
     Triangle1Type ();
     size_t blocks(size_t x) const;
     size_t size(const char* This) const;
+    size_t triangles(const char* This, BlockTriangle* tris) const;
   };
 
   struct SceneTriangle1 : public Triangle1Type
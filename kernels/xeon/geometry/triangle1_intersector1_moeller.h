@@ -19,6 +19,7 @@
 
 #include "triangle1.h"
 #include "../common/ray.h"
+#include "filter.h"
 
 namespace embree
 {
@@ -31,6 +32,7 @@ namespace embree
    *  e2. The resulting algorithm is similar to the fastest one of the
    *  paper "Optimizing Ray-Triangle Intersection via Automated
    *  Search". */
+  template<int kernelFeatures>
   struct Triangle1Intersector1MoellerTrumbore
   {
     typedef Triangle1 Primitive;
@@ -78,11 +80,26 @@ namespace embree
 
       /* ray masking test */
 #if defined(__USE_RAY_MASK__)
-      if (unlikely((tri.mask() & ray.mask) == 0)) return;
+      if (kernelFeatures & KERNEL_FEATURE_RAY_MASK) {
+        if (unlikely((tri.mask() & ray.mask) == 0)) return;
+      }
 #endif
 
-      /* update hit information */
       const float rcpAbsDen = rcp(absDen);
+
+      /* intersection filter test */
+#if defined(__INTERSECTION_FILTER__)
+      if (kernelFeatures & KERNEL_FEATURE_FILTER) {
+        const int geomID = tri.geomID();
+        const Geometry* geometry = getGeometry(geom,geomID);
+        if (unlikely(geometry->hasIntersectionFilter1())) {
+          runIntersectionFilter1(geometry,ray,U*rcpAbsDen,V*rcpAbsDen,T*rcpAbsDen,tri_Ng,geomID,tri.primID());
+          return;
+        }
+      }
+#endif
+
+      /* update hit information */
       ray.u   = U * rcpAbsDen;
       ray.v   = V * rcpAbsDen;
       ray.tfar = T * rcpAbsDen;
@@ -98,7 +115,7 @@ namespace embree
     }
 
     /*! Test if the ray is occluded by one of the triangles. */
-    static __forceinline bool occluded(const Ray& ray, const Triangle1& tri, const void* geom)
+    static __forceinline bool occluded(Ray& ray, const Triangle1& tri, const void* geom)
     {
       /* load triangle */
       STAT3(shadow.trav_prims,1,1,1);
@@ -140,7 +157,21 @@ namespace embree
 
       /* ray masking test */
 #if defined(__USE_RAY_MASK__)
-      if (unlikely((tri.mask() & ray.mask) == 0)) return false;
+      if (kernelFeatures & KERNEL_FEATURE_RAY_MASK) {
+        if (unlikely((tri.mask() & ray.mask) == 0)) return false;
+      }
+#endif
+
+      /* occlusion filter test */
+#if defined(__INTERSECTION_FILTER__)
+      if (kernelFeatures & KERNEL_FEATURE_FILTER) {
+        const int geomID = tri.geomID();
+        const Geometry* geometry = getGeometry(geom,geomID);
+        if (unlikely(geometry->hasOcclusionFilter1())) {
+          const float rcpAbsDen = rcp(absDen);
+          return runOcclusionFilter1(geometry,ray,U*rcpAbsDen,V*rcpAbsDen,T*rcpAbsDen,tri_Ng,geomID,tri.primID());
+        }
+      }
 #endif
       return true;
     }
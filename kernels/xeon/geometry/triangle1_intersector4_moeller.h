@@ -19,6 +19,7 @@
 
 #include "triangle1.h"
 #include "../common/ray4.h"
+#include "filter.h"
 
 namespace embree
 {
@@ -29,6 +30,7 @@ namespace embree
    *  precalculate some factors and factor the calculations
    *  differently to allow precalculating the cross product e1 x
    *  e2. */
+  template<int kernelFeatures>
   struct Triangle1Intersector4MoellerTrumbore
   {
     typedef Triangle1 Primitive;
@@ -81,12 +83,28 @@ namespace embree
         
         /* ray masking test */
 #if defined(__USE_RAY_MASK__)
-        valid &= (tri.mask() & ray.mask) != 0;
-        if (unlikely(none(valid))) continue;
+        if (kernelFeatures & KERNEL_FEATURE_RAY_MASK) {
+          valid &= (tri.mask() & ray.mask) != 0;
+          if (unlikely(none(valid))) continue;
+        }
 #endif
 
         /* update hit information */
         const ssef rcpAbsDen = rcp(absDen);
+
+        /* intersection filter test */
+#if defined(__INTERSECTION_FILTER__)
+        if (kernelFeatures & KERNEL_FEATURE_FILTER)
+        {
+          const int geomID = tri.geomID();
+          const Geometry* geometry = getGeometry(geom,geomID);
+          if (unlikely(geometry->hasIntersectionFilter4())) {
+            runIntersectionFilter4(valid,geometry,ray,U*rcpAbsDen,V*rcpAbsDen,T*rcpAbsDen,Ng,geomID,tri.primID());
+            continue;
+          }
+        }
+#endif
+
         store4f(valid,&ray.u,U*rcpAbsDen);
         store4f(valid,&ray.v,V*rcpAbsDen);
         store4f(valid,&ray.tfar,T*rcpAbsDen);
@@ -148,10 +166,26 @@ namespace embree
 
         /* ray masking test */
 #if defined(__USE_RAY_MASK__)
-        valid &= (tri.mask() & ray.mask) != 0;
-        if (unlikely(none(valid))) continue;
+        if (kernelFeatures & KERNEL_FEATURE_RAY_MASK) {
+          valid &= (tri.mask() & ray.mask) != 0;
+          if (unlikely(none(valid))) continue;
+        }
 #endif
         
+        /* occlusion filter test */
+#if defined(__INTERSECTION_FILTER__)
+        if (kernelFeatures & KERNEL_FEATURE_FILTER)
+        {
+          const int geomID = tri.geomID();
+          const Geometry* geometry = getGeometry(geom,geomID);
+          if (unlikely(geometry->hasOcclusionFilter4())) {
+            const ssef rcpAbsDen = rcp(absDen);
+            valid = runOcclusionFilter4(valid,geometry,ray,U*rcpAbsDen,V*rcpAbsDen,T*rcpAbsDen,Ng,geomID,tri.primID());
+            if (none(valid)) continue;
+          }
+        }
+#endif
+
         /* update occlusion */
         valid0 &= !valid;
         if (none(valid0)) break;
@@ -36,6 +36,14 @@ namespace embree
     return 1;
   }
 
+  size_t Triangle1vType::triangles(const char* This, BlockTriangle* tris) const 
+  {
+    const Triangle1v& tri = *(Triangle1v*)This;
+    tris[0].v0 = tri.v0; tris[0].v1 = tri.v1; tris[0].v2 = tri.v2;
+    tris[0].geomID = tri.geomID(); tris[0].primID = tri.primID();
+    return 1;
+  }
+
   void SceneTriangle1v::pack(char* dst, atomic_set<PrimRefBlock>::block_iterator_unsafe& prims, void* geom) const 
   {
     Scene* scene = (Scene*) geom;
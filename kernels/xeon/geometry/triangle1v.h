@@ -52,6 +52,7 @@ namespace embree
     Triangle1vType ();
     size_t blocks(size_t x) const;
     size_t size(const char* This) const;
+    size_t triangles(const char* This, BlockTriangle* tris) const;
   };
 
   struct SceneTriangle1v : public Triangle1vType 
@@ -19,6 +19,7 @@
 
 #include "triangle1v.h"
 #include "../common/ray.h"
+#include "filter.h"
 
 namespace embree
 {
@@ -84,8 +85,19 @@ namespace embree
       if (unlikely((tri.mask() & ray.mask) == 0)) return;
 #endif
 
-      /* update hit information */
       const float rcpAbsDen = rcp(absDen);
+
+      /* intersection filter test */
+#if defined(__INTERSECTION_FILTER__)
+      const int geomID = tri.geomID();
+      const Geometry* geometry = getGeometry(geom,geomID);
+      if (unlikely(geometry->hasIntersectionFilter1())) {
+        runIntersectionFilter1(geometry,ray,U*rcpAbsDen,V*rcpAbsDen,T*rcpAbsDen,Ng2,geomID,tri.primID());
+        return;
+      }
+#endif
+
+      /* update hit information */
       ray.u   = U * rcpAbsDen;
       ray.v   = V * rcpAbsDen;
       ray.tfar = T * rcpAbsDen;
@@ -101,7 +113,7 @@ namespace embree
     }
 
     /*! Test if the ray is occluded by one of the triangles. */
-    static __forceinline bool occluded(const Ray& ray, const Triangle1v& tri, const void* geom)
+    static __forceinline bool occluded(Ray& ray, const Triangle1v& tri, const void* geom)
     {
       /* load triangle */
       STAT3(shadow.trav_prims,1,1,1);
@@ -152,6 +164,16 @@ namespace embree
 #if defined(__USE_RAY_MASK__)
       if (unlikely((tri.mask() & ray.mask) == 0)) return false;
 #endif
+
+      /* occlusion filter test */
+#if defined(__INTERSECTION_FILTER__)
+      const int geomID = tri.geomID();
+      const Geometry* geometry = getGeometry(geom,geomID);
+      if (unlikely(geometry->hasOcclusionFilter1())) {
+        const float rcpAbsDen = rcp(absDen);
+        return runOcclusionFilter1(geometry,ray,U*rcpAbsDen,V*rcpAbsDen,T*rcpAbsDen,Ng2,geomID,tri.primID());
+      }
+#endif
       return true;
     }
 
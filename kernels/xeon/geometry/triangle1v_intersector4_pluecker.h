@@ -19,6 +19,7 @@
 
 #include "triangle1v.h"
 #include "../common/ray4.h"
+#include "filter.h"
 
 namespace embree
 {
@@ -91,6 +92,19 @@ namespace embree
 
         /* update hit information */
         const ssef rcpAbsDen = rcp(absDen);
+
+        /* intersection filter test */
+#if defined(__INTERSECTION_FILTER__)
+        {
+          const int geomID = tri.geomID();
+          const Geometry* geometry = getGeometry(geom,geomID);
+          if (unlikely(geometry->hasIntersectionFilter4())) {
+            runIntersectionFilter4(valid,geometry,ray,U*rcpAbsDen,V*rcpAbsDen,T*rcpAbsDen,Ng,geomID,tri.primID());
+            continue;
+          }
+        }
+#endif
+
         store4f(valid,&ray.u,U*rcpAbsDen);
         store4f(valid,&ray.v,V*rcpAbsDen);
         store4f(valid,&ray.tfar,T*rcpAbsDen);
@@ -162,6 +176,19 @@ namespace embree
         if (unlikely(none(valid))) continue;
 #endif
         
+        /* occlusion filter test */
+#if defined(__INTERSECTION_FILTER__)
+        {
+          const int geomID = tri.geomID();
+          const Geometry* geometry = getGeometry(geom,geomID);
+          if (unlikely(geometry->hasOcclusionFilter4())) {
+            const ssef rcpAbsDen = rcp(absDen);
+            valid = runOcclusionFilter4(valid,geometry,ray,U*rcpAbsDen,V*rcpAbsDen,T*rcpAbsDen,Ng,geomID,tri.primID());
+            if (none(valid)) continue;
+          }
+        }
+#endif
+
         /* update occlusion */
         valid0 &= !valid;
         if (none(valid0)) break;
@@ -105,6 +105,7 @@ namespace embree
     Triangle4Type ();
     size_t blocks(size_t x) const;
     size_t size(const char* This) const;
+    size_t triangles(const char* This, BlockTriangle* tris) const;
   };
 
   struct SceneTriangle4 : public Triangle4Type
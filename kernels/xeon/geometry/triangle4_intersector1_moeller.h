@@ -20,6 +20,7 @@
 #include "../common/default.h"
 #include "triangle4.h"
 #include "../common/ray.h"
+#include "filter.h"
 
 namespace embree
 {
@@ -31,6 +32,7 @@ namespace embree
    *  precalculating the cross product e1 x e2. The resulting
    *  algorithm is similar to the fastest one of the paper "Optimizing
    *  Ray-Triangle Intersection via Automated Search". */
+  template<int kernelFeatures>
   struct Triangle4Intersector1MoellerTrumbore
   {
     typedef Triangle4 Primitive;
@@ -67,8 +69,10 @@ namespace embree
 
       /* ray masking test */
 #if defined(__USE_RAY_MASK__)
-      valid &= (tri.mask & ray.mask) != 0;
-      if (unlikely(none(valid))) return;
+      if (kernelFeatures & KERNEL_FEATURE_RAY_MASK) {
+        valid &= (tri.mask & ray.mask) != 0;
+        if (unlikely(none(valid))) return;
+      }
 #endif
 
       /* update hit information */
@@ -76,7 +80,25 @@ namespace embree
       const ssef u = U * rcpAbsDen;
       const ssef v = V * rcpAbsDen;
       const ssef t = T * rcpAbsDen;
-      const size_t i = select_min(valid,t);
+      size_t i = select_min(valid,t);
+
+      /* intersection filter test */
+#if defined(__INTERSECTION_FILTER__)
+      if (kernelFeatures & KERNEL_FEATURE_FILTER) {
+        while (true) 
+        {
+          const int geomID = tri.geomID[i];
+          const Geometry* geometry = getGeometry(geom,geomID);
+          if (likely(!geometry->hasIntersectionFilter1())) break;
+          const Vec3fa Ng = Vec3fa(tri.Ng.x[i],tri.Ng.y[i],tri.Ng.z[i]);
+          if (runIntersectionFilter1(geometry,ray,u[i],v[i],t[i],Ng,geomID,tri.primID[i])) return;
+          valid[i] = 0;
+          if (none(valid)) return;
+          i = select_min(valid,t);
+        }
+      }
+#endif
+
       ray.u   = u[i];
       ray.v   = v[i];
       ray.tfar = t[i];
@@ -126,8 +148,29 @@ namespace embree
 
       /* ray masking test */
 #if defined(__USE_RAY_MASK__)
-      valid &= (tri.mask & ray.mask) != 0;
-      if (unlikely(none(valid))) return false;
+      if (kernelFeatures & KERNEL_FEATURE_RAY_MASK) {
+        valid &= (tri.mask & ray.mask) != 0;
+        if (unlikely(none(valid))) return false;
+      }
+#endif
+
+      /* occlusion filter test */
+#if defined(__INTERSECTION_FILTER__)
+      if (kernelFeatures & KERNEL_FEATURE_FILTER) {
+        const ssef rcpAbsDen = rcp(absDen);
+        const ssef u = U * rcpAbsDen;
+        const ssef v = V * rcpAbsDen;
+        const ssef t = T * rcpAbsDen;
+        for (size_t m=movemask(valid), i=__bsf(m); m!=0; m=__btc(m,i), i=__bsf(m))
+        {  
+          const int geomID = tri.geomID[i];
+          const Geometry* geometry = getGeometry(geom,geomID);
+          if (likely(!geometry->hasOcclusionFilter1())) return true;
+          const Vec3fa Ng = Vec3fa(tri.Ng.x[i],tri.Ng.y[i],tri.Ng.z[i]);
+          if (runOcclusionFilter1(geometry,ray,u[i],v[i],t[i],Ng,geomID,tri.primID[i])) return true;
+        }
+        return false;
+      }
 #endif
       return true;
     }
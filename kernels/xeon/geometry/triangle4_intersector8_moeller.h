@@ -19,6 +19,7 @@
 
 #include "triangle4.h"
 #include "triangle4_intersector1_moeller.h"
+#include "filter.h"
 
 #include "../common/ray8.h"
 
@@ -30,71 +31,105 @@ namespace embree
    *  Intersection". In contrast to the paper we precalculate some
    *  factors and factor the calculations differently to allow
    *  precalculating the cross product e1 x e2. */
+  template<int kernelFeatures>
   struct Triangle4Intersector8MoellerTrumbore
   {
     typedef Triangle4 Primitive;
 
-    /*! Intersects a 4 rays with 4 triangles. */
-    static __forceinline void intersect(const avxb& valid_i, Ray8& ray, const Triangle4& tri, const void* geom)
+    /*! Tests 8 rays against the i-th of the 4 triangles. Returns the
+     *  rays that hit the triangle inside their ray segment and sets
+     *  the hit distances, barycentric coordinates, and geometry
+     *  normal for them. */
+    static __forceinline avxb intersect(const avxb& valid_i, const Ray8& ray, const Triangle4& tri, size_t i, 
+                                        avxf& u, avxf& v, avxf& t, avx3f& Ng)
     {
-      for (size_t i=0; i<tri.size(); i++)
-      {
-        STAT3(normal.trav_prims,1,popcnt(valid_i),8);
-
-        /* load edges and geometry normal */
-        avxb valid = valid_i;
-        const avx3f p0 = broadcast8f(tri.v0,i);
-        const avx3f e1 = broadcast8f(tri.e1,i);
-        const avx3f e2 = broadcast8f(tri.e2,i);
-        const avx3f Ng = broadcast8f(tri.Ng,i);
+      /* load edges and geometry normal */
+      avxb valid = valid_i;
+      const avx3f p0 = broadcast8f(tri.v0,i);
+      const avx3f e1 = broadcast8f(tri.e1,i);
+      const avx3f e2 = broadcast8f(tri.e2,i);
+      Ng = broadcast8f(tri.Ng,i);
         
-        /* calculate denominator */
-        const avx3f C = p0 - ray.org;
-        const avx3f R = cross(ray.dir,C);
-        const avxf den = dot(Ng,ray.dir);
-        const avxf absDen = abs(den);
-        const avxf sgnDen = signmsk(den);
+      /* calculate denominator */
+      const avx3f C = p0 - ray.org;
+      const avx3f R = cross(ray.dir,C);
+      const avxf den = dot(Ng,ray.dir);
+      const avxf absDen = abs(den);
+      const avxf sgnDen = signmsk(den);
         
-        /* test against edge p2 p0 */
-        const avxf U = dot(R,e2) ^ sgnDen;
-        valid &= U >= 0.0f;
-        if (likely(none(valid))) continue;
+      /* test against edge p2 p0 */
+      const avxf U = dot(R,e2) ^ sgnDen;
+      valid &= U >= 0.0f;
+      if (likely(none(valid))) return valid;
         
-        /* test against edge p0 p1 */
-        const avxf V = dot(R,e1) ^ sgnDen;
-        valid &= V >= 0.0f;
-        if (likely(none(valid))) continue;
+      /* test against edge p0 p1 */
+      const avxf V = dot(R,e1) ^ sgnDen;
+      valid &= V >= 0.0f;
+      if (likely(none(valid))) return valid;
         
-        /* test against edge p1 p2 */
-        const avxf W = absDen-U-V;
-        valid &= W >= 0.0f;
-        if (likely(none(valid))) continue;
+      /* test against edge p1 p2 */
+      const avxf W = absDen-U-V;
+      valid &= W >= 0.0f;
+      if (likely(none(valid))) return valid;
         
-        /* perform depth test */
-        const avxf T = dot(Ng,C) ^ sgnDen;
-        valid &= (T >= absDen*ray.tnear) & (absDen*ray.tfar >= T);
-        if (unlikely(none(valid))) continue;
+      /* perform depth test */
+      const avxf T = dot(Ng,C) ^ sgnDen;
+      valid &= (T >= absDen*ray.tnear) & (absDen*ray.tfar >= T);
+      if (unlikely(none(valid))) return valid;
 
-        /* perform backface culling */
+      /* perform backface culling */
 #if defined(__BACKFACE_CULLING__)
-        valid &= den > avxf(zero);
-        if (unlikely(none(valid))) continue;
+      valid &= den > avxf(zero);
+      if (unlikely(none(valid))) return valid;
 #else
-        valid &= den != avxf(zero);
-        if (unlikely(none(valid))) continue;
+      valid &= den != avxf(zero);
+      if (unlikely(none(valid))) return valid;
 #endif
         
-        /* ray masking test */
+      /* ray masking test */
 #if defined(__USE_RAY_MASK__)
+      if (kernelFeatures & KERNEL_FEATURE_RAY_MASK) {
         valid &= (tri.mask[i] & ray.mask) != 0;
-        if (unlikely(none(valid))) continue;
+        if (unlikely(none(valid))) return valid;
+      }
+#endif
+
+      /* calculate hit information */
+      const avxf rcpAbsDen = rcp(absDen);
+      u = U * rcpAbsDen;
+      v = V * rcpAbsDen;
+      t = T * rcpAbsDen;
+      return valid;
+    }
+
+    /*! Intersects a 4 rays with 4 triangles. */
+    static __forceinline void intersect(const avxb& valid_i, Ray8& ray, const Triangle4& tri, const void* geom)
+    {
+      for (size_t i=0; i<tri.size(); i++)
+      {
+        STAT3(normal.trav_prims,1,popcnt(valid_i),8);
+
+        avxf u, v, t; avx3f Ng;
+        const avxb valid = intersect(valid_i,ray,tri,i,u,v,t,Ng);
+        if (likely(none(valid))) continue;
+
+        /* intersection filter test */
+#if defined(__INTERSECTION_FILTER__)
+        if (kernelFeatures & KERNEL_FEATURE_FILTER)
+        {
+          const int geomID = tri.geomID[i];
+          const Geometry* geometry = getGeometry(geom,geomID);
+          if (unlikely(geometry->hasIntersectionFilter8())) {
+            runIntersectionFilter8(valid,geometry,ray,u,v,t,Ng,geomID,tri.primID[i]);
+            continue;
+          }
+        }
 #endif
 
         /* update hit information for all rays that hit the triangle */
-        const avxf rcpAbsDen = rcp(absDen);
-        store8f(valid,&ray.u,U * rcpAbsDen);
-        store8f(valid,&ray.v,V * rcpAbsDen);
-        store8f(valid,&ray.tfar,T * rcpAbsDen);
+        store8f(valid,&ray.u,u);
+        store8f(valid,&ray.v,v);
+        store8f(valid,&ray.tfar,t);
         store8i(valid,&ray.geomID,tri.geomID[i]);
         store8i(valid,&ray.primID,tri.primID[i]);
         store8f(valid,&ray.Ng.x,Ng.x);
@@ -110,7 +145,7 @@ namespace embree
     }
 
     /*! Test for 4 rays if they are occluded by any of the 4 triangle. */
-    static __forceinline avxb occluded(const avxb& valid_i, const Ray8& ray, const Triangle4& tri, const void* geom)
+    static __forceinline avxb occluded(const avxb& valid_i, Ray8& ray, const Triangle4& tri, const void* geom)
     {
       avxb valid0 = valid_i;
 
@@ -163,8 +198,24 @@ namespace embree
 
         /* ray masking test */
 #if defined(__USE_RAY_MASK__)
-        valid &= (tri.mask[i] & ray.mask) != 0;
-        if (unlikely(none(valid))) continue;
+        if (kernelFeatures & KERNEL_FEATURE_RAY_MASK) {
+          valid &= (tri.mask[i] & ray.mask) != 0;
+          if (unlikely(none(valid))) continue;
+        }
+#endif
+
+        /* occlusion filter test */
+#if defined(__INTERSECTION_FILTER__)
+        if (kernelFeatures & KERNEL_FEATURE_FILTER)
+        {
+          const int geomID = tri.geomID[i];
+          const Geometry* geometry = getGeometry(geom,geomID);
+          if (unlikely(geometry->hasOcclusionFilter8())) {
+            const avxf rcpAbsDen = rcp(absDen);
+            valid = runOcclusionFilter8(valid,geometry,ray,U*rcpAbsDen,V*rcpAbsDen,T*rcpAbsDen,Ng,geomID,tri.primID[i]);
+            if (none(valid)) continue;
+          }
+        }
 #endif
 
         /* update occlusion */
@@ -174,7 +225,7 @@ namespace embree
       return !valid0;
     }
 
-    static __forceinline avxb occluded(const avxb& valid, const Ray8& ray, const Triangle4* tri, size_t num, const void* geom)
+    static __forceinline avxb occluded(const avxb& valid, Ray8& ray, const Triangle4* tri, size_t num, const void* geom)
     {
       avxb valid0 = valid;
       for (size_t i=0; i<num; i++) {
@@ -219,8 +270,10 @@ namespace embree
 
       /* ray masking test */
 #if defined(__USE_RAY_MASK__)
-      valid &= (tri.mask & ray.mask[k]) != 0;
-      if (unlikely(none(valid))) return;
+      if (kernelFeatures & KERNEL_FEATURE_RAY_MASK) {
+        valid &= (tri.mask & ray.mask[k]) != 0;
+        if (unlikely(none(valid))) return;
+      }
 #endif
 
       /* update hit information */
@@ -228,7 +281,25 @@ namespace embree
       const ssef u = U * rcpAbsDen;
       const ssef v = V * rcpAbsDen;
       const ssef t = T * rcpAbsDen;
-      const size_t i = select_min(valid,t);
+      size_t i = select_min(valid,t);
+
+      /* intersection filter test */
+#if defined(__INTERSECTION_FILTER__)
+      if (kernelFeatures & KERNEL_FEATURE_FILTER) {
+        while (true) 
+        {
+          const int geomID = tri.geomID[i];
+          const Geometry* geometry = getGeometry(geom,geomID);
+          if (likely(!geometry->hasIntersectionFilter8())) break;
+          const Vec3fa Ng = Vec3fa(tri.Ng.x[i],tri.Ng.y[i],tri.Ng.z[i]);
+          if (runIntersectionFilter8(geometry,ray,k,u[i],v[i],t[i],Ng,geomID,tri.primID[i])) return;
+          valid[i] = 0;
+          if (none(valid)) return;
+          i = select_min(valid,t);
+        }
+      }
+#endif
+
       ray.u[k]   = u[i];
       ray.v[k]   = v[i];
       ray.tfar[k] = t[i];
@@ -281,8 +352,29 @@ namespace embree
 
       /* ray masking test */
 #if defined(__USE_RAY_MASK__)
-      valid &= (tri.mask & ray.mask[k]) != 0;
-      if (unlikely(none(valid))) return false;
+      if (kernelFeatures & KERNEL_FEATURE_RAY_MASK) {
+        valid &= (tri.mask & ray.mask[k]) != 0;
+        if (unlikely(none(valid))) return false;
+      }
+#endif
+
+      /* occlusion filter test */
+#if defined(__INTERSECTION_FILTER__)
+      if (kernelFeatures & KERNEL_FEATURE_FILTER) {
+        const ssef rcpAbsDen = rcp(absDen);
+        const ssef u = U * rcpAbsDen;
+        const ssef v = V * rcpAbsDen;
+        const ssef t = T * rcpAbsDen;
+        for (size_t m=movemask(valid), i=__bsf(m); m!=0; m=__btc(m,i), i=__bsf(m))
+        {  
+          const int geomID = tri.geomID[i];
+          const Geometry* geometry = getGeometry(geom,geomID);
+          if (likely(!geometry->hasOcclusionFilter8())) return true;
+          const Vec3fa Ng = Vec3fa(tri.Ng.x[i],tri.Ng.y[i],tri.Ng.z[i]);
+          if (runOcclusionFilter8(geometry,ray,k,u[i],v[i],t[i],Ng,geomID,tri.primID[i])) return true;
+        }
+        return false;
+      }
 #endif
       return true;
     }
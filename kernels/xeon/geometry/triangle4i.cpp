@@ -31,6 +31,20 @@ namespace embree
   size_t Triangle4iType::size(const char* This) const {
     return ((Triangle4i*)This)->size();
   }
+
+  size_t Triangle4iType::triangles(const char* This, BlockTriangle* tris) const 
+  {
+    const Triangle4i& tri = *(Triangle4i*)This;
+    const size_t num = tri.size();
+    for (size_t i=0; i<num; i++) 
+    {
+      tris[i].v0 = tri.v0[i][0];
+      tris[i].v1 = tri.v0[i][tri.v1[i]];
+      tris[i].v2 = tri.v0[i][tri.v2[i]];
+      tris[i].geomID = tri.geomID[i]; tris[i].primID = tri.primID[i];
+    }
+    return num;
+  }
   
   void Triangle4iType::pack(char* This, atomic_set<PrimRefBlock>::block_iterator_unsafe& prims, void* geom) const 
   {
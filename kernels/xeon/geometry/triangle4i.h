@@ -62,6 +62,7 @@ namespace embree
     Triangle4iType ();
     size_t blocks(size_t x) const;
     size_t size(const char* This) const;
+    size_t triangles(const char* This, BlockTriangle* tris) const;
     void pack(char* This, atomic_set<PrimRefBlock>::block_iterator_unsafe& prims, void* geom) const;
   };
 }
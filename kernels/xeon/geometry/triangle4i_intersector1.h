@@ -19,6 +19,7 @@
 
 #include "triangle4i.h"
 #include "common/ray.h"
+#include "filter.h"
 
 namespace embree
 {
@@ -85,11 +86,24 @@ namespace embree
       const ssef t = T / absDen;
       size_t i = select_min(valid,t);
 
-      /* ray masking test */
-#if defined(__USE_RAY_MASK__)
+      /* ray masking test and intersection filter test */
+#if defined(__USE_RAY_MASK__) || defined(__INTERSECTION_FILTER__)
       while (true) {
+#if defined(__USE_RAY_MASK__)
         int mask = ((Scene*)geom)->getTriangleMesh(tri.geomID[i])->mask;
-        if (mask & ray.mask) break;
+        if (mask & ray.mask)
+#endif
+        {
+#if defined(__INTERSECTION_FILTER__)
+          const int geomID = tri.geomID[i];
+          const Geometry* geometry = getGeometry(geom,geomID);
+          if (likely(!geometry->hasIntersectionFilter1())) break;
+          const Vec3fa Ng = Vec3fa(Ng2.x[i],Ng2.y[i],Ng2.z[i]);
+          if (runIntersectionFilter1(geometry,ray,u[i],v[i],t[i],Ng,geomID,tri.primID[i])) return;
+#else
+          break;
+#endif
+        }
         valid[i] = 0;
         if (none(valid)) return;
         i = select_min(valid,t);
@@ -112,7 +126,7 @@ namespace embree
         intersect(ray,tri[i],geom);
     }
 
-    static __forceinline bool occluded(const Ray& ray, const Triangle4i& tri, const void* geom)
+    static __forceinline bool occluded(Ray& ray, const Triangle4i& tri, const void* geom)
     {
       /* gather vertices */
       STAT3(shadow.trav_prims,1,1,1);
@@ -164,12 +178,23 @@ namespace embree
       if (unlikely(none(valid))) return false;
 #endif
 
-      /* ray masking test */
-#if defined(__USE_RAY_MASK__)
+      /* ray masking test and occlusion filter test */
+#if defined(__USE_RAY_MASK__) || defined(__INTERSECTION_FILTER__)
       for (size_t m=movemask(valid), i=__bsf(m); m!=0; m=__btc(m,i), i=__bsf(m))
       {  
+#if defined(__USE_RAY_MASK__)
         int mask = ((Scene*)geom)->getTriangleMesh(tri.geomID[i])->mask;
-        if (mask & ray.mask) return true;
+        if ((mask & ray.mask) == 0) continue;
+#endif
+#if defined(__INTERSECTION_FILTER__)
+        const int geomID = tri.geomID[i];
+        const Geometry* geometry = getGeometry(geom,geomID);
+        if (likely(!geometry->hasOcclusionFilter1())) return true;
+        const Vec3fa Ng = Vec3fa(Ng2.x[i],Ng2.y[i],Ng2.z[i]);
+        if (runOcclusionFilter1(geometry,ray,U[i]/absDen[i],V[i]/absDen[i],T[i]/absDen[i],Ng,geomID,tri.primID[i])) return true;
+#else
+        return true;
+#endif
       }
       return false;
 #else
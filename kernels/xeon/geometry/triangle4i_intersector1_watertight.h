@@ -0,0 +1,151 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#ifndef __EMBREE_ACCEL_TRIANGLE4I_INTERSECTOR1_WATERTIGHT_H__
+#define __EMBREE_ACCEL_TRIANGLE4I_INTERSECTOR1_WATERTIGHT_H__
+
+#include "triangle4i.h"
+#include "triangle_intersector_watertight.h"
+#include "../common/ray.h"
+#include "filter.h"
+
+namespace embree
+{
+  /*! Watertight intersector for a single ray with 4 indexed triangles. */
+  template<int kernelFeatures>
+  struct Triangle4iIntersector1Watertight
+  {
+    typedef Triangle4i Primitive;
+
+    /*! Intersect a ray with the 4 triangles and updates the hit. */
+    static __forceinline void intersect(Ray& ray, const Triangle4i& tri, void* geom)
+    {
+      /* gather vertices */
+      const ssef* base0 = (const ssef*) tri.v0[0];
+      const ssef* base1 = (const ssef*) tri.v0[1];
+      const ssef* base2 = (const ssef*) tri.v0[2];
+      const ssef* base3 = (const ssef*) tri.v0[3];
+      sse3f p0; transpose(base0[        0],base1[        0],base2[        0],base3[        0],p0.x,p0.y,p0.z);
+      sse3f p1; transpose(base0[tri.v1[0]],base1[tri.v1[1]],base2[tri.v1[2]],base3[tri.v1[3]],p1.x,p1.y,p1.z);
+      sse3f p2; transpose(base0[tri.v2[0]],base1[tri.v2[1]],base2[tri.v2[2]],base3[tri.v2[3]],p2.x,p2.y,p2.z);
+
+      /* perform watertight ray/triangle test */
+      STAT3(normal.trav_prims,1,1,1);
+      ssef u, v, t; sse3f Ng;
+      sseb valid = TriangleIntersectorWatertight::intersect(tri.valid(),sse3f(ray.org),sse3f(ray.dir),ssef(ray.tnear),ssef(ray.tfar),p0,p1,p2,u,v,t,Ng);
+      if (likely(none(valid))) return;
+
+      /* ray masking test */
+#if defined(__USE_RAY_MASK__)
+      if (kernelFeatures & KERNEL_FEATURE_RAY_MASK) {
+        for (size_t m=movemask(valid), i=__bsf(m); m!=0; m=__btc(m,i), i=__bsf(m))
+          if ((((Scene*)geom)->getTriangleMesh(tri.geomID[i])->mask & ray.mask) == 0) valid[i] = 0;
+        if (unlikely(none(valid))) return;
+      }
+#endif
+
+      /* update hit information */
+      size_t i = select_min(valid,t);
+
+      /* intersection filter test */
+#if defined(__INTERSECTION_FILTER__)
+      if (kernelFeatures & KERNEL_FEATURE_FILTER) {
+        while (true) 
+        {
+          const int geomID = tri.geomID[i];
+          const Geometry* geometry = getGeometry(geom,geomID);
+          if (likely(!geometry->hasIntersectionFilter1())) break;
+          const Vec3fa N = Vec3fa(Ng.x[i],Ng.y[i],Ng.z[i]);
+          if (runIntersectionFilter1(geometry,ray,u[i],v[i],t[i],N,geomID,tri.primID[i])) return;
+          valid[i] = 0;
+          if (none(valid)) return;
+          i = select_min(valid,t);
+        }
+      }
+#endif
+
+      ray.tfar = t[i];
+      ray.u = u[i];
+      ray.v = v[i];
+      ray.Ng.x = Ng.x[i];
+      ray.Ng.y = Ng.y[i];
+      ray.Ng.z = Ng.z[i];
+      ray.geomID = tri.geomID[i];
+      ray.primID = tri.primID[i];
+    }
+
+    static __forceinline void intersect(Ray& ray, const Triangle4i* tri, size_t num, void* geom)
+    {
+      for (size_t i=0; i<num; i++)
+        intersect(ray,tri[i],geom);
+    }
+
+    /*! Test if the ray is occluded by one of the triangles. */
+    static __forceinline bool occluded(Ray& ray, const Triangle4i& tri, void* geom)
+    {
+      /* gather vertices */
+      const ssef* base0 = (const ssef*) tri.v0[0];
+      const ssef* base1 = (const ssef*) tri.v0[1];
+      const ssef* base2 = (const ssef*) tri.v0[2];
+      const ssef* base3 = (const ssef*) tri.v0[3];
+      sse3f p0; transpose(base0[        0],base1[        0],base2[        0],base3[        0],p0.x,p0.y,p0.z);
+      sse3f p1; transpose(base0[tri.v1[0]],base1[tri.v1[1]],base2[tri.v1[2]],base3[tri.v1[3]],p1.x,p1.y,p1.z);
+      sse3f p2; transpose(base0[tri.v2[0]],base1[tri.v2[1]],base2[tri.v2[2]],base3[tri.v2[3]],p2.x,p2.y,p2.z);
+
+      /* perform watertight ray/triangle test */
+      STAT3(shadow.trav_prims,1,1,1);
+      ssef u, v, t; sse3f Ng;
+      sseb valid = TriangleIntersectorWatertight::intersect(tri.valid(),sse3f(ray.org),sse3f(ray.dir),ssef(ray.tnear),ssef(ray.tfar),p0,p1,p2,u,v,t,Ng);
+      if (likely(none(valid))) return false;
+
+      /* ray masking test */
+#if defined(__USE_RAY_MASK__)
+      if (kernelFeatures & KERNEL_FEATURE_RAY_MASK) {
+        for (size_t m=movemask(valid), i=__bsf(m); m!=0; m=__btc(m,i), i=__bsf(m))
+          if ((((Scene*)geom)->getTriangleMesh(tri.geomID[i])->mask & ray.mask) == 0) valid[i] = 0;
+        if (unlikely(none(valid))) return false;
+      }
+#endif
+
+      /* occlusion filter test */
+#if defined(__INTERSECTION_FILTER__)
+      if (kernelFeatures & KERNEL_FEATURE_FILTER) {
+        for (size_t m=movemask(valid), i=__bsf(m); m!=0; m=__btc(m,i), i=__bsf(m))
+        {  
+          const int geomID = tri.geomID[i];
+          const Geometry* geometry = getGeometry(geom,geomID);
+          if (likely(!geometry->hasOcclusionFilter1())) return true;
+          const Vec3fa N = Vec3fa(Ng.x[i],Ng.y[i],Ng.z[i]);
+          if (runOcclusionFilter1(geometry,ray,u[i],v[i],t[i],N,geomID,tri.primID[i])) return true;
+        }
+        return false;
+      }
+#endif
+      return true;
+    }
+
+    static __forceinline bool occluded(Ray& ray, const Triangle4i* tri, size_t num, void* geom) 
+    {
+      for (size_t i=0; i<num; i++) 
+        if (occluded(ray,tri[i],geom))
+          return true;
+
+      return false;
+    }
+  };
+}
+
+#endif
@@ -19,6 +19,7 @@
 
 #include "triangle4i.h"
 #include "common/ray4.h"
+#include "filter.h"
 
 namespace embree
 {
@@ -91,6 +92,18 @@ namespace embree
         if (unlikely(none(valid))) continue;
 #endif
         
+        /* intersection filter test */
+#if defined(__INTERSECTION_FILTER__)
+        {
+          const int geomID = tri.geomID[i];
+          const Geometry* geometry = getGeometry(geom,geomID);
+          if (unlikely(geometry->hasIntersectionFilter4())) {
+            runIntersectionFilter4(valid,geometry,ray,U/absDen,V/absDen,T/absDen,Ng2,geomID,tri.primID[i]);
+            continue;
+          }
+        }
+#endif
+
         /* update hit information for all rays that hit the triangle */
         ray.u   = select(valid,U / absDen,ray.u );
         ray.v   = select(valid,V / absDen,ray.v );
@@ -109,7 +122,7 @@ namespace embree
         intersect(valid,ray,tri[i],geom);
     }
     
-    static __forceinline sseb occluded(const sseb& valid_i, const Ray4& ray, const Triangle4i& tri, const void* geom)
+    static __forceinline sseb occluded(const sseb& valid_i, Ray4& ray, const Triangle4i& tri, const void* geom)
     {
       sseb valid0 = valid_i;
 
@@ -174,6 +187,18 @@ namespace embree
         if (unlikely(none(valid))) continue;
 #endif
 
+        /* occlusion filter test */
+#if defined(__INTERSECTION_FILTER__)
+        {
+          const int geomID = tri.geomID[i];
+          const Geometry* geometry = getGeometry(geom,geomID);
+          if (unlikely(geometry->hasOcclusionFilter4())) {
+            valid = runOcclusionFilter4(valid,geometry,ray,U/absDen,V/absDen,T/absDen,Ng2,geomID,tri.primID[i]);
+            if (none(valid)) continue;
+          }
+        }
+#endif
+
         /* update occlusion */
         valid0 &= !valid;
         if (none(valid0)) break;
@@ -181,7 +206,7 @@ namespace embree
       return !valid0;
     }
 
-    static __forceinline sseb occluded(const sseb& valid, const Ray4& ray, const Triangle4i* tri, size_t num, const void* geom)
+    static __forceinline sseb occluded(const sseb& valid, Ray4& ray, const Triangle4i* tri, size_t num, const void* geom)
     {
       sseb valid0 = valid;
       for (size_t i=0; i<num; i++) {
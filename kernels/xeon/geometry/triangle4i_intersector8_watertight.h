@@ -0,0 +1,150 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#ifndef __EMBREE_ACCEL_TRIANGLE4I_INTERSECTOR8_WATERTIGHT_H__
+#define __EMBREE_ACCEL_TRIANGLE4I_INTERSECTOR8_WATERTIGHT_H__
+
+#include "triangle4i.h"
+#include "triangle_intersector_watertight.h"
+#include "../common/ray8.h"
+#include "filter.h"
+
+namespace embree
+{
+  /*! Watertight intersector for 8 rays with 4 indexed triangles. */
+  template<int kernelFeatures>
+  struct Triangle4iIntersector8Watertight
+  {
+    typedef Triangle4i Primitive;
+
+    /*! Intersects 8 rays with 4 triangles. */
+    static __forceinline void intersect(const avxb& valid_i, Ray8& ray, const Triangle4i& tri, void* geom)
+    {
+      for (size_t i=0; i<tri.size(); i++)
+      {
+        STAT3(normal.trav_prims,1,popcnt(valid_i),8);
+
+        /* load vertices */
+        const Vec3fa* base = tri.v0[i];
+        const avx3f p0 = avx3f(base[0]);
+        const avx3f p1 = avx3f(base[tri.v1[i]]);
+        const avx3f p2 = avx3f(base[tri.v2[i]]);
+
+        /* perform watertight ray/triangle test */
+        avxf u, v, t; avx3f Ng;
+        avxb valid = TriangleIntersectorWatertight::intersect(valid_i,ray.org,ray.dir,ray.tnear,ray.tfar,p0,p1,p2,u,v,t,Ng);
+        if (likely(none(valid))) continue;
+
+        /* ray masking test */
+#if defined(__USE_RAY_MASK__)
+        if (kernelFeatures & KERNEL_FEATURE_RAY_MASK) {
+          valid &= (((Scene*)geom)->getTriangleMesh(tri.geomID[i])->mask & ray.mask) != 0;
+          if (unlikely(none(valid))) continue;
+        }
+#endif
+
+        /* intersection filter test */
+#if defined(__INTERSECTION_FILTER__)
+        if (kernelFeatures & KERNEL_FEATURE_FILTER)
+        {
+          const int geomID = tri.geomID[i];
+          const Geometry* geometry = getGeometry(geom,geomID);
+          if (unlikely(geometry->hasIntersectionFilter8())) {
+            runIntersectionFilter8(valid,geometry,ray,u,v,t,Ng,geomID,tri.primID[i]);
+            continue;
+          }
+        }
+#endif
+
+        /* update hit information for all rays that hit the triangle */
+        ray.u = select(valid,u,ray.u);
+        ray.v = select(valid,v,ray.v);
+        ray.tfar = select(valid,t,ray.tfar);
+        ray.geomID = select(valid,tri.geomID[i],ray.geomID);
+        ray.primID = select(valid,tri.primID[i],ray.primID);
+        ray.Ng.x = select(valid,Ng.x,ray.Ng.x);
+        ray.Ng.y = select(valid,Ng.y,ray.Ng.y);
+        ray.Ng.z = select(valid,Ng.z,ray.Ng.z);
+      }
+    }
+
+    static __forceinline void intersect(const avxb& valid, Ray8& ray, const Triangle4i* tri, size_t num, void* geom)
+    {
+      for (size_t i=0; i<num; i++)
+        intersect(valid,ray,tri[i],geom);
+    }
+
+    /*! Test for 8 rays if they are occluded by any of the 4 triangles. */
+    static __forceinline avxb occluded(const avxb& valid_i, Ray8& ray, const Triangle4i& tri, void* geom)
+    {
+      avxb valid0 = valid_i;
+
+      for (size_t i=0; i<tri.size(); i++)
+      {
+        STAT3(shadow.trav_prims,1,popcnt(valid0),8);
+
+        /* load vertices */
+        const Vec3fa* base = tri.v0[i];
+        const avx3f p0 = avx3f(base[0]);
+        const avx3f p1 = avx3f(base[tri.v1[i]]);
+        const avx3f p2 = avx3f(base[tri.v2[i]]);
+
+        /* perform watertight ray/triangle test */
+        avxf u, v, t; avx3f Ng;
+        avxb valid = TriangleIntersectorWatertight::intersect(valid0,ray.org,ray.dir,ray.tnear,ray.tfar,p0,p1,p2,u,v,t,Ng);
+        if (likely(none(valid))) continue;
+
+        /* ray masking test */
+#if defined(__USE_RAY_MASK__)
+        if (kernelFeatures & KERNEL_FEATURE_RAY_MASK) {
+          valid &= (((Scene*)geom)->getTriangleMesh(tri.geomID[i])->mask & ray.mask) != 0;
+          if (unlikely(none(valid))) continue;
+        }
+#endif
+
+        /* occlusion filter test */
+#if defined(__INTERSECTION_FILTER__)
+        if (kernelFeatures & KERNEL_FEATURE_FILTER)
+        {
+          const int geomID = tri.geomID[i];
+          const Geometry* geometry = getGeometry(geom,geomID);
+          if (unlikely(geometry->hasOcclusionFilter8())) {
+            valid = runOcclusionFilter8(valid,geometry,ray,u,v,t,Ng,geomID,tri.primID[i]);
+            if (none(valid)) continue;
+          }
+        }
+#endif
+
+        /* update occlusion */
+        valid0 &= !valid;
+        if (none(valid0)) break;
+      }
+      return !valid0;
+    }
+
+    static __forceinline avxb occluded(const avxb& valid, Ray8& ray, const Triangle4i* tri, size_t num, void* geom)
+    {
+      avxb valid0 = valid;
+      for (size_t i=0; i<num; i++) {
+        valid0 &= !occluded(valid0,ray,tri[i],geom);
+        if (none(valid0)) break;
+      }
+      return !valid0;
+    }
+  };
+}
+
+#endif
@@ -0,0 +1,90 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "triangle4q.h"
+#include "common/scene.h"
+
+namespace embree
+{
+  SceneTriangle4q SceneTriangle4q::type;
+
+  Triangle4qType::Triangle4qType () 
+  : PrimitiveType("triangle4q",sizeof(Triangle4q),4,false,1) {} 
+  
+  size_t Triangle4qType::blocks(size_t x) const {
+    return (x+3)/4;
+  }
+  
+  size_t Triangle4qType::size(const char* This) const {
+    return ((Triangle4q*)This)->size();
+  }
+
+  size_t Triangle4qType::triangles(const char* This, BlockTriangle* tris) const 
+  {
+    const Triangle4q& tri = *(Triangle4q*)This;
+    const sse3f v0 = tri.vertex(0), v1 = tri.vertex(1), v2 = tri.vertex(2);
+    const size_t num = tri.size();
+    for (size_t i=0; i<num; i++) 
+    {
+      tris[i].v0 = Vec3fa(v0.x[i],v0.y[i],v0.z[i]);
+      tris[i].v1 = Vec3fa(v1.x[i],v1.y[i],v1.z[i]);
+      tris[i].v2 = Vec3fa(v2.x[i],v2.y[i],v2.z[i]);
+      tris[i].geomID = tri.geomID; tris[i].primID = tri.primID(i);
+    }
+    return num;
+  }
+
+  size_t SceneTriangle4q::leafBlocks(atomic_set<PrimRefBlock>& prims, size_t num, void* geom) const
+  {
+    Triangle4q tri;
+    atomic_set<PrimRefBlock>::block_iterator_unsafe iter(prims);
+    size_t blocks = 0;
+    for (; iter; blocks++) 
+      pack((char*)&tri,iter,geom);
+    return blocks;
+  }
+
+  void SceneTriangle4q::pack(char* This, atomic_set<PrimRefBlock>::block_iterator_unsafe& prims, void* geom) const 
+  {
+    Scene* scene = (Scene*) geom;
+    
+    /* a block ends early at a triangle of another geometry or out of the primitive ID range */
+    int geomID = -1, mask = -1;
+    ssei primID = -1;
+    sse3f v0 = zero, v1 = zero, v2 = zero;
+    
+    size_t num = 0;
+    for (; num<4 && prims; num++, prims++)
+    {
+      const PrimRef& prim = *prims;
+      if (num > 0 && (prim.geomID() != geomID || !Triangle4q::inRange(primID[0],prim.primID()))) 
+        break;
+
+      const TriangleMeshScene::TriangleMesh* mesh = scene->getTriangleMesh(prim.geomID());
+      const TriangleMeshScene::TriangleMesh::Triangle& tri = mesh->triangle(prim.primID());
+      const Vec3fa& p0 = mesh->vertex(tri.v[0]);
+      const Vec3fa& p1 = mesh->vertex(tri.v[1]);
+      const Vec3fa& p2 = mesh->vertex(tri.v[2]);
+      geomID = prim.geomID();
+      primID[num] = prim.primID();
+      mask = mesh->mask;
+      v0.x[num] = p0.x; v0.y[num] = p0.y; v0.z[num] = p0.z;
+      v1.x[num] = p1.x; v1.y[num] = p1.y; v1.z[num] = p1.z;
+      v2.x[num] = p2.x; v2.y[num] = p2.y; v2.z[num] = p2.z;
+    }
+    new (This) Triangle4q(v0,v1,v2,geomID,primID,num,mask);
+  }
+}
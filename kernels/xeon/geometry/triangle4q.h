@@ -0,0 +1,163 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#ifndef __EMBREE_ACCEL_TRIANGLE4Q_H__
+#define __EMBREE_ACCEL_TRIANGLE4Q_H__
+
+#include "primitive.h"
+
+namespace embree
+{
+  /*! Stores the vertices of 4 triangles quantized to 16 bit fixed
+   *  point relative to the bounds of the triangles. The decoded
+   *  vertices differ from the original vertices by at most err, which
+   *  the intersectors use to conservatively expand the triangles. All
+   *  triangles of a block belong to the same geometry and store their
+   *  primitive IDs as 16 bit offsets to the first one, which shrinks
+   *  the block to 128 bytes. */
+  struct __align(16) Triangle4q
+  {
+  public:
+
+    /*! Default constructor. */
+    __forceinline Triangle4q () {}
+
+    /*! Construction from vertices and IDs of num triangles of the same geometry. */
+    __forceinline Triangle4q (const sse3f& v0, const sse3f& v1, const sse3f& v2, int geomID, const ssei& primID, size_t num, int mask)
+      : geomID(geomID), primBase(primID[0]), num((unsigned char)num)
+    {
+#if defined(__USE_RAY_MASK__)
+      this->mask = mask;
+#endif
+      for (size_t i=0; i<4; i++)
+        primOffset[i] = i < num ? (short) (primID[i]-primBase) : 0;
+
+      /* calculate quantization grid over all valid triangles */
+      const sseb valid = this->valid();
+      sse3f vlower = min(v0,v1,v2);
+      sse3f vupper = max(v0,v1,v2);
+      vlower.x = select(valid,vlower.x,ssef(pos_inf));
+      vlower.y = select(valid,vlower.y,ssef(pos_inf));
+      vlower.z = select(valid,vlower.z,ssef(pos_inf));
+      vupper.x = select(valid,vupper.x,ssef(neg_inf));
+      vupper.y = select(valid,vupper.y,ssef(neg_inf));
+      vupper.z = select(valid,vupper.z,ssef(neg_inf));
+      const Vec3fa lo(reduce_min(vlower.x),reduce_min(vlower.y),reduce_min(vlower.z));
+      const Vec3fa hi(reduce_max(vupper.x),reduce_max(vupper.y),reduce_max(vupper.z));
+      const Vec3fa scale = max(hi-lo,Vec3fa(zero))*(1.0f/65535.0f);
+      this->lower = Vec3f(lo.x,lo.y,lo.z);
+      this->scale = Vec3f(scale.x,scale.y,scale.z);
+
+      /* half a grid cell plus rounding of the decoding */
+      const float maxAbs = max(reduce_max(abs(lo)),reduce_max(abs(hi)));
+      this->err = 0.5f*length(scale) + 4.0f*float(ulp)*maxAbs;
+
+      encode(0,v0,valid);
+      encode(1,v1,valid);
+      encode(2,v2,valid);
+    }
+
+    /*! Tests if a triangle with the primitive ID fits into the ID
+     *  range of a block whose first triangle has ID primBase. */
+    static __forceinline bool inRange(int primBase, int primID) {
+      return primID-primBase >= -32768 && primID-primBase <= 32767;
+    }
+
+    /*! Returns a mask that tells which triangles are valid. */
+    __forceinline sseb valid() const { return ssei(step) < ssei(int(num)); }
+
+    /*! Returns the number of stored triangles. */
+    __forceinline size_t size() const { return num; }
+
+    /*! Returns the primitive ID of the i-th triangle. */
+    __forceinline int primID(size_t i) const { return primBase + primOffset[i]; }
+
+    /*! Decodes the k-th vertex of the triangles. */
+    __forceinline sse3f vertex(size_t k) const {
+      return sse3f(ssef(lower.x) + decode(q[k][0])*ssef(scale.x),
+                   ssef(lower.y) + decode(q[k][1])*ssef(scale.y),
+                   ssef(lower.z) + decode(q[k][2])*ssef(scale.z));
+    }
+
+    /*! calculate the bounds of the triangle */
+    __forceinline BBox3f bounds() const 
+    {
+      const sse3f v0 = vertex(0), v1 = vertex(1), v2 = vertex(2);
+      sse3f lower = min(v0,v1,v2);
+      sse3f upper = max(v0,v1,v2);
+      sseb mask = valid();
+      lower.x = select(mask,lower.x,ssef(pos_inf));
+      lower.y = select(mask,lower.y,ssef(pos_inf));
+      lower.z = select(mask,lower.z,ssef(pos_inf));
+      upper.x = select(mask,upper.x,ssef(neg_inf));
+      upper.y = select(mask,upper.y,ssef(neg_inf));
+      upper.z = select(mask,upper.z,ssef(neg_inf));
+      return BBox3f(Vec3fa(reduce_min(lower.x),reduce_min(lower.y),reduce_min(lower.z)),
+                    Vec3fa(reduce_max(upper.x),reduce_max(upper.y),reduce_max(upper.z)));
+    }
+
+  private:
+
+    /*! converts 4 unsigned 16 bit values to float */
+    static __forceinline ssef decode(const unsigned short* q) {
+      return ssef(_mm_unpacklo_epi16(_mm_loadl_epi64((__m128i*)q),_mm_setzero_si128()));
+    }
+
+    /*! rounds the k-th vertex of the triangles to the quantization grid */
+    __forceinline void encode(size_t k, const sse3f& v, const sseb& valid)
+    {
+      for (size_t i=0; i<4; i++) {
+        q[k][0][i] = valid[i] ? quantize(v.x[i],lower.x,scale.x) : 0;
+        q[k][1][i] = valid[i] ? quantize(v.y[i],lower.y,scale.y) : 0;
+        q[k][2][i] = valid[i] ? quantize(v.z[i],lower.z,scale.z) : 0;
+      }
+    }
+
+    static __forceinline unsigned short quantize(float x, float lower, float scale) {
+      if (scale == 0.0f) return 0;
+      return (unsigned short) clamp(int((x-lower)/scale+0.5f),0,65535);
+    }
+
+  public:
+    int geomID;          //!< user geometry ID of all triangles
+    int primBase;        //!< primitive ID of the first triangle
+    short primOffset[4]; //!< primitive IDs relative to primBase
+    Vec3f lower;         //!< origin of the quantization grid
+    float err;           //!< maximal distance of decoded to original vertices
+    Vec3f scale;         //!< size of a grid cell
+#if defined(__USE_RAY_MASK__)
+    int mask;            //!< geometry mask
+#endif
+    unsigned short q[3][3][4]; //!< quantized vertices, indexed by vertex, dimension, and triangle
+    unsigned char num;   //!< number of stored triangles
+  };
+
+  struct Triangle4qType : public PrimitiveType {
+    Triangle4qType ();
+    size_t blocks(size_t x) const;
+    size_t size(const char* This) const;
+    size_t triangles(const char* This, BlockTriangle* tris) const;
+  };
+
+  struct SceneTriangle4q : public Triangle4qType
+  {
+    static SceneTriangle4q type;
+    size_t leafBlocks(atomic_set<PrimRefBlock>& prims, size_t num, void* geom) const;
+    void pack(char* This, atomic_set<PrimRefBlock>::block_iterator_unsafe& prims, void* geom) const;
+  };
+}
+
+#endif
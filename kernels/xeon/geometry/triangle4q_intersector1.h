@@ -0,0 +1,212 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#ifndef __EMBREE_ACCEL_TRIANGLE4Q_INTERSECTOR1_H__
+#define __EMBREE_ACCEL_TRIANGLE4Q_INTERSECTOR1_H__
+
+#include "triangle4q.h"
+#include "../common/ray.h"
+#include "filter.h"
+
+namespace embree
+{
+  /*! Pluecker intersector for a single ray with 4 quantized triangles. The
+   *  triangles are expanded by the quantization error, such that rays
+   *  that hit the original triangles never miss. */
+  struct Triangle4qIntersector1
+  {
+    typedef Triangle4q Primitive;
+
+    /*! Intersect a ray with the 4 triangles and updates the hit. */
+    static __forceinline void intersect(Ray& ray, const Triangle4q& tri, void* geom)
+    {
+      /* ray masking test, all triangles share the mask of their geometry */
+#if defined(__USE_RAY_MASK__)
+      if (unlikely((tri.mask & ray.mask) == 0)) return;
+#endif
+
+      /* calculate vertices relative to ray origin */
+      STAT3(normal.trav_prims,1,1,1);
+      const sse3f O = sse3f(ray.org);
+      const sse3f D = sse3f(ray.dir);
+      const sse3f v0 = tri.vertex(0)-O;
+      const sse3f v1 = tri.vertex(1)-O;
+      const sse3f v2 = tri.vertex(2)-O;
+
+      /* calculate triangle edges */
+      const sse3f e0 = v2-v0;
+      const sse3f e1 = v0-v1;
+      const sse3f e2 = v1-v2;
+
+      /* calculate geometry normal and denominator */
+      const sse3f Ng = cross(e1,e0);
+      const sse3f Ng2 = Ng+Ng;
+      const ssef den = dot(Ng2,D);
+      const ssef absDen = abs(den);
+      const ssef sgnDen = signmsk(den);
+
+      /* expand edges by the quantization error */
+      const ssef tol = ssef(tri.err)*absDen*rsqrt(dot(Ng,Ng));
+      const ssef tolU = tol*sqrt(dot(e0,e0));
+      const ssef tolV = tol*sqrt(dot(e1,e1));
+      const ssef tolW = tol*sqrt(dot(e2,e2));
+
+      /* perform edge tests */
+      const ssef U = dot(cross(v2+v0,e0),D) ^ sgnDen;
+      const ssef V = dot(cross(v0+v1,e1),D) ^ sgnDen;
+      const ssef W = dot(cross(v1+v2,e2),D) ^ sgnDen;
+      sseb valid = (U >= -tolU) & (V >= -tolV) & (W >= -tolW);
+      if (unlikely(none(valid))) return;
+
+      /* perform depth test */
+      const ssef T = dot(v0,Ng2) ^ sgnDen;
+      valid &= (T >= absDen*ssef(ray.tnear)) & (absDen*ssef(ray.tfar) >= T);
+      if (unlikely(none(valid))) return;
+
+        /* perform backface culling */
+#if defined(__BACKFACE_CULLING__)
+      valid &= den > ssef(zero);
+      if (unlikely(none(valid))) return;
+#else
+      valid &= den != ssef(zero);
+      if (unlikely(none(valid))) return;
+#endif
+
+      /* update hit information */
+      const ssef u = U / absDen;
+      const ssef v = V / absDen;
+      const ssef t = T / absDen;
+      size_t i = select_min(valid,t);
+
+      /* intersection filter test */
+#if defined(__INTERSECTION_FILTER__)
+      while (true) 
+      {
+        const int geomID = tri.geomID;
+        const Geometry* geometry = getGeometry(geom,geomID);
+        if (likely(!geometry->hasIntersectionFilter1())) break;
+        const Vec3fa Ng = Vec3fa(Ng2.x[i],Ng2.y[i],Ng2.z[i]);
+        if (runIntersectionFilter1(geometry,ray,u[i],v[i],t[i],Ng,geomID,tri.primID(i))) return;
+        valid[i] = 0;
+        if (none(valid)) return;
+        i = select_min(valid,t);
+      }
+#endif
+
+      ray.tfar = t[i];
+      ray.u = u[i];
+      ray.v = v[i];
+      ray.Ng.x = Ng2.x[i];
+      ray.Ng.y = Ng2.y[i];
+      ray.Ng.z = Ng2.z[i];
+      ray.geomID = tri.geomID;
+      ray.primID = tri.primID(i);
+    }
+
+    static __forceinline void intersect(Ray& ray, const Triangle4q* tri, size_t num, void* geom)
+    {
+      for (size_t i=0; i<num; i++)
+        intersect(ray,tri[i],geom);
+    }
+
+    /*! Test if the ray is occluded by one of the triangles. */
+    static __forceinline bool occluded(Ray& ray, const Triangle4q& tri, void* geom)
+    {
+      /* ray masking test, all triangles share the mask of their geometry */
+#if defined(__USE_RAY_MASK__)
+      if (unlikely((tri.mask & ray.mask) == 0)) return false;
+#endif
+
+      /* calculate vertices relative to ray origin */
+      STAT3(shadow.trav_prims,1,1,1);
+      const sse3f O = sse3f(ray.org);
+      const sse3f D = sse3f(ray.dir);
+      const sse3f v0 = tri.vertex(0)-O;
+      const sse3f v1 = tri.vertex(1)-O;
+      const sse3f v2 = tri.vertex(2)-O;
+
+      /* calculate triangle edges */
+      const sse3f e0 = v2-v0;
+      const sse3f e1 = v0-v1;
+      const sse3f e2 = v1-v2;
+
+      /* calculate geometry normal and denominator */
+      const sse3f Ng = cross(e1,e0);
+      const sse3f Ng2 = Ng+Ng;
+      const ssef den = dot(Ng2,D);
+      const ssef absDen = abs(den);
+      const ssef sgnDen = signmsk(den);
+
+      /* expand edges by the quantization error */
+      const ssef tol = ssef(tri.err)*absDen*rsqrt(dot(Ng,Ng));
+      const ssef tolU = tol*sqrt(dot(e0,e0));
+      const ssef tolV = tol*sqrt(dot(e1,e1));
+      const ssef tolW = tol*sqrt(dot(e2,e2));
+
+      /* perform edge tests */
+      const ssef U = dot(cross(v2+v0,e0),D) ^ sgnDen;
+      const ssef V = dot(cross(v0+v1,e1),D) ^ sgnDen;
+      const ssef W = dot(cross(v1+v2,e2),D) ^ sgnDen;
+      sseb valid = (U >= -tolU) & (V >= -tolV) & (W >= -tolW);
+      if (unlikely(none(valid))) return false;
+      
+      /* perform depth test */
+      const ssef T = dot(v0,Ng2) ^ sgnDen;
+      valid &= (T >= absDen*ssef(ray.tnear)) & (absDen*ssef(ray.tfar) >= T);
+      if (unlikely(none(valid))) return false;
+
+      /* perform backface culling */
+#if defined(__BACKFACE_CULLING__)
+      valid &= den > ssef(zero);
+      if (unlikely(none(valid))) return false;
+#else
+      valid &= den != ssef(zero);
+      if (unlikely(none(valid))) return false;
+#endif
+
+      /* occlusion filter test */
+#if defined(__INTERSECTION_FILTER__)
+      const ssef u = U / absDen;
+      const ssef v = V / absDen;
+      const ssef t = T / absDen;
+      for (size_t m=movemask(valid), i=__bsf(m); m!=0; m=__btc(m,i), i=__bsf(m))
+      {  
+        const int geomID = tri.geomID;
+        const Geometry* geometry = getGeometry(geom,geomID);
+        if (likely(!geometry->hasOcclusionFilter1())) return true;
+        const Vec3fa Ng = Vec3fa(Ng2.x[i],Ng2.y[i],Ng2.z[i]);
+        if (runOcclusionFilter1(geometry,ray,u[i],v[i],t[i],Ng,geomID,tri.primID(i))) return true;
+      }
+      return false;
+#else
+      return true;
+#endif
+    }
+
+    static __forceinline bool occluded(Ray& ray, const Triangle4q* tri, size_t num, void* geom) 
+    {
+      for (size_t i=0; i<num; i++) 
+        if (occluded(ray,tri[i],geom))
+          return true;
+
+      return false;
+    }
+  };
+}
+
+#endif
+
+
@@ -0,0 +1,236 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#ifndef __EMBREE_ACCEL_TRIANGLE4Q_INTERSECTOR4_H__
+#define __EMBREE_ACCEL_TRIANGLE4Q_INTERSECTOR4_H__
+
+#include "triangle4q.h"
+#include "../common/ray4.h"
+#include "filter.h"
+
+namespace embree
+{
+  /*! Pluecker intersector for 4 rays with 4 quantized triangles. The
+   *  triangles are expanded by the quantization error, such that rays
+   *  that hit the original triangles never miss. */
+  struct Triangle4qIntersector4
+  {
+    typedef Triangle4q Primitive;
+
+    /*! Intersects a 4 rays with 4 triangles. */
+    static __forceinline void intersect(const sseb& valid_i, Ray4& ray, const Triangle4q& tri, void* geom)
+    {
+      /* decode quantized vertices */
+      const sse3f p0 = tri.vertex(0);
+      const sse3f p1 = tri.vertex(1);
+      const sse3f p2 = tri.vertex(2);
+
+      for (size_t i=0; i<tri.size(); i++)
+      {
+        STAT3(normal.trav_prims,1,popcnt(valid_i),4);
+
+        /* calculate vertices relative to ray origin */
+        sseb valid = valid_i;
+        const sse3f O = ray.org;
+        const sse3f D = ray.dir;
+        const sse3f v0 = broadcast4f(p0,i)-O;
+        const sse3f v1 = broadcast4f(p1,i)-O;
+        const sse3f v2 = broadcast4f(p2,i)-O;
+        
+        /* calculate triangle edges */
+        const sse3f e0 = v2-v0;
+        const sse3f e1 = v0-v1;
+        const sse3f e2 = v1-v2;
+        
+        /* calculate geometry normal and denominator */
+        const sse3f Ng = cross(e1,e0);
+        const sse3f Ng2 = Ng+Ng;
+        const ssef den = dot(sse3f(Ng2),D);
+        const ssef absDen = abs(den);
+        const ssef sgnDen = signmsk(den);
+
+        /* expand edges by the quantization error */
+        const ssef tol = ssef(tri.err)*absDen*rsqrt(dot(Ng,Ng));
+        const ssef tolU = tol*sqrt(dot(e0,e0));
+        const ssef tolV = tol*sqrt(dot(e1,e1));
+        const ssef tolW = tol*sqrt(dot(e2,e2));
+        
+        /* perform edge tests */
+        const ssef U = dot(sse3f(cross(v2+v0,e0)),D) ^ sgnDen;
+        valid &= U >= -tolU;
+        if (likely(none(valid))) continue;
+        const ssef V = dot(sse3f(cross(v0+v1,e1)),D) ^ sgnDen;
+        valid &= V >= -tolV;
+        if (likely(none(valid))) continue;
+        const ssef W = dot(sse3f(cross(v1+v2,e2)),D) ^ sgnDen;
+        valid &= W >= -tolW;
+        if (likely(none(valid))) continue;
+        
+        /* perform depth test */
+        const ssef T = dot(v0,sse3f(Ng2)) ^ sgnDen;
+        valid &= (T >= absDen*ray.tnear) & (absDen*ray.tfar >= T);
+        if (unlikely(none(valid))) continue;
+
+        /* perform backface culling */
+#if defined(__BACKFACE_CULLING__)
+        valid &= den > ssef(zero);
+        if (unlikely(none(valid))) continue;
+#else
+        valid &= den != ssef(zero);
+        if (unlikely(none(valid))) continue;
+#endif
+
+        /* ray masking test */
+#if defined(__USE_RAY_MASK__)
+        valid &= (tri.mask & ray.mask) != 0;
+        if (unlikely(none(valid))) continue;
+#endif
+        
+        /* intersection filter test */
+#if defined(__INTERSECTION_FILTER__)
+        {
+          const int geomID = tri.geomID;
+          const Geometry* geometry = getGeometry(geom,geomID);
+          if (unlikely(geometry->hasIntersectionFilter4())) {
+            runIntersectionFilter4(valid,geometry,ray,U/absDen,V/absDen,T/absDen,Ng2,geomID,tri.primID(i));
+            continue;
+          }
+        }
+#endif
+
+        /* update hit information for all rays that hit the triangle */
+        ray.u   = select(valid,U / absDen,ray.u );
+        ray.v   = select(valid,V / absDen,ray.v );
+        ray.tfar = select(valid,T / absDen,ray.tfar );
+        ray.geomID = select(valid,tri.geomID,ray.geomID);
+        ray.primID = select(valid,tri.primID(i),ray.primID);
+        ray.Ng.x = select(valid,Ng2.x,ray.Ng.x);
+        ray.Ng.y = select(valid,Ng2.y,ray.Ng.y);
+        ray.Ng.z = select(valid,Ng2.z,ray.Ng.z);
+      }
+    }
+
+    static __forceinline void intersect(const sseb& valid, Ray4& ray, const Triangle4q* tri, size_t num, void* geom)
+    {
+      for (size_t i=0; i<num; i++) {
+        intersect(valid,ray,tri[i],geom);
+      }
+    }
+
+    /*! Test for 4 rays if they are occluded by any of the 4 triangle. */
+    static __forceinline sseb occluded(const sseb& valid_i, Ray4& ray, const Triangle4q& tri, void* geom)
+    {
+      sseb valid0 = valid_i;
+
+      /* decode quantized vertices */
+      const sse3f p0 = tri.vertex(0);
+      const sse3f p1 = tri.vertex(1);
+      const sse3f p2 = tri.vertex(2);
+
+      for (size_t i=0; i<tri.size(); i++)
+      {
+        STAT3(shadow.trav_prims,1,popcnt(valid_i),4);
+
+        /* calculate vertices relative to ray origin */
+        sseb valid = valid0;
+        const sse3f O = ray.org;
+        const sse3f D = ray.dir;
+        const sse3f v0 = broadcast4f(p0,i)-O;
+        const sse3f v1 = broadcast4f(p1,i)-O;
+        const sse3f v2 = broadcast4f(p2,i)-O;
+
+        /* calculate triangle edges */
+        const sse3f e0 = v2-v0;
+        const sse3f e1 = v0-v1;
+        const sse3f e2 = v1-v2;
+        
+        /* calculate geometry normal and denominator */
+        const sse3f Ng = cross(e1,e0);
+        const sse3f Ng2 = Ng+Ng;
+        const ssef den = dot(sse3f(Ng2),D);
+        const ssef absDen = abs(den);
+        const ssef sgnDen = signmsk(den);
+
+        /* expand edges by the quantization error */
+        const ssef tol = ssef(tri.err)*absDen*rsqrt(dot(Ng,Ng));
+        const ssef tolU = tol*sqrt(dot(e0,e0));
+        const ssef tolV = tol*sqrt(dot(e1,e1));
+        const ssef tolW = tol*sqrt(dot(e2,e2));
+        
+        /* perform edge tests */
+        const ssef U = dot(sse3f(cross(v2+v0,e0)),D) ^ sgnDen;
+        valid &= U >= -tolU;
+        if (likely(none(valid))) continue;
+        const ssef V = dot(sse3f(cross(v0+v1,e1)),D) ^ sgnDen;
+        valid &= V >= -tolV;
+        if (likely(none(valid))) continue;
+        const ssef W = dot(sse3f(cross(v1+v2,e2)),D) ^ sgnDen;
+        valid &= W >= -tolW;
+        if (likely(none(valid))) continue;
+        
+        /* perform depth test */
+        const ssef T = dot(v0,sse3f(Ng2)) ^ sgnDen;
+        valid &= (T >= absDen*ray.tnear) & (absDen*ray.tfar >= T);
+
+        /* perform backface culling */
+#if defined(__BACKFACE_CULLING__)
+        valid &= den > ssef(zero);
+        if (unlikely(none(valid))) continue;
+#else
+        valid &= den != ssef(zero);
+        if (unlikely(none(valid))) continue;
+#endif
+
+        /* ray masking test */
+#if defined(__USE_RAY_MASK__)
+        valid &= (tri.mask & ray.mask) != 0;
+        if (unlikely(none(valid))) continue;
+#endif
+
+        /* occlusion filter test */
+#if defined(__INTERSECTION_FILTER__)
+        {
+          const int geomID = tri.geomID;
+          const Geometry* geometry = getGeometry(geom,geomID);
+          if (unlikely(geometry->hasOcclusionFilter4())) {
+            valid = runOcclusionFilter4(valid,geometry,ray,U/absDen,V/absDen,T/absDen,Ng2,geomID,tri.primID(i));
+            if (none(valid)) continue;
+          }
+        }
+#endif
+
+        /* update occlusion */
+        valid0 &= !valid;
+        if (none(valid0)) break;
+      }
+      return !valid0;
+    }
+
+    static __forceinline sseb occluded(const sseb& valid, Ray4& ray, const Triangle4q* tri, size_t num, void* geom)
+    {
+      sseb valid0 = valid;
+      for (size_t i=0; i<num; i++) {
+        valid0 &= !occluded(valid0,ray,tri[i],geom);
+        if (none(valid0)) break;
+      }
+      return !valid0;
+    }
+  };
+}
+
+#endif
+
+
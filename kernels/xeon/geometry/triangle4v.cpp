@@ -33,6 +33,20 @@ namespace embree
     return ((Triangle4v*)This)->size();
   }
 
+  size_t Triangle4vType::triangles(const char* This, BlockTriangle* tris) const 
+  {
+    const Triangle4v& tri = *(Triangle4v*)This;
+    const size_t num = tri.size();
+    for (size_t i=0; i<num; i++) 
+    {
+      tris[i].v0 = Vec3fa(tri.v0.x[i],tri.v0.y[i],tri.v0.z[i]);
+      tris[i].v1 = Vec3fa(tri.v1.x[i],tri.v1.y[i],tri.v1.z[i]);
+      tris[i].v2 = Vec3fa(tri.v2.x[i],tri.v2.y[i],tri.v2.z[i]);
+      tris[i].geomID = tri.geomID[i]; tris[i].primID = tri.primID[i];
+    }
+    return num;
+  }
+
   void SceneTriangle4v::pack(char* This, atomic_set<PrimRefBlock>::block_iterator_unsafe& prims, void* geom) const 
   {
     Scene* scene = (Scene*) geom;
@@ -96,6 +96,7 @@ namespace embree
     Triangle4vType ();
     size_t blocks(size_t x) const;
     size_t size(const char* This) const;
+    size_t triangles(const char* This, BlockTriangle* tris) const;
   };
 
   struct SceneTriangle4v : public Triangle4vType
@@ -19,6 +19,7 @@
 
 #include "triangle4v.h"
 #include "../common/ray.h"
+#include "filter.h"
 
 namespace embree
 {
@@ -80,7 +81,23 @@ namespace embree
       const ssef u = U / absDen;
       const ssef v = V / absDen;
       const ssef t = T / absDen;
-      const size_t i = select_min(valid,t);
+      size_t i = select_min(valid,t);
+
+      /* intersection filter test */
+#if defined(__INTERSECTION_FILTER__)
+      while (true) 
+      {
+        const int geomID = tri.geomID[i];
+        const Geometry* geometry = getGeometry(geom,geomID);
+        if (likely(!geometry->hasIntersectionFilter1())) break;
+        const Vec3fa Ng = Vec3fa(Ng2.x[i],Ng2.y[i],Ng2.z[i]);
+        if (runIntersectionFilter1(geometry,ray,u[i],v[i],t[i],Ng,geomID,tri.primID[i])) return;
+        valid[i] = 0;
+        if (none(valid)) return;
+        i = select_min(valid,t);
+      }
+#endif
+
       ray.tfar = t[i];
       ray.u = u[i];
       ray.v = v[i];
@@ -147,7 +164,23 @@ namespace embree
       if (unlikely(none(valid))) return false;
 #endif
 
+      /* occlusion filter test */
+#if defined(__INTERSECTION_FILTER__)
+      const ssef u = U / absDen;
+      const ssef v = V / absDen;
+      const ssef t = T / absDen;
+      for (size_t m=movemask(valid), i=__bsf(m); m!=0; m=__btc(m,i), i=__bsf(m))
+      {  
+        const int geomID = tri.geomID[i];
+        const Geometry* geometry = getGeometry(geom,geomID);
+        if (likely(!geometry->hasOcclusionFilter1())) return true;
+        const Vec3fa Ng = Vec3fa(Ng2.x[i],Ng2.y[i],Ng2.z[i]);
+        if (runOcclusionFilter1(geometry,ray,u[i],v[i],t[i],Ng,geomID,tri.primID[i])) return true;
+      }
+      return false;
+#else
       return true;
+#endif
     }
 
     static __forceinline bool occluded(Ray& ray, const Triangle4v* tri, size_t num, void* geom) 
@@ -19,6 +19,7 @@
 
 #include "triangle4v.h"
 #include "../common/ray8.h"
+#include "filter.h"
 
 namespace embree
 {
@@ -84,6 +85,18 @@ namespace embree
         if (unlikely(none(valid))) continue;
 #endif
         
+        /* intersection filter test */
+#if defined(__INTERSECTION_FILTER__)
+        {
+          const int geomID = tri.geomID[i];
+          const Geometry* geometry = getGeometry(geom,geomID);
+          if (unlikely(geometry->hasIntersectionFilter8())) {
+            runIntersectionFilter8(valid,geometry,ray,U/absDen,V/absDen,T/absDen,Ng2,geomID,tri.primID[i]);
+            continue;
+          }
+        }
+#endif
+
         /* update hit information for all rays that hit the triangle */
         ray.u   = select(valid,U / absDen,ray.u );
         ray.v   = select(valid,V / absDen,ray.v );
@@ -104,7 +117,7 @@ namespace embree
     }
 
     /*! Test for 8 rays if they are occluded by any of the 4 triangle. */
-    static __forceinline avxb occluded(const avxb& valid_i, const Ray8& ray, const Triangle4v& tri, void* geom)
+    static __forceinline avxb occluded(const avxb& valid_i, Ray8& ray, const Triangle4v& tri, void* geom)
     {
       avxb valid0 = valid_i;
 
@@ -162,6 +175,18 @@ namespace embree
         if (unlikely(none(valid))) continue;
 #endif
 
+        /* occlusion filter test */
+#if defined(__INTERSECTION_FILTER__)
+        {
+          const int geomID = tri.geomID[i];
+          const Geometry* geometry = getGeometry(geom,geomID);
+          if (unlikely(geometry->hasOcclusionFilter8())) {
+            valid = runOcclusionFilter8(valid,geometry,ray,U/absDen,V/absDen,T/absDen,Ng2,geomID,tri.primID[i]);
+            if (none(valid)) continue;
+          }
+        }
+#endif
+
         /* update occlusion */
         valid0 &= !valid;
         if (none(valid0)) break;
@@ -169,7 +194,7 @@ namespace embree
       return !valid0;
     }
 
-    static __forceinline avxb occluded(const avxb& valid, const Ray8& ray, const Triangle4v* tri, size_t num, void* geom)
+    static __forceinline avxb occluded(const avxb& valid, Ray8& ray, const Triangle4v* tri, size_t num, void* geom)
     {
       avxb valid0 = valid;
       for (size_t i=0; i<num; i++) {
@@ -233,7 +258,23 @@ namespace embree
       const ssef u = U / absDen;
       const ssef v = V / absDen;
       const ssef t = T / absDen;
-      const size_t i = select_min(valid,t);
+      size_t i = select_min(valid,t);
+
+      /* intersection filter test */
+#if defined(__INTERSECTION_FILTER__)
+      while (true) 
+      {
+        const int geomID = tri.geomID[i];
+        const Geometry* geometry = getGeometry(geom,geomID);
+        if (likely(!geometry->hasIntersectionFilter8())) break;
+        const Vec3fa Ng = Vec3fa(Ng2.x[i],Ng2.y[i],Ng2.z[i]);
+        if (runIntersectionFilter8(geometry,ray,k,u[i],v[i],t[i],Ng,geomID,tri.primID[i])) return;
+        valid[i] = 0;
+        if (none(valid)) return;
+        i = select_min(valid,t);
+      }
+#endif
+
       ray.tfar[k] = t[i];
       ray.u[k] = u[i];
       ray.v[k] = v[i];
@@ -300,7 +341,23 @@ namespace embree
       if (unlikely(none(valid))) return false;
 #endif
 
+      /* occlusion filter test */
+#if defined(__INTERSECTION_FILTER__)
+      const ssef u = U / absDen;
+      const ssef v = V / absDen;
+      const ssef t = T / absDen;
+      for (size_t m=movemask(valid), i=__bsf(m); m!=0; m=__btc(m,i), i=__bsf(m))
+      {  
+        const int geomID = tri.geomID[i];
+        const Geometry* geometry = getGeometry(geom,geomID);
+        if (likely(!geometry->hasOcclusionFilter8())) return true;
+        const Vec3fa Ng = Vec3fa(Ng2.x[i],Ng2.y[i],Ng2.z[i]);
+        if (runOcclusionFilter8(geometry,ray,k,u[i],v[i],t[i],Ng,geomID,tri.primID[i])) return true;
+      }
+      return false;
+#else
       return true;
+#endif
     }
 
     static __forceinline bool occluded(Ray8& ray, size_t k, const Triangle4v* tri, size_t num, void* geom) 
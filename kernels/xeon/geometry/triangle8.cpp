@@ -36,6 +36,21 @@ namespace embree
     return ((Triangle8*)This)->size();
   }
 
+  size_t Triangle8Type::triangles(const char* This, BlockTriangle* tris) const 
+  {
+    const Triangle8& tri = *(Triangle8*)This;
+    const size_t num = tri.size();
+    for (size_t i=0; i<num; i++) 
+    {
+      const Vec3fa v0(tri.v0.x[i],tri.v0.y[i],tri.v0.z[i]);
+      const Vec3fa e1(tri.e1.x[i],tri.e1.y[i],tri.e1.z[i]);
+      const Vec3fa e2(tri.e2.x[i],tri.e2.y[i],tri.e2.z[i]);
+      tris[i].v0 = v0; tris[i].v1 = v0-e1; tris[i].v2 = v0+e2;
+      tris[i].geomID = tri.geomID[i]; tris[i].primID = tri.primID[i];
+    }
+    return num;
+  }
+
   void SceneTriangle8::pack(char* This, atomic_set<PrimRefBlock>::block_iterator_unsafe& prims, void* geom) const 
   {
     Scene* scene = (Scene*) geom;
@@ -109,6 +109,7 @@ namespace embree
     Triangle8Type ();
     size_t blocks(size_t x) const;
     size_t size(const char* This) const;
+    size_t triangles(const char* This, BlockTriangle* tris) const;
   };
 
   struct SceneTriangle8 : public Triangle8Type
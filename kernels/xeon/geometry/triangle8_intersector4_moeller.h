@@ -19,6 +19,7 @@
 
 #include "triangle8.h"
 #include "triangle8_intersector1_moeller.h"
+#include "filter.h"
 
 #include "../common/ray4.h"
 
@@ -30,6 +31,7 @@ namespace embree
    *  Intersection". In contrast to the paper we precalculate some
    *  factors and factor the calculations differently to allow
    *  precalculating the cross product e1 x e2. */
+  template<int kernelFeatures>
   struct Triangle8Intersector4MoellerTrumbore
   {
     typedef Triangle8 Primitive;
@@ -86,12 +88,28 @@ namespace embree
 
         /* ray masking test */
 #if defined(__USE_RAY_MASK__)
-        valid &= (tri.mask[i] & ray.mask) != 0;
-        if (unlikely(none(valid))) continue;
+        if (kernelFeatures & KERNEL_FEATURE_RAY_MASK) {
+          valid &= (tri.mask[i] & ray.mask) != 0;
+          if (unlikely(none(valid))) continue;
+        }
 #endif
         
         /* update hit information for all rays that hit the triangle */
         const ssef rcpAbsDen = rcp(absDen);
+
+        /* intersection filter test */
+#if defined(__INTERSECTION_FILTER__)
+        if (kernelFeatures & KERNEL_FEATURE_FILTER)
+        {
+          const int geomID = tri.geomID[i];
+          const Geometry* geometry = getGeometry(geom,geomID);
+          if (unlikely(geometry->hasIntersectionFilter4())) {
+            runIntersectionFilter4(valid,geometry,ray,U*rcpAbsDen,V*rcpAbsDen,T*rcpAbsDen,Ng,geomID,tri.primID[i]);
+            continue;
+          }
+        }
+#endif
+
         ray.u    = select(valid,U * rcpAbsDen,ray.u );
         ray.v    = select(valid,V * rcpAbsDen,ray.v );
         ray.tfar  = select(valid,T * rcpAbsDen,ray.tfar );
@@ -111,7 +129,7 @@ namespace embree
     }
 
     /*! Test for 4 rays if they are occluded by any of the 4 triangle. */
-    static __forceinline sseb occluded(const sseb& valid_i, const Ray4& ray, const Triangle8& tri, void* geom)
+    static __forceinline sseb occluded(const sseb& valid_i, Ray4& ray, const Triangle8& tri, void* geom)
     {
       sseb valid0 = valid_i;
 
@@ -164,8 +182,24 @@ namespace embree
 
         /* ray masking test */
 #if defined(__USE_RAY_MASK__)
-        valid &= (tri.mask[i] & ray.mask) != 0;
-        if (unlikely(none(valid))) continue;
+        if (kernelFeatures & KERNEL_FEATURE_RAY_MASK) {
+          valid &= (tri.mask[i] & ray.mask) != 0;
+          if (unlikely(none(valid))) continue;
+        }
+#endif
+
+        /* occlusion filter test */
+#if defined(__INTERSECTION_FILTER__)
+        if (kernelFeatures & KERNEL_FEATURE_FILTER)
+        {
+          const int geomID = tri.geomID[i];
+          const Geometry* geometry = getGeometry(geom,geomID);
+          if (unlikely(geometry->hasOcclusionFilter4())) {
+            const ssef rcpAbsDen = rcp(absDen);
+            valid = runOcclusionFilter4(valid,geometry,ray,U*rcpAbsDen,V*rcpAbsDen,T*rcpAbsDen,Ng,geomID,tri.primID[i]);
+            if (none(valid)) continue;
+          }
+        }
 #endif
 
         /* update occlusion */
@@ -175,7 +209,7 @@ namespace embree
       return !valid0;
     }
 
-    static __forceinline sseb occluded(const sseb& valid, const Ray4& ray, const Triangle8* tri, size_t num, void* geom)
+    static __forceinline sseb occluded(const sseb& valid, Ray4& ray, const Triangle8* tri, size_t num, void* geom)
     {
       sseb valid0 = valid;
       for (size_t i=0; i<num; i++) {
@@ -217,8 +251,10 @@ namespace embree
 
       /* ray masking test */
 #if defined(__USE_RAY_MASK__)
-      valid &= (tri.mask & ray.mask[k]) != 0;
-      if (unlikely(none(valid))) return;
+      if (kernelFeatures & KERNEL_FEATURE_RAY_MASK) {
+        valid &= (tri.mask & ray.mask[k]) != 0;
+        if (unlikely(none(valid))) return;
+      }
 #endif
 
       /* update hit information */
@@ -226,7 +262,25 @@ namespace embree
       const avxf u = U * rcpAbsDen;
       const avxf v = V * rcpAbsDen;
       const avxf t = T * rcpAbsDen;
-      const size_t i = select_min(valid,t);
+      size_t i = select_min(valid,t);
+
+      /* intersection filter test */
+#if defined(__INTERSECTION_FILTER__)
+      if (kernelFeatures & KERNEL_FEATURE_FILTER) {
+        while (true) 
+        {
+          const int geomID = tri.geomID[i];
+          const Geometry* geometry = getGeometry(geom,geomID);
+          if (likely(!geometry->hasIntersectionFilter4())) break;
+          const Vec3fa Ng = Vec3fa(tri.Ng.x[i],tri.Ng.y[i],tri.Ng.z[i]);
+          if (runIntersectionFilter4(geometry,ray,k,u[i],v[i],t[i],Ng,geomID,tri.primID[i])) return;
+          valid[i] = 0;
+          if (none(valid)) return;
+          i = select_min(valid,t);
+        }
+      }
+#endif
+
       ray.u[k]   = u[i];
       ray.v[k]   = v[i];
       ray.tfar[k] = t[i];
@@ -279,8 +333,29 @@ namespace embree
 
       /* ray masking test */
 #if defined(__USE_RAY_MASK__)
-      valid &= (tri.mask & ray.mask[k]) != 0;
-      if (unlikely(none(valid))) return false;
+      if (kernelFeatures & KERNEL_FEATURE_RAY_MASK) {
+        valid &= (tri.mask & ray.mask[k]) != 0;
+        if (unlikely(none(valid))) return false;
+      }
+#endif
+
+      /* occlusion filter test */
+#if defined(__INTERSECTION_FILTER__)
+      if (kernelFeatures & KERNEL_FEATURE_FILTER) {
+        const avxf rcpAbsDen = rcp(absDen);
+        const avxf u = U * rcpAbsDen;
+        const avxf v = V * rcpAbsDen;
+        const avxf t = T * rcpAbsDen;
+        for (size_t m=movemask(valid), i=__bsf(m); m!=0; m=__btc(m,i), i=__bsf(m))
+        {  
+          const int geomID = tri.geomID[i];
+          const Geometry* geometry = getGeometry(geom,geomID);
+          if (likely(!geometry->hasOcclusionFilter4())) return true;
+          const Vec3fa Ng = Vec3fa(tri.Ng.x[i],tri.Ng.y[i],tri.Ng.z[i]);
+          if (runOcclusionFilter4(geometry,ray,k,u[i],v[i],t[i],Ng,geomID,tri.primID[i])) return true;
+        }
+        return false;
+      }
 #endif
       return true;
     }
@@ -0,0 +1,106 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#ifndef __EMBREE_ACCEL_TRIANGLE_INTERSECTOR_WATERTIGHT_H__
+#define __EMBREE_ACCEL_TRIANGLE_INTERSECTOR_WATERTIGHT_H__
+
+#include "../common/default.h"
+
+namespace embree
+{
+  /*! Watertight ray/triangle test after Woop, Benthin, and Wald
+   *  2013. The vertices are transformed into a space where the ray
+   *  starts at the origin and points along the z axis, by permuting
+   *  the dimensions such that z is the largest dimension of the ray
+   *  direction and shearing the direction onto (0,0,1). The edge
+   *  functions are then evaluated in 2D. They only depend on the
+   *  transformed vertices of the edge and are exactly negated for
+   *  the neighbouring triangle, thus rays cannot pass between
+   *  triangles that share an edge. Hits exactly on the edge are
+   *  reported for both triangles. The products of the edge functions
+   *  must not be fused, thus these kernels are not compiled with
+   *  FMA enabled. */
+  struct TriangleIntersectorWatertight
+  {
+    /*! Permutes the dimensions of a vector such that the largest
+     *  dimension of the ray direction becomes z. */
+    template<typename vfloat, typename vbool>
+      static __forceinline Vec3<vfloat> permute(const vbool& kz0, const vbool& kz1, const Vec3<vfloat>& a) 
+    {
+      return Vec3<vfloat>(select(kz0,a.y,select(kz1,a.z,a.x)),
+                          select(kz0,a.z,select(kz1,a.x,a.y)),
+                          select(kz0,a.x,select(kz1,a.y,a.z)));
+    }
+
+    template<typename vfloat, typename vbool>
+      static __forceinline vbool intersect(const vbool& valid_i, 
+                                           const Vec3<vfloat>& O, const Vec3<vfloat>& D, 
+                                           const vfloat& tnear, const vfloat& tfar,
+                                           const Vec3<vfloat>& p0, const Vec3<vfloat>& p1, const Vec3<vfloat>& p2, 
+                                           vfloat& u_o, vfloat& v_o, vfloat& t_o, Vec3<vfloat>& Ng_o)
+    {
+      /* calculate shear transformation of the ray */
+      const Vec3<vfloat> absD = abs(D);
+      const vbool kz0 = (absD.x >= absD.y) & (absD.x >= absD.z);
+      const vbool kz1 = !kz0 & (absD.y >= absD.z);
+      const Vec3<vfloat> d = permute(kz0,kz1,D);
+      const vfloat Sz = vfloat(one)/d.z;
+      const vfloat Sx = d.x*Sz;
+      const vfloat Sy = d.y*Sz;
+
+      /* calculate vertices in ray space */
+      const Vec3<vfloat> a = permute(kz0,kz1,p0-O);
+      const Vec3<vfloat> b = permute(kz0,kz1,p1-O);
+      const Vec3<vfloat> c = permute(kz0,kz1,p2-O);
+      const vfloat Ax = a.x-Sx*a.z, Ay = a.y-Sy*a.z;
+      const vfloat Bx = b.x-Sx*b.z, By = b.y-Sy*b.z;
+      const vfloat Cx = c.x-Sx*c.z, Cy = c.y-Sy*c.z;
+
+      /* perform edge tests */
+      const vfloat U = Cx*By-Cy*Bx;
+      const vfloat V = Ax*Cy-Ay*Cx;
+      const vfloat W = Bx*Ay-By*Ax;
+      const vfloat zero = vfloat(embree::zero);
+      vbool valid = valid_i & (((U >= zero) & (V >= zero) & (W >= zero)) | ((U <= zero) & (V <= zero) & (W <= zero)));
+      if (likely(none(valid))) return valid;
+
+      /* perform depth test */
+      const vfloat det = U+V+W;
+      const vfloat absDet = abs(det);
+      const vfloat sgnDet = signmsk(det);
+      const vfloat T = (U*(Sz*a.z) + V*(Sz*b.z) + W*(Sz*c.z)) ^ sgnDet;
+      valid &= (det != zero) & (T >= absDet*tnear) & (absDet*tfar >= T);
+      if (unlikely(none(valid))) return valid;
+
+      /* calculate geometry normal and perform backface culling */
+      const Vec3<vfloat> Ng = cross(p0-p1,p2-p0);
+#if defined(__BACKFACE_CULLING__)
+      valid &= dot(Ng,D) > zero;
+      if (unlikely(none(valid))) return valid;
+#endif
+
+      /* the weights of the second and third vertex are the hit's u/v */
+      const vfloat rcpDet = vfloat(one)/det;
+      u_o = V*rcpDet;
+      v_o = W*rcpDet;
+      t_o = T/absDet;
+      Ng_o = Ng;
+      return valid;
+    }
+  };
+}
+
+#endif
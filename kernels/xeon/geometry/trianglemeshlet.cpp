@@ -0,0 +1,116 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "trianglemeshlet.h"
+#include "common/scene.h"
+
+namespace embree
+{
+  SceneTriangleMeshlet SceneTriangleMeshlet::type;
+
+  TriangleMeshletType::TriangleMeshletType () 
+  : PrimitiveType("trianglemeshlet",sizeof(TriangleMeshlet),8,false,1) {} 
+  
+  size_t TriangleMeshletType::blocks(size_t x) const {
+    return (x+7)/8;
+  }
+  
+  size_t TriangleMeshletType::size(const char* This) const {
+    return ((TriangleMeshlet*)This)->size();
+  }
+
+  size_t TriangleMeshletType::triangles(const char* This, BlockTriangle* tris) const 
+  {
+    const TriangleMeshlet& meshlet = *(TriangleMeshlet*)This;
+    const size_t num = meshlet.size();
+    for (size_t i=0; i<num; i++) 
+    {
+      const Vec3f& v0 = meshlet.vertex(0,i), &v1 = meshlet.vertex(1,i), &v2 = meshlet.vertex(2,i);
+      tris[i].v0 = Vec3fa(v0.x,v0.y,v0.z);
+      tris[i].v1 = Vec3fa(v1.x,v1.y,v1.z);
+      tris[i].v2 = Vec3fa(v2.x,v2.y,v2.z);
+      tris[i].geomID = meshlet.geomID[i]; tris[i].primID = meshlet.primID[i];
+    }
+    return num;
+  }
+
+  /*! Adds the triangle to the cluster if there is space left for the
+   *  triangle and its new vertices. The vertices of the cluster are
+   *  identified by their geometry ID and their index in the mesh. */
+  static bool add(TriangleMeshlet* dst, unsigned vertexID[][2], Scene* scene, const PrimRef& prim)
+  {
+    if (dst->numTriangles >= TriangleMeshlet::maxTriangles) 
+      return false;
+
+    const TriangleMeshScene::TriangleMesh* mesh = scene->getTriangleMesh(prim.geomID());
+    const TriangleMeshScene::TriangleMesh::Triangle& tri = mesh->triangle(prim.primID());
+
+    /* lookup vertices in the cluster and append missing ones */
+    size_t numVertices = dst->numVertices;
+    unsigned char local[3];
+    for (size_t k=0; k<3; k++) 
+    {
+      size_t j=0;
+      while (j<numVertices && (vertexID[j][0] != prim.geomID() || vertexID[j][1] != tri.v[k])) j++;
+      if (j == numVertices) {
+        if (numVertices >= TriangleMeshlet::maxVertices) return false;
+        vertexID[j][0] = prim.geomID();
+        vertexID[j][1] = tri.v[k];
+        numVertices++;
+      }
+      local[k] = (unsigned char) j;
+    }
+
+    /* copy new vertices */
+    for (size_t j=dst->numVertices; j<numVertices; j++) {
+      const Vec3fa& p = mesh->vertex(vertexID[j][1]);
+      dst->vertices[j] = Vec3f(p.x,p.y,p.z);
+    }
+    dst->numVertices = (unsigned char) numVertices;
+
+    /* store triangle */
+    const size_t i = dst->numTriangles++;
+    dst->v[0][i] = local[0];
+    dst->v[1][i] = local[1];
+    dst->v[2][i] = local[2];
+    dst->geomID[i] = prim.geomID();
+    dst->primID[i] = prim.primID();
+#if defined(__USE_RAY_MASK__)
+    dst->mask[i] = mesh->mask;
+#endif
+    return true;
+  }
+
+  size_t SceneTriangleMeshlet::leafBlocks(atomic_set<PrimRefBlock>& prims, size_t num, void* geom) const
+  {
+    TriangleMeshlet meshlet;
+    atomic_set<PrimRefBlock>::block_iterator_unsafe iter(prims);
+    size_t blocks = 0;
+    for (; iter; blocks++) 
+      pack((char*)&meshlet,iter,geom);
+    return blocks;
+  }
+
+  void SceneTriangleMeshlet::pack(char* This, atomic_set<PrimRefBlock>::block_iterator_unsafe& prims, void* geom) const 
+  {
+    Scene* scene = (Scene*) geom;
+    TriangleMeshlet* dst = new (This) TriangleMeshlet;
+    unsigned vertexID[TriangleMeshlet::maxVertices][2];
+    
+    while (prims && add(dst,vertexID,scene,*prims)) 
+      prims++;
+  }
+}
@@ -0,0 +1,105 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#ifndef __EMBREE_ACCEL_TRIANGLEMESHLET_H__
+#define __EMBREE_ACCEL_TRIANGLEMESHLET_H__
+
+#include "primitive.h"
+
+namespace embree
+{
+  /*! Stores a small cluster of up to 16 triangles together with a
+   *  local copy of their vertices. Triangles reference the local
+   *  vertices through 8 bit indices, thus a cluster is fetched from a
+   *  single contiguous block of memory. As each triangle adds at most
+   *  3 vertices, a cluster is guaranteed to hold at least 8
+   *  triangles. */
+  struct __align(16) TriangleMeshlet
+  {
+  public:
+    enum { maxTriangles = 16, maxVertices = 24 };
+
+    /*! Constructs an empty cluster. */
+    __forceinline TriangleMeshlet () : numTriangles(0), numVertices(0) 
+    {
+      for (size_t i=0; i<maxTriangles; i++) {
+        v[0][i] = v[1][i] = v[2][i] = 0;
+        geomID[i] = primID[i] = -1;
+#if defined(__USE_RAY_MASK__)
+        mask[i] = -1;
+#endif
+      }
+    }
+
+    /*! Returns the number of stored triangles. */
+    __forceinline size_t size() const { return numTriangles; }
+
+    /*! Returns the k-th vertex of the i-th triangle. */
+    __forceinline const Vec3f& vertex(size_t k, size_t i) const {
+      return vertices[v[k][i]];
+    }
+
+    /*! Gathers the vertices of the triangles i to i+3 and returns
+     *  which of these triangles are valid. */
+    __forceinline sseb gather(size_t i, sse3f& p0, sse3f& p1, sse3f& p2) const 
+    {
+      p0 = gather(v[0]+i);
+      p1 = gather(v[1]+i);
+      p2 = gather(v[2]+i);
+      return ssei(step)+ssei(int(i)) < ssei(int(numTriangles));
+    }
+
+  private:
+
+    /*! Gathers 4 local vertices into SOA layout. */
+    __forceinline sse3f gather(const unsigned char* idx) const 
+    {
+      const Vec3f& a = vertices[idx[0]];
+      const Vec3f& b = vertices[idx[1]];
+      const Vec3f& c = vertices[idx[2]];
+      const Vec3f& d = vertices[idx[3]];
+      return sse3f(ssef(a.x,b.x,c.x,d.x),ssef(a.y,b.y,c.y,d.y),ssef(a.z,b.z,c.z,d.z));
+    }
+
+  public:
+    unsigned char numTriangles;       //!< number of stored triangles
+    unsigned char numVertices;        //!< number of stored vertices
+    unsigned char align[14];
+    unsigned char v[3][maxTriangles]; //!< local vertex indices, indexed by vertex and triangle
+    int geomID[maxTriangles];         //!< user geometry ID
+    int primID[maxTriangles];         //!< primitive ID
+#if defined(__USE_RAY_MASK__)
+    int mask[maxTriangles];           //!< geometry mask
+#endif
+    Vec3f vertices[maxVertices];      //!< local vertex block
+  };
+
+  struct TriangleMeshletType : public PrimitiveType {
+    TriangleMeshletType ();
+    size_t blocks(size_t x) const;
+    size_t size(const char* This) const;
+    size_t triangles(const char* This, BlockTriangle* tris) const;
+  };
+
+  struct SceneTriangleMeshlet : public TriangleMeshletType
+  {
+    static SceneTriangleMeshlet type;
+    size_t leafBlocks(atomic_set<PrimRefBlock>& prims, size_t num, void* geom) const;
+    void pack(char* This, atomic_set<PrimRefBlock>::block_iterator_unsafe& prims, void* geom) const;
+  };
+}
+
+#endif
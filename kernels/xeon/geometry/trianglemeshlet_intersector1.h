@@ -0,0 +1,206 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#ifndef __EMBREE_ACCEL_TRIANGLEMESHLET_INTERSECTOR1_H__
+#define __EMBREE_ACCEL_TRIANGLEMESHLET_INTERSECTOR1_H__
+
+#include "trianglemeshlet.h"
+#include "../common/ray.h"
+#include "filter.h"
+
+namespace embree
+{
+  /*! Pluecker intersector for a single ray with a triangle
+   *  cluster. The triangles are gathered from the local vertex block
+   *  and intersected 4 at a time. */
+  struct TriangleMeshletIntersector1
+  {
+    typedef TriangleMeshlet Primitive;
+
+    /*! Intersect a ray with 4 triangles of the cluster starting at j and updates the hit. */
+    static __forceinline void intersect(Ray& ray, const TriangleMeshlet& tri, size_t j, void* geom)
+    {
+      /* calculate vertices relative to ray origin */
+      STAT3(normal.trav_prims,1,1,1);
+      sse3f p0, p1, p2; 
+      sseb valid = tri.gather(j,p0,p1,p2);
+      const sse3f O = sse3f(ray.org);
+      const sse3f D = sse3f(ray.dir);
+      const sse3f v0 = p0-O;
+      const sse3f v1 = p1-O;
+      const sse3f v2 = p2-O;
+
+      /* calculate triangle edges */
+      const sse3f e0 = v2-v0;
+      const sse3f e1 = v0-v1;
+      const sse3f e2 = v1-v2;
+
+      /* calculate geometry normal and denominator */
+      const sse3f Ng1 = cross(e1,e0);
+      const sse3f Ng = Ng1+Ng1;
+      const ssef den = dot(Ng,D);
+      const ssef absDen = abs(den);
+      const ssef sgnDen = signmsk(den);
+
+      /* perform edge tests */
+      const ssef U = dot(cross(v2+v0,e0),D) ^ sgnDen;
+      const ssef V = dot(cross(v0+v1,e1),D) ^ sgnDen;
+      const ssef W = dot(cross(v1+v2,e2),D) ^ sgnDen;
+      valid &= (U >= 0.0f) & (V >= 0.0f) & (W >= 0.0f);
+      if (unlikely(none(valid))) return;
+
+      /* perform depth test */
+      const ssef T = dot(v0,Ng) ^ sgnDen;
+      valid &= (T >= absDen*ssef(ray.tnear)) & (absDen*ssef(ray.tfar) >= T);
+      if (unlikely(none(valid))) return;
+
+      /* perform backface culling */
+#if defined(__BACKFACE_CULLING__)
+      valid &= den > ssef(zero);
+      if (unlikely(none(valid))) return;
+#else
+      valid &= den != ssef(zero);
+      if (unlikely(none(valid))) return;
+#endif
+
+      /* ray masking test */
+#if defined(__USE_RAY_MASK__)
+      valid &= (ssei(tri.mask+j) & ray.mask) != 0;
+      if (unlikely(none(valid))) return;
+#endif
+
+      /* update hit information */
+      const ssef u = U / absDen;
+      const ssef v = V / absDen;
+      const ssef t = T / absDen;
+      size_t i = select_min(valid,t);
+
+      /* intersection filter test */
+#if defined(__INTERSECTION_FILTER__)
+      while (true) 
+      {
+        const int geomID = tri.geomID[j+i];
+        const Geometry* geometry = getGeometry(geom,geomID);
+        if (likely(!geometry->hasIntersectionFilter1())) break;
+        const Vec3fa N = Vec3fa(Ng.x[i],Ng.y[i],Ng.z[i]);
+        if (runIntersectionFilter1(geometry,ray,u[i],v[i],t[i],N,geomID,tri.primID[j+i])) return;
+        valid[i] = 0;
+        if (none(valid)) return;
+        i = select_min(valid,t);
+      }
+#endif
+
+      ray.tfar = t[i];
+      ray.u = u[i];
+      ray.v = v[i];
+      ray.Ng.x = Ng.x[i];
+      ray.Ng.y = Ng.y[i];
+      ray.Ng.z = Ng.z[i];
+      ray.geomID = tri.geomID[j+i];
+      ray.primID = tri.primID[j+i];
+    }
+
+    static __forceinline void intersect(Ray& ray, const TriangleMeshlet* tri, size_t num, void* geom)
+    {
+      for (size_t i=0; i<num; i++)
+        for (size_t j=0; j<tri[i].size(); j+=4)
+          intersect(ray,tri[i],j,geom);
+    }
+
+    /*! Test if the ray is occluded by one of 4 triangles of the cluster starting at j. */
+    static __forceinline bool occluded(Ray& ray, const TriangleMeshlet& tri, size_t j, void* geom)
+    {
+      /* calculate vertices relative to ray origin */
+      STAT3(shadow.trav_prims,1,1,1);
+      sse3f p0, p1, p2; 
+      sseb valid = tri.gather(j,p0,p1,p2);
+      const sse3f O = sse3f(ray.org);
+      const sse3f D = sse3f(ray.dir);
+      const sse3f v0 = p0-O;
+      const sse3f v1 = p1-O;
+      const sse3f v2 = p2-O;
+
+      /* calculate triangle edges */
+      const sse3f e0 = v2-v0;
+      const sse3f e1 = v0-v1;
+      const sse3f e2 = v1-v2;
+
+      /* calculate geometry normal and denominator */
+      const sse3f Ng1 = cross(e1,e0);
+      const sse3f Ng = Ng1+Ng1;
+      const ssef den = dot(Ng,D);
+      const ssef absDen = abs(den);
+      const ssef sgnDen = signmsk(den);
+
+      /* perform edge tests */
+      const ssef U = dot(cross(v2+v0,e0),D) ^ sgnDen;
+      const ssef V = dot(cross(v0+v1,e1),D) ^ sgnDen;
+      const ssef W = dot(cross(v1+v2,e2),D) ^ sgnDen;
+      valid &= (U >= 0.0f) & (V >= 0.0f) & (W >= 0.0f);
+      if (unlikely(none(valid))) return false;
+      
+      /* perform depth test */
+      const ssef T = dot(v0,Ng) ^ sgnDen;
+      valid &= (T >= absDen*ssef(ray.tnear)) & (absDen*ssef(ray.tfar) >= T);
+      if (unlikely(none(valid))) return false;
+
+      /* perform backface culling */
+#if defined(__BACKFACE_CULLING__)
+      valid &= den > ssef(zero);
+      if (unlikely(none(valid))) return false;
+#else
+      valid &= den != ssef(zero);
+      if (unlikely(none(valid))) return false;
+#endif
+
+      /* ray masking test */
+#if defined(__USE_RAY_MASK__)
+      valid &= (ssei(tri.mask+j) & ray.mask) != 0;
+      if (unlikely(none(valid))) return false;
+#endif
+
+      /* occlusion filter test */
+#if defined(__INTERSECTION_FILTER__)
+      const ssef u = U / absDen;
+      const ssef v = V / absDen;
+      const ssef t = T / absDen;
+      for (size_t m=movemask(valid), i=__bsf(m); m!=0; m=__btc(m,i), i=__bsf(m))
+      {  
+        const int geomID = tri.geomID[j+i];
+        const Geometry* geometry = getGeometry(geom,geomID);
+        if (likely(!geometry->hasOcclusionFilter1())) return true;
+        const Vec3fa N = Vec3fa(Ng.x[i],Ng.y[i],Ng.z[i]);
+        if (runOcclusionFilter1(geometry,ray,u[i],v[i],t[i],N,geomID,tri.primID[j+i])) return true;
+      }
+      return false;
+#else
+      return true;
+#endif
+    }
+
+    static __forceinline bool occluded(Ray& ray, const TriangleMeshlet* tri, size_t num, void* geom) 
+    {
+      for (size_t i=0; i<num; i++) 
+        for (size_t j=0; j<tri[i].size(); j+=4)
+          if (occluded(ray,tri[i],j,geom))
+            return true;
+
+      return false;
+    }
+  };
+}
+
+#endif
@@ -0,0 +1,217 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#ifndef __EMBREE_ACCEL_TRIANGLEMESHLET_INTERSECTOR8_H__
+#define __EMBREE_ACCEL_TRIANGLEMESHLET_INTERSECTOR8_H__
+
+#include "trianglemeshlet.h"
+#include "../common/ray8.h"
+#include "filter.h"
+
+namespace embree
+{
+  /*! Pluecker intersector for 8 rays with a triangle cluster. */
+  struct TriangleMeshletIntersector8
+  {
+    typedef TriangleMeshlet Primitive;
+
+    /*! Broadcasts a vertex to all rays. */
+    static __forceinline avx3f broadcast(const Vec3f& p) {
+      return avx3f(avxf(p.x),avxf(p.y),avxf(p.z));
+    }
+
+    /*! Intersects 8 rays with the triangles of the cluster. */
+    static __forceinline void intersect(const avxb& valid_i, Ray8& ray, const TriangleMeshlet& tri, void* geom)
+    {
+      for (size_t i=0; i<tri.size(); i++)
+      {
+        STAT3(normal.trav_prims,1,popcnt(valid_i),8);
+
+        /* calculate vertices relative to ray origin */
+        avxb valid = valid_i;
+        const avx3f O = ray.org;
+        const avx3f D = ray.dir;
+        const avx3f v0 = broadcast(tri.vertex(0,i))-O;
+        const avx3f v1 = broadcast(tri.vertex(1,i))-O;
+        const avx3f v2 = broadcast(tri.vertex(2,i))-O;
+        
+        /* calculate triangle edges */
+        const avx3f e0 = v2-v0;
+        const avx3f e1 = v0-v1;
+        const avx3f e2 = v1-v2;
+        
+        /* calculate geometry normal and denominator */
+        const avx3f Ng1 = cross(e1,e0);
+        const avx3f Ng2 = Ng1+Ng1;
+        const avxf den = dot(avx3f(Ng2),D);
+        const avxf absDen = abs(den);
+        const avxf sgnDen = signmsk(den);
+
+        /* perform edge tests */
+        const avxf U = dot(avx3f(cross(v2+v0,e0)),D) ^ sgnDen;
+        valid &= U >= avxf(zero);
+        if (likely(none(valid))) continue;
+        const avxf V = dot(avx3f(cross(v0+v1,e1)),D) ^ sgnDen;
+        valid &= V >= avxf(zero);
+        if (likely(none(valid))) continue;
+        const avxf W = dot(avx3f(cross(v1+v2,e2)),D) ^ sgnDen;
+        valid &= W >= avxf(zero);
+        if (likely(none(valid))) continue;
+        
+        /* perform depth test */
+        const avxf T = dot(v0,avx3f(Ng2)) ^ sgnDen;
+        valid &= (T >= absDen*ray.tnear) & (absDen*ray.tfar >= T);
+        if (unlikely(none(valid))) continue;
+
+        /* perform backface culling */
+#if defined(__BACKFACE_CULLING__)
+        valid &= den > avxf(zero);
+        if (unlikely(none(valid))) continue;
+#else
+        valid &= den != avxf(zero);
+        if (unlikely(none(valid))) continue;
+#endif
+
+        /* ray masking test */
+#if defined(__USE_RAY_MASK__)
+        valid &= (tri.mask[i] & ray.mask) != 0;
+        if (unlikely(none(valid))) continue;
+#endif
+        
+        /* intersection filter test */
+#if defined(__INTERSECTION_FILTER__)
+        {
+          const int geomID = tri.geomID[i];
+          const Geometry* geometry = getGeometry(geom,geomID);
+          if (unlikely(geometry->hasIntersectionFilter8())) {
+            runIntersectionFilter8(valid,geometry,ray,U/absDen,V/absDen,T/absDen,Ng2,geomID,tri.primID[i]);
+            continue;
+          }
+        }
+#endif
+
+        /* update hit information for all rays that hit the triangle */
+        ray.u   = select(valid,U / absDen,ray.u );
+        ray.v   = select(valid,V / absDen,ray.v );
+        ray.tfar = select(valid,T / absDen,ray.tfar );
+        ray.geomID = select(valid,tri.geomID[i],ray.geomID);
+        ray.primID = select(valid,tri.primID[i],ray.primID);
+        ray.Ng.x = select(valid,Ng2.x,ray.Ng.x);
+        ray.Ng.y = select(valid,Ng2.y,ray.Ng.y);
+        ray.Ng.z = select(valid,Ng2.z,ray.Ng.z);
+      }
+    }
+
+    static __forceinline void intersect(const avxb& valid, Ray8& ray, const TriangleMeshlet* tri, size_t num, void* geom)
+    {
+      for (size_t i=0; i<num; i++) {
+        intersect(valid,ray,tri[i],geom);
+      }
+    }
+
+    /*! Test for 8 rays if they are occluded by any triangle of the cluster. */
+    static __forceinline avxb occluded(const avxb& valid_i, Ray8& ray, const TriangleMeshlet& tri, void* geom)
+    {
+      avxb valid0 = valid_i;
+
+      for (size_t i=0; i<tri.size(); i++)
+      {
+        STAT3(shadow.trav_prims,1,popcnt(valid_i),8);
+
+        /* calculate vertices relative to ray origin */
+        avxb valid = valid0;
+        const avx3f O = ray.org;
+        const avx3f D = ray.dir;
+        const avx3f v0 = broadcast(tri.vertex(0,i))-O;
+        const avx3f v1 = broadcast(tri.vertex(1,i))-O;
+        const avx3f v2 = broadcast(tri.vertex(2,i))-O;
+
+        /* calculate triangle edges */
+        const avx3f e0 = v2-v0;
+        const avx3f e1 = v0-v1;
+        const avx3f e2 = v1-v2;
+        
+        /* calculate geometry normal and denominator */
+        const avx3f Ng1 = cross(e1,e0);
+        const avx3f Ng2 = Ng1+Ng1;
+        const avxf den = dot(avx3f(Ng2),D);
+        const avxf absDen = abs(den);
+        const avxf sgnDen = signmsk(den);
+
+        /* perform edge tests */
+        const avxf U = dot(avx3f(cross(v2+v0,e0)),D) ^ sgnDen;
+        valid &= U >= avxf(zero);
+        if (likely(none(valid))) continue;
+        const avxf V = dot(avx3f(cross(v0+v1,e1)),D) ^ sgnDen;
+        valid &= V >= avxf(zero);
+        if (likely(none(valid))) continue;
+        const avxf W = dot(avx3f(cross(v1+v2,e2)),D) ^ sgnDen;
+        valid &= W >= avxf(zero);
+        if (likely(none(valid))) continue;
+        
+        /* perform depth test */
+        const avxf T = dot(v0,avx3f(Ng2)) ^ sgnDen;
+        valid &= (T >= absDen*ray.tnear) & (absDen*ray.tfar >= T);
+
+        /* perform backface culling */
+#if defined(__BACKFACE_CULLING__)
+        valid &= den > avxf(zero);
+        if (unlikely(none(valid))) continue;
+#else
+        valid &= den != avxf(zero);
+        if (unlikely(none(valid))) continue;
+#endif
+
+        /* ray masking test */
+#if defined(__USE_RAY_MASK__)
+        valid &= (tri.mask[i] & ray.mask) != 0;
+        if (unlikely(none(valid))) continue;
+#endif
+
+        /* occlusion filter test */
+#if defined(__INTERSECTION_FILTER__)
+        {
+          const int geomID = tri.geomID[i];
+          const Geometry* geometry = getGeometry(geom,geomID);
+          if (unlikely(geometry->hasOcclusionFilter8())) {
+            valid = runOcclusionFilter8(valid,geometry,ray,U/absDen,V/absDen,T/absDen,Ng2,geomID,tri.primID[i]);
+            if (none(valid)) continue;
+          }
+        }
+#endif
+
+        /* update occlusion */
+        valid0 &= !valid;
+        if (none(valid0)) break;
+      }
+      return !valid0;
+    }
+
+    static __forceinline avxb occluded(const avxb& valid, Ray8& ray, const TriangleMeshlet* tri, size_t num, void* geom)
+    {
+      avxb valid0 = valid;
+      for (size_t i=0; i<num; i++) {
+        valid0 &= !occluded(valid0,ray,tri[i],geom);
+        if (none(valid0)) break;
+      }
+      return !valid0;
+    }
+  };
+}
+
+#endif
+
+
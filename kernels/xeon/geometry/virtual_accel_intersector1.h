@@ -29,7 +29,9 @@ namespace embree
     static __forceinline void intersect(Ray& ray, const Primitive& prim, const void* geom) 
     {
       AVX_ZERO_UPPER();
-      prim.accel->intersect((RTCRay&)ray,prim.item);
+      const SavedHit1 hit((RTCRay&)ray);
+      prim.accel->intersectBlock((RTCRay&)ray,prim.item);
+      hit.restore((RTCRay&)ray);
     }
 
     static __forceinline void intersect(Ray& ray, const Primitive* prim, size_t num, const void* geom) 
@@ -41,7 +43,7 @@ namespace embree
     static __forceinline bool occluded(Ray& ray, const Primitive& prim, const void* geom) 
     {
       AVX_ZERO_UPPER();
-      prim.accel->occluded((RTCRay&)ray,prim.item);
+      prim.accel->occludedBlock((RTCRay&)ray,prim.item);
       return ray.geomID == 0;
     }
 
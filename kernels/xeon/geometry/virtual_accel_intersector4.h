@@ -29,7 +29,9 @@ namespace embree
     static __forceinline void intersect(const sseb& valid_i, Ray4& ray, const Primitive& prim, const void* geom) 
     {
       AVX_ZERO_UPPER();
-      prim.accel->intersect4(&valid_i,(RTCRay4&)ray,prim.item);
+      const SavedHitN<4,RTCRay4> hit(&valid_i,(RTCRay4&)ray);
+      prim.accel->intersect4Block(&valid_i,(RTCRay4&)ray,prim.item);
+      hit.restore((RTCRay4&)ray);
     }
 
     static __forceinline void intersect(const sseb& valid, Ray4& ray, const Primitive* tri, size_t num, const void* geom)
@@ -41,7 +43,7 @@ namespace embree
     static __forceinline sseb occluded(const sseb& valid_i, const Ray4& ray, const Primitive& prim, const void* geom) 
     {
       AVX_ZERO_UPPER();
-      prim.accel->occluded4(&valid_i,(RTCRay4&)ray,prim.item);
+      prim.accel->occluded4Block(&valid_i,(RTCRay4&)ray,prim.item);
       return ray.geomID == 0;
     }
 
@@ -29,7 +29,9 @@ namespace embree
     static __forceinline void intersect(const avxb& valid_i, Ray8& ray, const Primitive& prim, const void* geom) 
     {
       AVX_ZERO_UPPER();
-      prim.accel->intersect8(&valid_i,(RTCRay8&)ray,prim.item);
+      const SavedHitN<8,RTCRay8> hit(&valid_i,(RTCRay8&)ray);
+      prim.accel->intersect8Block(&valid_i,(RTCRay8&)ray,prim.item);
+      hit.restore((RTCRay8&)ray);
     }
 
     static __forceinline void intersect(const avxb& valid, Ray8& ray, const Primitive* tri, size_t num, const void* geom)
@@ -41,7 +43,7 @@ namespace embree
     static __forceinline avxb occluded(const avxb& valid_i, const Ray8& ray, const Primitive& prim, const void* geom) 
     {
       AVX_ZERO_UPPER();
-      prim.accel->occluded8(&valid_i,(RTCRay8&)ray,prim.item);
+      prim.accel->occluded8Block(&valid_i,(RTCRay8&)ray,prim.item);
       return ray.geomID == 0;
     }
 
@@ -22,32 +22,56 @@ namespace embree
   {
     typedef AffineSpaceT<LinearSpace3<mic3f> > AffineSpace3fMIC;
     
-    void FastInstanceIntersector16::intersect(mic_i* valid, const UserGeometryScene::Instance* instance, Ray16& ray, size_t item)
+    void FastInstanceIntersector16::intersect(mic_i* valid_i, const UserGeometryScene::Instance* instance, Ray16& ray, size_t item)
     {
+      mic_i valid = *valid_i;
+#if defined(__USE_RAY_MASK__)
+      /* skip the instanced scene for rays that cannot hit any of its geometries */
+      const mic_m m_valid = (valid != mic_i(0)) & ((ray.mask & int(instance->mask)) != mic_i(0)) & ((ray.mask & int(instance->objectMask)) != mic_i(0));
+      if (none(m_valid)) return;
+      valid = select(m_valid,mic_i(-1),mic_i(0));
+#endif
       const mic3f ray_org = ray.org;
       const mic3f ray_dir = ray.dir;
       const mic_i ray_geomID = ray.geomID;
-      const AffineSpace3fMIC world2local(instance->world2local);
+      mic_i ray_instStack[RTC_MAX_INSTANCE_DEPTH];
+      for (size_t i=0; i<RTC_MAX_INSTANCE_DEPTH; i++) {
+        ray_instStack[i] = ray.instStack[i];
+        ray.instStack[i] = -1;
+      }
+      const AffineSpace3fMIC world2local = instance->getWorld2Local<AffineSpace3fMIC>(ray.time);
       ray.org = xfmPoint (world2local,ray_org);
       ray.dir = xfmVector(world2local,ray_dir);
       ray.geomID = -1;
-      instance->object->intersect16(valid,(RTCRay16&)ray);
+      instance->object->intersect16(&valid,(RTCRay16&)ray);
       ray.org = ray_org;
       ray.dir = ray_dir;
       mic_m nohit = ray.geomID == mic_i(-1);
       ray.geomID = select(nohit,ray_geomID,ray.geomID);
       ray.instID = select(nohit,ray.instID,instance->id);
+
+      /* this instance becomes the outermost level of the instance stack */
+      for (size_t i=RTC_MAX_INSTANCE_DEPTH-1; i>0; i--)
+        ray.instStack[i] = select(nohit,ray_instStack[i],ray.instStack[i-1]);
+      ray.instStack[0] = select(nohit,ray_instStack[0],instance->id);
     }
     
-    void FastInstanceIntersector16::occluded (mic_i* valid, const UserGeometryScene::Instance* instance, Ray16& ray, size_t item)
+    void FastInstanceIntersector16::occluded (mic_i* valid_i, const UserGeometryScene::Instance* instance, Ray16& ray, size_t item)
     {
+      mic_i valid = *valid_i;
+#if defined(__USE_RAY_MASK__)
+      /* skip the instanced scene for rays that cannot hit any of its geometries */
+      const mic_m m_valid = (valid != mic_i(0)) & ((ray.mask & int(instance->mask)) != mic_i(0)) & ((ray.mask & int(instance->objectMask)) != mic_i(0));
+      if (none(m_valid)) return;
+      valid = select(m_valid,mic_i(-1),mic_i(0));
+#endif
       const mic3f ray_org = ray.org;
       const mic3f ray_dir = ray.dir;
       const mic_i ray_geomID = ray.geomID;
-      const AffineSpace3fMIC world2local(instance->world2local);
+      const AffineSpace3fMIC world2local = instance->getWorld2Local<AffineSpace3fMIC>(ray.time);
       ray.org = xfmPoint (world2local,ray_org);
       ray.dir = xfmVector(world2local,ray_dir);
-      instance->object->occluded16(valid,(RTCRay16&)ray);
+      instance->object->occluded16(&valid,(RTCRay16&)ray);
       ray.org = ray_org;
       ray.dir = ray_dir;
     }
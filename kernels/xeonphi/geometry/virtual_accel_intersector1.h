@@ -29,7 +29,9 @@ namespace embree
     static __forceinline void intersect(Ray& ray, const Primitive& prim, const void* geom) 
     {
       AVX_ZERO_UPPER();
+      const SavedHit1 hit((RTCRay&)ray);
       prim.accel->intersect((RTCRay&)ray,prim.item);
+      hit.restore((RTCRay&)ray);
     }
 
     static __forceinline void intersect(Ray& ray, const Primitive* prim, size_t num, const void* geom) 
@@ -19,8 +19,13 @@
 #include "embree2/rtcore.h"
 #include "embree2/rtcore_ray.h"
 #include "math/vec3.h"
+#include "math/bbox.h"
 #include "../kernels/common/default.h"
 #include <vector>
+#include <map>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
 
 namespace embree
 {
@@ -28,23 +33,27 @@ namespace embree
 
   /* configuration */
   static std::string g_rtcore = "";
+  static std::vector<std::string> g_tri_accels;  //!< triangle acceleration structures to sweep over
+  static std::vector<std::string> g_builders;    //!< builders to sweep over
+  static std::vector<size_t> g_threads_list;     //!< thread counts to sweep over (0 = all threads)
+  static std::vector<size_t> g_packets;          //!< packet widths to sweep over
+  static std::vector<std::string> g_objFiles;    //!< OBJ scenes to benchmark
+  static std::vector<std::string> g_groups;      //!< benchmark groups to run (sync, build, intersect)
+  static size_t g_warmup = 1;                    //!< number of untimed warm-up runs
+  static size_t g_repeat = 5;                    //!< number of timed runs
+  static std::string g_output = "";              //!< JSON or CSV file to write results to
+  static std::string g_compare = "";             //!< JSON or CSV baseline to compare results against
+  static double g_threshold = 5.0;               //!< regression threshold in percent
+
+  /* currently benchmarked configuration */
+  static std::string g_cur_tri_accel = "default";
+  static std::string g_cur_builder = "default";
+  static size_t g_cur_threads = 0;
   
   /* vertex and triangle layout */
   struct Vertex   { float x,y,z,a; };
   struct Triangle { int v0, v1, v2; };
 
-#define AssertNoError() \
-  if (rtcGetError() != RTC_NO_ERROR) return false;
-#define AssertAnyError() \
-  if (rtcGetError() == RTC_NO_ERROR) return false;
-#define AssertError(code) \
-  if (rtcGetError() != code) return false;
-#define BUILD(name,test) {                                              \
-    double perf = test;                                                \
-    printf("%30s ... %f Mtris/s\n",name,perf*1E-6);                                 \
-	fflush(stdout);\
-  }
-
   std::vector<thread_t> g_threads;
   std::vector<thread_t> g_threads2;
 
@@ -66,7 +75,7 @@ namespace embree
     }
   }
   
-  void benchmark_mutex_sys ()
+  double benchmark_mutex_sys ()
   {
     size_t numThreads = getNumberOfLogicalThreads();
 #if defined (__MIC__)
@@ -86,8 +95,7 @@ namespace embree
 
     g_threads.clear();
 
-    printf("%30s ... %f ms (%f k/s)\n","mutex_sys",1000.0f*(t1-t0)/double(g_num_mutex_locks),1E-3*g_num_mutex_locks/(t1-t0));
-    fflush(stdout);
+    return t1-t0;
   }
 
   void benchmark_barrier_sys_thread(void* ptr) 
@@ -96,7 +104,7 @@ namespace embree
       g_barrier.wait();
   }
   
-  void benchmark_barrier_sys ()
+  double benchmark_barrier_sys ()
   {
     size_t numThreads = getNumberOfLogicalThreads();
 #if defined (__MIC__)
@@ -119,15 +127,14 @@ namespace embree
 
     g_threads.clear();
 
-    printf("%30s ... %f ms (%f k/s)\n","barrier_sys",1000.0f*(t1-t0)/double(g_num_barrier_waits),1E-3*g_num_barrier_waits/(t1-t0));
-    fflush(stdout);
+    return t1-t0;
   }
 
   void benchmark_barrier_sys_thread2(void* ptr) {
     g_barrier2.wait();
   }
 
-  void benchmark_barrier_sys_oversubscribed ()
+  double benchmark_barrier_sys_oversubscribed ()
   {
     size_t numThreads = getNumberOfLogicalThreads();
 #if defined (__MIC__)
@@ -159,8 +166,7 @@ namespace embree
     g_threads.clear();
     g_threads2.clear();
 
-    printf("%30s ... %f ms (%f k/s)\n","barrier_sys_oversubscribed",1000.0f*(t1-t0)/double(g_num_barrier_waits),1E-3*g_num_barrier_waits/(t1-t0));
-    fflush(stdout);
+    return t1-t0;
   }
 
   RTCRay makeRay(Vec3f org, Vec3f dir) 
@@ -236,31 +242,322 @@ namespace embree
     ray_o.instID[i] = ray_i.instID;
   }
 
-  static void parseCommandLine(int argc, char** argv)
+  /* triangle mesh */
+  struct Mesh {
+    std::vector<Vertex> vertices;
+    std::vector<Triangle> triangles;
+  };
+
+  /* scene to benchmark, either a set of spheres or an OBJ file */
+  struct BenchScene 
   {
-    for (int i=1; i<argc; i++)
+    BenchScene (const std::string& name, bool intersect) 
+      : name(name), intersect(intersect) {}
+
+    size_t numTriangles() const {
+      size_t N = 0;
+      for (size_t i=0; i<meshes.size(); i++) N += meshes[i].triangles.size();
+      return N;
+    }
+
+    BBox3f bounds() const 
     {
-      std::string tag = argv[i];
-      if (tag == "") return;
+      BBox3f b = empty;
+      for (size_t i=0; i<meshes.size(); i++)
+        for (size_t j=0; j<meshes[i].vertices.size(); j++) {
+          const Vertex& v = meshes[i].vertices[j];
+          b.extend(Vec3f(v.x,v.y,v.z));
+        }
+      return b;
+    }
 
-      /* rtcore configuration */
-      else if (tag == "-rtcore" && i+1<argc) {
-        g_rtcore = argv[++i];
-      }
+    std::string name;
+    bool intersect;              //!< also run ray benchmarks for this scene
+    std::vector<Mesh> meshes;
+  };
 
-      /* skip unknown command line parameter */
-      else {
-        std::cerr << "unknown command line parameter: " << tag << " ";
-        std::cerr << std::endl;
+  /* result of one benchmark in one configuration */
+  struct Result
+  {
+    std::string key() const 
+    {
+      std::stringstream str;
+      str << benchmark << "|" << scene << "|" << tri_accel << "|" << builder << "|" << threads;
+      return str.str();
+    }
+
+    double median() const 
+    {
+      std::vector<double> s = samples; std::sort(s.begin(),s.end());
+      const size_t N = s.size();
+      if (N == 0) return 0.0;
+      return (N%2) ? s[N/2] : 0.5*(s[N/2-1]+s[N/2]);
+    }
+
+    double percentile(double p) const 
+    {
+      std::vector<double> s = samples; std::sort(s.begin(),s.end());
+      if (s.size() == 0) return 0.0;
+      size_t i = (size_t) ceil(p*s.size());
+      return s[i > 0 ? i-1 : 0];
+    }
+
+    double minimum() const {
+      return samples.size() ? *std::min_element(samples.begin(),samples.end()) : 0.0;
+    }
+
+    std::string benchmark;
+    std::string scene;
+    std::string tri_accel;
+    std::string builder;
+    size_t threads;
+    std::string unit;            //!< unit of work, e.g. Mrays/s or Mtris/s
+    double work;                 //!< work per run in millions of units
+    std::vector<double> samples; //!< seconds per timed run
+  };
+
+  std::vector<Result> g_results;
+
+  /* base class of all benchmarks, a benchmark performs one timed run */
+  struct Benchmark
+  {
+    Benchmark (const std::string& name, const std::string& unit, double work) 
+      : name(name), unit(unit), work(work) {}
+    virtual ~Benchmark() {}
+
+    /*! performs a single run and returns the measured time in seconds */
+    virtual double run() = 0;
+
+    std::string name;
+    std::string unit;
+    double work;
+  };
+
+  void measure(Benchmark& bench, const std::string& scene)
+  {
+    Result result;
+    result.benchmark = bench.name;
+    result.scene = scene;
+    result.tri_accel = g_cur_tri_accel;
+    result.builder = g_cur_builder;
+    result.threads = g_cur_threads;
+    result.unit = bench.unit;
+    result.work = bench.work;
+
+    for (size_t i=0; i<g_warmup; i++) bench.run();
+    for (size_t i=0; i<g_repeat; i++) result.samples.push_back(bench.run());
+    g_results.push_back(result);
+
+    const double median = result.median();
+    printf("%30s %-20s ... median %f ms, p95 %f ms, %f %s\n",bench.name.c_str(),scene.c_str(),
+           1000.0*median,1000.0*result.percentile(0.95),bench.work/median,bench.unit.c_str());
+    fflush(stdout);
+  }
+
+  struct SyncBenchmark : public Benchmark
+  {
+    SyncBenchmark (const std::string& name, double (*func)(), size_t ops) 
+      : Benchmark(name,"Mops/s",1E-6*double(ops)), func(func) {}
+
+    double run() { return func(); }
+
+    double (*func)();
+  };
+
+  /* fill all meshes of the scene into a new embree scene */
+  RTCScene createScene(const BenchScene& bscene, RTCSceneFlags sflags, RTCGeometryFlags gflags)
+  {
+    RTCScene scene = rtcNewScene(sflags,aflags);
+    for (size_t i=0; i<bscene.meshes.size(); i++) 
+    {
+      const Mesh& mesh = bscene.meshes[i];
+      unsigned geom = rtcNewTriangleMesh (scene, gflags, mesh.triangles.size(), mesh.vertices.size());
+      memcpy(rtcMapBuffer(scene,geom,RTC_VERTEX_BUFFER), &mesh.vertices[0], mesh.vertices.size()*sizeof(Vertex));
+      memcpy(rtcMapBuffer(scene,geom,RTC_INDEX_BUFFER ), &mesh.triangles[0], mesh.triangles.size()*sizeof(Triangle));
+      rtcUnmapBuffer(scene,geom,RTC_VERTEX_BUFFER);
+      rtcUnmapBuffer(scene,geom,RTC_INDEX_BUFFER);
+    }
+    return scene;
+  }
+
+  struct CreateBenchmark : public Benchmark
+  {
+    CreateBenchmark (const std::string& name, const BenchScene& scene, RTCSceneFlags sflags, RTCGeometryFlags gflags) 
+      : Benchmark(name,"Mtris/s",1E-6*double(scene.numTriangles())), scene(scene), sflags(sflags), gflags(gflags) {}
+
+    double run() 
+    {
+      double t0 = getSeconds();
+      RTCScene s = createScene(scene,sflags,gflags);
+      rtcCommit (s);
+      double t1 = getSeconds();
+      rtcDeleteScene(s);
+      return t1-t0;
+    }
+
+    const BenchScene& scene;
+    RTCSceneFlags sflags;
+    RTCGeometryFlags gflags;
+  };
+
+  struct UpdateBenchmark : public Benchmark
+  {
+    UpdateBenchmark (const std::string& name, const BenchScene& scene, RTCGeometryFlags gflags) 
+      : Benchmark(name,"Mtris/s",1E-6*double(scene.numTriangles())), scene(scene), gflags(gflags) {}
+
+    double run() 
+    {
+      RTCScene s = createScene(scene,RTC_SCENE_DYNAMIC,gflags);
+      rtcCommit (s);
+      double t0 = getSeconds();
+      for (size_t i=0; i<scene.meshes.size(); i++) rtcUpdate(s,i);
+      rtcCommit (s);
+      double t1 = getSeconds();
+      rtcDeleteScene(s);
+      return t1-t0;
+    }
+
+    const BenchScene& scene;
+    RTCGeometryFlags gflags;
+  };
+
+  /* traces packets of rays of the specified width */
+  double intersectRays(RTCScene scene, const Vec3f& org, const Vec3f* dirs, size_t N, size_t width)
+  {
+    double t0 = getSeconds();
+    switch (width) 
+    {
+    case 1: {
+      for (size_t i=0; i<N; i++) {
+        RTCRay ray = makeRay(org,dirs[i]);
+        rtcIntersect(scene,ray);
       }
+      break;
     }
+    case 4: {
+      for (size_t i=0; i<N; i+=4) {
+        RTCRay4 ray4;
+        for (size_t j=0; j<4; j++) setRay(ray4,j,makeRay(org,dirs[i+j]));
+        __align(16) int valid4[4] = { -1,-1,-1,-1 };
+        rtcIntersect4(valid4,scene,ray4);
+      }
+      break;
+    }
+    case 8: {
+      for (size_t i=0; i<N; i+=8) {
+        RTCRay8 ray8;
+        for (size_t j=0; j<8; j++) setRay(ray8,j,makeRay(org,dirs[i+j]));
+        __align(32) int valid8[8] = { -1,-1,-1,-1,-1,-1,-1,-1 };
+        rtcIntersect8(valid8,scene,ray8);
+      }
+      break;
+    }
+    case 16: {
+      for (size_t i=0; i<N; i+=16) {
+        RTCRay16 ray16;
+        for (size_t j=0; j<16; j++) setRay(ray16,j,makeRay(org,dirs[i+j]));
+        __align(64) int valid16[16] = { -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1 };
+        rtcIntersect16(valid16,scene,ray16);
+      }
+      break;
+    }
+    }
+    double t1 = getSeconds();
+    return t1-t0;
   }
 
-  struct Mesh {
-    std::vector<Vertex> vertices;
-    std::vector<Triangle> triangles;
+  bool packetSupported(size_t width)
+  {
+    switch (width) {
+    case 1: return true;
+#if !defined(__MIC__)
+    case 4: return true;
+#else
+    case 16: return true;
+#endif
+#if defined(__TARGET_AVX__) || defined(__TARGET_AVX2__)
+    case 8: return has_feature(AVX);
+#endif
+    default: return false;
+    }
+  }
+
+  struct IntersectBenchmark : public Benchmark
+  {
+    IntersectBenchmark (const std::string& name, RTCScene scene, const Vec3f& org, const std::vector<Vec3f>& dirs, size_t width) 
+      : Benchmark(name,"Mrays/s",1E-6*double(dirs.size())), scene(scene), org(org), dirs(dirs), width(width) {}
+
+    double run() {
+      return intersectRays(scene,org,&dirs[0],dirs.size(),width);
+    }
+
+    RTCScene scene;
+    Vec3f org;
+    const std::vector<Vec3f>& dirs;
+    size_t width;
   };
 
+  void rtcore_intersect_benchmark(const BenchScene& bscene)
+  {
+    RTCScene scene = createScene(bscene,RTC_SCENE_STATIC,RTC_GEOMETRY_STATIC);
+    rtcCommit (scene);
+    
+    const BBox3f bounds = bscene.bounds();
+    const Vec3f center = 0.5f*(bounds.lower+bounds.upper);
+    const float extent = length(bounds.upper-bounds.lower);
+
+    /* coherent rays of a pinhole camera that sees the entire scene */
+    const size_t width = 1024, height = 1024;
+    const float rcpWidth = 1.0f/float(width), rcpHeight = 1.0f/float(height);
+    std::vector<Vec3f> coherent(width*height);
+    for (size_t y=0; y<height; y+=4) 
+      for (size_t x=0; x<width; x+=4) 
+        for (size_t dy=0; dy<4; dy++) 
+          for (size_t dx=0; dx<4; dx++) 
+            coherent[y*width+4*x+4*dy+dx] = Vec3f(float(x+dx)*rcpWidth-0.5f,float(y+dy)*rcpHeight-0.5f,1.0f);
+    
+    /* incoherent rays starting at the scene center */
+    std::vector<Vec3f> incoherent(width*height);
+    for (size_t i=0; i<incoherent.size(); i++) {
+      float x = 2.0f*drand48()-1.0f;
+      float y = 2.0f*drand48()-1.0f;
+      float z = 2.0f*drand48()-1.0f;
+      incoherent[i] = Vec3f(x,y,z);
+    }
+
+    for (size_t i=0; i<g_packets.size(); i++) 
+    {
+      const size_t w = g_packets[i];
+      if (!packetSupported(w)) continue;
+      std::stringstream name; name << "coherent_intersect" << w;
+      IntersectBenchmark bench(name.str(),scene,center-Vec3f(0.0f,0.0f,extent),coherent,w);
+      measure(bench,bscene.name);
+    }
+
+    for (size_t i=0; i<g_packets.size(); i++) 
+    {
+      const size_t w = g_packets[i];
+      if (!packetSupported(w)) continue;
+      std::stringstream name; name << "incoherent_intersect" << w;
+      IntersectBenchmark bench(name.str(),scene,center,incoherent,w);
+      measure(bench,bscene.name);
+    }
+
+    rtcDeleteScene(scene);
+  }
+
+  void rtcore_build_benchmark(const BenchScene& scene)
+  {
+    CreateBenchmark create_static ("create_static_geometry", scene,RTC_SCENE_STATIC, RTC_GEOMETRY_STATIC);
+    CreateBenchmark create_dynamic("create_dynamic_geometry",scene,RTC_SCENE_DYNAMIC,RTC_GEOMETRY_STATIC);
+    UpdateBenchmark refit ("refit_geometry", scene,RTC_GEOMETRY_DEFORMABLE);
+    UpdateBenchmark update("update_geometry",scene,RTC_GEOMETRY_DYNAMIC);
+    measure(create_static, scene.name);
+    measure(create_dynamic,scene.name);
+    measure(refit,         scene.name);
+    measure(update,        scene.name);
+  }
+
   void createSphereMesh (const Vec3f pos, const float r, size_t numPhi, Mesh& mesh_o)
   {
     /* create a triangulated sphere */
@@ -313,281 +610,260 @@ namespace embree
     }
   }
 
-  unsigned addSphere (RTCScene scene, RTCGeometryFlags flag, const Vec3f pos, const float r, size_t numPhi)
-  {
-    Mesh mesh; createSphereMesh (pos, r, numPhi, mesh);
-    unsigned geom = rtcNewTriangleMesh (scene, flag, mesh.triangles.size(), mesh.vertices.size());
-    memcpy(rtcMapBuffer(scene,geom,RTC_VERTEX_BUFFER), &mesh.vertices[0], mesh.vertices.size()*sizeof(Vertex));
-    memcpy(rtcMapBuffer(scene,geom,RTC_INDEX_BUFFER ), &mesh.triangles[0], mesh.triangles.size()*sizeof(Triangle));
-    rtcUnmapBuffer(scene,geom,RTC_VERTEX_BUFFER);
-    rtcUnmapBuffer(scene,geom,RTC_INDEX_BUFFER);
-    return geom;
-  }
-
-  double rtcore_create_geometry(RTCSceneFlags sflags, RTCGeometryFlags gflags, size_t numPhi, size_t numMeshes)
+  /* creates numMeshes spheres, each shifted by one unit against the previous one */
+  BenchScene createSphereScene (const std::string& name, size_t numPhi, size_t numMeshes, bool intersect)
   {
+    BenchScene scene(name,intersect);
     Mesh mesh; createSphereMesh (Vec3f(0,0,0), 1, numPhi, mesh);
-
-    double t0 = getSeconds();
-    RTCScene scene = rtcNewScene(sflags,aflags);
-
     for (size_t i=0; i<numMeshes; i++) 
     {
-      unsigned geom = rtcNewTriangleMesh (scene, gflags, mesh.triangles.size(), mesh.vertices.size());
-      memcpy(rtcMapBuffer(scene,geom,RTC_VERTEX_BUFFER), &mesh.vertices[0], mesh.vertices.size()*sizeof(Vertex));
-      memcpy(rtcMapBuffer(scene,geom,RTC_INDEX_BUFFER ), &mesh.triangles[0], mesh.triangles.size()*sizeof(Triangle));
-      rtcUnmapBuffer(scene,geom,RTC_VERTEX_BUFFER);
-      rtcUnmapBuffer(scene,geom,RTC_INDEX_BUFFER);
+      scene.meshes.push_back(mesh);
       for (size_t i=0; i<mesh.vertices.size(); i++) {
         mesh.vertices[i].x += 1.0f;
         mesh.vertices[i].y += 1.0f;
         mesh.vertices[i].z += 1.0f;
       }
     }
-    rtcCommit (scene);
-    double t1 = getSeconds();
-    rtcDeleteScene(scene);
+    return scene;
+  }
 
-    size_t numTriangles = mesh.triangles.size() * numMeshes;
-    return double(numTriangles)/(t1-t0);
+  /* parses a vertex index of an OBJ face, negative indices are relative to the end */
+  int parseOBJIndex(const std::string& tok, size_t numVertices) 
+  {
+    int i = atoi(tok.c_str());
+    if (i < 0) return int(numVertices)+i;
+    return i-1;
   }
-  
-  double rtcore_update_geometry(RTCGeometryFlags flags, size_t numPhi, size_t numMeshes)
+
+  /* loads positions and faces of an OBJ file into a single mesh, polygons get triangulated as fans */
+  BenchScene loadOBJ (const std::string& fileName)
   {
-    Mesh mesh; createSphereMesh (Vec3f(0,0,0), 1, numPhi, mesh);
-    RTCScene scene = rtcNewScene(RTC_SCENE_DYNAMIC,aflags);
+    std::ifstream file(fileName.c_str());
+    if (!file) throw std::runtime_error("cannot open file "+fileName);
 
-    for (size_t i=0; i<numMeshes; i++) 
+    size_t slash = fileName.find_last_of("/\\");
+    BenchScene scene(slash == std::string::npos ? fileName : fileName.substr(slash+1),true);
+    Mesh mesh;
+
+    std::string line;
+    while (std::getline(file,line))
     {
-      unsigned geom = rtcNewTriangleMesh (scene, flags, mesh.triangles.size(), mesh.vertices.size());
-      memcpy(rtcMapBuffer(scene,geom,RTC_VERTEX_BUFFER), &mesh.vertices[0], mesh.vertices.size()*sizeof(Vertex));
-      memcpy(rtcMapBuffer(scene,geom,RTC_INDEX_BUFFER ), &mesh.triangles[0], mesh.triangles.size()*sizeof(Triangle));
-      rtcUnmapBuffer(scene,geom,RTC_VERTEX_BUFFER);
-      rtcUnmapBuffer(scene,geom,RTC_INDEX_BUFFER);
-      for (size_t i=0; i<mesh.vertices.size(); i++) {
-        mesh.vertices[i].x += 1.0f;
-        mesh.vertices[i].y += 1.0f;
-        mesh.vertices[i].z += 1.0f;
+      std::stringstream str(line);
+      std::string cmd; str >> cmd;
+      if (cmd == "v") {
+        Vertex v; v.a = 0.0f;
+        str >> v.x >> v.y >> v.z;
+        mesh.vertices.push_back(v);
+      }
+      else if (cmd == "f") {
+        std::vector<int> face;
+        std::string tok;
+        while (str >> tok) face.push_back(parseOBJIndex(tok,mesh.vertices.size()));
+        for (size_t i=2; i<face.size(); i++) {
+          Triangle tri; tri.v0 = face[0]; tri.v1 = face[i-1]; tri.v2 = face[i];
+          mesh.triangles.push_back(tri);
+        }
       }
     }
-    rtcCommit (scene);
+    if (mesh.triangles.size() == 0) 
+      throw std::runtime_error("no triangles found in "+fileName);
 
-    double t0 = getSeconds();
-    for (size_t i=0; i<numMeshes; i++) rtcUpdate(scene,i);
-    rtcCommit (scene);
-    double t1 = getSeconds();
-    rtcDeleteScene(scene);
-
-    size_t numTriangles = mesh.triangles.size() * numMeshes;
-    return double(numTriangles)/(t1-t0);
+    scene.meshes.push_back(mesh);
+    return scene;
   }
 
-  void rtcore_coherent_intersect1(RTCScene scene)
+  /* splits a comma separated list */
+  std::vector<std::string> parseList(const std::string& str)
   {
-    size_t width = 1024;
-    size_t height = 1024;
-    float rcpWidth = 1.0f/1024.0f;
-    float rcpHeight = 1.0f/1024.0f;
-    double t0 = getSeconds();
-    for (size_t y=0; y<height; y++) {
-      for (size_t x=0; x<width; x++) {
-        RTCRay ray = makeRay(zero,Vec3f(float(x)*rcpWidth,1,float(y)*rcpHeight));
-        rtcIntersect(scene,ray);
-      }
-    }
-    double t1 = getSeconds();
-
-    printf("%30s ... %f Mrps\n","coherent_intersect1",1E-6*(double)(width*height)/(t1-t0));
-    fflush(stdout);
+    std::vector<std::string> list;
+    std::stringstream stream(str);
+    std::string item;
+    while (std::getline(stream,item,',')) 
+      if (item != "") list.push_back(item);
+    return list;
   }
 
-  void rtcore_coherent_intersect4(RTCScene scene)
+  std::vector<size_t> parseSizeList(const std::string& str)
   {
-    size_t width = 1024;
-    size_t height = 1024;
-    float rcpWidth = 1.0f/1024.0f;
-    float rcpHeight = 1.0f/1024.0f;
-    double t0 = getSeconds();
-    for (size_t y=0; y<height; y+=2) {
-      for (size_t x=0; x<width; x+=2) {
-        RTCRay4 ray4; 
-        for (size_t dy=0; dy<2; dy++) {
-          for (size_t dx=0; dx<2; dx++) {
-            setRay(ray4,2*dy+dx,makeRay(zero,Vec3f(float(x+dx)*rcpWidth,1,float(y+dy)*rcpHeight)));
-          }
-        }
-        __align(16) int valid4[4] = { -1,-1,-1,-1 };
-        rtcIntersect4(valid4,scene,ray4);
-      }
-    }
-    double t1 = getSeconds();
-
-    printf("%30s ... %f Mrps\n","coherent_intersect4",1E-6*(double)(width*height)/(t1-t0));
-	fflush(stdout);
+    std::vector<std::string> list = parseList(str);
+    std::vector<size_t> sizes;
+    for (size_t i=0; i<list.size(); i++) sizes.push_back(atoi(list[i].c_str()));
+    return sizes;
   }
 
-  void rtcore_coherent_intersect8(RTCScene scene)
-  {
-    size_t width = 1024;
-    size_t height = 1024;
-    float rcpWidth = 1.0f/1024.0f;
-    float rcpHeight = 1.0f/1024.0f;
-    double t0 = getSeconds();
-    for (size_t y=0; y<height; y+=4) {
-      for (size_t x=0; x<width; x+=2) {
-        RTCRay8 ray8; 
-        for (size_t dy=0; dy<4; dy++) {
-          for (size_t dx=0; dx<2; dx++) {
-            setRay(ray8,2*dy+dx,makeRay(zero,Vec3f(float(x+dx)*rcpWidth,1,float(y+dy)*rcpHeight)));
-          }
-        }
-        __align(32) int valid8[8] = { -1,-1,-1,-1,-1,-1,-1,-1 };
-        rtcIntersect8(valid8,scene,ray8);
-      }
-    }
-    double t1 = getSeconds();
+  bool enabled(const std::string& group) {
+    return std::find(g_groups.begin(),g_groups.end(),group) != g_groups.end();
+  }
 
-    printf("%30s ... %f Mrps\n","coherent_intersect8",1E-6*(double)(width*height)/(t1-t0));
-	fflush(stdout);
+  bool hasExtension(const std::string& fileName, const std::string& ext) {
+    return fileName.size() >= ext.size() && fileName.substr(fileName.size()-ext.size()) == ext;
   }
 
-  void rtcore_coherent_intersect16(RTCScene scene)
+  /* stores all results as JSON array or as CSV table */
+  void storeResults(const std::string& fileName)
   {
-    size_t width = 1024;
-    size_t height = 1024;
-    float rcpWidth = 1.0f/1024.0f;
-    float rcpHeight = 1.0f/1024.0f;
-    double t0 = getSeconds();
-    for (size_t y=0; y<height; y+=4) {
-      for (size_t x=0; x<width; x+=4) {
-        RTCRay16 ray16; 
-        for (size_t dy=0; dy<4; dy++) {
-          for (size_t dx=0; dx<4; dx++) {
-            setRay(ray16,4*dy+dx,makeRay(zero,Vec3f(float(x+dx)*rcpWidth,1,float(y+dy)*rcpHeight)));
-          }
-        }
-        __align(64) int valid16[16] = { -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1 };
-        rtcIntersect16(valid16,scene,ray16);
-      }
-    }
-    double t1 = getSeconds();
+    std::ofstream file(fileName.c_str());
+    if (!file) throw std::runtime_error("cannot open file "+fileName);
+    const bool json = hasExtension(fileName,".json");
 
-    printf("%30s ... %f Mrps\n","coherent_intersect16",1E-6*(double)(width*height)/(t1-t0));
-	fflush(stdout);
-  }
+    if (json) file << "[" << std::endl;
+    else file << "benchmark,scene,tri_accel,builder,threads,runs,median_ms,p95_ms,min_ms,throughput,unit" << std::endl;
 
-  void rtcore_incoherent_intersect1(RTCScene scene, Vec3f* numbers, size_t N)
-  {
-    double t0 = getSeconds();
-    for (size_t i=0; i<N; i++) {
-      RTCRay ray = makeRay(zero,numbers[i]);
-      rtcIntersect(scene,ray);
+    for (size_t i=0; i<g_results.size(); i++)
+    {
+      const Result& r = g_results[i];
+      const double median = r.median();
+      if (json) {
+        file << "  {\"benchmark\":\"" << r.benchmark << "\",\"scene\":\"" << r.scene 
+             << "\",\"tri_accel\":\"" << r.tri_accel << "\",\"builder\":\"" << r.builder 
+             << "\",\"threads\":" << r.threads << ",\"runs\":" << r.samples.size()
+             << ",\"median_ms\":" << 1000.0*median << ",\"p95_ms\":" << 1000.0*r.percentile(0.95) 
+             << ",\"min_ms\":" << 1000.0*r.minimum() << ",\"throughput\":" << r.work/median 
+             << ",\"unit\":\"" << r.unit << "\"}" << (i+1 < g_results.size() ? "," : "") << std::endl;
+      } else {
+        file << r.benchmark << "," << r.scene << "," << r.tri_accel << "," << r.builder << "," 
+             << r.threads << "," << r.samples.size() << "," << 1000.0*median << "," 
+             << 1000.0*r.percentile(0.95) << "," << 1000.0*r.minimum() << "," << r.work/median 
+             << "," << r.unit << std::endl;
+      }
     }
-    double t1 = getSeconds();
-
-    printf("%30s ... %f Mrps\n","incoherent_intersect1",1E-6*(double)N/(t1-t0));
-	fflush(stdout);
   }
 
-  void rtcore_incoherent_intersect4(RTCScene scene, Vec3f* numbers, size_t N)
+  /* reads the value of a field from a line of the JSON result file */
+  std::string parseJSONField(const std::string& line, const std::string& field)
   {
-    double t0 = getSeconds();
-    for (size_t i=0; i<N; i+=4) {
-      RTCRay4 ray4;
-      for (size_t j=0; j<4; j++) {
-        setRay(ray4,j,makeRay(zero,numbers[i+j]));
-      }
-      __align(16) int valid4[4] = { -1,-1,-1,-1 };
-      rtcIntersect4(valid4,scene,ray4);
+    size_t pos = line.find("\"" + field + "\":");
+    if (pos == std::string::npos) return "";
+    pos += field.size()+3;
+    if (pos < line.size() && line[pos] == '"') {
+      size_t end = line.find('"',pos+1);
+      return line.substr(pos+1,end-pos-1);
     }
-    double t1 = getSeconds();
-
-    printf("%30s ... %f Mrps\n","incoherent_intersect4",1E-6*(double)N/(t1-t0));
-	fflush(stdout);
+    size_t end = line.find_first_of(",}",pos);
+    return line.substr(pos,end-pos);
   }
 
-  void rtcore_incoherent_intersect8(RTCScene scene, Vec3f* numbers, size_t N)
+  /* loads median times of a previous JSON or CSV result file */
+  std::map<std::string,double> loadBaseline(const std::string& fileName)
   {
-    double t0 = getSeconds();
-    for (size_t i=0; i<N; i+=8) {
-      RTCRay8 ray8;
-      for (size_t j=0; j<8; j++) {
-        setRay(ray8,j,makeRay(zero,numbers[i+j]));
+    std::ifstream file(fileName.c_str());
+    if (!file) throw std::runtime_error("cannot open file "+fileName);
+    const bool json = hasExtension(fileName,".json");
+    std::map<std::string,double> baseline;
+
+    std::string line;
+    std::vector<std::string> header;
+    while (std::getline(file,line))
+    {
+      std::map<std::string,std::string> fields;
+      if (json) {
+        if (line.find("\"benchmark\"") == std::string::npos) continue;
+        const char* names[] = { "benchmark", "scene", "tri_accel", "builder", "threads", "median_ms" };
+        for (size_t i=0; i<6; i++) fields[names[i]] = parseJSONField(line,names[i]);
+      } 
+      else {
+        std::vector<std::string> values = parseList(line);
+        if (header.size() == 0) { header = values; continue; }
+        for (size_t i=0; i<values.size() && i<header.size(); i++) fields[header[i]] = values[i];
       }
-      __align(16) int valid8[8] = { -1,-1,-1,-1,-1,-1,-1,-1 };
-      rtcIntersect8(valid8,scene,ray8);
+      Result r;
+      r.benchmark = fields["benchmark"];
+      r.scene = fields["scene"];
+      r.tri_accel = fields["tri_accel"];
+      r.builder = fields["builder"];
+      r.threads = atoi(fields["threads"].c_str());
+      baseline[r.key()] = atof(fields["median_ms"].c_str());
     }
-    double t1 = getSeconds();
-
-    printf("%30s ... %f Mrps\n","incoherent_intersect8",1E-6*(double)N/(t1-t0));
-	fflush(stdout);
+    return baseline;
   }
 
-  void rtcore_incoherent_intersect16(RTCScene scene, Vec3f* numbers, size_t N)
+  /* compares all results against the baseline and returns the number of regressions */
+  size_t compareResults(const std::string& fileName)
   {
-    double t0 = getSeconds();
-    for (size_t i=0; i<N; i+=16) {
-      RTCRay16 ray16;
-      for (size_t j=0; j<16; j++) {
-        setRay(ray16,j,makeRay(zero,numbers[i+j]));
+    std::map<std::string,double> baseline = loadBaseline(fileName);
+    size_t numRegressions = 0, numCompared = 0;
+
+    printf("\ncomparing against %s (threshold %f%%)\n",fileName.c_str(),g_threshold);
+    for (size_t i=0; i<g_results.size(); i++)
+    {
+      const Result& r = g_results[i];
+      std::map<std::string,double>::iterator it = baseline.find(r.key());
+      if (it == baseline.end() || it->second <= 0.0) continue;
+      numCompared++;
+      const double change = 100.0*(1000.0*r.median()-it->second)/it->second;
+      if (change > g_threshold) {
+        printf("%30s %-20s ... REGRESSION %+f%% (%f ms -> %f ms)\n",r.benchmark.c_str(),r.scene.c_str(),change,it->second,1000.0*r.median());
+        numRegressions++;
       }
-      __align(64) int valid16[16] = { -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1 };
-      rtcIntersect16(valid16,scene,ray16);
+      else if (change < -g_threshold) 
+        printf("%30s %-20s ... improved %+f%%\n",r.benchmark.c_str(),r.scene.c_str(),change);
     }
-    double t1 = getSeconds();
-
-    printf("%30s ... %f Mrps\n","incoherent_intersect16",1E-6*(double)N/(t1-t0));
-	fflush(stdout);
+    printf("%d of %d benchmarks regressed\n",(int)numRegressions,(int)numCompared);
+    fflush(stdout);
+    return numRegressions;
   }
 
-  void rtcore_intersect_benchmark(RTCSceneFlags flags, size_t numPhi)
+  static void parseCommandLine(int argc, char** argv)
   {
-    RTCScene scene = rtcNewScene(flags,aflags);
-    addSphere (scene, RTC_GEOMETRY_STATIC, zero, 1, numPhi);
-    rtcCommit (scene);
-
-    rtcore_coherent_intersect1(scene);
-#if !defined(__MIC__)
-    rtcore_coherent_intersect4(scene);
-#endif
-
-#if defined(__TARGET_AVX__) || defined(__TARGET_AVX2__)
-    if (has_feature(AVX)) {
-      rtcore_coherent_intersect8(scene);
-    }
-#endif
+    for (int i=1; i<argc; i++)
+    {
+      std::string tag = argv[i];
+      if (tag == "") return;
 
-#if defined(__MIC__)
-    rtcore_coherent_intersect16(scene);
-#endif
+      /* rtcore configuration */
+      else if (tag == "-rtcore" && i+1<argc) {
+        g_rtcore = argv[++i];
+      }
 
-    size_t N = 1024*1024;
-    Vec3f* numbers = new Vec3f[N];
-    for (size_t i=0; i<N; i++) {
-      float x = 2.0f*drand48()-1.0f;
-      float y = 2.0f*drand48()-1.0f;
-      float z = 2.0f*drand48()-1.0f;
-      numbers[i] = Vec3f(x,y,z);
-    }
+      /* OBJ scene to benchmark, can be specified multiple times */
+      else if (tag == "-i" && i+1<argc) {
+        g_objFiles.push_back(argv[++i]);
+      }
 
-    rtcore_incoherent_intersect1(scene,numbers,N);
-#if !defined(__MIC__)
-    rtcore_incoherent_intersect4(scene,numbers,N);
-#endif
+      /* comma separated lists of configurations to sweep over */
+      else if (tag == "-tri_accel" && i+1<argc) {
+        g_tri_accels = parseList(argv[++i]);
+      }
+      else if (tag == "-builder" && i+1<argc) {
+        g_builders = parseList(argv[++i]);
+      }
+      else if (tag == "-threads" && i+1<argc) {
+        g_threads_list = parseSizeList(argv[++i]);
+      }
+      else if (tag == "-packets" && i+1<argc) {
+        g_packets = parseSizeList(argv[++i]);
+      }
 
-#if defined(__TARGET_AVX__) || defined(__TARGET_AVX2__)
-    if (has_feature(AVX)) {
-      rtcore_incoherent_intersect8(scene,numbers,N);
-    }
-#endif
+      /* benchmark groups to run */
+      else if (tag == "-benchmarks" && i+1<argc) {
+        g_groups = parseList(argv[++i]);
+      }
 
-#if defined(__MIC__)
-    rtcore_incoherent_intersect16(scene,numbers,N);
-#endif
+      /* number of warm-up and timed runs */
+      else if (tag == "-warmup" && i+1<argc) {
+        g_warmup = atoi(argv[++i]);
+      }
+      else if (tag == "-repeat" && i+1<argc) {
+        g_repeat = max(1,atoi(argv[++i]));
+      }
 
-    delete numbers;
+      /* result output and comparison against baseline */
+      else if (tag == "-o" && i+1<argc) {
+        g_output = argv[++i];
+      }
+      else if (tag == "-compare" && i+1<argc) {
+        g_compare = argv[++i];
+      }
+      else if (tag == "-threshold" && i+1<argc) {
+        g_threshold = atof(argv[++i]);
+      }
 
-    rtcDeleteScene(scene);
+      /* skip unknown command line parameter */
+      else {
+        std::cerr << "unknown command line parameter: " << tag << " ";
+        std::cerr << std::endl;
+      }
+    }
   }
 
   /* main function in embree namespace */
@@ -596,64 +872,83 @@ namespace embree
     /* parse command line */  
     parseCommandLine(argc,argv);
 
-    /* perform tests */
-    rtcInit(g_rtcore.c_str());
+    if (g_tri_accels.size() == 0) g_tri_accels.push_back("default");
+    if (g_builders.size() == 0) g_builders.push_back("default");
+    if (g_threads_list.size() == 0) g_threads_list.push_back(0);
+    if (g_packets.size() == 0) {
+      g_packets.push_back(1); g_packets.push_back(4); g_packets.push_back(8); g_packets.push_back(16);
+    }
+    if (g_groups.size() == 0) {
+      g_groups.push_back("sync"); g_groups.push_back("build"); g_groups.push_back("intersect");
+    }
 
-    benchmark_mutex_sys();
-    benchmark_barrier_sys();
-    benchmark_barrier_sys_oversubscribed();
-    
-    rtcore_intersect_benchmark(RTC_SCENE_STATIC, 501);
-
-    BUILD   ("create_static_geometry_120",       rtcore_create_geometry(RTC_SCENE_STATIC,RTC_GEOMETRY_STATIC,6,1));
-    BUILD   ("create_static_geometry_1k",        rtcore_create_geometry(RTC_SCENE_STATIC,RTC_GEOMETRY_STATIC,17,1));
-    BUILD   ("create_static_geometry_10k",       rtcore_create_geometry(RTC_SCENE_STATIC,RTC_GEOMETRY_STATIC,51,1));
-    BUILD   ("create_static_geometry_100k",      rtcore_create_geometry(RTC_SCENE_STATIC,RTC_GEOMETRY_STATIC,159,1));
-    BUILD   ("create_static_geometry_1000k_1",   rtcore_create_geometry(RTC_SCENE_STATIC,RTC_GEOMETRY_STATIC,501,1));
-    BUILD   ("create_static_geometry_100k_10",   rtcore_create_geometry(RTC_SCENE_STATIC,RTC_GEOMETRY_STATIC,159,10));
-    BUILD   ("create_static_geometry_10k_100",   rtcore_create_geometry(RTC_SCENE_STATIC,RTC_GEOMETRY_STATIC,51,100));
-    BUILD   ("create_static_geometry_1k_1000",   rtcore_create_geometry(RTC_SCENE_STATIC,RTC_GEOMETRY_STATIC,17,1000));
-#if defined(__X86_64__)
-    BUILD   ("create_static_geometry_120_10000", rtcore_create_geometry(RTC_SCENE_STATIC,RTC_GEOMETRY_STATIC,6,8334));
-#endif
+    /* create scenes */
+    std::vector<BenchScene> scenes;
+    for (size_t i=0; i<g_objFiles.size(); i++)
+      scenes.push_back(loadOBJ(g_objFiles[i]));
 
-    BUILD   ("create_dynamic_geometry_120",       rtcore_create_geometry(RTC_SCENE_DYNAMIC,RTC_GEOMETRY_STATIC,6,1));
-    BUILD   ("create_dynamic_geometry_1k",        rtcore_create_geometry(RTC_SCENE_DYNAMIC,RTC_GEOMETRY_STATIC,17,1));
-    BUILD   ("create_dynamic_geometry_10k",       rtcore_create_geometry(RTC_SCENE_DYNAMIC,RTC_GEOMETRY_STATIC,51,1));
-    BUILD   ("create_dynamic_geometry_100k",      rtcore_create_geometry(RTC_SCENE_DYNAMIC,RTC_GEOMETRY_STATIC,159,1));
-    BUILD   ("create_dynamic_geometry_1000k_1",   rtcore_create_geometry(RTC_SCENE_DYNAMIC,RTC_GEOMETRY_STATIC,501,1));
-    BUILD   ("create_dynamic_geometry_100k_10",   rtcore_create_geometry(RTC_SCENE_DYNAMIC,RTC_GEOMETRY_STATIC,159,10));
-    BUILD   ("create_dynamic_geometry_10k_100",   rtcore_create_geometry(RTC_SCENE_DYNAMIC,RTC_GEOMETRY_STATIC,51,100));
-    BUILD   ("create_dynamic_geometry_1k_1000",   rtcore_create_geometry(RTC_SCENE_DYNAMIC,RTC_GEOMETRY_STATIC,17,1000));
+    if (scenes.size() == 0) 
+    {
+      scenes.push_back(createSphereScene("sphere_120",       6,   1, false));
+      scenes.push_back(createSphereScene("sphere_1k",        17,  1, false));
+      scenes.push_back(createSphereScene("sphere_10k",       51,  1, false));
+      scenes.push_back(createSphereScene("sphere_100k",      159, 1, false));
+      scenes.push_back(createSphereScene("sphere_1000k_1",   501, 1, true ));
+      scenes.push_back(createSphereScene("sphere_100k_10",   159, 10, false));
+      scenes.push_back(createSphereScene("sphere_10k_100",   51,  100, false));
+      scenes.push_back(createSphereScene("sphere_1k_1000",   17,  1000, false));
 #if defined(__X86_64__)
-    BUILD   ("create_dynamic_geometry_120_10000", rtcore_create_geometry(RTC_SCENE_DYNAMIC,RTC_GEOMETRY_STATIC,6,8334));
+      scenes.push_back(createSphereScene("sphere_120_10000", 6,   8334, false));
 #endif
+    }
 
-    BUILD   ("refit_geometry_120",        rtcore_update_geometry(RTC_GEOMETRY_DEFORMABLE,6,1));
-    BUILD   ("refit_geometry_1k",         rtcore_update_geometry(RTC_GEOMETRY_DEFORMABLE,17,1));
-    BUILD   ("refit_geometry_10k",        rtcore_update_geometry(RTC_GEOMETRY_DEFORMABLE,51,1));
-    BUILD   ("refit_geometry_100k",       rtcore_update_geometry(RTC_GEOMETRY_DEFORMABLE,159,1));
-    BUILD   ("refit_geometry_1000k_1",    rtcore_update_geometry(RTC_GEOMETRY_DEFORMABLE,501,1));
-    BUILD   ("refit_geometry_100k_10",    rtcore_update_geometry(RTC_GEOMETRY_DEFORMABLE,159,10));
-    BUILD   ("refit_geometry_10k_100",    rtcore_update_geometry(RTC_GEOMETRY_DEFORMABLE,51,100));
-    BUILD   ("refit_geometry_1k_1000",    rtcore_update_geometry(RTC_GEOMETRY_DEFORMABLE,17,1000));
-#if defined(__X86_64__)
-    BUILD   ("refit_geometry_120_10000",  rtcore_update_geometry(RTC_GEOMETRY_DEFORMABLE,6,8334));
-#endif
+    /* benchmark synchronization primitives */
+    if (enabled("sync")) 
+    {
+      SyncBenchmark mutex_sys("mutex_sys",benchmark_mutex_sys,g_num_mutex_locks);
+      SyncBenchmark barrier_sys("barrier_sys",benchmark_barrier_sys,g_num_barrier_waits);
+      SyncBenchmark barrier_sys_oversubscribed("barrier_sys_oversubscribed",benchmark_barrier_sys_oversubscribed,g_num_barrier_waits);
+      measure(mutex_sys,"-");
+      measure(barrier_sys,"-");
+      measure(barrier_sys_oversubscribed,"-");
+    }
 
-    BUILD   ("update_geometry_120",        rtcore_update_geometry(RTC_GEOMETRY_DYNAMIC,6,1));
-    BUILD   ("update_geometry_1k",         rtcore_update_geometry(RTC_GEOMETRY_DYNAMIC,17,1));
-    BUILD   ("update_geometry_10k",        rtcore_update_geometry(RTC_GEOMETRY_DYNAMIC,51,1));
-    BUILD   ("update_geometry_100k",       rtcore_update_geometry(RTC_GEOMETRY_DYNAMIC,159,1));
-    BUILD   ("update_geometry_1000k_1",    rtcore_update_geometry(RTC_GEOMETRY_DYNAMIC,501,1));
-    BUILD   ("update_geometry_100k_10",    rtcore_update_geometry(RTC_GEOMETRY_DYNAMIC,159,10));
-    BUILD   ("update_geometry_10k_100",    rtcore_update_geometry(RTC_GEOMETRY_DYNAMIC,51,100));
-    BUILD   ("update_geometry_1k_1000",    rtcore_update_geometry(RTC_GEOMETRY_DYNAMIC,17,1000));
-#if defined(__X86_64__)
-    BUILD   ("update_geometry_120_10000",  rtcore_update_geometry(RTC_GEOMETRY_DYNAMIC,6,8334));
-#endif
+    /* sweep over all configurations */
+    for (size_t t=0; t<g_threads_list.size(); t++)
+    {
+      for (size_t a=0; a<g_tri_accels.size(); a++)
+      {
+        for (size_t b=0; b<g_builders.size(); b++)
+        {
+          g_cur_threads = g_threads_list[t];
+          g_cur_tri_accel = g_tri_accels[a];
+          g_cur_builder = g_builders[b];
+
+          std::stringstream cfg;
+          cfg << g_rtcore;
+          if (g_cur_threads  != 0)         cfg << ",threads=" << g_cur_threads;
+          if (g_cur_tri_accel != "default") cfg << ",triaccel=" << g_cur_tri_accel;
+          if (g_cur_builder   != "default") cfg << ",builder=" << g_cur_builder;
+          printf("\nthreads = %d, tri_accel = %s, builder = %s\n",(int)g_cur_threads,g_cur_tri_accel.c_str(),g_cur_builder.c_str());
+
+          rtcInit(cfg.str().c_str());
+          for (size_t i=0; i<scenes.size(); i++) 
+          {
+            if (enabled("build")) 
+              rtcore_build_benchmark(scenes[i]);
+            if (enabled("intersect") && scenes[i].intersect) 
+              rtcore_intersect_benchmark(scenes[i]);
+          }
+          rtcExit();
+        }
+      }
+    }
+
+    if (g_output != "") 
+      storeResults(g_output);
 
-    rtcExit();
+    if (g_compare != "" && compareResults(g_compare) > 0) 
+      return 1;
 
     return 0;
   }
@@ -0,0 +1,435 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+
+/*! \file Microbenchmarks of the primitive intersectors and the BVH node
+    intersection kernels. Synthetic batches of rays and primitives are
+    fed directly into the kernels and the number of cycles per ray
+    primitive (or ray node) test is reported. The file is compiled once
+    per ISA, each executable benchmarks the kernels available for it. */
+
+#include "common/default.h"
+#include "common/ray.h"
+#include "common/ray4.h"
+
+#include "geometry/triangle1_intersector1_moeller.h"
+#include "geometry/triangle4_intersector1_moeller.h"
+#include "geometry/triangle1v_intersector1_pluecker.h"
+#include "geometry/triangle4v_intersector1_pluecker.h"
+#include "geometry/triangle4i_intersector1.h"
+#include "geometry/triangle1_intersector4_moeller.h"
+#include "geometry/triangle4_intersector4_moeller.h"
+#include "geometry/triangle1v_intersector4_pluecker.h"
+#include "geometry/triangle4v_intersector4_pluecker.h"
+#include "geometry/triangle4i_intersector4.h"
+#include "bvh4/bvh4_intersector1.h"
+
+#if defined(__AVX__)
+#include "common/ray8.h"
+#include "geometry/triangle8_intersector1_moeller.h"
+#include "geometry/triangle8_intersector4_moeller.h"
+#include "geometry/triangle1_intersector8_moeller.h"
+#include "geometry/triangle4_intersector8_moeller.h"
+#include "geometry/triangle8_intersector8_moeller.h"
+#include "geometry/triangle1v_intersector8_pluecker.h"
+#include "geometry/triangle4v_intersector8_pluecker.h"
+#include "geometry/triangle4i_intersector8.h"
+#include "bvh8i/bvh8i_intersector1.h"
+#endif
+
+#include <vector>
+
+namespace embree
+{
+  using namespace isa;
+
+  /* configuration */
+  static size_t g_numPrims = 256;     //!< number of triangles in a batch
+  static size_t g_numRays = 256;      //!< number of rays in a batch
+  static size_t g_repeat = 20;        //!< number of times each batch is processed
+  static std::string g_filter = "";   //!< only run kernels whose name contains this string
+
+  /* synthetic triangles inside the unit cube */
+  std::vector<Vec3fa> g_vertices;
+  std::vector<Vec3fa> g_org, g_dir;
+
+  /* prevents the compiler from removing the kernel calls */
+  static volatile int g_sink = 0;
+
+  float frand() { return float(drand48()); }
+
+  void createBatch()
+  {
+    g_vertices.resize(3*g_numPrims);
+    for (size_t i=0; i<g_numPrims; i++) 
+    {
+      const Vec3fa p = Vec3fa(frand(),frand(),frand());
+      for (size_t j=0; j<3; j++)
+        g_vertices[3*i+j] = p + 0.3f*Vec3fa(frand()-0.5f,frand()-0.5f,frand()-0.5f);
+    }
+
+    /* rays start on a sphere around the cube and point to a random point inside */
+    g_org.resize(g_numRays);
+    g_dir.resize(g_numRays);
+    for (size_t i=0; i<g_numRays; i++) 
+    {
+      const Vec3fa d = normalize(Vec3fa(frand()-0.5f,frand()-0.5f,frand()-0.5f));
+      g_org[i] = Vec3fa(0.5f) + 2.0f*d;
+      g_dir[i] = Vec3fa(frand(),frand(),frand()) - g_org[i];
+    }
+  }
+
+  /* packs the triangles into N wide leaf blocks */
+  template<typename Primitive> struct Packer {};
+
+  template<> struct Packer<Triangle1> {
+    static const size_t N = 1;
+    static Triangle1 pack(size_t i, size_t n) {
+      return Triangle1(g_vertices[3*i+0],g_vertices[3*i+1],g_vertices[3*i+2],0,i,-1);
+    }
+  };
+
+  template<> struct Packer<Triangle1v> {
+    static const size_t N = 1;
+    static Triangle1v pack(size_t i, size_t n) {
+      return Triangle1v(g_vertices[3*i+0],g_vertices[3*i+1],g_vertices[3*i+2],0,i,-1);
+    }
+  };
+
+  template<typename Triangle, typename ssef3, typename ssei1, size_t K> 
+  __forceinline Triangle packSOA(size_t i, size_t n)
+  {
+    ssef3 v0, v1, v2; ssei1 geomID = -1, primID = -1;
+    for (size_t k=0; k<K && i+k<n; k++) {
+      const Vec3fa& p0 = g_vertices[3*(i+k)+0], p1 = g_vertices[3*(i+k)+1], p2 = g_vertices[3*(i+k)+2];
+      v0.x[k] = p0.x; v0.y[k] = p0.y; v0.z[k] = p0.z;
+      v1.x[k] = p1.x; v1.y[k] = p1.y; v1.z[k] = p1.z;
+      v2.x[k] = p2.x; v2.y[k] = p2.y; v2.z[k] = p2.z;
+      geomID[k] = 0; primID[k] = i+k;
+    }
+    return Triangle(v0,v1,v2,geomID,primID,ssei1(-1));
+  }
+
+  template<> struct Packer<Triangle4> {
+    static const size_t N = 4;
+    static Triangle4 pack(size_t i, size_t n) { return packSOA<Triangle4,sse3f,ssei,4>(i,n); }
+  };
+
+  template<> struct Packer<Triangle4v> {
+    static const size_t N = 4;
+    static Triangle4v pack(size_t i, size_t n) { return packSOA<Triangle4v,sse3f,ssei,4>(i,n); }
+  };
+
+  template<> struct Packer<Triangle4i> {
+    static const size_t N = 4;
+    static Triangle4i pack(size_t i, size_t n) 
+    {
+      Vec3fa* base[4]; ssei v1 = 1, v2 = 2, geomID = -1, primID = -1;
+      for (size_t k=0; k<4; k++) {
+        const size_t j = min(i+k,n-1);
+        base[k] = &g_vertices[3*j];
+        if (i+k < n) { geomID[k] = 0; primID[k] = i+k; }
+      }
+      return Triangle4i(base,v1,v2,geomID,primID);
+    }
+  };
+
+#if defined(__AVX__)
+  template<> struct Packer<Triangle8> {
+    static const size_t N = 8;
+    static Triangle8 pack(size_t i, size_t n) { return packSOA<Triangle8,avx3f,avxi,8>(i,n); }
+  };
+#endif
+
+  template<typename Primitive>
+  Primitive* packBatch(size_t& numBlocks)
+  {
+    const size_t N = Packer<Primitive>::N;
+    numBlocks = (g_numPrims+N-1)/N;
+    Primitive* prims = (Primitive*) alignedMalloc(numBlocks*sizeof(Primitive));
+    for (size_t i=0; i<numBlocks; i++)
+      prims[i] = Packer<Primitive>::pack(i*N,g_numPrims);
+    return prims;
+  }
+
+  bool enabled(const char* name) {
+    return g_filter == "" || std::string(name).find(g_filter) != std::string::npos;
+  }
+
+  template<typename Intersector>
+  void benchmark_intersector1(const char* name, bool occluded)
+  {
+    if (!enabled(name)) return;
+    typedef typename Intersector::Primitive Primitive;
+    size_t numBlocks = 0;
+    Primitive* prims = packBatch<Primitive>(numBlocks);
+
+    int64 cycles = 0;
+    int hits = 0;
+    for (size_t r=0; r<g_repeat; r++) 
+    {
+      for (size_t i=0; i<g_numRays; i++) 
+      {
+        Ray ray(g_org[i],g_dir[i]);
+        const int64 c0 = rdtsc();
+        for (size_t j=0; j<numBlocks; j++) {
+          if (occluded) hits += Intersector::occluded(ray,&prims[j],1,NULL);
+          else          Intersector::intersect(ray,&prims[j],1,NULL);
+        }
+        cycles += rdtsc()-c0;
+        hits += ray.primID;
+      }
+    }
+    g_sink += hits;
+    alignedFree(prims);
+    const size_t numTests = g_repeat*g_numRays*numBlocks;
+    printf("%50s ... %8.2f cycles/test, %8.2f cycles/ray/triangle\n",name,
+           double(cycles)/double(numTests),double(cycles)/double(g_repeat*g_numRays*g_numPrims));
+    fflush(stdout);
+  }
+
+  template<typename Intersector, typename RayK, typename Mask, typename Float, typename Float3, size_t K>
+  void benchmark_intersectorK(const char* name, bool occluded)
+  {
+    if (!enabled(name)) return;
+    typedef typename Intersector::Primitive Primitive;
+    size_t numBlocks = 0;
+    Primitive* prims = packBatch<Primitive>(numBlocks);
+    const Mask valid = Float(zero) == Float(zero);
+    
+    int64 cycles = 0;
+    int hits = 0;
+    for (size_t r=0; r<g_repeat; r++) 
+    {
+      for (size_t i=0; i+K<=g_numRays; i+=K) 
+      {
+        Float3 org, dir;
+        for (size_t k=0; k<K; k++) {
+          org.x[k] = g_org[i+k].x; org.y[k] = g_org[i+k].y; org.z[k] = g_org[i+k].z;
+          dir.x[k] = g_dir[i+k].x; dir.y[k] = g_dir[i+k].y; dir.z[k] = g_dir[i+k].z;
+        }
+        RayK ray(org,dir);
+        const int64 c0 = rdtsc();
+        for (size_t j=0; j<numBlocks; j++) {
+          if (occluded) hits += movemask(Intersector::occluded(valid,ray,&prims[j],1,NULL));
+          else          Intersector::intersect(valid,ray,&prims[j],1,NULL);
+        }
+        cycles += rdtsc()-c0;
+        hits += ray.primID[0];
+      }
+    }
+    g_sink += hits;
+    alignedFree(prims);
+    const size_t numPackets = g_repeat*(g_numRays/K);
+    printf("%50s ... %8.2f cycles/test, %8.2f cycles/ray/triangle\n",name,
+           double(cycles)/double(numPackets*numBlocks),double(cycles)/double(numPackets*K*g_numPrims));
+    fflush(stdout);
+  }
+
+  void benchmark_bvh4_node_intersector1()
+  {
+    const char* name = "BVH4::intersectBox";
+    if (!enabled(name)) return;
+
+    const size_t numNodes = g_numPrims/4;
+    BVH4::Node* nodes = (BVH4::Node*) alignedMalloc(numNodes*sizeof(BVH4::Node));
+    for (size_t i=0; i<numNodes; i++) 
+    {
+      nodes[i].clear();
+      for (size_t k=0; k<4; k++) {
+        const Vec3fa a = g_vertices[12*i+3*k+0], b = g_vertices[12*i+3*k+1];
+        nodes[i].set(k,BBox3f(min(a,b),max(a,b)),BVH4::emptyNode);
+      }
+    }
+
+    int64 cycles = 0;
+    size_t hits = 0;
+    for (size_t r=0; r<g_repeat; r++) 
+    {
+      for (size_t i=0; i<g_numRays; i++) 
+      {
+        const size_t nearX = g_dir[i].x >= 0.0f ? 0*sizeof(ssef) : 1*sizeof(ssef);
+        const size_t nearY = g_dir[i].y >= 0.0f ? 2*sizeof(ssef) : 3*sizeof(ssef);
+        const size_t nearZ = g_dir[i].z >= 0.0f ? 4*sizeof(ssef) : 5*sizeof(ssef);
+        const sse3f norg(-g_org[i].x,-g_org[i].y,-g_org[i].z);
+        const Vec3fa ray_rdir = rcp_safe(g_dir[i]);
+        const sse3f rdir(ray_rdir.x,ray_rdir.y,ray_rdir.z);
+        const Vec3fa ray_org_rdir = g_org[i]*ray_rdir;
+        const sse3f org_rdir(ray_org_rdir.x,ray_org_rdir.y,ray_org_rdir.z);
+        const ssef ray_near(zero), ray_far(inf);
+
+        const int64 c0 = rdtsc();
+        for (size_t j=0; j<numNodes; j++) {
+          ssef tNear;
+          hits += intersectBox(&nodes[j],nearX,nearY,nearZ,norg,rdir,org_rdir,ray_near,ray_far,tNear);
+        }
+        cycles += rdtsc()-c0;
+      }
+    }
+    g_sink += (int)hits;
+    alignedFree(nodes);
+    const size_t numTests = g_repeat*g_numRays*numNodes;
+    printf("%50s ... %8.2f cycles/test, %8.2f cycles/ray/box\n",name,double(cycles)/double(numTests),double(cycles)/double(4*numTests));
+    fflush(stdout);
+  }
+
+#if defined(__AVX__)
+  void benchmark_bvh8i_node_intersector1()
+  {
+    const char* name = "BVH8i::intersectBox";
+    if (!enabled(name)) return;
+
+    const size_t numNodes = g_numPrims/8;
+    BVH8i::BVH8iNode* nodes = (BVH8i::BVH8iNode*) alignedMalloc(numNodes*sizeof(BVH8i::BVH8iNode));
+    for (size_t i=0; i<numNodes; i++) 
+    {
+      for (size_t k=0; k<8; k++) {
+        const Vec3fa a = g_vertices[24*i+3*k+0], b = g_vertices[24*i+3*k+1];
+        nodes[i].set(k,BBox3f(min(a,b),max(a,b)));
+      }
+    }
+
+    int64 cycles = 0;
+    size_t hits = 0;
+    for (size_t r=0; r<g_repeat; r++) 
+    {
+      for (size_t i=0; i<g_numRays; i++) 
+      {
+        const Vec3fa rdir = rcp_safe(g_dir[i]);
+        const Vec3fa org_rdir = g_org[i] * rdir;
+        const size_t nearX = g_dir[i].x >= 0.0f ? 0*sizeof(avxf) : 1*sizeof(avxf);
+        const size_t nearY = g_dir[i].y >= 0.0f ? 2*sizeof(avxf) : 3*sizeof(avxf);
+        const size_t nearZ = g_dir[i].z >= 0.0f ? 4*sizeof(avxf) : 5*sizeof(avxf);
+        const avxf rdir_x(rdir[0]), rdir_y(rdir[1]), rdir_z(rdir[2]);
+        const avxf org_rdir_x(org_rdir[0]), org_rdir_y(org_rdir[1]), org_rdir_z(org_rdir[2]);
+
+        const int64 c0 = rdtsc();
+        for (size_t j=0; j<numNodes; j++) {
+          avxi near8;
+          hits += intersectBox(&nodes[j],nearX,nearY,nearZ,rdir_x,rdir_y,rdir_z,org_rdir_x,org_rdir_y,org_rdir_z,0.0f,float(inf),near8);
+        }
+        cycles += rdtsc()-c0;
+      }
+    }
+    g_sink += (int)hits;
+    alignedFree(nodes);
+    const size_t numTests = g_repeat*g_numRays*numNodes;
+    printf("%50s ... %8.2f cycles/test, %8.2f cycles/ray/box\n",name,double(cycles)/double(numTests),double(cycles)/double(8*numTests));
+    fflush(stdout);
+  }
+#endif
+
+  static void parseCommandLine(int argc, char** argv)
+  {
+    for (int i=1; i<argc; i++)
+    {
+      std::string tag = argv[i];
+      if (tag == "") return;
+
+      /* size of the synthetic batches */
+      else if (tag == "-prims" && i+1<argc) {
+        g_numPrims = max(size_t(8),size_t(atoi(argv[++i])) & size_t(-8));
+      }
+      else if (tag == "-rays" && i+1<argc) {
+        g_numRays = max(size_t(8),size_t(atoi(argv[++i])) & size_t(-8));
+      }
+      else if (tag == "-repeat" && i+1<argc) {
+        g_repeat = max(1,atoi(argv[++i]));
+      }
+
+      /* only benchmark kernels containing this string */
+      else if (tag == "-filter" && i+1<argc) {
+        g_filter = argv[++i];
+      }
+
+      /* skip unknown command line parameter */
+      else {
+        std::cerr << "unknown command line parameter: " << tag << " ";
+        std::cerr << std::endl;
+      }
+    }
+  }
+
+#define INTERSECTOR1(Intersector) \
+  benchmark_intersector1<Intersector>(#Intersector "::intersect",false); \
+  benchmark_intersector1<Intersector>(#Intersector "::occluded",true);
+
+#define INTERSECTOR4(Intersector) \
+  benchmark_intersectorK<Intersector,Ray4,sseb,ssef,sse3f,4>(#Intersector "::intersect",false); \
+  benchmark_intersectorK<Intersector,Ray4,sseb,ssef,sse3f,4>(#Intersector "::occluded",true);
+
+#define INTERSECTOR8(Intersector) \
+  benchmark_intersectorK<Intersector,Ray8,avxb,avxf,avx3f,8>(#Intersector "::intersect",false); \
+  benchmark_intersectorK<Intersector,Ray8,avxb,avxf,avx3f,8>(#Intersector "::occluded",true);
+
+  /* main function in embree namespace */
+  int main(int argc, char** argv) 
+  {
+    /* parse command line */  
+    parseCommandLine(argc,argv);
+
+    printf("%s kernels, %d triangles, %d rays\n",TOSTRING(isa),(int)g_numPrims,(int)g_numRays);
+    createBatch();
+
+    INTERSECTOR1(Triangle1Intersector1MoellerTrumbore);
+    INTERSECTOR1(Triangle4Intersector1MoellerTrumbore<KERNEL_FEATURES_NONE>);
+    INTERSECTOR1(Triangle1vIntersector1Pluecker);
+    INTERSECTOR1(Triangle4vIntersector1Pluecker);
+    INTERSECTOR1(Triangle4iIntersector1Pluecker);
+#if defined(__AVX__)
+    INTERSECTOR1(Triangle8Intersector1MoellerTrumbore<KERNEL_FEATURES_NONE>);
+#endif
+
+    INTERSECTOR4(Triangle1Intersector4MoellerTrumbore);
+    INTERSECTOR4(Triangle4Intersector4MoellerTrumbore<KERNEL_FEATURES_NONE>);
+    INTERSECTOR4(Triangle1vIntersector4Pluecker);
+    INTERSECTOR4(Triangle4vIntersector4Pluecker);
+    INTERSECTOR4(Triangle4iIntersector4Pluecker);
+#if defined(__AVX__)
+    INTERSECTOR4(Triangle8Intersector4MoellerTrumbore<KERNEL_FEATURES_NONE>);
+#endif
+
+#if defined(__AVX__)
+    INTERSECTOR8(Triangle1Intersector8MoellerTrumbore);
+    INTERSECTOR8(Triangle4Intersector8MoellerTrumbore<KERNEL_FEATURES_NONE>);
+    INTERSECTOR8(Triangle8Intersector8MoellerTrumbore<KERNEL_FEATURES_NONE>);
+    INTERSECTOR8(Triangle1vIntersector8Pluecker);
+    INTERSECTOR8(Triangle4vIntersector8Pluecker);
+    INTERSECTOR8(Triangle4iIntersector8Pluecker);
+#endif
+
+    benchmark_bvh4_node_intersector1();
+#if defined(__AVX__)
+    benchmark_bvh8i_node_intersector1();
+#endif
+    return 0;
+  }
+}
+
+int main(int argc, char** argv)
+{
+  try {
+    return embree::main(argc, argv);
+  }
+  catch (const std::exception& e) {
+    std::cout << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+  catch (...) {
+    std::cout << "Error: unknown exception caught." << std::endl;
+    return 1;
+  }
+}
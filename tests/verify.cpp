@@ -95,6 +95,7 @@ namespace embree
     ray.tnear = 0.0f; ray.tfar = inf;
     ray.time = 0; ray.mask = -1;
     ray.geomID = ray.primID = ray.instID = -1;
+    for (size_t i=0; i<RTC_MAX_INSTANCE_DEPTH; i++) ray.instStack[i] = -1;
     return ray;
   }
 
@@ -106,6 +107,7 @@ namespace embree
     ray.tnear = tnear; ray.tfar = tfar;
     ray.time = 0; ray.mask = -1;
     ray.geomID = ray.primID = ray.instID = -1;
+    for (size_t i=0; i<RTC_MAX_INSTANCE_DEPTH; i++) ray.instStack[i] = -1;
     return ray;
   }
   
@@ -122,11 +124,14 @@ namespace embree
     ray_o.Ngx[i] = ray_i.Ng[0];
     ray_o.Ngy[i] = ray_i.Ng[1];
     ray_o.Ngz[i] = ray_i.Ng[2];
+    ray_o.u[i] = ray_i.u;
+    ray_o.v[i] = ray_i.v;
     ray_o.time[i] = ray_i.time;
     ray_o.mask[i] = ray_i.mask;
     ray_o.geomID[i] = ray_i.geomID;
     ray_o.primID[i] = ray_i.primID;
     ray_o.instID[i] = ray_i.instID;
+    for (size_t j=0; j<RTC_MAX_INSTANCE_DEPTH; j++) ray_o.instStack[j][i] = ray_i.instStack[j];
   }
 
   void setRay(RTCRay8& ray_o, int i, const RTCRay& ray_i)
@@ -142,11 +147,14 @@ namespace embree
     ray_o.Ngx[i] = ray_i.Ng[0];
     ray_o.Ngy[i] = ray_i.Ng[1];
     ray_o.Ngz[i] = ray_i.Ng[2];
+    ray_o.u[i] = ray_i.u;
+    ray_o.v[i] = ray_i.v;
     ray_o.time[i] = ray_i.time;
     ray_o.mask[i] = ray_i.mask;
     ray_o.geomID[i] = ray_i.geomID;
     ray_o.primID[i] = ray_i.primID;
     ray_o.instID[i] = ray_i.instID;
+    for (size_t j=0; j<RTC_MAX_INSTANCE_DEPTH; j++) ray_o.instStack[j][i] = ray_i.instStack[j];
   }
 
   void setRay(RTCRay16& ray_o, int i, const RTCRay& ray_i)
@@ -162,11 +170,14 @@ namespace embree
     ray_o.Ngx[i] = ray_i.Ng[0];
     ray_o.Ngy[i] = ray_i.Ng[1];
     ray_o.Ngz[i] = ray_i.Ng[2];
+    ray_o.u[i] = ray_i.u;
+    ray_o.v[i] = ray_i.v;
     ray_o.time[i] = ray_i.time;
     ray_o.mask[i] = ray_i.mask;
     ray_o.geomID[i] = ray_i.geomID;
     ray_o.primID[i] = ray_i.primID;
     ray_o.instID[i] = ray_i.instID;
+    for (size_t j=0; j<RTC_MAX_INSTANCE_DEPTH; j++) ray_o.instStack[j][i] = ray_i.instStack[j];
   }
 
   RTCRay getRay(RTCRay4& ray_i, int i)
@@ -183,11 +194,14 @@ namespace embree
     ray_o.Ng[0] = ray_i.Ngx[i];
     ray_o.Ng[1] = ray_i.Ngy[i];
     ray_o.Ng[2] = ray_i.Ngz[i];
+    ray_o.u = ray_i.u[i];
+    ray_o.v = ray_i.v[i];
     ray_o.time = ray_i.time[i];
     ray_o.mask = ray_i.mask[i];
     ray_o.geomID = ray_i.geomID[i];
     ray_o.primID = ray_i.primID[i];
     ray_o.instID = ray_i.instID[i];
+    for (size_t j=0; j<RTC_MAX_INSTANCE_DEPTH; j++) ray_o.instStack[j] = ray_i.instStack[j][i];
     return ray_o;
   }
 
@@ -205,11 +219,14 @@ namespace embree
     ray_o.Ng[0] = ray_i.Ngx[i];
     ray_o.Ng[1] = ray_i.Ngy[i];
     ray_o.Ng[2] = ray_i.Ngz[i];
+    ray_o.u = ray_i.u[i];
+    ray_o.v = ray_i.v[i];
     ray_o.time = ray_i.time[i];
     ray_o.mask = ray_i.mask[i];
     ray_o.geomID = ray_i.geomID[i];
     ray_o.primID = ray_i.primID[i];
     ray_o.instID = ray_i.instID[i];
+    for (size_t j=0; j<RTC_MAX_INSTANCE_DEPTH; j++) ray_o.instStack[j] = ray_i.instStack[j][i];
     return ray_o;
   }
 
@@ -227,11 +244,14 @@ namespace embree
     ray_o.Ng[0] = ray_i.Ngx[i];
     ray_o.Ng[1] = ray_i.Ngy[i];
     ray_o.Ng[2] = ray_i.Ngz[i];
+    ray_o.u = ray_i.u[i];
+    ray_o.v = ray_i.v[i];
     ray_o.time = ray_i.time[i];
     ray_o.mask = ray_i.mask[i];
     ray_o.geomID = ray_i.geomID[i];
     ray_o.primID = ray_i.primID[i];
     ray_o.instID = ray_i.instID[i];
+    for (size_t j=0; j<RTC_MAX_INSTANCE_DEPTH; j++) ray_o.instStack[j] = ray_i.instStack[j][i];
     return ray_o;
   }
 
@@ -1146,6 +1166,57 @@ namespace embree
     return passed;
   }
   
+  bool rtcore_instance_masks(int N)
+  {
+    /* instances of a scene with mask 1 and of a scene with mask 2, the last instance restricts its scene to rays with mask 4 */
+    RTCScene object0 = rtcNewScene(RTC_SCENE_STATIC,aflags);
+    rtcSetMask(object0,addSphere(object0,RTC_GEOMETRY_STATIC,Vec3fa(0.0f),1.0f,50),1);
+    rtcCommit (object0);
+    RTCScene object1 = rtcNewScene(RTC_SCENE_STATIC,aflags);
+    rtcSetMask(object1,addSphere(object1,RTC_GEOMETRY_STATIC,Vec3fa(0.0f),1.0f,50),2);
+    rtcCommit (object1);
+    RTCScene scene = rtcNewScene(RTC_SCENE_DYNAMIC,aflags);
+    unsigned inst[3];
+    inst[0] = rtcNewInstance(scene,object0);
+    inst[1] = rtcNewInstance(scene,object1);
+    inst[2] = rtcNewInstance(scene,object0);
+    for (size_t i=0; i<3; i++) {
+      const float xfm[12] = { 1.0f,0.0f,0.0f, 0.0f,1.0f,0.0f, 0.0f,0.0f,1.0f, 3.0f*float(i)-3.0f,0.0f,0.0f };
+      rtcSetTransform(scene,inst[i],RTC_MATRIX_COLUMN_MAJOR,xfm);
+    }
+    rtcSetMask(scene,inst[2],4);
+    rtcCommit (scene);
+    AssertNoError();
+
+    bool passed = true;
+    for (size_t pass=0; pass<2; pass++)
+    {
+      for (int mask=0; mask<8; mask++) 
+      {
+        const bool hit[3] = { (mask & 1) != 0, (mask & 2) != 0, (mask & 1) && (pass || (mask & 4)) };
+        for (size_t i=0; i<3; i++) {
+          RTCRay ray0 = makeRay(Vec3fa(3.0f*float(i)-3.0f,0.0f,-5.0f),Vec3fa(0.0f,0.0f,1.0f)); ray0.mask = mask;
+          rtcIntersectN(scene,ray0,N);
+          passed &= hit[i] ? ray0.instID == inst[i] : ray0.geomID == RTC_INVALID_GEOMETRY_ID;
+          RTCRay ray1 = makeRay(Vec3fa(3.0f*float(i)-3.0f,0.0f,-5.0f),Vec3fa(0.0f,0.0f,1.0f)); ray1.mask = mask;
+          rtcOccludedN(scene,ray1,N);
+          passed &= hit[i] ? ray1.geomID == 0 : ray1.geomID == RTC_INVALID_GEOMETRY_ID;
+        }
+      }
+
+      /* masks of instances get updated at commit */
+      rtcSetMask(scene,inst[2],-1);
+      rtcCommit (scene);
+      AssertNoError();
+    }
+
+    rtcDeleteScene (scene);
+    rtcDeleteScene (object0);
+    rtcDeleteScene (object1);
+    AssertNoError();
+    return passed;
+  }
+
   void rtcore_ray_masks_all()
   {
     printf("%30s ... ","ray_masks");
@@ -1230,9 +1301,9 @@ namespace embree
     return passed;
   }
 
-  void rtcore_packet_write_test_all()
+  void rtcore_packet_write_test_all(const char* name)
   {
-    printf("%30s ... ","packet_write_test");
+    printf("%30s ... ",name);
     bool passed = true;
     for (int i=0; i<numSceneFlags; i++) 
     {
@@ -1245,7 +1316,7 @@ namespace embree
 	  fflush(stdout);
   }
 
-  void rtcore_watertight_sphere1(float pos)
+  void rtcore_watertight_sphere1(const char* name, float pos)
   {
     RTCScene scene = rtcNewScene(RTC_SCENE_STATIC | RTC_SCENE_ROBUST,aflags);
     unsigned geom = addSphere(scene,RTC_GEOMETRY_STATIC,Vec3fa(pos,0.0f,0.0f),2.0f,1000);
@@ -1260,12 +1331,12 @@ namespace embree
     }
     rtcDeleteScene (scene);
 
-    printf("%30s ... %s (%f%%)\n","watertight_sphere1",
+    printf("%30s ... %s (%f%%)\n",name,
            numFailures ? "\033[31m[FAILED]\033[0m" : "\033[32m[PASSED]\033[0m", 100.0f*(double)numFailures/(double)testN);
 	  fflush(stdout);
   }
   
-  void rtcore_watertight_sphere4(float pos)
+  void rtcore_watertight_sphere4(const char* name, float pos)
   {
     RTCScene scene = rtcNewScene(RTCSceneFlags(RTC_SCENE_STATIC | RTC_SCENE_ROBUST),aflags);
     unsigned geom = addSphere(scene,RTC_GEOMETRY_STATIC,Vec3fa(pos,0.0f,0.0f),2.0f,1000);
@@ -1285,12 +1356,12 @@ namespace embree
         numFailures += ray4.primID[j] == -1;
     }
     rtcDeleteScene (scene);
-    printf("%30s ... %s (%f%%)\n","watertight_sphere4",
+    printf("%30s ... %s (%f%%)\n",name,
            numFailures ? "\033[31m[FAILED]\033[0m" : "\033[32m[PASSED]\033[0m", 100.0f*(double)numFailures/(double)testN);
 	  fflush(stdout);
   }
 
-  void rtcore_watertight_sphere8(float pos)
+  void rtcore_watertight_sphere8(const char* name, float pos)
   {
     RTCScene scene = rtcNewScene(RTC_SCENE_STATIC | RTC_SCENE_ROBUST,aflags);
     unsigned geom = addSphere(scene,RTC_GEOMETRY_STATIC,Vec3fa(pos,0.0f,0.0f),2.0f,1000);
@@ -1310,12 +1381,12 @@ namespace embree
         numFailures += ray8.primID[j] == -1;
     }
     rtcDeleteScene (scene);
-    printf("%30s ... %s (%f%%)\n","watertight_sphere8",
+    printf("%30s ... %s (%f%%)\n",name,
            numFailures ? "\033[31m[FAILED]\033[0m" : "\033[32m[PASSED]\033[0m", 100.0f*(double)numFailures/(double)testN);
 	  fflush(stdout);
   }
 
-  void rtcore_watertight_sphere16(float pos)
+  void rtcore_watertight_sphere16(const char* name, float pos)
   {
     RTCScene scene = rtcNewScene(RTC_SCENE_STATIC | RTC_SCENE_ROBUST,aflags);
     unsigned geom = addSphere(scene,RTC_GEOMETRY_STATIC,Vec3fa(pos,0.0f,0.0f),2.0f,1000);
@@ -1335,14 +1406,14 @@ namespace embree
         numFailures += ray16.primID[j] == -1;
     }
     rtcDeleteScene (scene);
-    printf("%30s ... %s (%f%%)\n","watertight_sphere16",
+    printf("%30s ... %s (%f%%)\n",name,
            numFailures ? "\033[31m[FAILED]\033[0m" : "\033[32m[PASSED]\033[0m", 100.0f*(double)numFailures/(double)testN);
 	  fflush(stdout);
   }
   
-  void rtcore_watertight_plane1(float pos)
+  void rtcore_watertight_plane1(const char* name, RTCSceneFlags sflags, float pos)
   {
-    RTCScene scene = rtcNewScene(RTC_SCENE_STATIC | RTC_SCENE_ROBUST,aflags);
+    RTCScene scene = rtcNewScene(sflags,aflags);
     unsigned geom = addPlane(scene,RTC_GEOMETRY_STATIC,1000,Vec3fa(pos,-6.0f,-6.0f),Vec3fa(0.0f,12.0f,0.0f),Vec3fa(0.0f,0.0f,12.0f));
     rtcCommit (scene);
     size_t numFailures = 0;
@@ -1354,14 +1425,14 @@ namespace embree
       numFailures += ray.primID == -1;
     }
     rtcDeleteScene (scene);
-    printf("%30s ... %s (%f%%)\n","watertight_plane1",
+    printf("%30s ... %s (%f%%)\n",name,
            numFailures ? "\033[31m[FAILED]\033[0m" : "\033[32m[PASSED]\033[0m", 100.0f*(double)numFailures/(double)testN);
 	fflush(stdout);
   }
 
-  void rtcore_watertight_plane4(float pos)
+  void rtcore_watertight_plane4(const char* name, RTCSceneFlags sflags, float pos)
   {
-    RTCScene scene = rtcNewScene(RTC_SCENE_STATIC | RTC_SCENE_ROBUST,aflags);
+    RTCScene scene = rtcNewScene(sflags,aflags);
     unsigned geom = addPlane(scene,RTC_GEOMETRY_STATIC,1000,Vec3fa(pos,-6.0f,-6.0f),Vec3fa(0.0f,12.0f,0.0f),Vec3fa(0.0f,0.0f,12.0f));
     rtcCommit (scene);
     size_t numFailures = 0;
@@ -1379,14 +1450,14 @@ namespace embree
         numFailures += ray4.primID[j] == -1;
     }
     rtcDeleteScene (scene);
-    printf("%30s ... %s (%f%%)\n","watertight_plane4",
+    printf("%30s ... %s (%f%%)\n",name,
            numFailures ? "\033[31m[FAILED]\033[0m" : "\033[32m[PASSED]\033[0m", 100.0f*(double)numFailures/(double)testN);
   	fflush(stdout);
   }
 
-  void rtcore_watertight_plane8(float pos)
+  void rtcore_watertight_plane8(const char* name, RTCSceneFlags sflags, float pos)
   {
-    RTCScene scene = rtcNewScene(RTC_SCENE_STATIC | RTC_SCENE_ROBUST,aflags);
+    RTCScene scene = rtcNewScene(sflags,aflags);
     unsigned geom = addPlane(scene,RTC_GEOMETRY_STATIC,1000,Vec3fa(pos,-6.0f,-6.0f),Vec3fa(0.0f,12.0f,0.0f),Vec3fa(0.0f,0.0f,12.0f));
     rtcCommit (scene);
     size_t numFailures = 0;
@@ -1404,7 +1475,7 @@ namespace embree
         numFailures += ray8.primID[j] == -1;
     }
     rtcDeleteScene (scene);
-    printf("%30s ... %s (%f%%)\n","watertight_plane8",
+    printf("%30s ... %s (%f%%)\n",name,
            numFailures ? "\033[31m[FAILED]\033[0m" : "\033[32m[PASSED]\033[0m", 100.0f*(double)numFailures/(double)testN);
 	  fflush(stdout);
   }
@@ -1653,6 +1724,154 @@ namespace embree
 	fflush(stdout);
   }
 
+#if defined(__INTERSECTION_FILTER__)
+
+  /* filter functions reject all hits closer than 10 */
+  void filterFunction1(void* ptr, RTCRay& ray)
+  {
+    if (ptr != (void*)123) return;
+    if (ray.tfar < 10.0f) ray.geomID = RTC_INVALID_GEOMETRY_ID;
+  }
+
+  void filterFunction4(const void* valid_i, void* ptr, RTCRay4& ray)
+  {
+    if (ptr != (void*)123) return;
+    const int* valid = (const int*) valid_i;
+    for (size_t i=0; i<4; i++)
+      if (valid[i] == -1 && ray.tfar[i] < 10.0f) ray.geomID[i] = RTC_INVALID_GEOMETRY_ID;
+  }
+
+  void filterFunction8(const void* valid_i, void* ptr, RTCRay8& ray)
+  {
+    if (ptr != (void*)123) return;
+    const int* valid = (const int*) valid_i;
+    for (size_t i=0; i<8; i++)
+      if (valid[i] == -1 && ray.tfar[i] < 10.0f) ray.geomID[i] = RTC_INVALID_GEOMETRY_ID;
+  }
+
+  bool rtcore_intersection_filter(RTCSceneFlags sflags, RTCGeometryFlags gflags, int N)
+  {
+    /* the front side of the sphere is at distance 9, the back side at distance 11 */
+    RTCScene scene = rtcNewScene(sflags,aflags);
+    unsigned geom = addSphere(scene,gflags,zero,1.0f,50);
+    rtcSetUserData(scene,geom,(void*)123);
+    rtcSetIntersectionFilterFunction (scene,geom,filterFunction1);
+    rtcSetIntersectionFilterFunction4(scene,geom,filterFunction4);
+    rtcSetIntersectionFilterFunction8(scene,geom,filterFunction8);
+    rtcSetOcclusionFilterFunction    (scene,geom,filterFunction1);
+    rtcSetOcclusionFilterFunction4   (scene,geom,filterFunction4);
+    rtcSetOcclusionFilterFunction8   (scene,geom,filterFunction8);
+    AssertNoError();
+    rtcCommit (scene);
+
+    bool passed = true;
+    for (size_t i=0; i<16; i++)
+    {
+      const Vec3fa org(0.05f*float(i)-0.4f,10.0f,0.1f);
+      RTCRay ray = makeRay(org,Vec3fa(0,-1,0));
+      rtcIntersectN(scene,ray,N);
+#if defined(__BACKFACE_CULLING__)
+      if (ray.geomID != -1 && (ray.geomID != geom || ray.tfar < 10.0f)) passed = false;
+#else
+      if (ray.geomID != geom || ray.tfar < 10.0f) passed = false;
+#endif
+
+      /* the back side is beyond tfar, thus the ray is not occluded */
+      RTCRay shadow = makeRay(org,Vec3fa(0,-1,0),0.0f,10.5f);
+      rtcOccludedN(scene,shadow,N);
+      if (shadow.geomID != -1) passed = false;
+    }
+    rtcDeleteScene (scene);
+    return passed;
+  }
+
+  void rtcore_intersection_filter_all ()
+  {
+    printf("%30s ... ","intersection_filter");
+    bool passed = true;
+    for (int i=0; i<numSceneFlags; i++)
+    {
+      RTCSceneFlags flag = getSceneFlag(i);
+      bool ok0 = rtcore_intersection_filter(flag,RTC_GEOMETRY_STATIC,1);
+#if !defined(__MIC__)
+      ok0 &= rtcore_intersection_filter(flag,RTC_GEOMETRY_STATIC,4);
+#endif
+#if defined(__TARGET_AVX__) || defined(__TARGET_AVX2__)
+      if (has_feature(AVX)) ok0 &= rtcore_intersection_filter(flag,RTC_GEOMETRY_STATIC,8);
+#endif
+      if (ok0) printf("\033[32m+\033[0m"); else printf("\033[31m-\033[0m");
+      passed &= ok0;
+    }
+    printf(" %s\n",passed ? "\033[32m[PASSED]\033[0m" : "\033[31m[FAILED]\033[0m");
+	fflush(stdout);
+  }
+
+  /* each commit selects the intersectors for the masks and filters in use */
+  bool rtcore_kernel_features(RTCSceneFlags sflags)
+  {
+    RTCScene scene = rtcNewScene(sflags,aflags);
+    unsigned geom = addSphere(scene,RTC_GEOMETRY_STATIC,zero,1.0f,50);
+    rtcCommit (scene);
+    RTCSceneIntersector basic;
+    rtcGetSceneIntersector(scene,basic);
+    AssertNoError();
+
+    rtcSetIntersectionFilterFunction(scene,geom,filterFunction1);
+    rtcCommit (scene);
+    RTCSceneIntersector filter;
+    rtcGetSceneIntersector(scene,filter);
+    bool passed = filter.intersect != basic.intersect;
+
+    rtcSetIntersectionFilterFunction(scene,geom,NULL);
+    rtcCommit (scene);
+    RTCSceneIntersector none;
+    rtcGetSceneIntersector(scene,none);
+    passed &= none.intersect == basic.intersect;
+
+#if defined(__USE_RAY_MASK__)
+    rtcSetMask(scene,geom,1);
+    rtcCommit (scene);
+    RTCSceneIntersector mask;
+    rtcGetSceneIntersector(scene,mask);
+    passed &= mask.intersect != basic.intersect;
+#endif
+    AssertNoError();
+    rtcDeleteScene (scene);
+    return passed;
+  }
+
+  /* counts the invocations of the filter functions */
+  static size_t numFilterCalls = 0;
+  void countingFilterFunction1(void* ptr, RTCRay& ray) { numFilterCalls++; }
+  void countingFilterFunction4(const void* valid, void* ptr, RTCRay4& ray) { numFilterCalls++; }
+  void countingFilterFunction8(const void* valid, void* ptr, RTCRay8& ray) { numFilterCalls++; }
+
+  /* autotuning must not invoke filters, but the selected accel has to */
+  bool rtcore_autotune_filter(RTCSceneFlags sflags)
+  {
+    RTCScene scene = rtcNewScene(RTCSceneFlags(sflags | RTC_SCENE_AUTOTUNE),aflags);
+    unsigned geom = addSphere(scene,RTC_GEOMETRY_STATIC,zero,1.0f,50);
+    rtcSetIntersectionFilterFunction (scene,geom,countingFilterFunction1);
+    rtcSetIntersectionFilterFunction4(scene,geom,countingFilterFunction4);
+    rtcSetIntersectionFilterFunction8(scene,geom,countingFilterFunction8);
+    rtcSetOcclusionFilterFunction    (scene,geom,countingFilterFunction1);
+    rtcSetOcclusionFilterFunction4   (scene,geom,countingFilterFunction4);
+    rtcSetOcclusionFilterFunction8   (scene,geom,countingFilterFunction8);
+    AssertNoError();
+    numFilterCalls = 0;
+    rtcCommit (scene);
+    AssertNoError();
+    bool passed = numFilterCalls == 0;
+
+    RTCRay ray = makeRay(Vec3fa(0.0f,10.0f,0.1f),Vec3fa(0,-1,0));
+    rtcIntersect(scene,ray);
+    passed &= numFilterCalls > 0;
+    rtcDeleteScene (scene);
+    return passed;
+  }
+
+#endif
+
   bool rtcore_new_delete_geometry()
   {
     RTCScene scene = rtcNewScene(RTC_SCENE_DYNAMIC,aflags);
@@ -1687,127 +1906,1205 @@ namespace embree
     return true;
   }
 
-  void shootRays (RTCScene scene)
+  /* a row of spheres that is only accessible through the range functions */
+  struct SphereSet
   {
-    Vec3fa org(2.0f*drand48()-1.0f,2.0f*drand48()-1.0f,2.0f*drand48()-1.0f);
-    Vec3fa dir(2.0f*drand48()-1.0f,2.0f*drand48()-1.0f,2.0f*drand48()-1.0f);
-    RTCRay ray = makeRay(org,dir); 
-    rtcOccluded(scene,ray);
-    rtcIntersect(scene,ray);
+    unsigned geomID;
+    size_t maxRange;
+    Sphere* spheres;
+  };
 
-#if !defined(__MIC__)
-    RTCRay4 ray4;
-    for (size_t j=0; j<4; j++) {
-      Vec3fa org(2.0f*drand48()-1.0f,2.0f*drand48()-1.0f,2.0f*drand48()-1.0f);
-      Vec3fa dir(2.0f*drand48()-1.0f,2.0f*drand48()-1.0f,2.0f*drand48()-1.0f);
-      RTCRay ray = makeRay(org,dir); 
-      setRay(ray4,j,ray);
+  bool intersectSphere(const Sphere& sphere, const Vec3fa& org, const Vec3fa& dir, float tnear, float& tfar)
+  {
+    const Vec3fa v = org-sphere.pos;
+    const float A = dot(dir,dir);
+    const float B = dot(v,dir);
+    const float C = dot(v,v) - sphere.r*sphere.r;
+    const float D = B*B - A*C;
+    if (D < 0.0f) return false;
+    const float t = (-B-sqrtf(D))/A;
+    if (t <= tnear || t >= tfar) return false;
+    tfar = t;
+    return true;
+  }
+
+  void BoundsRangeFunc(SphereSet* set, size_t begin, size_t end, BBox3f* bounds_o)
+  {
+    for (size_t i=begin; i<end; i++) 
+      BoundsFunc(&set->spheres[i],i,&bounds_o[i-begin]);
+  }
+
+  void IntersectRangeFunc(SphereSet* set, RTCRay& ray, size_t begin, size_t end) 
+  {
+    set->maxRange = max(set->maxRange,end-begin);
+    for (size_t i=begin; i<end; i++) {
+      if (!intersectSphere(set->spheres[i],Vec3fa(ray.org[0],ray.org[1],ray.org[2]),Vec3fa(ray.dir[0],ray.dir[1],ray.dir[2]),ray.tnear,ray.tfar)) continue;
+      ray.geomID = set->geomID;
+      ray.primID = i;
     }
-    __align(16) int valid4[4] = { -1,-1,-1,-1 };
-    rtcOccluded4(valid4,scene,ray4);
-    rtcIntersect4(valid4,scene,ray4);
-#endif
+  }
 
-#if defined(__TARGET_AVX__) || defined(__TARGET_AVX2__)
-    if (has_feature(AVX)) {
-      RTCRay8 ray8;
-      for (size_t j=0; j<8; j++) {
-        Vec3fa org(2.0f*drand48()-1.0f,2.0f*drand48()-1.0f,2.0f*drand48()-1.0f);
-        Vec3fa dir(2.0f*drand48()-1.0f,2.0f*drand48()-1.0f,2.0f*drand48()-1.0f);
-        RTCRay ray = makeRay(org,dir); 
-        setRay(ray8,j,ray);
+  void OccludedRangeFunc(SphereSet* set, RTCRay& ray, size_t begin, size_t end) 
+  {
+    for (size_t i=begin; i<end; i++) {
+      float tfar = ray.tfar;
+      if (intersectSphere(set->spheres[i],Vec3fa(ray.org[0],ray.org[1],ray.org[2]),Vec3fa(ray.dir[0],ray.dir[1],ray.dir[2]),ray.tnear,tfar)) 
+        ray.geomID = 0;
+    }
+  }
+
+  template<int N, typename RTCRayN>
+  void IntersectRangeFuncN(const int* valid, SphereSet* set, RTCRayN& ray, size_t begin, size_t end) 
+  {
+    set->maxRange = max(set->maxRange,end-begin);
+    for (size_t k=0; k<N; k++) 
+    {
+      if (valid[k] != -1) continue;
+      const Vec3fa org(ray.orgx[k],ray.orgy[k],ray.orgz[k]);
+      const Vec3fa dir(ray.dirx[k],ray.diry[k],ray.dirz[k]);
+      for (size_t i=begin; i<end; i++) {
+        if (!intersectSphere(set->spheres[i],org,dir,ray.tnear[k],ray.tfar[k])) continue;
+        ray.geomID[k] = set->geomID;
+        ray.primID[k] = i;
       }
-      __align(32) int valid8[8] = { -1,-1,-1,-1,-1,-1,-1,-1 };
-      rtcOccluded8(valid8,scene,ray8);
-      rtcIntersect8(valid8,scene,ray8);
     }
-#endif
+  }
 
-#if defined(__MIC__)
-    RTCRay16 ray16;
-    for (size_t j=0; j<16; j++) {
-      Vec3fa org(2.0f*drand48()-1.0f,2.0f*drand48()-1.0f,2.0f*drand48()-1.0f);
-      Vec3fa dir(2.0f*drand48()-1.0f,2.0f*drand48()-1.0f,2.0f*drand48()-1.0f);
-      RTCRay ray = makeRay(org,dir); 
-      setRay(ray16,j,ray);
+  template<int N, typename RTCRayN>
+  void OccludedRangeFuncN(const int* valid, SphereSet* set, RTCRayN& ray, size_t begin, size_t end) 
+  {
+    for (size_t k=0; k<N; k++) 
+    {
+      if (valid[k] != -1) continue;
+      const Vec3fa org(ray.orgx[k],ray.orgy[k],ray.orgz[k]);
+      const Vec3fa dir(ray.dirx[k],ray.diry[k],ray.dirz[k]);
+      for (size_t i=begin; i<end; i++) {
+        float tfar = ray.tfar[k];
+        if (intersectSphere(set->spheres[i],org,dir,ray.tnear[k],tfar)) 
+          ray.geomID[k] = 0;
+      }
     }
-    __align(16) int valid16[16] = { -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1 };
-    rtcOccluded16(valid16,scene,ray16);
-    rtcIntersect16(valid16,scene,ray16);
-#endif
   }
 
-  bool rtcore_regression_static()
+  bool rtcore_user_geometry_range(RTCSceneFlags sflags, int N)
   {
-    for (size_t i=0; i<200; i++) 
+    /* odd number of spheres to also get a partially filled block */
+    const size_t numSpheres = 37;
+    SphereSet set;
+    set.maxRange = 0;
+    set.spheres = new Sphere[numSpheres];
+    for (size_t i=0; i<numSpheres; i++) {
+      set.spheres[i].pos = Vec3fa(4.0f*float(i),0.0f,0.0f);
+      set.spheres[i].r = 1.0f;
+    }
+
+    RTCScene scene = rtcNewScene(sflags,aflags);
+    set.geomID = rtcNewUserGeometry (scene,numSpheres);
+    rtcSetUserData(scene,set.geomID,&set);
+    rtcSetBoundsRangeFunction(scene,set.geomID,(RTCBoundsRangeFunc)BoundsRangeFunc);
+    rtcSetIntersectRangeFunction(scene,set.geomID,(RTCIntersectRangeFunc)IntersectRangeFunc);
+    rtcSetIntersectRangeFunction4(scene,set.geomID,(RTCIntersectRangeFunc4)IntersectRangeFuncN<4,RTCRay4>);
+    rtcSetIntersectRangeFunction8(scene,set.geomID,(RTCIntersectRangeFunc8)IntersectRangeFuncN<8,RTCRay8>);
+    rtcSetOccludedRangeFunction(scene,set.geomID,(RTCOccludedRangeFunc)OccludedRangeFunc);
+    rtcSetOccludedRangeFunction4(scene,set.geomID,(RTCOccludedRangeFunc4)OccludedRangeFuncN<4,RTCRay4>);
+    rtcSetOccludedRangeFunction8(scene,set.geomID,(RTCOccludedRangeFunc8)OccludedRangeFuncN<8,RTCRay8>);
+    rtcCommit (scene);
+    AssertNoError();
+
+    bool passed = true;
+    for (size_t i=0; i<numSpheres; i++)
     {
-      if (i%20 == 0) std::cout << "." << std::flush;
+      /* rays hit the front side of each sphere at distance 9 */
+      const Vec3fa org(4.0f*float(i)+0.1f,10.0f,0.0f);
+      RTCRay ray = makeRay(org,Vec3fa(0,-1,0));
+      rtcIntersectN(scene,ray,N);
+      if (ray.geomID != set.geomID || ray.primID != i || abs(ray.tfar-9.0f) > 0.01f) passed = false;
 
-      RTCScene scene = rtcNewScene(RTC_SCENE_STATIC,aflags);
-      AssertNoError();
+      RTCRay shadow = makeRay(org,Vec3fa(0,-1,0));
+      rtcOccludedN(scene,shadow,N);
+      if (shadow.geomID != 0) passed = false;
 
-      for (size_t j=0; j<20; j++) 
-      {
-        Vec3fa pos = 100.0f*Vec3fa(drand48(),drand48(),drand48());
-        size_t numPhi = rand()%100;
-        size_t numTriangles = 2*2*numPhi*(numPhi-1);
-        numTriangles = rand()%(numTriangles+1);
-        switch (rand()%3) {
-        case 0: addSphere(scene,RTC_GEOMETRY_STATIC,pos,2.0f,numPhi,numTriangles,0.0f); break;
-        case 1: addSphere(scene,RTC_GEOMETRY_STATIC,pos,2.0f,numPhi,numTriangles,1.0f); break;
-        case 2: addUserGeometryEmpty(scene,pos,2.0f); break;
-        }
-        AssertNoError();
-      }
+      /* rays between two spheres hit nothing */
+      RTCRay miss = makeRay(org+Vec3fa(1.9f,0,0),Vec3fa(0,-1,0));
+      rtcIntersectN(scene,miss,N);
+      if (miss.geomID != -1) passed = false;
+    }
+    if (set.maxRange <= 1) passed = false;
 
-      rtcCommit(scene);
-      AssertNoError();
+#if !defined(__EXIT_ON_ERROR__)
+    /* committed static scenes cannot change their blocking anymore */
+    if ((sflags & RTC_SCENE_DYNAMIC) == RTC_SCENE_STATIC) {
+      rtcSetBoundsRangeFunction(scene,set.geomID,NULL);
+      AssertError(RTC_INVALID_OPERATION);
+    }
+#endif
 
-      for (size_t i=0; i<100; i++)
-        shootRays(scene);
+    rtcDeleteScene (scene);
+    delete[] set.spheres;
+    return passed;
+  }
 
-      rtcDeleteScene (scene);
-      AssertNoError();
+  void rtcore_user_geometry_range_all ()
+  {
+    printf("%30s ... ","user_geometry_range");
+    bool passed = true;
+    for (int i=0; i<numSceneFlags; i++)
+    {
+      RTCSceneFlags flag = getSceneFlag(i);
+      bool ok0 = rtcore_user_geometry_range(flag,1);
+#if !defined(__MIC__)
+      ok0 &= rtcore_user_geometry_range(flag,4);
+#endif
+#if defined(__TARGET_AVX__) || defined(__TARGET_AVX2__)
+      if (has_feature(AVX)) ok0 &= rtcore_user_geometry_range(flag,8);
+#endif
+      if (ok0) printf("\033[32m+\033[0m"); else printf("\033[31m-\033[0m");
+      passed &= ok0;
     }
-    return true;
+    printf(" %s\n",passed ? "\033[32m[PASSED]\033[0m" : "\033[31m[FAILED]\033[0m");
+	fflush(stdout);
   }
 
-  bool rtcore_regression_dynamic()
+  unsigned addPoints (RTCScene scene, RTCPointType type, size_t num, const Vec3fa& p0, const Vec3fa& dp, float r)
   {
-    RTCScene scene = rtcNewScene(RTC_SCENE_DYNAMIC,aflags);
-    AssertNoError();
-    int geom[1024];
-    int types[1024];
-    size_t numVertices[1024];
-    for (size_t i=0; i<1024; i++)  {
-      geom[i] = -1;
-      types[i] = 0;
-      numVertices[i] = 0;
+    unsigned geom = rtcNewPoints (scene, RTC_GEOMETRY_STATIC, type, num);
+    Vec3fa* vertices = (Vec3fa*) rtcMapBuffer(scene,geom,RTC_VERTEX_BUFFER);
+    for (size_t i=0; i<num; i++) {
+      vertices[i] = p0+float(i)*dp;
+      vertices[i].w = r;
     }
+    rtcUnmapBuffer(scene,geom,RTC_VERTEX_BUFFER);
+    return geom;
+  }
 
-    for (size_t i=0; i<200; i++) 
+  bool rtcore_points(RTCSceneFlags sflags, int N)
+  {
+    /* odd number of points to also get partially filled leaves */
+    const size_t numPoints = 37;
+    RTCScene scene = rtcNewScene(sflags,aflags);
+    unsigned spheres = addPoints(scene,RTC_POINT_SPHERE,numPoints,Vec3fa(0,0,0),Vec3fa(4,0,0),1.0f);
+    unsigned discs   = addPoints(scene,RTC_POINT_DISC  ,numPoints,Vec3fa(0,0,10),Vec3fa(4,0,0),1.0f);
+    unsigned plane   = addPlane(scene,RTC_GEOMETRY_STATIC,1,Vec3fa(-10,-5,-10),Vec3fa(200,0,0),Vec3fa(0,0,40));
+    rtcCommit (scene);
+    AssertNoError();
+
+    bool passed = true;
+    for (size_t i=0; i<numPoints; i++)
     {
-      if (i%20 == 0) std::cout << "." << std::flush;
+      /* spheres are hit at the front side */
+      const Vec3fa org(4.0f*float(i)+0.1f,10.0f,0.0f);
+      RTCRay ray0 = makeRay(org,Vec3fa(0,-1,0));
+      rtcIntersectN(scene,ray0,N);
+      if (ray0.geomID != spheres || ray0.primID != i || abs(ray0.tfar-9.005f) > 0.01f || ray0.Ng[1] <= 0.0f) passed = false;
+
+      /* rays starting inside a sphere hit its back side */
+      RTCRay ray1 = makeRay(Vec3fa(4.0f*float(i),0.0f,0.0f),Vec3fa(0,1,0));
+      rtcIntersectN(scene,ray1,N);
+      if (ray1.geomID != spheres || ray1.primID != i || abs(ray1.tfar-1.0f) > 0.01f) passed = false;
+
+      /* discs are hit at the closest distance to their center */
+      RTCRay ray2 = makeRay(org+Vec3fa(0,0,10),Vec3fa(0,-1,0));
+      rtcIntersectN(scene,ray2,N);
+      if (ray2.geomID != discs || ray2.primID != i || abs(ray2.tfar-10.0f) > 0.01f || ray2.Ng[1] <= 0.0f) passed = false;
+
+      RTCRay shadow = makeRay(org+Vec3fa(0,0,10),Vec3fa(0,-1,0));
+      rtcOccludedN(scene,shadow,N);
+      if (shadow.geomID != 0) passed = false;
+
+      /* rays between two points reach the ground plane */
+      RTCRay ray3 = makeRay(org+Vec3fa(1.9f,0,10),Vec3fa(0,-1,0));
+      rtcIntersectN(scene,ray3,N);
+      if (ray3.geomID != plane || abs(ray3.tfar-15.0f) > 0.01f) passed = false;
+    }
 
-      for (size_t j=0; j<20; j++) 
-      {
-        int index = rand()%1024;
-        Vec3fa pos = 100.0f*Vec3fa(drand48(),drand48(),drand48());
-        if (geom[index] == -1) 
-        {
-          int type = rand()%3;
-          size_t numPhi = rand()%100;
-          size_t numTriangles = 2*2*numPhi*(numPhi-1);
-          numTriangles = rand()%(numTriangles+1);
-          types[index] = type;
-          numVertices[index] = 2*numPhi*(numPhi+1);
-          switch (type) {
-          case 0: geom[index] = addSphere(scene,RTC_GEOMETRY_STATIC,pos,2.0f,numPhi,numTriangles,0.0f); break;
-          case 1: geom[index] = addSphere(scene,RTC_GEOMETRY_DEFORMABLE,pos,2.0f,numPhi,numTriangles,0.0f); break;
-          case 2: geom[index] = addSphere(scene,RTC_GEOMETRY_DYNAMIC,pos,2.0f,numPhi,numTriangles,0.0f); break;
+    rtcDeleteScene (scene);
+    return passed;
+  }
 
-          case 3: geom[index] = addSphere(scene,RTC_GEOMETRY_STATIC,pos,2.0f,numPhi,numTriangles,1.0f); break;
-          case 4: geom[index] = addSphere(scene,RTC_GEOMETRY_DEFORMABLE,pos,2.0f,numPhi,numTriangles,1.0f); break;
+  void rtcore_points_all ()
+  {
+    printf("%30s ... ","points");
+    bool passed = true;
+    for (int i=0; i<numSceneFlags; i++)
+    {
+      RTCSceneFlags flag = getSceneFlag(i);
+      bool ok0 = rtcore_points(flag,1);
+      ok0 &= rtcore_points(flag,4);
+#if defined(__TARGET_AVX__) || defined(__TARGET_AVX2__)
+      if (has_feature(AVX)) ok0 &= rtcore_points(flag,8);
+#endif
+      if (ok0) printf("\033[32m+\033[0m"); else printf("\033[31m-\033[0m");
+      passed &= ok0;
+    }
+    printf(" %s\n",passed ? "\033[32m[PASSED]\033[0m" : "\033[31m[FAILED]\033[0m");
+	fflush(stdout);
+  }
+
+  unsigned addQuadGrid (RTCScene scene, size_t width, size_t height, float maxHeight)
+  {
+    unsigned geom = rtcNewQuadMesh (scene, RTC_GEOMETRY_STATIC, width*height, (width+1)*(height+1));
+    Vec3fa* vertices = (Vec3fa*) rtcMapBuffer(scene,geom,RTC_VERTEX_BUFFER);
+    for (size_t z=0; z<=height; z++)
+      for (size_t x=0; x<=width; x++)
+        vertices[z*(width+1)+x] = Vec3fa(float(x),maxHeight*float(drand48()),float(z));
+    rtcUnmapBuffer(scene,geom,RTC_VERTEX_BUFFER);
+    int* quads = (int*) rtcMapBuffer(scene,geom,RTC_INDEX_BUFFER);
+    for (size_t z=0; z<height; z++) {
+      for (size_t x=0; x<width; x++) {
+        int* quad = &quads[4*(z*width+x)];
+        quad[0] = (z+0)*(width+1)+(x+0);
+        quad[1] = (z+0)*(width+1)+(x+1);
+        quad[2] = (z+1)*(width+1)+(x+1);
+        quad[3] = (z+1)*(width+1)+(x+0);
+      }
+    }
+    rtcUnmapBuffer(scene,geom,RTC_INDEX_BUFFER);
+    return geom;
+  }
+
+  bool rtcore_quad_mesh(RTCSceneFlags sflags, int N)
+  {
+    /* odd number of quads to also get partially filled leaves */
+    const size_t width = 9, height = 7;
+    RTCScene scene = rtcNewScene(sflags,aflags);
+    unsigned mesh = addQuadGrid(scene,width,height,0.5f);
+    rtcCommit (scene);
+    AssertNoError();
+
+    /* sample points in both triangles and on the shared diagonal */
+    const float uv[3][2] = { { 0.25f, 0.5f }, { 0.75f, 0.625f }, { 0.25f, 0.75f } };
+
+    bool passed = true;
+    for (size_t z=0; z<height; z++)
+    {
+      for (size_t x=0; x<width; x++)
+      {
+        for (size_t k=0; k<3; k++)
+        {
+          const Vec3fa org(float(x)+uv[k][0],10.0f,float(z)+uv[k][1]);
+          RTCRay ray = makeRay(org,Vec3fa(0,-1,0));
+          rtcIntersectN(scene,ray,N);
+          if (ray.geomID != mesh || ray.primID != z*width+x) passed = false;
+          if (abs(ray.u-uv[k][0]) > 0.001f || abs(ray.v-uv[k][1]) > 0.001f) passed = false;
+
+          RTCRay shadow = makeRay(org,Vec3fa(0,-1,0));
+          rtcOccludedN(scene,shadow,N);
+          if (shadow.geomID != 0) passed = false;
+        }
+      }
+    }
+
+    rtcDeleteScene (scene);
+    return passed;
+  }
+
+  void rtcore_quad_mesh_all ()
+  {
+    printf("%30s ... ","quad_mesh");
+    bool passed = true;
+    for (int i=0; i<numSceneFlags; i++)
+    {
+      RTCSceneFlags flag = getSceneFlag(i);
+      bool ok0 = rtcore_quad_mesh(flag,1);
+      ok0 &= rtcore_quad_mesh(flag,4);
+#if defined(__TARGET_AVX__) || defined(__TARGET_AVX2__)
+      if (has_feature(AVX)) ok0 &= rtcore_quad_mesh(flag,8);
+#endif
+      if (ok0) printf("\033[32m+\033[0m"); else printf("\033[31m-\033[0m");
+      passed &= ok0;
+    }
+    printf(" %s\n",passed ? "\033[32m[PASSED]\033[0m" : "\033[31m[FAILED]\033[0m");
+	fflush(stdout);
+  }
+
+  bool rtcore_autotune(RTCSceneFlags sflags)
+  {
+    RTCScene scene0 = rtcNewScene(sflags,aflags);
+    RTCScene scene1 = rtcNewScene(RTCSceneFlags(sflags | RTC_SCENE_AUTOTUNE),aflags);
+    AssertNoError();
+    for (size_t i=0; i<10; i++) {
+      Vec3fa pos = 4.0f*Vec3fa(drand48(),drand48(),drand48());
+      addSphere(scene0,RTC_GEOMETRY_STATIC,pos,1.0f,50);
+      addSphere(scene1,RTC_GEOMETRY_STATIC,pos,1.0f,50);
+    }
+    AssertNoError();
+
+#if !defined(__EXIT_ON_ERROR__)
+    rtcGetSceneAccel(scene1); // scene is not committed yet
+    AssertAnyError();
+#endif
+    rtcCommit (scene0);
+    rtcCommit (scene1);
+    AssertNoError();
+    if (rtcGetSceneAccel(scene1) == NULL) return false;
+    AssertNoError();
+
+    /* selected acceleration structure has to find the same hits */
+    bool passed = true;
+    for (size_t i=0; i<1000; i++) 
+    {
+      Vec3fa org = 10.0f*Vec3fa(drand48(),drand48(),drand48())-Vec3fa(3.0f);
+      Vec3fa dir = Vec3fa(2.0f)-org;
+      RTCRay ray0 = makeRay(org,dir); rtcIntersect(scene0,ray0);
+      RTCRay ray1 = makeRay(org,dir); rtcIntersect(scene1,ray1);
+      passed &= ray0.geomID == ray1.geomID;
+      passed &= ray0.geomID == -1 || abs(ray0.tfar-ray1.tfar) < 1E-4f*ray0.tfar;
+    }
+    
+    rtcDeleteScene (scene0);
+    rtcDeleteScene (scene1);
+    AssertNoError();
+    return passed;
+  }
+
+  bool rtcore_closest_point(RTCSceneFlags sflags)
+  {
+    RTCScene scene = rtcNewScene(sflags,aflags);
+    AssertNoError();
+    unsigned geom0 = addPlane(scene,RTC_GEOMETRY_STATIC,20,Vec3fa(0.0f,0.0f,0.0f),Vec3fa(1.0f,0.0f,0.0f),Vec3fa(0.0f,1.0f,0.0f));
+    unsigned geom1 = addPlane(scene,RTC_GEOMETRY_STATIC,20,Vec3fa(0.0f,0.0f,1.0f),Vec3fa(1.0f,0.0f,0.0f),Vec3fa(0.0f,1.0f,0.0f));
+    addSphere(scene,RTC_GEOMETRY_STATIC,Vec3fa(10.0f),1.0f,50);
+    rtcSetMask(scene,geom1,2);
+    AssertNoError();
+
+#if !defined(__EXIT_ON_ERROR__)
+    RTCClosestPoint result;
+    const float p0[3] = { 0.5f, 0.5f, 0.5f };
+    rtcClosestPoint(scene,p0,inf,-1,result); // scene is not committed yet
+    AssertAnyError();
+#endif
+    rtcCommit (scene);
+    AssertNoError();
+
+    /* query points above the planes, the closest point is the projection onto the closest plane */
+    bool passed = true;
+    for (size_t i=0; i<1000; i++) 
+    {
+      const float p[3] = { 0.1f+0.8f*float(drand48()), 0.1f+0.8f*float(drand48()), 2.0f*float(drand48())-0.5f };
+      RTCClosestPoint hit0; rtcClosestPoint(scene,p,inf,-1,hit0);
+      RTCClosestPoint hit1; rtcClosestPoint(scene,p,inf,1,hit1);
+      AssertNoError();
+      const bool above = abs(p[2]-1.0f) < abs(p[2]);
+      passed &= hit0.geomID == (above ? geom1 : geom0);
+      passed &= abs(hit0.dist-min(abs(p[2]),abs(p[2]-1.0f))) < 1E-4f;
+      passed &= abs(hit0.p[0]-p[0]) < 1E-4f && abs(hit0.p[1]-p[1]) < 1E-4f && abs(hit0.p[2]-(above ? 1.0f : 0.0f)) < 1E-4f;
+      passed &= hit0.u >= 0.0f && hit0.v >= 0.0f && hit0.u+hit0.v <= 1.0f+1E-5f;
+      passed &= hit1.geomID == geom0 && abs(hit1.dist-abs(p[2])) < 1E-4f;
+
+      /* no triangle within a small radius */
+      RTCClosestPoint hit2; rtcClosestPoint(scene,p,0.5f*hit0.dist,-1,hit2);
+      passed &= hit2.geomID == RTC_INVALID_GEOMETRY_ID;
+    }
+
+#if !defined(__EXIT_ON_ERROR__)
+    /* the query only considers triangles, thus scenes with other geometry types are rejected */
+    RTCScene mixed = rtcNewScene(sflags,aflags);
+    addSphere(mixed,RTC_GEOMETRY_STATIC,zero,1.0f,50);
+    addPoints(mixed,RTC_POINT_SPHERE,1,Vec3fa(4.0f,0.0f,0.0f),Vec3fa(0.0f),1.0f);
+    rtcCommit (mixed);
+    AssertNoError();
+    RTCClosestPoint hit3;
+    const float p3[3] = { 4.0f, 0.0f, 0.0f };
+    rtcClosestPoint(mixed,p3,inf,-1,hit3);
+    AssertError(RTC_INVALID_OPERATION);
+    rtcDeleteScene (mixed);
+#endif
+
+    rtcDeleteScene (scene);
+    AssertNoError();
+    return passed;
+  }
+
+  bool rtcore_occluded_matrix(RTCSceneFlags sflags)
+  {
+    RTCScene scene = rtcNewScene(sflags,aflags);
+    AssertNoError();
+    for (size_t i=0; i<10; i++) 
+      addSphere(scene,RTC_GEOMETRY_STATIC,4.0f*Vec3fa(drand48(),drand48(),drand48()),1.0f,50);
+    rtcCommit (scene);
+    AssertNoError();
+
+    const size_t numPoints = 50, numTargets = 70, rowWords = (numTargets+31)/32;
+    std::vector<Vec3fa> points(numPoints), targets(numTargets);
+    for (size_t i=0; i<numPoints; i++) points[i] = 6.0f*Vec3fa(drand48(),drand48(),drand48())-Vec3fa(1.0f);
+    for (size_t j=0; j<numTargets; j++) targets[j] = 6.0f*Vec3fa(drand48(),drand48(),drand48())-Vec3fa(1.0f);
+    std::vector<unsigned int> occluded(numPoints*rowWords);
+    const float eps = 1E-3f;
+    rtcOccludedMatrix(scene,(float*)&points[0],numPoints,sizeof(Vec3fa),(float*)&targets[0],numTargets,sizeof(Vec3fa),eps,&occluded[0]);
+    AssertNoError();
+
+    /* compare against individual occlusion rays */
+    size_t numErrors = 0, numOccluded = 0;
+    for (size_t i=0; i<numPoints; i++) {
+      for (size_t j=0; j<numTargets; j++) {
+        const float dist = length(targets[j]-points[i]);
+        RTCRay ray = makeRay(points[i],(targets[j]-points[i])/dist);
+        ray.tnear = eps; ray.tfar = dist-eps;
+        rtcOccluded(scene,ray);
+        const bool hit0 = ray.geomID == 0;
+        const bool hit1 = (occluded[i*rowWords+j/32] >> (j%32)) & 1;
+        numErrors += hit0 != hit1;
+        numOccluded += hit1;
+      }
+    }
+
+#if !defined(__EXIT_ON_ERROR__)
+    rtcOccludedMatrix(scene,NULL,numPoints,sizeof(Vec3fa),(float*)&targets[0],numTargets,sizeof(Vec3fa),eps,&occluded[0]);
+    AssertError(RTC_INVALID_ARGUMENT);
+#endif
+
+    rtcDeleteScene (scene);
+    AssertNoError();
+    return numErrors <= 2 && numOccluded > 0 && numOccluded < numPoints*numTargets;
+  }
+
+  /*! collects the collisions reported by rtcCollide */
+  struct CollisionList
+  {
+    static void callback(void* ptr, const RTCCollision* collisions, size_t num) 
+    {
+      CollisionList* list = (CollisionList*) ptr;
+      Lock<MutexSys> lock(list->mutex);
+      for (size_t i=0; i<num; i++) {
+        const RTCCollision& c = collisions[i];
+        list->pairs.push_back(std::make_pair(std::make_pair(c.geomID0,c.primID0),std::make_pair(c.geomID1,c.primID1)));
+      }
+    }
+
+    void sort() { std::sort(pairs.begin(),pairs.end()); }
+
+    MutexSys mutex;
+    std::vector<std::pair<std::pair<unsigned,unsigned>,std::pair<unsigned,unsigned> > > pairs;
+  };
+
+  bool rtcore_collide(RTCSceneFlags sflags)
+  {
+    /* horizontal plane in the unit square and a vertical plane at x = 0.537 crossing it */
+    const size_t num = 100;
+    RTCScene scene0 = rtcNewScene(sflags,aflags);
+    unsigned geom0 = addPlane(scene0,RTC_GEOMETRY_STATIC,num,Vec3fa(0.0f,0.0f,0.0f),Vec3fa(1.0f,0.0f,0.0f),Vec3fa(0.0f,1.0f,0.0f));
+    RTCScene scene1 = rtcNewScene(sflags,aflags);
+    unsigned geom1 = addPlane(scene1,RTC_GEOMETRY_STATIC,10,Vec3fa(0.537f,-1.0f,-0.95f),Vec3fa(0.0f,3.0f,0.0f),Vec3fa(0.0f,0.0f,2.0f));
+
+    /* same vertical plane at x = 0 to get translated, and rotated by permuting the coordinates */
+    RTCScene scene2 = rtcNewScene(sflags,aflags);
+    addPlane(scene2,RTC_GEOMETRY_STATIC,10,Vec3fa(0.0f,-1.0f,-0.95f),Vec3fa(0.0f,3.0f,0.0f),Vec3fa(0.0f,0.0f,2.0f));
+    RTCScene scene3 = rtcNewScene(sflags,aflags);
+    addPlane(scene3,RTC_GEOMETRY_STATIC,10,Vec3fa(-1.0f,-0.95f,0.537f),Vec3fa(3.0f,0.0f,0.0f),Vec3fa(0.0f,2.0f,0.0f));
+    AssertNoError();
+
+    CollisionList list0;
+#if !defined(__EXIT_ON_ERROR__)
+    rtcCollide(scene0,scene1,NULL,CollisionList::callback,&list0); // scenes are not committed yet
+    AssertAnyError();
+#endif
+    rtcCommit (scene0);
+    rtcCommit (scene1);
+    rtcCommit (scene2);
+    rtcCommit (scene3);
+    AssertNoError();
+
+    /* exactly the triangles of the column at x = 0.537 have to collide */
+    rtcCollide(scene0,scene1,NULL,CollisionList::callback,&list0);
+    AssertNoError();
+    list0.sort();
+    bool passed = list0.pairs.size() > 0;
+    std::vector<bool> hit(2*num*num,false);
+    for (size_t i=0; i<list0.pairs.size(); i++) {
+      passed &= list0.pairs[i].first.first == geom0 && list0.pairs[i].second.first == geom1;
+      passed &= list0.pairs[i].first.second < 2*num*num;
+      if (passed) hit[list0.pairs[i].first.second] = true;
+    }
+    for (size_t y=0; y<num; y++)
+      for (size_t x=0; x<num; x++)
+        for (size_t k=0; k<2; k++)
+          passed &= hit[2*y*num+2*x+k] == (x == 53);
+
+    /* translated and rotated instances of the vertical plane have to give the same result */
+    const float translation[12] = { 1.0f,0.0f,0.0f, 0.0f,1.0f,0.0f, 0.0f,0.0f,1.0f, 0.537f,0.0f,0.0f };
+    CollisionList list1; rtcCollide(scene0,scene2,translation,CollisionList::callback,&list1); list1.sort();
+    const float rotation[12] = { 0.0f,1.0f,0.0f, 0.0f,0.0f,1.0f, 1.0f,0.0f,0.0f, 0.0f,0.0f,0.0f };
+    CollisionList list2; rtcCollide(scene0,scene3,rotation,CollisionList::callback,&list2); list2.sort();
+    const float far[12] = { 1.0f,0.0f,0.0f, 0.0f,1.0f,0.0f, 0.0f,0.0f,1.0f, 5.0f,0.0f,0.0f };
+    CollisionList list3; rtcCollide(scene0,scene2,far,CollisionList::callback,&list3);
+    AssertNoError();
+    passed &= list1.pairs == list0.pairs;
+    passed &= list2.pairs == list0.pairs;
+    passed &= list3.pairs.empty();
+
+#if !defined(__EXIT_ON_ERROR__)
+    /* the query only considers triangles, thus scenes with other geometry types are rejected */
+    RTCScene mixed = rtcNewScene(sflags,aflags);
+    addPlane(mixed,RTC_GEOMETRY_STATIC,10,Vec3fa(0.537f,-1.0f,-0.95f),Vec3fa(0.0f,3.0f,0.0f),Vec3fa(0.0f,0.0f,2.0f));
+    addPoints(mixed,RTC_POINT_SPHERE,1,Vec3fa(0.5f,0.5f,0.0f),Vec3fa(0.0f),0.1f);
+    rtcCommit (mixed);
+    AssertNoError();
+    CollisionList list4; rtcCollide(scene0,mixed,NULL,CollisionList::callback,&list4);
+    AssertError(RTC_INVALID_OPERATION);
+    rtcDeleteScene (mixed);
+#endif
+
+    rtcDeleteScene (scene0);
+    rtcDeleteScene (scene1);
+    rtcDeleteScene (scene2);
+    rtcDeleteScene (scene3);
+    AssertNoError();
+    return passed;
+  }
+
+  bool rtcore_multi_hit(RTCSceneFlags sflags)
+  {
+    /* stack of parallel planes at z = 0,1,...,numPlanes-1 */
+    const size_t numPlanes = 8;
+    RTCScene scene = rtcNewScene(sflags,aflags);
+    for (size_t i=0; i<numPlanes; i++)
+      addPlane(scene,RTC_GEOMETRY_STATIC,10,Vec3fa(0.0f,0.0f,float(i)),Vec3fa(1.0f,0.0f,0.0f),Vec3fa(0.0f,1.0f,0.0f));
+    AssertNoError();
+
+    RTCHit hits[8*(numPlanes+2)];
+#if !defined(__EXIT_ON_ERROR__)
+    rtcIntersectMultiHit(scene,makeRay(Vec3fa(0.5f,0.5f,-1.0f),Vec3fa(0,0,1)),hits,numPlanes); // scene is not committed yet
+    AssertAnyError();
+#endif
+    rtcCommit (scene);
+    AssertNoError();
+
+    /* every plane is hit once in front to back order, the ray segment limits the number of hits */
+    bool passed = true;
+    for (size_t i=0; i<1000; i++) 
+    {
+      const Vec3fa org(0.2f+0.6f*drand48(),0.2f+0.6f*drand48(),-1.0f);
+      const Vec3fa dir(0.02f*drand48(),0.02f*drand48(),1.0f);
+      const size_t k = i%(numPlanes+2);
+      const float tfar = i%3 ? inf : 4.5f;
+      const size_t expected = min(k,tfar == float(inf) ? numPlanes : size_t(4));
+      RTCRay ray = makeRay(org,dir,0.0f,tfar);
+      size_t num = rtcIntersectMultiHit(scene,ray,hits,k);
+      passed &= num == expected;
+      for (size_t j=0; j<min(num,expected); j++) {
+        passed &= hits[j].geomID == int(j);
+        passed &= abs(hits[j].t-float(j+1)) < 1E-4f;
+      }
+      if (num) {
+        RTCRay ray0 = makeRay(org,dir,0.0f,tfar); rtcIntersect(scene,ray0);
+        passed &= ray0.geomID == hits[0].geomID && ray0.primID == hits[0].primID && abs(ray0.tfar-hits[0].t) < 1E-4f;
+      }
+    }
+    AssertNoError();
+
+#if defined(__TARGET_AVX__) || defined(__TARGET_AVX2__)
+    if (has_feature(AVX)) 
+    {
+      const size_t k = numPlanes+2;
+      for (size_t i=0; i<100; i++) 
+      {
+        __align(32) int valid8[8];
+        RTCRay8 ray8; size_t numHits[8];
+        for (size_t j=0; j<8; j++) {
+          valid8[j] = (i+j)%4 ? -1 : 0;
+          const Vec3fa org(0.2f+0.6f*drand48(),0.2f+0.6f*drand48(),-1.0f);
+          const Vec3fa dir(0.02f*drand48(),0.02f*drand48(),1.0f);
+          setRay(ray8,j,makeRay(org,dir,0.0f,j%2 ? inf : 4.5f));
+        }
+        rtcIntersectMultiHit8(valid8,scene,ray8,hits,k,numHits);
+        for (size_t j=0; j<8; j++) {
+          const size_t expected = valid8[j] ? (j%2 ? numPlanes : 4) : 0;
+          passed &= numHits[j] == expected;
+          for (size_t l=0; l<min(numHits[j],expected); l++) {
+            passed &= hits[j*k+l].geomID == int(l);
+            passed &= abs(hits[j*k+l].t-float(l+1)) < 1E-4f;
+          }
+        }
+      }
+      AssertNoError();
+    }
+#endif
+
+    rtcDeleteScene (scene);
+    AssertNoError();
+    return passed;
+  }
+
+  bool rtcore_occluded_hint(RTCSceneFlags sflags)
+  {
+    RTCScene scene = rtcNewScene(sflags,aflags);
+    for (size_t i=0; i<10; i++) 
+      addSphere(scene,RTC_GEOMETRY_STATIC,4.0f*Vec3fa(drand48(),drand48(),drand48()),1.0f,50);
+    AssertNoError();
+
+    RTCOccluderHint hint; hint.geomID = RTC_INVALID_GEOMETRY_ID; hint.primID = 0; hint.leaf = 0; hint.scene = NULL; hint.commit = 0;
+#if !defined(__EXIT_ON_ERROR__)
+    RTCRay ray = makeRay(zero,Vec3fa(1.0f));
+    rtcOccludedHint(scene,ray,hint); // scene is not committed yet
+    AssertError(RTC_INVALID_OPERATION);
+#endif
+    rtcCommit (scene);
+    AssertNoError();
+
+    /* the hint must not change the result, and the reported occluder has to block the ray again */
+    bool passed = true;
+    for (size_t i=0; i<1000; i++) 
+    {
+      const Vec3fa org = 10.0f*Vec3fa(drand48(),drand48(),drand48())-Vec3fa(3.0f);
+      const Vec3fa dir = Vec3fa(2.0f)-org;
+      RTCRay ray0 = makeRay(org,dir); rtcOccluded(scene,ray0);
+      RTCOccluderHint hint0 = hint;
+      RTCRay ray1 = makeRay(org,dir); rtcOccludedHint(scene,ray1,hint);
+      passed &= ray0.geomID == ray1.geomID;
+      if (ray1.geomID == RTC_INVALID_GEOMETRY_ID) {
+        passed &= hint.geomID == hint0.geomID && hint.primID == hint0.primID;
+        continue;
+      }
+      passed &= hint.geomID < 10;
+      RTCOccluderHint hint1 = hint;
+      RTCRay ray2 = makeRay(org,dir); rtcOccludedHint(scene,ray2,hint1);
+      passed &= ray2.geomID == 0 && hint1.geomID == hint.geomID && hint1.primID == hint.primID;
+      RTCRay ray3 = makeRay(org,dir); ray3.tfar = 0.0f; rtcOccludedHint(scene,ray3,hint1);
+      passed &= ray3.geomID == RTC_INVALID_GEOMETRY_ID;
+    }
+    AssertNoError();
+
+    /* a hint of another scene is ignored */
+    RTCScene scene1 = rtcNewScene(sflags,aflags);
+    addSphere(scene1,RTC_GEOMETRY_STATIC,Vec3fa(-4.0f,0.0f,0.0f),1.0f,50);
+    rtcCommit (scene1);
+    AssertNoError();
+    for (size_t i=0; i<100; i++) 
+    {
+      const Vec3fa org = 10.0f*Vec3fa(drand48(),drand48(),drand48())-Vec3fa(3.0f);
+      const Vec3fa dir = Vec3fa(2.0f)-org;
+      RTCRay ray0 = makeRay(org,dir); rtcOccluded(scene1,ray0);
+      RTCOccluderHint hint0 = hint;
+      RTCRay ray1 = makeRay(org,dir); rtcOccludedHint(scene1,ray1,hint0);
+      passed &= ray0.geomID == ray1.geomID;
+      passed &= ray1.geomID == RTC_INVALID_GEOMETRY_ID ? hint0.geomID == RTC_INVALID_GEOMETRY_ID : hint0.scene == scene1;
+    }
+    rtcDeleteScene (scene1);
+    AssertNoError();
+
+    /* a hint gets invalid when the scene is committed again */
+    if (sflags & RTC_SCENE_DYNAMIC) 
+    {
+      for (size_t i=0; i<10; i++) rtcDeleteGeometry(scene,i);
+      addSphere(scene,RTC_GEOMETRY_STATIC,Vec3fa(-4.0f,0.0f,0.0f),1.0f,50);
+      rtcCommit (scene);
+      AssertNoError();
+      for (size_t i=0; i<100; i++) 
+      {
+        const Vec3fa org = 10.0f*Vec3fa(drand48(),drand48(),drand48())-Vec3fa(3.0f);
+        const Vec3fa dir = Vec3fa(2.0f)-org;
+        RTCRay ray0 = makeRay(org,dir); rtcOccluded(scene,ray0);
+        RTCOccluderHint hint0 = hint;
+        RTCRay ray1 = makeRay(org,dir); rtcOccludedHint(scene,ray1,hint0);
+        passed &= ray0.geomID == ray1.geomID;
+      }
+      AssertNoError();
+    }
+
+    rtcDeleteScene (scene);
+    AssertNoError();
+    return passed;
+  }
+
+  bool rtcore_instancing(RTCSceneFlags sflags, int N)
+  {
+    /* two translated instances of a sphere and the same spheres as plain geometry */
+    RTCScene object = rtcNewScene(sflags,aflags);
+    addSphere(object,RTC_GEOMETRY_STATIC,Vec3fa(0.0f),1.0f,50);
+    rtcCommit (object);
+    RTCScene scene0 = rtcNewScene(sflags,aflags);
+    RTCScene scene1 = rtcNewScene(sflags,aflags);
+    const Vec3fa pos[2] = { Vec3fa(-2.0f,0.0f,0.0f), Vec3fa(+2.0f,0.5f,0.0f) };
+    for (size_t i=0; i<2; i++) {
+      const float xfm[12] = { 1.0f,0.0f,0.0f, 0.0f,1.0f,0.0f, 0.0f,0.0f,1.0f, pos[i].x,pos[i].y,pos[i].z };
+      unsigned inst = rtcNewInstance(scene0,object);
+      rtcSetTransform(scene0,inst,RTC_MATRIX_COLUMN_MAJOR,xfm);
+      addSphere(scene1,RTC_GEOMETRY_STATIC,pos[i],1.0f,50);
+    }
+    rtcCommit (scene0);
+    rtcCommit (scene1);
+    AssertNoError();
+
+    /* instance hits have to match the plain spheres and the ray origin and direction must not change */
+    bool passed = true;
+    for (size_t i=0; i<1000; i++) 
+    {
+      const Vec3fa org = Vec3fa(4.0f*drand48()-2.0f,2.0f*drand48()-1.0f,-5.0f);
+      const Vec3fa dir = pos[i%2]+Vec3fa(0.5f*drand48()-0.25f,0.5f*drand48()-0.25f,0.0f)-org;
+      RTCRay ray0 = makeRay(org,dir); rtcIntersectN(scene0,ray0,N);
+      RTCRay ray1 = makeRay(org,dir); rtcIntersectN(scene1,ray1,N);
+      passed &= ray0.instID == ray1.geomID && (ray0.geomID == 0) == (ray1.geomID != RTC_INVALID_GEOMETRY_ID);
+      passed &= abs(ray0.tfar-ray1.tfar) < 1E-3f;
+      passed &= Vec3fa(ray0.org[0],ray0.org[1],ray0.org[2]) == org && Vec3fa(ray0.dir[0],ray0.dir[1],ray0.dir[2]) == dir;
+      RTCRay ray2 = makeRay(org,dir); rtcOccludedN(scene0,ray2,N);
+      passed &= ray2.geomID == (ray1.geomID == RTC_INVALID_GEOMETRY_ID ? RTC_INVALID_GEOMETRY_ID : 0);
+    }
+    AssertNoError();
+
+    rtcDeleteScene (scene0);
+    rtcDeleteScene (scene1);
+    rtcDeleteScene (object);
+    AssertNoError();
+    return passed;
+  }
+
+  bool rtcore_nested_instancing(int N)
+  {
+    /* three levels of instances of a small sphere, the instance IDs
+     * of all levels together identify the sphere */
+    RTCScene scenes[4];
+    for (size_t i=0; i<4; i++) scenes[i] = rtcNewScene(RTC_SCENE_DYNAMIC,aflags);
+    unsigned sphere = addSphere(scenes[0],RTC_GEOMETRY_DEFORMABLE,Vec3fa(0.0f),0.25f,20);
+    const Vec3fa offset[3] = { Vec3fa(0.5f,0.0f,0.0f), Vec3fa(0.0f,1.0f,0.0f), Vec3fa(2.0f,0.0f,0.0f) };
+    for (size_t l=0; l<3; l++) {
+      for (size_t i=0; i<2; i++) {
+        const Vec3fa p = (i ? 1.0f : -1.0f)*offset[l];
+        const float xfm[12] = { 1.0f,0.0f,0.0f, 0.0f,1.0f,0.0f, 0.0f,0.0f,1.0f, p.x,p.y,p.z };
+        unsigned inst = rtcNewInstance(scenes[l+1],scenes[l]);
+        rtcSetTransform(scenes[l+1],inst,RTC_MATRIX_COLUMN_MAJOR,xfm);
+      }
+      rtcCommit (scenes[l]);
+    }
+    rtcCommit (scenes[3]);
+    AssertNoError();
+
+#if !defined(__EXIT_ON_ERROR__)
+    /* instancing a scene into itself or into a scene it instances is not allowed */
+    if (rtcNewInstance(scenes[0],scenes[3]) != RTC_INVALID_GEOMETRY_ID) return false;
+    AssertError(RTC_INVALID_ARGUMENT);
+    if (rtcNewInstance(scenes[2],scenes[2]) != RTC_INVALID_GEOMETRY_ID) return false;
+    AssertError(RTC_INVALID_ARGUMENT);
+#endif
+
+    bool passed = true;
+    for (size_t pass=0; pass<2; pass++)
+    {
+      /* the instance stack lists the instance IDs from the outermost level down */
+      for (size_t i=0; i<8; i++)
+      {
+        const int id[3] = { int(i>>2)&1, int(i>>1)&1, int(i>>0)&1 };
+        Vec3fa org(0.0f,0.0f,-5.0f);
+        for (size_t l=0; l<3; l++) org += (id[2-l] ? 1.0f : -1.0f)*offset[l];
+        RTCRay ray = makeRay(org,Vec3fa(0.0f,0.0f,1.0f)); rtcIntersectN(scenes[3],ray,N);
+        passed &= ray.geomID == 0 && ray.instID == id[0];
+        passed &= ray.instStack[0] == id[0] && ray.instStack[1] == id[1] && ray.instStack[2] == id[2] && ray.instStack[3] == -1;
+        passed &= abs(ray.tfar-(pass ? 5.75f : 4.75f)) < 1E-3f;
+      }
+
+      /* moving the sphere and committing only the innermost and outermost scene updates the levels in between */
+      Vertex* vertices = (Vertex*) rtcMapBuffer(scenes[0],sphere,RTC_VERTEX_BUFFER);
+      for (size_t i=0; i<20*2*21; i++) vertices[i].z += 1.0f;
+      rtcUnmapBuffer(scenes[0],sphere,RTC_VERTEX_BUFFER);
+      rtcUpdate(scenes[0],sphere);
+      rtcCommit (scenes[0]);
+      rtcCommit (scenes[3]);
+      AssertNoError();
+    }
+
+    /* a closer hit outside of any instance resets the instance IDs of the instance hit behind it, even if they were not initialized */
+    unsigned points = addPoints(scenes[3],RTC_POINT_SPHERE,1,Vec3fa(-2.5f,-1.0f,-3.0f),Vec3fa(0.0f),0.25f);
+    rtcCommit (scenes[3]);
+    AssertNoError();
+    RTCRay ray = makeRay(Vec3fa(-2.5f,-1.0f,-5.0f),Vec3fa(0.0f,0.0f,1.0f)); 
+    ray.instID = 7; for (size_t l=0; l<RTC_MAX_INSTANCE_DEPTH; l++) ray.instStack[l] = 7;
+    rtcIntersectN(scenes[3],ray,N);
+    passed &= ray.geomID == points && ray.instID == -1 && abs(ray.tfar-1.75f) < 1E-3f;
+    for (size_t l=0; l<RTC_MAX_INSTANCE_DEPTH; l++) passed &= ray.instStack[l] == -1;
+
+    for (size_t i=0; i<4; i++) rtcDeleteScene (scenes[i]);
+    AssertNoError();
+    return passed;
+  }
+
+  bool rtcore_motion_blur_instancing(size_t numTimeSteps, int N)
+  {
+    /* an instance of a sphere moving along a path through some keys */
+    const Vec3fa keys[3] = { Vec3fa(-3.0f,0.0f,0.0f), Vec3fa(0.0f,2.0f,0.0f), Vec3fa(3.0f,0.0f,0.0f) };
+    RTCScene object = rtcNewScene(RTC_SCENE_STATIC,aflags);
+    addSphere(object,RTC_GEOMETRY_STATIC,Vec3fa(0.0f),1.0f,50);
+    rtcCommit (object);
+    RTCScene scene = rtcNewScene(RTC_SCENE_STATIC,aflags);
+    unsigned inst = rtcNewInstance(scene,object,numTimeSteps);
+    for (size_t i=0; i<numTimeSteps; i++) {
+      const Vec3fa& p = keys[numTimeSteps == 2 ? 2*i : i];
+      const float xfm[12] = { 1.0f,0.0f,0.0f, 0.0f,1.0f,0.0f, 0.0f,0.0f,1.0f, p.x,p.y,p.z };
+      rtcSetTransform(scene,inst,RTC_MATRIX_COLUMN_MAJOR,xfm,i);
+    }
+    AssertNoError();
+#if !defined(__EXIT_ON_ERROR__)
+    const float xfm[12] = { 1.0f,0.0f,0.0f, 0.0f,1.0f,0.0f, 0.0f,0.0f,1.0f, 0.0f,0.0f,0.0f };
+    rtcSetTransform(scene,inst,RTC_MATRIX_COLUMN_MAJOR,xfm,numTimeSteps);
+    AssertError(RTC_INVALID_OPERATION);
+    rtcNewInstance(scene,object,0);
+    AssertError(RTC_INVALID_ARGUMENT);
+    rtcNewInstance(scene,object,RTC_MAX_INSTANCE_TIME_STEPS+1);
+    AssertError(RTC_INVALID_ARGUMENT);
+#endif
+    rtcCommit (scene);
+    AssertNoError();
+
+    /* rays have to hit the sphere at its interpolated position and miss it at the mirrored one */
+    bool passed = true;
+    for (size_t i=0; i<1000; i++) 
+    {
+      const float time = drand48();
+      const float t = time*float(numTimeSteps-1);
+      const size_t k = min(size_t(t),numTimeSteps-2);
+      const Vec3fa p0 = keys[numTimeSteps == 2 ? 0 : k], p1 = keys[numTimeSteps == 2 ? 2 : k+1];
+      const Vec3fa pos = (1.0f-(t-k))*p0+(t-k)*p1;
+      const Vec3fa offset(drand48()-0.5f,drand48()-0.5f,0.0f);
+      RTCRay ray0 = makeRay(pos+offset-Vec3fa(0.0f,0.0f,5.0f),Vec3fa(0.0f,0.0f,1.0f)); ray0.time = time;
+      rtcIntersectN(scene,ray0,N);
+      passed &= ray0.geomID == 0 && ray0.instID == inst;
+      passed &= abs(ray0.tfar-(5.0f-sqrtf(1.0f-dot(offset,offset)))) < 1E-2f;
+      if (abs(pos.x) < 2.5f) continue;
+      RTCRay ray1 = makeRay(Vec3fa(-pos.x,pos.y,-5.0f)+offset,Vec3fa(0.0f,0.0f,1.0f)); ray1.time = time;
+      rtcOccludedN(scene,ray1,N);
+      passed &= ray1.geomID == RTC_INVALID_GEOMETRY_ID;
+    }
+    AssertNoError();
+
+    rtcDeleteScene (scene);
+    rtcDeleteScene (object);
+    AssertNoError();
+    return passed;
+  }
+
+  bool rtcore_bulk_transforms(int N)
+  {
+    /* many instances of a small sphere, each moving inside its own grid cell */
+    const size_t numInstances = 64*64;
+    RTCScene object = rtcNewScene(RTC_SCENE_STATIC,aflags);
+    addSphere(object,RTC_GEOMETRY_STATIC,Vec3fa(0.0f),0.2f,10);
+    rtcCommit (object);
+    RTCScene scene = rtcNewScene(RTC_SCENE_DYNAMIC,aflags);
+    std::vector<unsigned> geomIDs(numInstances);
+    for (size_t i=0; i<numInstances; i++) 
+      geomIDs[i] = rtcNewInstance(scene,object);
+    AssertNoError();
+
+    bool passed = true;
+    std::vector<float> xfms(12*numInstances);
+    std::vector<size_t> cells(numInstances);
+    for (size_t i=0; i<numInstances; i++) cells[i] = i;
+    for (size_t frame=0; frame<6; frame++)
+    {
+      /* shuffling the instances across the grid lets the refitted BVH degrade and triggers a rebuild */
+      if (frame == 2) {
+        for (size_t i=numInstances-1; i>0; i--) 
+          std::swap(cells[i],cells[size_t(drand48()*(i+1))%(i+1)]);
+      }
+
+      for (size_t i=0; i<numInstances; i++) {
+        const size_t c = cells[i];
+        const float xfm[12] = { 1.0f,0.0f,0.0f, 0.0f,1.0f,0.0f, 0.0f,0.0f,1.0f, 
+                                float(c%64)+0.6f*float(drand48())-0.3f, float(c/64)+0.6f*float(drand48())-0.3f, 0.0f };
+        for (size_t j=0; j<12; j++) xfms[12*i+j] = xfm[j];
+      }
+      rtcSetTransforms(scene,RTC_MATRIX_COLUMN_MAJOR,numInstances,&geomIDs[0],&xfms[0]);
+
+      /* disabling an instance changes the set of objects and causes a rebuild */
+      if (frame == 4) rtcDisable(scene,geomIDs[0]);
+      rtcCommit (scene);
+      AssertNoError();
+
+      /* rays towards the center of each instance have to hit it */
+      for (size_t i=0; i<numInstances; i+=7) {
+        RTCRay ray = makeRay(Vec3fa(xfms[12*i+9],xfms[12*i+10],-5.0f),Vec3fa(0.0f,0.0f,1.0f));
+        rtcIntersectN(scene,ray,N);
+        if (frame >= 4 && i == 0) passed &= ray.geomID == RTC_INVALID_GEOMETRY_ID;
+        else passed &= ray.geomID == 0 && ray.instID == geomIDs[i] && abs(ray.tfar-4.8f) < 1E-2f;
+      }
+    }
+    AssertNoError();
+
+#if !defined(__EXIT_ON_ERROR__)
+    const unsigned invalidID = numInstances;
+    rtcSetTransforms(scene,RTC_MATRIX_COLUMN_MAJOR,1,&invalidID,&xfms[0]);
+    AssertError(RTC_INVALID_ARGUMENT);
+#endif
+
+    rtcDeleteScene (scene);
+    rtcDeleteScene (object);
+    AssertNoError();
+    return passed;
+  }
+
+  /*! state of a thread tracing rays into instances of deferred scenes */
+  struct DeferredBuildThread
+  {
+    RTCScene scene;
+    int N;
+    size_t seed;
+    bool passed;
+  };
+
+  void rtcore_deferred_build_thread(void* ptr)
+  {
+    DeferredBuildThread* thread = (DeferredBuildThread*) ptr;
+    for (size_t i=0; i<256; i++) 
+    {
+      const size_t j = (thread->seed+7*i)%16;
+      RTCRay ray = makeRay(Vec3fa(3.0f*float(j),0.0f,-5.0f),Vec3fa(0.0f,0.0f,1.0f));
+      rtcIntersectN(thread->scene,ray,thread->N);
+      thread->passed &= ray.geomID == 0 && ray.instID == j && abs(ray.tfar-4.8f) < 1E-2f;
+      ray = makeRay(Vec3fa(3.0f*float(j),0.0f,-5.0f),Vec3fa(0.0f,0.0f,1.0f));
+      rtcOccludedN(thread->scene,ray,thread->N);
+      thread->passed &= ray.geomID == 0;
+    }
+  }
+
+  bool rtcore_deferred_build(int N)
+  {
+    /* the objects only get built when the first ray enters one of their instances */
+    RTCScene objects[16];
+    RTCScene scene = rtcNewScene(RTC_SCENE_STATIC,aflags);
+    for (size_t i=0; i<16; i++) {
+      objects[i] = rtcNewScene(RTCSceneFlags(RTC_SCENE_STATIC | RTC_SCENE_DEFERRED),aflags);
+      addSphere(objects[i],RTC_GEOMETRY_STATIC,Vec3fa(0.0f),0.2f,10);
+      rtcCommit (objects[i]);
+      unsigned instID = rtcNewInstance(scene,objects[i]);
+      const float xfm[12] = { 1.0f,0.0f,0.0f, 0.0f,1.0f,0.0f, 0.0f,0.0f,1.0f, 3.0f*float(i),0.0f,0.0f };
+      rtcSetTransform(scene,instID,RTC_MATRIX_COLUMN_MAJOR,xfm);
+    }
+    rtcCommit (scene);
+    AssertNoError();
+
+    /* all threads enter the instances at the same time */
+    const size_t numThreads = 4;
+    DeferredBuildThread threads[numThreads];
+    std::vector<thread_t> handles;
+    for (size_t i=0; i<numThreads; i++) {
+      threads[i].scene = scene; threads[i].N = N; threads[i].seed = 3*i; threads[i].passed = true;
+      if (i) handles.push_back(createThread(rtcore_deferred_build_thread,&threads[i],4*1024*1024,-1));
+    }
+    rtcore_deferred_build_thread(&threads[0]);
+    for (size_t i=0; i<handles.size(); i++) join(handles[i]);
+    AssertNoError();
+
+    bool passed = true;
+    for (size_t i=0; i<numThreads; i++) 
+      passed &= threads[i].passed;
+
+    /* deferred scenes also get built when traced directly */
+    RTCScene object = rtcNewScene(RTCSceneFlags(RTC_SCENE_STATIC | RTC_SCENE_DEFERRED),aflags);
+    addSphere(object,RTC_GEOMETRY_STATIC,Vec3fa(0.0f),0.2f,10);
+    rtcCommit (object);
+    RTCRay ray = makeRay(Vec3fa(0.0f,0.0f,-5.0f),Vec3fa(0.0f,0.0f,1.0f));
+    rtcIntersectN(object,ray,N);
+    passed &= ray.geomID == 0 && abs(ray.tfar-4.8f) < 1E-2f;
+    AssertNoError();
+
+    rtcDeleteScene (object);
+    rtcDeleteScene (scene);
+    for (size_t i=0; i<16; i++) rtcDeleteScene (objects[i]);
+    AssertNoError();
+    return passed;
+  }
+
+  bool rtcore_scene_intersector(RTCSceneFlags sflags)
+  {
+    RTCScene scene = rtcNewScene(sflags,aflags);
+    AssertNoError();
+    for (size_t i=0; i<10; i++) 
+      addSphere(scene,RTC_GEOMETRY_STATIC,4.0f*Vec3fa(drand48(),drand48(),drand48()),1.0f,50);
+    AssertNoError();
+
+#if !defined(__EXIT_ON_ERROR__)
+    RTCSceneIntersector intersector1;
+    rtcGetSceneIntersector(scene,intersector1); // scene is not committed yet
+    AssertAnyError();
+    if (intersector1.intersect != NULL) return false;
+#endif
+    rtcCommit (scene);
+    AssertNoError();
+
+    /* resolved functions have to find the same hits as the API calls */
+    RTCSceneIntersector intersector;
+    rtcGetSceneIntersector(scene,intersector);
+    AssertNoError();
+    bool passed = true;
+    for (size_t i=0; i<1000; i++) 
+    {
+      Vec3fa org = 10.0f*Vec3fa(drand48(),drand48(),drand48())-Vec3fa(3.0f);
+      Vec3fa dir = Vec3fa(2.0f)-org;
+      RTCRay ray0 = makeRay(org,dir); rtcIntersect(scene,ray0);
+      RTCRay ray1 = makeRay(org,dir); intersector.intersect(intersector.ptr,ray1);
+      passed &= ray0.geomID == ray1.geomID && ray0.primID == ray1.primID && ray0.tfar == ray1.tfar;
+      RTCRay ray2 = makeRay(org,dir); rtcOccluded(scene,ray2);
+      RTCRay ray3 = makeRay(org,dir); intersector.occluded(intersector.ptr,ray3);
+      passed &= ray2.geomID == ray3.geomID;
+    }
+
+#if !defined(__MIC__)
+    RTCSceneIntersector4 intersector4;
+    rtcGetSceneIntersector4(scene,intersector4);
+    AssertNoError();
+    for (size_t i=0; i<100; i++) 
+    {
+      RTCRay4 ray0, ray1;
+      for (size_t j=0; j<4; j++) {
+        Vec3fa org = 10.0f*Vec3fa(drand48(),drand48(),drand48())-Vec3fa(3.0f);
+        RTCRay ray = makeRay(org,Vec3fa(2.0f)-org);
+        setRay(ray0,j,ray); setRay(ray1,j,ray);
+      }
+      __align(16) int valid4[4] = { -1,-1,-1,-1 };
+      rtcIntersect4(valid4,scene,ray0);
+      intersector4.intersect(valid4,intersector4.ptr,ray1);
+      for (size_t j=0; j<4; j++)
+        passed &= ray0.geomID[j] == ray1.geomID[j] && ray0.tfar[j] == ray1.tfar[j];
+    }
+#endif
+
+#if defined(__TARGET_AVX__) || defined(__TARGET_AVX2__)
+    if (has_feature(AVX)) 
+    {
+      RTCSceneIntersector8 intersector8;
+      rtcGetSceneIntersector8(scene,intersector8);
+      AssertNoError();
+      for (size_t i=0; i<100; i++) 
+      {
+        RTCRay8 ray0, ray1;
+        for (size_t j=0; j<8; j++) {
+          Vec3fa org = 10.0f*Vec3fa(drand48(),drand48(),drand48())-Vec3fa(3.0f);
+          RTCRay ray = makeRay(org,Vec3fa(2.0f)-org);
+          setRay(ray0,j,ray); setRay(ray1,j,ray);
+        }
+        __align(32) int valid8[8] = { -1,-1,-1,-1,-1,-1,-1,-1 };
+        rtcOccluded8(valid8,scene,ray0);
+        intersector8.occluded(valid8,intersector8.ptr,ray1);
+        for (size_t j=0; j<8; j++)
+          passed &= ray0.geomID[j] == ray1.geomID[j];
+      }
+    }
+#endif
+    
+    rtcDeleteScene (scene);
+    AssertNoError();
+    return passed;
+  }
+
+  void shootRays (RTCScene scene)
+  {
+    Vec3fa org(2.0f*drand48()-1.0f,2.0f*drand48()-1.0f,2.0f*drand48()-1.0f);
+    Vec3fa dir(2.0f*drand48()-1.0f,2.0f*drand48()-1.0f,2.0f*drand48()-1.0f);
+    RTCRay ray = makeRay(org,dir); 
+    rtcOccluded(scene,ray);
+    rtcIntersect(scene,ray);
+
+#if !defined(__MIC__)
+    RTCRay4 ray4;
+    for (size_t j=0; j<4; j++) {
+      Vec3fa org(2.0f*drand48()-1.0f,2.0f*drand48()-1.0f,2.0f*drand48()-1.0f);
+      Vec3fa dir(2.0f*drand48()-1.0f,2.0f*drand48()-1.0f,2.0f*drand48()-1.0f);
+      RTCRay ray = makeRay(org,dir); 
+      setRay(ray4,j,ray);
+    }
+    __align(16) int valid4[4] = { -1,-1,-1,-1 };
+    rtcOccluded4(valid4,scene,ray4);
+    rtcIntersect4(valid4,scene,ray4);
+#endif
+
+#if defined(__TARGET_AVX__) || defined(__TARGET_AVX2__)
+    if (has_feature(AVX)) {
+      RTCRay8 ray8;
+      for (size_t j=0; j<8; j++) {
+        Vec3fa org(2.0f*drand48()-1.0f,2.0f*drand48()-1.0f,2.0f*drand48()-1.0f);
+        Vec3fa dir(2.0f*drand48()-1.0f,2.0f*drand48()-1.0f,2.0f*drand48()-1.0f);
+        RTCRay ray = makeRay(org,dir); 
+        setRay(ray8,j,ray);
+      }
+      __align(32) int valid8[8] = { -1,-1,-1,-1,-1,-1,-1,-1 };
+      rtcOccluded8(valid8,scene,ray8);
+      rtcIntersect8(valid8,scene,ray8);
+    }
+#endif
+
+#if defined(__MIC__)
+    RTCRay16 ray16;
+    for (size_t j=0; j<16; j++) {
+      Vec3fa org(2.0f*drand48()-1.0f,2.0f*drand48()-1.0f,2.0f*drand48()-1.0f);
+      Vec3fa dir(2.0f*drand48()-1.0f,2.0f*drand48()-1.0f,2.0f*drand48()-1.0f);
+      RTCRay ray = makeRay(org,dir); 
+      setRay(ray16,j,ray);
+    }
+    __align(16) int valid16[16] = { -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1 };
+    rtcOccluded16(valid16,scene,ray16);
+    rtcIntersect16(valid16,scene,ray16);
+#endif
+  }
+
+  bool rtcore_regression_static()
+  {
+    for (size_t i=0; i<200; i++) 
+    {
+      if (i%20 == 0) std::cout << "." << std::flush;
+
+      RTCScene scene = rtcNewScene(RTC_SCENE_STATIC,aflags);
+      AssertNoError();
+
+      for (size_t j=0; j<20; j++) 
+      {
+        Vec3fa pos = 100.0f*Vec3fa(drand48(),drand48(),drand48());
+        size_t numPhi = rand()%100;
+        size_t numTriangles = 2*2*numPhi*(numPhi-1);
+        numTriangles = rand()%(numTriangles+1);
+        switch (rand()%3) {
+        case 0: addSphere(scene,RTC_GEOMETRY_STATIC,pos,2.0f,numPhi,numTriangles,0.0f); break;
+        case 1: addSphere(scene,RTC_GEOMETRY_STATIC,pos,2.0f,numPhi,numTriangles,1.0f); break;
+        case 2: addUserGeometryEmpty(scene,pos,2.0f); break;
+        }
+        AssertNoError();
+      }
+
+      rtcCommit(scene);
+      AssertNoError();
+
+      for (size_t i=0; i<100; i++)
+        shootRays(scene);
+
+      rtcDeleteScene (scene);
+      AssertNoError();
+    }
+    return true;
+  }
+
+  bool rtcore_regression_dynamic()
+  {
+    RTCScene scene = rtcNewScene(RTC_SCENE_DYNAMIC,aflags);
+    AssertNoError();
+    int geom[1024];
+    int types[1024];
+    size_t numVertices[1024];
+    for (size_t i=0; i<1024; i++)  {
+      geom[i] = -1;
+      types[i] = 0;
+      numVertices[i] = 0;
+    }
+
+    for (size_t i=0; i<200; i++) 
+    {
+      if (i%20 == 0) std::cout << "." << std::flush;
+
+      for (size_t j=0; j<20; j++) 
+      {
+        int index = rand()%1024;
+        Vec3fa pos = 100.0f*Vec3fa(drand48(),drand48(),drand48());
+        if (geom[index] == -1) 
+        {
+          int type = rand()%3;
+          size_t numPhi = rand()%100;
+          size_t numTriangles = 2*2*numPhi*(numPhi-1);
+          numTriangles = rand()%(numTriangles+1);
+          types[index] = type;
+          numVertices[index] = 2*numPhi*(numPhi+1);
+          switch (type) {
+          case 0: geom[index] = addSphere(scene,RTC_GEOMETRY_STATIC,pos,2.0f,numPhi,numTriangles,0.0f); break;
+          case 1: geom[index] = addSphere(scene,RTC_GEOMETRY_DEFORMABLE,pos,2.0f,numPhi,numTriangles,0.0f); break;
+          case 2: geom[index] = addSphere(scene,RTC_GEOMETRY_DYNAMIC,pos,2.0f,numPhi,numTriangles,0.0f); break;
+
+          case 3: geom[index] = addSphere(scene,RTC_GEOMETRY_STATIC,pos,2.0f,numPhi,numTriangles,1.0f); break;
+          case 4: geom[index] = addSphere(scene,RTC_GEOMETRY_DEFORMABLE,pos,2.0f,numPhi,numTriangles,1.0f); break;
           case 5: geom[index] = addSphere(scene,RTC_GEOMETRY_DYNAMIC,pos,2.0f,numPhi,numTriangles,1.0f); break;
             
           case 6: geom[index] = addUserGeometryEmpty(scene,pos,2.0f); break;
@@ -1867,6 +3164,80 @@ namespace embree
     return true;
   }
 
+  /*! tests a mesh of disconnected triangles that share no vertices */
+  bool rtcore_triangle_soup(RTCSceneFlags sflags)
+  {
+    const size_t num = 32;
+    RTCScene scene = rtcNewScene(sflags,aflags);
+    unsigned mesh = rtcNewTriangleMesh (scene, RTC_GEOMETRY_STATIC, num*num, 3*num*num);
+    Vertex*   vertices  = (Vertex*  ) rtcMapBuffer(scene,mesh,RTC_VERTEX_BUFFER); 
+    Triangle* triangles = (Triangle*) rtcMapBuffer(scene,mesh,RTC_INDEX_BUFFER);
+    for (size_t y=0; y<num; y++) {
+      for (size_t x=0; x<num; x++) {
+        size_t i = y*num+x;
+        vertices[3*i+0].x = float(x)+0.1f; vertices[3*i+0].y = float(y)+0.1f; vertices[3*i+0].z = 0.0f;
+        vertices[3*i+1].x = float(x)+0.9f; vertices[3*i+1].y = float(y)+0.1f; vertices[3*i+1].z = 0.0f;
+        vertices[3*i+2].x = float(x)+0.1f; vertices[3*i+2].y = float(y)+0.9f; vertices[3*i+2].z = 0.0f;
+        triangles[i].v0 = 3*i+0; triangles[i].v1 = 3*i+1; triangles[i].v2 = 3*i+2;
+      }
+    }
+    rtcUnmapBuffer(scene,mesh,RTC_VERTEX_BUFFER); 
+    rtcUnmapBuffer(scene,mesh,RTC_INDEX_BUFFER);
+    rtcCommit (scene);
+    AssertNoError();
+
+    /* every triangle is hit at its center, the gaps between the triangles are missed */
+    bool passed = true;
+    for (size_t i=0; i<num*num; i++) 
+    {
+      const float x = float(i%num), y = float(i/num);
+      RTCRay ray0 = makeRay(Vec3fa(x+0.3f,y+0.3f,-1.0f),Vec3fa(0.0f,0.0f,1.0f)); 
+      rtcIntersect(scene,ray0);
+      passed &= ray0.geomID == mesh && ray0.primID == i;
+      RTCRay ray1 = makeRay(Vec3fa(x+0.8f,y+0.8f,-1.0f),Vec3fa(0.0f,0.0f,1.0f)); 
+      rtcIntersect(scene,ray1);
+      passed &= ray1.geomID == RTC_INVALID_GEOMETRY_ID;
+    }
+
+    rtcDeleteScene (scene);
+    AssertNoError();
+    return passed;
+  }
+
+  /*! reruns the triangle tests with the specified triangle acceleration structure */
+  void rtcore_triangle_accel_all(const char* accel, bool watertight)
+  {
+    rtcExit();
+    rtcInit((g_rtcore+",accel="+accel).c_str());
+
+    const std::string prefix = std::string(accel) + ".";
+    POSITIVE((prefix+"closest_point").c_str(), rtcore_closest_point(RTC_SCENE_STATIC));
+    POSITIVE((prefix+"collide").c_str(),       rtcore_collide(RTC_SCENE_STATIC));
+    POSITIVE((prefix+"multi_hit").c_str(),     rtcore_multi_hit(RTC_SCENE_STATIC));
+    POSITIVE((prefix+"occluded_hint").c_str(), rtcore_occluded_hint(RTC_SCENE_STATIC));
+    POSITIVE((prefix+"triangle_soup").c_str(), rtcore_triangle_soup(RTC_SCENE_STATIC));
+    rtcore_packet_write_test_all((prefix+"packet_write_test").c_str());
+
+    /* the leaf type has to keep shared edges watertight in robust mode */
+    if (watertight) 
+    {
+      rtcore_watertight_sphere1((prefix+"watertight_sphere1").c_str(),100000);
+      rtcore_watertight_plane1((prefix+"watertight_plane1").c_str(),RTCSceneFlags(RTC_SCENE_STATIC | RTC_SCENE_ROBUST),100000);
+      rtcore_watertight_sphere4((prefix+"watertight_sphere4").c_str(),100000);
+      rtcore_watertight_plane4((prefix+"watertight_plane4").c_str(),RTCSceneFlags(RTC_SCENE_STATIC | RTC_SCENE_ROBUST),100000);
+      rtcore_watertight_plane4((prefix+"watertight_plane4_compact").c_str(),RTCSceneFlags(RTC_SCENE_STATIC | RTC_SCENE_COMPACT | RTC_SCENE_ROBUST),100000);
+#if defined(__TARGET_AVX__) || defined(__TARGET_AVX2__)
+      if (has_feature(AVX)) {
+        rtcore_watertight_sphere8((prefix+"watertight_sphere8").c_str(),100000);
+        rtcore_watertight_plane8((prefix+"watertight_plane8").c_str(),RTCSceneFlags(RTC_SCENE_STATIC | RTC_SCENE_ROBUST),100000);
+      }
+#endif
+    }
+
+    rtcExit();
+    rtcInit(g_rtcore.c_str());
+  }
+
   /* main function in embree namespace */
   int main(int argc, char** argv) 
   {
@@ -1905,36 +3276,115 @@ namespace embree
     POSITIVE("update_dynamic",            rtcore_update(RTC_GEOMETRY_DYNAMIC));
     POSITIVE("overlapping_geometry",      rtcore_overlapping(100000));
     POSITIVE("new_delete_geometry",       rtcore_new_delete_geometry());
+#if !defined(__MIC__)
+    POSITIVE("autotune_static",           rtcore_autotune(RTC_SCENE_STATIC));
+    POSITIVE("autotune_dynamic",          rtcore_autotune(RTC_SCENE_DYNAMIC));
+    POSITIVE("autotune_robust",           rtcore_autotune(RTC_SCENE_ROBUST));
+#endif
+    POSITIVE("scene_intersector_static",  rtcore_scene_intersector(RTC_SCENE_STATIC));
+    POSITIVE("scene_intersector_dynamic", rtcore_scene_intersector(RTC_SCENE_DYNAMIC));
+    POSITIVE("occluded_matrix_static",    rtcore_occluded_matrix(RTC_SCENE_STATIC));
+    POSITIVE("occluded_matrix_dynamic",   rtcore_occluded_matrix(RTC_SCENE_DYNAMIC));
+#if !defined(__MIC__)
+    POSITIVE("closest_point_static",      rtcore_closest_point(RTC_SCENE_STATIC));
+    POSITIVE("closest_point_dynamic",     rtcore_closest_point(RTC_SCENE_DYNAMIC));
+    POSITIVE("closest_point_robust",      rtcore_closest_point(RTC_SCENE_ROBUST));
+    POSITIVE("closest_point_compact",     rtcore_closest_point(RTC_SCENE_COMPACT));
+    POSITIVE("collide_static",            rtcore_collide(RTC_SCENE_STATIC));
+    POSITIVE("collide_dynamic",           rtcore_collide(RTC_SCENE_DYNAMIC));
+    POSITIVE("collide_compact",           rtcore_collide(RTC_SCENE_COMPACT));
+    POSITIVE("multi_hit_static",          rtcore_multi_hit(RTC_SCENE_STATIC));
+    POSITIVE("multi_hit_dynamic",         rtcore_multi_hit(RTC_SCENE_DYNAMIC));
+    POSITIVE("multi_hit_compact",         rtcore_multi_hit(RTC_SCENE_COMPACT));
+    POSITIVE("occluded_hint_static",      rtcore_occluded_hint(RTC_SCENE_STATIC));
+    POSITIVE("occluded_hint_dynamic",     rtcore_occluded_hint(RTC_SCENE_DYNAMIC));
+    POSITIVE("occluded_hint_compact",     rtcore_occluded_hint(RTC_SCENE_COMPACT));
+    POSITIVE("instancing1",               rtcore_instancing(RTC_SCENE_STATIC,1));
+    POSITIVE("instancing4",               rtcore_instancing(RTC_SCENE_STATIC,4));
+#if defined(__TARGET_AVX__) || defined(__TARGET_AVX2__)
+    if (has_feature(AVX)) POSITIVE("instancing8",rtcore_instancing(RTC_SCENE_STATIC,8));
+#endif
+    POSITIVE("nested_instancing1",        rtcore_nested_instancing(1));
+    POSITIVE("nested_instancing4",        rtcore_nested_instancing(4));
+#if defined(__TARGET_AVX__) || defined(__TARGET_AVX2__)
+    if (has_feature(AVX)) POSITIVE("nested_instancing8",rtcore_nested_instancing(8));
+#endif
+    POSITIVE("motion_blur_instancing1",   rtcore_motion_blur_instancing(2,1));
+    POSITIVE("motion_blur_instancing4",   rtcore_motion_blur_instancing(2,4));
+    POSITIVE("motion_blur_keys_instancing1", rtcore_motion_blur_instancing(3,1));
+    POSITIVE("motion_blur_keys_instancing4", rtcore_motion_blur_instancing(3,4));
+#if defined(__TARGET_AVX__) || defined(__TARGET_AVX2__)
+    if (has_feature(AVX)) POSITIVE("motion_blur_instancing8",rtcore_motion_blur_instancing(2,8));
+    if (has_feature(AVX)) POSITIVE("motion_blur_keys_instancing8",rtcore_motion_blur_instancing(3,8));
+#endif
+    POSITIVE("bulk_transforms1",          rtcore_bulk_transforms(1));
+    POSITIVE("bulk_transforms4",          rtcore_bulk_transforms(4));
+    POSITIVE("deferred_build1",           rtcore_deferred_build(1));
+    POSITIVE("deferred_build4",           rtcore_deferred_build(4));
+#if defined(__TARGET_AVX__) || defined(__TARGET_AVX2__)
+    if (has_feature(AVX)) POSITIVE("deferred_build8",rtcore_deferred_build(8));
+#endif
+#endif
 
 #if defined(__USE_RAY_MASK__)
     rtcore_ray_masks_all();
+    POSITIVE("instance_masks1",           rtcore_instance_masks(1));
+    POSITIVE("instance_masks4",           rtcore_instance_masks(4));
+#if defined(__TARGET_AVX__) || defined(__TARGET_AVX2__)
+    if (has_feature(AVX)) POSITIVE("instance_masks8",rtcore_instance_masks(8));
+#endif
 #endif
 
 #if defined(__BACKFACE_CULLING__)
     rtcore_backface_culling_all();
 #endif
 
-    rtcore_packet_write_test_all();
+#if defined(__INTERSECTION_FILTER__) && !defined(__MIC__)
+    rtcore_intersection_filter_all();
+    POSITIVE("kernel_features",           rtcore_kernel_features(RTC_SCENE_DYNAMIC));
+    POSITIVE("kernel_features_robust",    rtcore_kernel_features(RTCSceneFlags(RTC_SCENE_DYNAMIC | RTC_SCENE_ROBUST)));
+    POSITIVE("autotune_filter_static",    rtcore_autotune_filter(RTC_SCENE_STATIC));
+    POSITIVE("autotune_filter_dynamic",   rtcore_autotune_filter(RTC_SCENE_DYNAMIC));
+#endif
+
+#if !defined(__MIC__)
+    rtcore_user_geometry_range_all();
+    rtcore_points_all();
+    rtcore_quad_mesh_all();
+#endif
 
-    rtcore_watertight_sphere1(100000);
-    rtcore_watertight_plane1(100000);
+    rtcore_packet_write_test_all("packet_write_test");
+
+    rtcore_watertight_sphere1("watertight_sphere1",100000);
+    rtcore_watertight_plane1("watertight_plane1",RTCSceneFlags(RTC_SCENE_STATIC | RTC_SCENE_ROBUST),100000);
+    rtcore_watertight_plane1("watertight_plane1_coherent",RTCSceneFlags(RTC_SCENE_STATIC | RTC_SCENE_COHERENT | RTC_SCENE_ROBUST),100000);
+    rtcore_watertight_plane1("watertight_plane1_dynamic",RTCSceneFlags(RTC_SCENE_DYNAMIC | RTC_SCENE_ROBUST),100000);
 #if !defined(__MIC__)
-    rtcore_watertight_sphere4(100000);
-    rtcore_watertight_plane4(100000);
+    rtcore_watertight_sphere4("watertight_sphere4",100000);
+    rtcore_watertight_plane4("watertight_plane4",RTCSceneFlags(RTC_SCENE_STATIC | RTC_SCENE_ROBUST),100000);
+    rtcore_watertight_plane4("watertight_plane4_compact",RTCSceneFlags(RTC_SCENE_STATIC | RTC_SCENE_COMPACT | RTC_SCENE_ROBUST),100000);
+    rtcore_watertight_plane4("watertight_plane4_dynamic",RTCSceneFlags(RTC_SCENE_DYNAMIC | RTC_SCENE_ROBUST),100000);
 #endif
 
 #if defined(__TARGET_AVX__) || defined(__TARGET_AVX2__)
     if (has_feature(AVX)) {
-      rtcore_watertight_sphere8(100000);
-      rtcore_watertight_plane8(100000);
+      rtcore_watertight_sphere8("watertight_sphere8",100000);
+      rtcore_watertight_plane8("watertight_plane8",RTCSceneFlags(RTC_SCENE_STATIC | RTC_SCENE_ROBUST),100000);
+      rtcore_watertight_plane8("watertight_plane8_compact",RTCSceneFlags(RTC_SCENE_STATIC | RTC_SCENE_COMPACT | RTC_SCENE_ROBUST),100000);
     }
 #endif
 
 #if defined(__MIC__)
-    rtcore_watertight_sphere16(100000);
+    rtcore_watertight_sphere16("watertight_sphere16",100000);
     rtcore_watertight_plane16(100000);
 #endif
 
+#if !defined(__MIC__)
+    POSITIVE("triangle_soup",             rtcore_triangle_soup(RTC_SCENE_STATIC));
+    rtcore_triangle_accel_all("bvh4.triangle4q",true);
+    rtcore_triangle_accel_all("bvh4.trianglemeshlet",false); // no watertight meshlet intersectors
+#endif
+
 #if defined(__FIX_RAYS__)
     rtcore_nan("nan_test_1",RTC_SCENE_STATIC,RTC_GEOMETRY_STATIC,1);
     rtcore_inf("inf_test_1",RTC_SCENE_STATIC,RTC_GEOMETRY_STATIC,1);
@@ -0,0 +1,182 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+
+#include "headless.h"
+#include "sys/sysinfo.h"
+#include "lexers/streamfilters.h"
+#include "lexers/parsestream.h"
+#include "transport/transport_host.h"
+#include "image/image.h"
+
+#include <iomanip>
+
+namespace embree
+{
+  /* headless mode settings */
+  static bool g_headless = false;
+  static FileName g_cameraPath = "";
+  static size_t g_numFrames = 0;
+  static FileName g_outFileName = "";
+
+  void loadCameraPath(const FileName& fileName, const Camera& camera, std::vector<Camera>& path)
+  {
+    Ref<ParseStream> cin = new ParseStream(new LineCommentFilter(fileName, "#"), "\n\t\r ", "\n");
+    Camera key = camera;
+    bool empty = true;
+    while (true)
+    {
+      std::string tag = cin->getString();
+
+      /* end of keyframe */
+      if (tag == "\n" || tag == "") {
+        if (!empty) path.push_back(key);
+        empty = true;
+        if (tag == "") return;
+        continue;
+      }
+
+      /* parse camera parameters */
+      else if (tag == "-vp") key.from = cin->getVec3fa();
+      else if (tag == "-vi") key.to = cin->getVec3fa();
+      else if (tag == "-vd") key.to = key.from + cin->getVec3fa();
+      else if (tag == "-vu") key.up = cin->getVec3fa();
+      else if (tag == "-fov") key.fov = cin->getFloat();
+      else throw std::runtime_error(fileName.str()+": unknown camera path parameter: "+tag);
+      empty = false;
+    }
+  }
+
+  /* interpolates the camera path at time t in [0,1] */
+  static Camera interpolateCamera(const std::vector<Camera>& path, float t)
+  {
+    if (path.size() == 1) return path[0];
+    const float s = t*float(path.size()-1);
+    const size_t i = min(size_t(s),path.size()-2);
+    const float f = s-float(i);
+    const Camera& c0 = path[i];
+    const Camera& c1 = path[i+1];
+    Camera c;
+    c.from = (1.0f-f)*c0.from + f*c1.from;
+    c.to   = (1.0f-f)*c0.to   + f*c1.to;
+    c.up   = (1.0f-f)*c0.up   + f*c1.up;
+    c.fov  = (1.0f-f)*c0.fov  + f*c1.fov;
+    return c;
+  }
+
+  /* stores the framebuffer to an image file */
+  static void storeFrame(const int* pixels, size_t width, size_t height, const FileName& fileName)
+  {
+    Ref<Image> image = new Image3c(width,height,fileName.str());
+    for (size_t y=0; y<height; y++) {
+      for (size_t x=0; x<width; x++) {
+        const int pixel = pixels[y*width+x];
+        const float r = float((pixel >>  0) & 0xFF)*one_over_255;
+        const float g = float((pixel >>  8) & 0xFF)*one_over_255;
+        const float b = float((pixel >> 16) & 0xFF)*one_over_255;
+        image->set(x,y,Color(r,g,b));
+      }
+    }
+    storeImage(image,fileName);
+  }
+
+  void renderHeadless(const std::vector<Camera>& path, size_t numFrames, size_t width, size_t height, const FileName& outFileName)
+  {
+    if (path.size() == 0)
+      throw std::runtime_error("empty camera path");
+
+    /* the scene gets built lazily by the first rendered frame, thus
+     * we measure the build time by rendering a single pixel first */
+    AffineSpace3f pixel2world = path[0].pixel2world(1,1);
+    resize(1,1);
+    double t0 = getSeconds();
+    render(0.0f,pixel2world.l.vx,pixel2world.l.vy,pixel2world.l.vz,pixel2world.p);
+    const double buildTime = getSeconds()-t0;
+    resize(width,height);
+
+    std::cout << "frame,build_ms,render_ms,mrays_per_s" << std::endl;
+    std::cout.setf(std::ios::fixed, std::ios::floatfield);
+    std::cout.precision(3);
+
+    for (size_t i=0; i<numFrames; i++)
+    {
+      Camera camera = interpolateCamera(path,numFrames > 1 ? float(i)/float(numFrames-1) : 0.0f);
+      pixel2world = camera.pixel2world(width,height);
+
+      /* render frame */
+      t0 = getSeconds();
+      render(0.0f,pixel2world.l.vx,pixel2world.l.vy,pixel2world.l.vz,pixel2world.p);
+      const double dt = getSeconds()-t0;
+
+      /* print statistics, only primary rays are counted */
+      std::cout << i << ",";
+      std::cout << (i == 0 ? 1000.0*buildTime : 0.0) << ",";
+      std::cout << 1000.0*dt << ",";
+      std::cout << 1E-6*double(width*height)/dt << std::endl;
+
+      /* store frame */
+      if (outFileName.str() != "") 
+      {
+        FileName fileName = outFileName;
+        if (numFrames > 1) {
+          std::ostringstream number; number << std::setw(4) << std::setfill('0') << i;
+          fileName = FileName(outFileName.dropExt().str()+number.str()).addExt("."+outFileName.ext());
+        }
+        storeFrame(map(),width,height,fileName);
+        unmap();
+      }
+    }
+    cleanup();
+  }
+
+  bool parseHeadlessCommandLine(const std::string& tag, Ref<ParseStream> cin, const FileName& path)
+  {
+    /* render without display */
+    if (tag == "-headless")
+      g_headless = true;
+
+    /* camera path to play back in headless mode */
+    else if (tag == "-camerapath") {
+      g_cameraPath = path + cin->getFileName();
+      g_headless = true;
+    }
+
+    /* number of frames to render in headless mode */
+    else if (tag == "-frames") {
+      g_numFrames = cin->getInt();
+      g_headless = true;
+    }
+
+    /* output image of headless mode */
+    else if (tag == "-o") {
+      g_outFileName = path + cin->getFileName();
+      g_headless = true;
+    }
+
+    else return false;
+    return true;
+  }
+
+  bool runHeadless(const Camera& camera, size_t width, size_t height)
+  {
+    if (!g_headless) return false;
+    std::vector<Camera> path;
+    if (g_cameraPath.str() != "") loadCameraPath(g_cameraPath,camera,path);
+    else path.push_back(camera);
+    renderHeadless(path,g_numFrames ? g_numFrames : path.size(),width,height,g_outFileName);
+    return true;
+  }
+}
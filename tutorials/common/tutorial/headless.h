@@ -0,0 +1,50 @@
+// ======================================================================== //
+// Copyright 2009-2013 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+
+#ifndef __EMBREE_TUTORIALS_HEADLESS_H__
+#define __EMBREE_TUTORIALS_HEADLESS_H__
+
+#include "sys/platform.h"
+#include "sys/filename.h"
+#include "lexers/parsestream.h"
+#include "camera.h"
+
+#include <vector>
+
+namespace embree
+{
+  /* loads a camera path, each line of the file is one keyframe
+   * using the -vp, -vi, -vd, -vu, and -fov command line
+   * semantics, unspecified values are taken from the previous keyframe */
+  void loadCameraPath(const FileName& fileName, const Camera& camera, std::vector<Camera>& path);
+
+  /* renders numFrames frames along the camera path without display
+   * and prints build time, render time, and Mrays/s per frame as
+   * CSV, frames are optionally stored to image files */
+  void renderHeadless(const std::vector<Camera>& path, size_t numFrames, size_t width, size_t height, const FileName& outFileName);
+
+  /* parses the -headless, -camerapath, -frames, and -o command line
+   * parameters, returns false if tag is none of them */
+  bool parseHeadlessCommandLine(const std::string& tag, Ref<ParseStream> cin, const FileName& path);
+
+  /* renders along the camera path given on the command line, or
+   * from the initial camera, if headless mode was selected, returns
+   * false otherwise */
+  bool runHeadless(const Camera& camera, size_t width, size_t height);
+}
+
+#endif
@@ -46,7 +46,10 @@
     __forceinline RTCRay(const embree::Vec3fa& org, const embree::Vec3fa& dir, 
 			 float tnear = embree::zero, float tfar = embree::inf, 
 			 float time = embree::zero, int mask = -1)
-      : org(org), dir(dir), tnear(tnear), tfar(tfar), geomID(-1), primID(-1), instID(-1), mask(mask), time(time) {}
+      : org(org), dir(dir), tnear(tnear), tfar(tfar), geomID(-1), primID(-1), instID(-1), mask(mask), time(time) 
+    {
+      for (size_t i=0; i<RTC_MAX_INSTANCE_DEPTH; i++) instStack[i] = -1;
+    }
 
     /*! Tests if we hit something. */
     __forceinline operator bool() const { return geomID != -1; }
@@ -65,7 +68,8 @@
     float v;           //!< Barycentric v coordinate of hit
     int geomID;           //!< geometry ID
     int primID;           //!< primitive ID
-    int instID;           //!< instance ID
+    int instID;           //!< instance ID of the outermost instance
+    int instStack[RTC_MAX_INSTANCE_DEPTH]; //!< instance IDs of all nested instances, outermost first
   };
 
   /*! Outputs ray to stream. */
@@ -387,7 +387,7 @@ Vec3fa renderPixelStandard(int x, int y, const Vec3fa& vx, const Vec3fa& vy, con
   ray.tfar = inf;
   ray.geomID = -1;
   ray.primID = -1;
-  ray.instID = 4; // set default instance ID
+  ray.instID = -1;
   ray.mask = -1;
   ray.time = 0;
   
@@ -399,8 +399,9 @@ Vec3fa renderPixelStandard(int x, int y, const Vec3fa& vx, const Vec3fa& vy, con
   if (ray.geomID != -1) 
   {
     Vec3f diffuse = Vec3f(0.0f);
-    if (ray.instID == 0) diffuse = colors[ray.instID][ray.primID];
-    else                 diffuse = colors[ray.instID][ray.geomID];
+    const int instID = ray.instID == -1 ? 4 : ray.instID; // hits outside of any instance use the last color set
+    if (instID == 0) diffuse = colors[instID][ray.primID];
+    else             diffuse = colors[instID][ray.geomID];
     color = add(color,mul(diffuse,0.5));
     Vec3f lightDir = normalize(Vec3f(-1,-1,-1));
     
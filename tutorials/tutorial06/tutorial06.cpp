@@ -16,6 +16,7 @@
 
 #include "tutorial/tutorial.h"
 #include "tutorial/obj_loader.h"
+#include "tutorial/headless.h"
 #include "sys/taskscheduler.h"
 
 namespace embree
@@ -99,6 +100,10 @@ namespace embree
       else if (tag == "-threads")
         g_numThreads = cin->getInt();
 
+      /* headless mode parameters */
+      else if (parseHeadlessCommandLine(tag,cin,path)) 
+        continue;
+
       /* skip unknown command line parameter */
       else {
         std::cerr << "unknown command line parameter: " << tag << " ";
@@ -131,6 +136,10 @@ namespace embree
     /* send model */
     set_scene(&g_obj_scene);
 
+    /* render along camera path without display */
+    if (runHeadless(g_camera,g_width,g_height))
+      return 0;
+
     /* initialize GLUT */
     initGlut(tutorialName,g_width,g_height,g_fullscreen,true);
     